@@ -11,10 +11,19 @@
 
 #include <sys/types.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdatomic.h>
 #include "config.h"
 #include "statistics.h"
 #include "menu.h"
 #include "message.h"
+#include "shm_ring.h"
+#include "dining_area.h"
+#include "user_registry.h"
+#include "virtual_clock.h"
+#include "simulation_clock.h"
+#include "live_statistics.h"
 
 /** Percorso e ID per la generazione delle chiavi IPC tramite ftok() */
 #define IPC_KEY_PATH "config/config.conf"
@@ -26,8 +35,8 @@
 /** Numero massimo di utenti per gruppo di amici */
 #define MAX_USERS_PER_GROUP 8
 
-/** Numero massimo di tavoli gestibili nell'area refezione */
-#define MAX_TABLES 128
+/** Slot di gruppo riservati oltre a quelli iniziali per i gruppi aggiunti da add_users */
+#define SPARE_GROUP_SLOTS 100
 
 /* ==========================================================================
  *                         SEZIONE: INDICI SEMAFORICI
@@ -70,16 +79,26 @@ typedef enum {
     SYNC_BARRIER_SEM_COUNT      /**< Totale semafori in questo set */
 } SyncBarrierIndex;
 
+/** Numero di lock a strisce per lo stato dei gruppi (indice = group_id % N) */
+#define GROUP_MUTEX_STRIPES 16
+
 /**
  * @brief Indici per il set di semafori Mutex.
  * Garantiscono l'accesso atomico alle sezioni critiche della memoria condivisa.
  */
 typedef enum {
     MUTEX_SIMULATION_STATS = 0, /**< Protegge la struttura delle statistiche globali */
-    MUTEX_SHARED_DATA,          /**< Protegge i campi comuni della memoria condivisa (es. giorno corrente) */
+    MUTEX_SHARED_DATA,          /**< Protegge i campi comuni (current_total_users) */
     MUTEX_ADD_USERS_PERMISSION, /**< Permesso per i processi add_users di procedere */
     MUTEX_TABLES,               /**< Protegge l'accesso atomico all'array dei tavoli */
-    MUTEX_SEMAPHORE_COUNT       /**< Numero totale di semafori mutex */
+    MUTEX_USER_REGISTRY,        /**< Protegge user_registry (PID -> gruppo) */
+    MUTEX_CASHIER_LEDGER,       /**< Protegge gli incassi di register_station */
+    MUTEX_STATION_FIRST_COURSE, /**< Decisione pause operatori della stazione Primi */
+    MUTEX_STATION_SECOND_COURSE,  /**< Decisione pause operatori della stazione Secondi */
+    MUTEX_STATION_COFFEE_DESSERT, /**< Decisione pause operatori della stazione Caffè/Dolci */
+    MUTEX_STATION_CASHIER,      /**< Decisione pause dei cassieri */
+    MUTEX_GROUP_STRIPE_BASE,    /**< Primo dei GROUP_MUTEX_STRIPES lock su group_statuses[] */
+    MUTEX_SEMAPHORE_COUNT = MUTEX_GROUP_STRIPE_BASE + GROUP_MUTEX_STRIPES /**< Numero totale di semafori mutex */
 } MutexSemaphoreIndex;
 
 /**
@@ -94,59 +113,45 @@ typedef enum {
     STATION_SEM_COUNT                /**< Totale semafori per stazione */
 } StationSemaphoreIndex;
 
+/**
+ * @brief Numero di code di risposta per stazione (sharding per PID utente).
+ *
+ * Le risposte non transitano sulla coda ordini: l'utente le attende sulla
+ * coda `reply_queue_ids[pid % STATION_REPLY_QUEUE_SHARDS]`, così la ricerca
+ * per mtype del kernel scorre solo le risposte del proprio shard.
+ */
+#define STATION_REPLY_QUEUE_SHARDS 4
+
 /**
  * @brief Rappresentazione di una stazione di distribuzione cibo.
  */
 typedef struct {
-    int message_queue_id;               /**< ID della coda di messaggi per gli ordini */
+    int message_queue_id;               /**< ID della coda di messaggi per gli ordini (solo FIFO) */
+    int reply_queue_ids[STATION_REPLY_QUEUE_SHARDS]; /**< Code di risposta, shard = pid % K */
     int semaphore_set_id;               /**< ID del set di semafori della stazione (StationSemaphoreIndex) */
     int num_operators_assigned;         /**< Numero di operatori assegnati a questa stazione */
-    int portions[MAX_DISHES_PER_CATEGORY];  /**< Disponibilità fisica delle porzioni di cibo */
+    _Atomic int portions[MAX_DISHES_PER_CATEGORY];  /**< Porzioni disponibili (lock-free, vedi take_station_portion) */
+    OrderRing order_ring;               /**< Ring ordini in SHM (backend QUEUE_BACKEND=ring) */
 } FoodDistributionStation;
 
 /**
  * @brief Rappresentazione della stazione di pagamento (Cassa).
  */
 typedef struct {
-    int message_queue_id;               /**< ID della coda di messaggi per i pagamenti */
+    int message_queue_id;               /**< ID della coda di messaggi per i pagamenti (solo FIFO) */
+    int reply_queue_ids[STATION_REPLY_QUEUE_SHARDS]; /**< Code di risposta, shard = pid % K */
     int semaphore_set_id;               /**< ID del set di semafori (Cassa) */
     double daily_income;                /**< Incasso specifico della giornata corrente */
     double total_income;                /**< Incasso totale accumulato nella simulazione */
+    OrderRing order_ring;               /**< Ring pagamenti in SHM (backend QUEUE_BACKEND=ring) */
 } CashierStation;
 
 /* ==========================================================================
  *                         SEZIONE: STRUTTURE DATI
  * ========================================================================== */
 
-/** Capacità massima del registry per il tracciamento dei processi utente */
-#define MAX_USERS_REGISTRY 4096
-
-/**
- * @brief Informazioni di tracciamento per ogni processo utente.
- * Usato dal Master per gestire la morte asincrona e le barriere di gruppo.
- */
-typedef struct {
-    pid_t pid;                          /**< PID del processo */
-    int group_index;                    /**< Indice del gruppo di appartenenza */
-} UserProcessMetadata;
-
-/**
- * @brief Rappresentazione di un singolo tavolo della mensa.
- */
-typedef struct {
-    int id;               /**< Identificativo univoco del tavolo */
-    int capacity;         /**< Numero massimo di posti (es. 2, 4, 6) */
-    int occupied_seats;   /**< Numero di posti attualmente occupati */
-} Table;
-
-/**
- * @brief Area dedicata al consumo dei pasti (Refezione).
- */
-typedef struct {
-    int condition_semaphore_id;         /**< Semaforo di segnalazione per posti liberati */
-    int active_tables_count;            /**< Numero di tavoli effettivamente inizializzati */
-    Table tables[MAX_TABLES];           /**< Stato dinamico della topologia dei tavoli */
-} DiningArea;
+/** Shard statistici oltre a quelli degli utenti (operatori, cassieri, Master, utility) */
+#define NON_USER_STATISTICS_SHARDS 256
 
 /**
  * @brief Stato dinamico di un gruppo di utenti durante la giornata.
@@ -179,6 +184,9 @@ struct MainSharedMemory {
     int group_pool_size;                /**< Numero totale di slot nel pool di sincronizzazione */
     int semaphore_ticket_id;            /**< ID Semaforo per la validazione ticket all'ingresso */
 
+    /** Mutex process-shared robusti (usati solo con MUTEX_BACKEND=pthread, vedi mutex.h) */
+    pthread_mutex_t simulation_mutexes[MUTEX_SEMAPHORE_COUNT];
+
     pid_t master_pid;                   /**< PID del processo Responsabile Mensa */
     pid_t process_group_pids[MAX_PROCESS_GROUPS]; /**< PGID dei vari gruppi di processi */
 
@@ -190,16 +198,46 @@ struct MainSharedMemory {
     DiningArea seat_area;
 
     int control_queue_id;               /**< ID Coda per richieste add_users */
+    int zygote_queue_id;                /**< ID Coda richieste di spawn allo zygote utenti */
+    int trace_shared_memory_id;         /**< ID del segmento delle ring di traccia, vedi trace.h */
+    _Atomic int trace_enabled;          /**< Tracciamento eventi attivo (acceso da mensa_trace) */
     int current_total_users;           /**< Numero attuale di utenti nella simulazione */
     int add_users_flag;                /**< Flag per segnalare richieste di aggiunta utenti */
 
     int current_simulation_day;         /**< Giorno attuale della simulazione */
-    int simulation_minutes_passed;      /**< Minuti simulati trascorsi dall'inizio del giorno */
+    int simulation_minutes_passed;      /**< Minuti simulati trascorsi dall'inizio del giorno (ticker) */
     int is_simulation_running;          /**< Flag globale (1: Attiva, 0: Arresto Totale) */
     int current_simulation_status;      /**< Stato attuale (Aperto, In Chiusura, Disorder) */
 
-    /** Registry per tracciamento PID -> Group (Proposta 2 Punto 2) */
-    UserProcessMetadata user_registry[MAX_USERS_REGISTRY];
+    /** Registry per tracciamento PID -> Group (Proposta 2 Punto 2), vedi user_registry.h */
+    UserRegistry user_registry;
+
+    /**
+     * Capacità in utenti (iniziali + SPARE_GROUP_SLOTS gruppi pieni): dimensiona le
+     * caselle di risposta (backend ring), gli shard statistici e gli slot di risveglio
+     * dell'orologio virtuale, allocati in coda al segmento dopo group_statuses.
+     * Accesso tramite shm_reply_slots(), shm_statistics_shards() e virtual_clock_wakeups().
+     */
+    int user_capacity;
+    int reply_slots_count;
+    size_t reply_slots_offset;
+    int statistics_shards_count;
+    size_t statistics_shards_offset;
+
+    /** Orologio simulato pubblicato dal Master, vedi simulation_clock.h */
+    SimulationClock simulation_clock;
+
+    /** Orologio virtuale condiviso (usato solo con CLOCK_MODE=virtual, vedi virtual_clock.h) */
+    VirtualClock virtual_clock;
+
+    /** Istogrammi delle attese, fusi da collect_simulation_statistics */
+    LatencyStripe latency_stripes[MAX_LATENCY_STRIPES];
+
+    /** Tempi di coda e servizio per operatore/cassiere, vedi OperatorActivity */
+    OperatorActivity operator_activity[MAX_OPERATOR_ACTIVITY];
+
+    /** Istantanea per il monitoraggio (mensa_top), pubblicata a ogni minuto, vedi live_statistics.h */
+    LiveStatistics live_statistics;
 
     /**
      * @brief Stato dinamico dei gruppi.
@@ -211,6 +249,16 @@ struct MainSharedMemory {
 
 typedef struct MainSharedMemory MainSharedMemory;
 
+/** Caselle di risposta per utente del canale di stazione (reply_slots_count elementi). */
+static inline ReplySlot *shm_reply_slots(MainSharedMemory *shm) {
+    return (ReplySlot *)((char *)shm + shm->reply_slots_offset);
+}
+
+/** Contatori statistici per processo/thread, sommati da collect_simulation_statistics (statistics_shards_count elementi). */
+static inline StatisticsShard *shm_statistics_shards(MainSharedMemory *shm) {
+    return (StatisticsShard *)((char *)shm + shm->statistics_shards_offset);
+}
+
 /* ==========================================================================
  *                         SEZIONE: PROTOTIPI FUNZIONI
  * ========================================================================== */
@@ -223,6 +271,59 @@ typedef struct MainSharedMemory MainSharedMemory;
  */
 MainSharedMemory* attach_to_simulation_shared_memory(int shared_memory_id);
 
+/**
+ * @brief Preleva una porzione del piatto indicato (decremento CAS, senza lock).
+ *
+ * @param station Stazione di distribuzione in SHM.
+ * @param dish_index Indice del piatto nel menu della stazione.
+ * @return bool true se la porzione è stata prelevata, false se esaurita.
+ */
+bool take_station_portion(FoodDistributionStation *station, int dish_index);
+
+/**
+ * @brief Lettura senza lock della disponibilità di un piatto.
+ */
+int get_station_portions(FoodDistributionStation *station, int dish_index);
+
+/**
+ * @brief Aggiunge porzioni con saturazione al massimo consentito (CAS).
+ *
+ * @param amount Porzioni da aggiungere.
+ * @param maximum Capienza massima della stazione per il piatto.
+ */
+void refill_station_portions(FoodDistributionStation *station, int dish_index, int amount, int maximum);
+
+/**
+ * @brief Imposta la disponibilità di un piatto (rifornimento di inizio giornata).
+ */
+void set_station_portions(FoodDistributionStation *station, int dish_index, int amount);
+
+/**
+ * @brief Compensa gli arrivi mancanti di processi terminati sulle barriere di startup, mattina e sera.
+ *
+ * Prelievi non bloccanti: nessun effetto sulle barriere già aperte.
+ *
+ * @param count Processi (o utenti di un host) da non attendere più.
+ */
+void compensate_lost_barrier_arrivals(MainSharedMemory *shm, int count);
+
+/**
+ * @brief Toglie dalla simulazione utenti terminati o mai avviati.
+ *
+ * Compensa le barriere e, a simulazione in corso, riduce current_total_users
+ * (MUTEX_SHARED_DATA) perché le barriere dei giorni successivi non li contino.
+ */
+void withdraw_lost_users(MainSharedMemory *shm, int count);
+
+/**
+ * @brief Toglie membri persi da un gruppo e ne compensa le barriere di gruppo.
+ *
+ * @param members Membri da togliere, -1 per tutti quelli ancora attivi.
+ * @param member_pid PID/TID del membro: se era il leader il ruolo viene liberato (0: nessuno).
+ * @return int Membri effettivamente tolti.
+ */
+int withdraw_lost_group_members(MainSharedMemory *shm, int group_index, int members, pid_t member_pid);
+
 /**
  * @brief Esegue la pulizia di tutte le risorse IPC allocate.
  * @param shared_memory_ptr Puntatore alla struttura di memoria condivisa.
@@ -11,6 +11,9 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+/* Includes del progetto */
+#include "log.h"
+
 /* ==========================================================================
  *                      SEZIONE: STRUTTURE DI CONFIGURAZIONE
  * ========================================================================== */
@@ -24,6 +27,8 @@ typedef struct {
     int number_of_new_users_batch;     /**< Numero di utenti aggiunti in ogni batch */
     int number_of_allowed_breaks;       /**< Numero massimo di pause consentite per operatore */
     int maximum_users_per_group;        /**< Dimensione massima di un gruppo di utenti */
+    int users_per_host;                 /**< Utenti per processo host (thread); 0: un processo per utente */
+    int user_host_event_loop;           /**< 1: host a macchina a stati (event loop) invece che a thread */
 } ConfigurationQuantities;
 
 /**
@@ -62,6 +67,7 @@ typedef struct {
     int average_service_time_ticket;    /**< Tempo medio per la validazione del ticket */
     int average_refill_time;            /**< Tempo medio per un rifornimento stazione */
     int stop_duration_minutes;          /**< Durata del blocco Communication Disorder (sec reali) */
+    int timeseries_interval_minutes;    /**< Passo della serie temporale (TIMESERIES_INTERVAL), 0: disattivata */
 } ConfigurationTimings;
 
 /**
@@ -85,6 +91,9 @@ typedef struct {
     ConfigurationPrices prices;
     ConfigurationThresholds thresholds;
     ConfigurationTimings timings;
+    unsigned long long random_seed;     /**< Seme dei flussi casuali (RANDOM_SEED); 0: scelto all'avvio dal Master */
+    int statistics_format;              /**< Formato del file statistiche (STATISTICS_FORMAT, StatisticsFormat) */
+    int log_levels[LOG_ROLE_COUNT];     /**< Livello di log per ruolo (LOG_LEVEL_*), default debug */
 } SimulationConfiguration;
 
 /* ==========================================================================
@@ -0,0 +1,127 @@
+/**
+ * @file dining_area.h
+ * @brief Area refezione: tavoli e indice dei posti liberi per capacità.
+ *
+ * I tavoli sono indicizzati per numero di posti liberi (0..TABLE_MAX_CAPACITY)
+ * tramite bitmap a due livelli: la ricerca di un tavolo con almeno N posti
+ * liberi costa O(TABLE_MAX_CAPACITY) operazioni di bit-scan, indipendentemente
+ * dal numero di tavoli. Prenotazione e rilascio aggiornano l'indice in modo
+ * incrementale.
+ *
+ * I leader che non trovano posto attendono sul canale (semaforo) della
+ * propria dimensione di gruppo: ogni rilascio risveglia al più un leader per
+ * ciascuna dimensione che ora trova un tavolo, evitando risvegli inutili.
+ *
+ * Le funzioni non acquisiscono lock: il chiamante deve detenere MUTEX_TABLES.
+ */
+
+#ifndef DINING_AREA_H
+#define DINING_AREA_H
+
+#include <stdint.h>
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/** Numero massimo di tavoli gestibili nell'area refezione */
+#define MAX_TABLES 1024
+
+/** Capacità massima di un singolo tavolo (topologia: tavoli da 2, 4 e 6) */
+#define TABLE_MAX_CAPACITY 6
+
+/** Parole a 64 bit per bitmap di bucket (una per tavolo) */
+#define TABLE_BITMAP_WORDS (MAX_TABLES / 64)
+
+/**
+ * Canali di attesa dei leader (semafori del set condition_semaphore_id):
+ * l'indice s in 1..TABLE_MAX_CAPACITY serve i gruppi di s persone, l'indice 0
+ * i gruppi più grandi di qualsiasi tavolo (mai segnalato, attesa fino a fine giornata).
+ */
+#define DINING_WAIT_CHANNELS (TABLE_MAX_CAPACITY + 1)
+
+_Static_assert(MAX_TABLES % 64 == 0, "MAX_TABLES deve essere multiplo di 64");
+_Static_assert(TABLE_BITMAP_WORDS <= 64, "Il riepilogo del bucket deve stare in una parola");
+
+/* ==========================================================================
+ *                        SEZIONE: TIPI E STRUTTURE
+ * ========================================================================== */
+
+/**
+ * @brief Rappresentazione di un singolo tavolo della mensa.
+ */
+typedef struct {
+    int id;               /**< Identificativo univoco del tavolo */
+    int capacity;         /**< Numero massimo di posti (es. 2, 4, 6) */
+    int occupied_seats;   /**< Numero di posti attualmente occupati */
+} Table;
+
+/**
+ * @brief Insieme dei tavoli con uno stesso numero di posti liberi.
+ */
+typedef struct {
+    uint64_t summary;                       /**< Bit w acceso se words[w] != 0 */
+    uint64_t words[TABLE_BITMAP_WORDS];     /**< Bit t acceso se il tavolo t è nel bucket */
+} TableFreeBucket;
+
+/**
+ * @brief Area dedicata al consumo dei pasti (Refezione).
+ */
+typedef struct {
+    int condition_semaphore_id;         /**< Set di DINING_WAIT_CHANNELS semafori (un canale per dimensione gruppo) */
+    int active_tables_count;            /**< Numero di tavoli effettivamente inizializzati */
+    Table tables[MAX_TABLES];           /**< Stato dinamico della topologia dei tavoli */
+    TableFreeBucket free_buckets[TABLE_MAX_CAPACITY + 1]; /**< Indice tavoli per posti liberi */
+    int waiting_leaders[DINING_WAIT_CHANNELS]; /**< Leader registrati in attesa su ciascun canale */
+} DiningArea;
+
+/* ==========================================================================
+ *                        SEZIONE: FUNZIONI PUBBLICHE
+ * ========================================================================== */
+
+/**
+ * @brief Libera tutti i posti, ricostruisce l'indice e azzera i canali di attesa.
+ *
+ * Da invocare dopo la generazione della topologia e ad ogni inizio giornata
+ * (i semafori dei canali vengono riportati a 0 con una sola SETALL).
+ *
+ * @param area Area refezione in SHM.
+ */
+void dining_area_reset(DiningArea *area);
+
+/**
+ * @brief Occupa `seats` posti sul tavolo più piccolo che li può ospitare.
+ *
+ * @param area Area refezione in SHM.
+ * @param seats Numero di posti richiesti (membri del gruppo).
+ * @return int Indice del tavolo assegnato, -1 se nessun tavolo ha posti sufficienti.
+ */
+int dining_area_reserve(DiningArea *area, int seats);
+
+/**
+ * @brief Restituisce `seats` posti del tavolo indicato.
+ *
+ * @param area Area refezione in SHM.
+ * @param table_id Indice del tavolo.
+ * @param seats Numero di posti liberati.
+ */
+void dining_area_release(DiningArea *area, int table_id, int seats);
+
+/**
+ * @brief Registra un leader in attesa di un tavolo da `seats` posti.
+ *
+ * Dopo aver rilasciato MUTEX_TABLES il chiamante deve attendere sul semaforo
+ * restituito del set condition_semaphore_id.
+ *
+ * @return int Canale (indice del semaforo) su cui attendere.
+ */
+int dining_area_register_waiter(DiningArea *area, int seats);
+
+/**
+ * @brief Risveglia un leader per ogni dimensione di gruppo che ora trova posto.
+ *
+ * Da invocare dopo dining_area_release(), sempre sotto MUTEX_TABLES.
+ */
+void dining_area_wake_fitting_waiters(DiningArea *area);
+
+#endif /* DINING_AREA_H */
@@ -0,0 +1,37 @@
+/**
+ * @file futex.h
+ * @brief Wrapper minimi sulla syscall futex per parole in memoria condivisa.
+ *
+ * Usati dalla ring ordini, dall'orologio simulato e dall'orologio virtuale.
+ * I futex non sono privati (niente FUTEX_PRIVATE_FLAG): le parole risiedono
+ * in SHM e sono condivise tra processi.
+ */
+
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Sospende il chiamante finché *word == expected.
+ *
+ * @return int 0 al risveglio, -1 errore (errno EAGAIN se *word != expected, EINTR se interrotto).
+ */
+int futex_wait(_Atomic uint32_t *word, uint32_t expected);
+
+/**
+ * @brief Risveglia fino a `count` processi sospesi su *word.
+ */
+void futex_wake(_Atomic uint32_t *word, int count);
+
+/**
+ * @brief Risveglia tutti i processi sospesi su *word.
+ */
+void futex_wake_all(_Atomic uint32_t *word);
+
+#endif /* FUTEX_H */
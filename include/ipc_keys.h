@@ -64,9 +64,18 @@
 /** ID della coda di messaggi della stazione cassa */
 #define IPC_KEY_QUEUE_REGISTER_STATION      2300
 
+/**
+ * Le code di risposta di ogni stazione usano le chiavi successive a quella
+ * della coda ordini: chiave_ordini + 1 + shard (es. 2001-2004 per i primi).
+ */
+#define IPC_KEY_REPLY_QUEUE_OFFSET          1
+
 /** ID della coda di controllo per le richieste add_users */
 #define IPC_KEY_QUEUE_CONTROL               2400
 
+/** ID della coda delle richieste di spawn verso lo zygote utenti */
+#define IPC_KEY_QUEUE_USER_ZYGOTE           2500
+
 /* ==========================================================================
  *                    MEMORIA CONDIVISA (Range 3000-3999)
  * ========================================================================== */
@@ -74,4 +83,7 @@
 /** ID della memoria condivisa principale della simulazione */
 #define IPC_KEY_SHARED_MEMORY               3000
 
+/** ID del segmento delle ring di tracciamento eventi (trace.h) */
+#define IPC_KEY_SHARED_MEMORY_TRACE         3100
+
 #endif /* IPC_KEYS_H */
@@ -0,0 +1,86 @@
+/**
+ * @file latency_histogram.h
+ * @brief Istogrammi log-lineari (stile HDR) per le distribuzioni dei tempi di attesa.
+ *
+ * I valori sono secondi simulati interi (la risoluzione dell'orologio
+ * simulato). Sotto 2^LATENCY_HISTOGRAM_SUB_BITS ogni secondo ha un bucket
+ * proprio; oltre, ogni potenza di 2 è divisa in metà di quei bucket lineari,
+ * con errore relativo massimo ~1.6% su tutto l'intervallo.
+ *
+ * La registrazione è un incremento atomico relaxed, senza lock: più
+ * processi possono scrivere nello stesso istogramma. Lettura e fusione
+ * (latency_histogram_merge) sono fatte dal Master.
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/** Bit della parte lineare: 64 bucket esatti, poi 32 per ogni potenza di 2 */
+#define LATENCY_HISTOGRAM_SUB_BITS 6
+
+/** Esponente del valore massimo distinto (2^20 s, circa 12 giorni simulati) */
+#define LATENCY_HISTOGRAM_MAX_BITS 20
+
+/** Numero di bucket: i valori oltre il massimo ricadono nell'ultimo */
+#define LATENCY_HISTOGRAM_BUCKETS \
+    ((LATENCY_HISTOGRAM_MAX_BITS - LATENCY_HISTOGRAM_SUB_BITS + 2) << (LATENCY_HISTOGRAM_SUB_BITS - 1))
+
+/** Unità dei valori registrati per minuto simulato (secondi) */
+#define LATENCY_UNITS_PER_MINUTE 60.0
+
+/* ==========================================================================
+ *                        SEZIONE: TIPI E STRUTTURE
+ * ========================================================================== */
+
+/**
+ * @brief Conteggi per bucket di una distribuzione.
+ */
+typedef struct {
+    _Atomic uint32_t counts[LATENCY_HISTOGRAM_BUCKETS];
+} LatencyHistogram;
+
+/**
+ * @brief Riepilogo di un istogramma, in minuti simulati.
+ */
+typedef struct {
+    int samples;                        /**< Numero di campioni */
+    double mean;                        /**< Media (sui valori rappresentativi dei bucket) */
+    double p50;                         /**< Mediana */
+    double p95;                         /**< 95° percentile */
+    double p99;                         /**< 99° percentile */
+    double max;                         /**< Massimo (estremo superiore del bucket) */
+} LatencyPercentiles;
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Registra un tempo espresso in minuti simulati (lock-free).
+ */
+void latency_histogram_record(LatencyHistogram *histogram, double minutes);
+
+/**
+ * @brief Somma i conteggi di `src` in `dst`.
+ */
+void latency_histogram_merge(LatencyHistogram *dst, const LatencyHistogram *src);
+
+/**
+ * @brief Valore (in minuti) sotto cui cade la frazione `percentile` (0-100) dei campioni.
+ * @return 0 se l'istogramma è vuoto.
+ */
+double latency_histogram_percentile(const LatencyHistogram *histogram, double percentile);
+
+/**
+ * @brief Calcola campioni, p50, p95, p99 e massimo.
+ */
+LatencyPercentiles latency_histogram_summary(const LatencyHistogram *histogram);
+
+#endif /* LATENCY_HISTOGRAM_H */
@@ -0,0 +1,102 @@
+/**
+ * @file live_statistics.h
+ * @brief Istantanea dello stato della mensa pubblicata a ogni minuto simulato.
+ *
+ * Il Master (thread dell'orologio, clock_ticker.c) è l'unico scrittore: a
+ * ogni cambio di minuto raccoglie senza lock code, porzioni, postazioni
+ * occupate, tavoli e clienti serviti e li copia in SHM sotto un seqlock.
+ * I lettori (mensa_top) agganciano la SHM in sola lettura e riprovano la
+ * copia se il contatore di sequenza cambia nel frattempo: non prendono
+ * lock e non possono rallentare né bloccare lo scrittore.
+ *
+ * Contatore dispari: scrittura in corso; 0: nessuna pubblicazione ancora.
+ */
+
+#ifndef LIVE_STATISTICS_H
+#define LIVE_STATISTICS_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "menu.h"
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/** Punti di servizio nell'istantanea (StationChannelIndex: Primi, Secondi, Caffè, Cassa) */
+#define LIVE_STATION_COUNT 4
+
+/** Finestra (minuti simulati) del throughput mobile */
+#define LIVE_THROUGHPUT_WINDOW_MINUTES 10
+
+/** Tentativi di lettura prima di rinunciare (scrittore in corso a ogni tentativo) */
+#define LIVE_STATISTICS_READ_RETRIES 1000
+
+/* ==========================================================================
+ *                        SEZIONE: TIPI E STRUTTURE
+ * ========================================================================== */
+
+/**
+ * @brief Stato di una stazione (o della cassa) al momento della pubblicazione.
+ */
+typedef struct {
+    int pending_orders;                 /**< Ordini in coda sul canale */
+    int busy_posts;                     /**< Postazioni occupate da un operatore */
+    int total_posts;                    /**< Postazioni assegnate alla stazione */
+    int dish_count;                     /**< Piatti con porzioni contate (0 per Caffè e Cassa) */
+    int portions[MAX_DISHES_PER_CATEGORY]; /**< Porzioni residue per piatto */
+} LiveStationView;
+
+/**
+ * @brief Contenuto dell'istantanea (copiato per intero dai lettori).
+ */
+typedef struct {
+    unsigned long long tick;            /**< Tick simulato della pubblicazione */
+    int day;                            /**< Giorno corrente (da 0) */
+    int minute;                         /**< Minuto simulato del giorno */
+    int total_users;                    /**< Utenti nella simulazione */
+
+    LiveStationView stations[LIVE_STATION_COUNT]; /**< Stazioni e cassa */
+
+    int tables_count;                   /**< Tavoli attivi */
+    int tables_in_use;                  /**< Tavoli con almeno un posto occupato */
+    int total_seats;                    /**< Posti a sedere totali */
+    int occupied_seats;                 /**< Posti a sedere occupati */
+    int waiting_groups;                 /**< Leader in attesa di un tavolo */
+
+    int clients_served_today;           /**< Clienti serviti oggi */
+    int clients_not_served_today;       /**< Clienti che hanno rinunciato oggi */
+    int clients_served_total;           /**< Clienti serviti dall'inizio della simulazione */
+    int clients_not_served_total;       /**< Rinunce dall'inizio della simulazione */
+    double throughput_per_minute;       /**< Clienti serviti al minuto nella finestra mobile */
+    int throughput_window_minutes;      /**< Ampiezza effettiva della finestra (minuti) */
+} LiveStatisticsData;
+
+/**
+ * @brief Istantanea in SHM protetta da seqlock.
+ */
+typedef struct {
+    _Atomic uint32_t sequence __attribute__((aligned(64))); /**< Pari: stabile; dispari: in scrittura */
+    LiveStatisticsData data;            /**< Ultima istantanea pubblicata */
+} __attribute__((aligned(64))) LiveStatistics;
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+struct MainSharedMemory;
+
+/**
+ * @brief Raccoglie lo stato corrente e lo pubblica. Riservata al Master (unico scrittore).
+ */
+void live_statistics_publish(struct MainSharedMemory *shared_memory_ptr);
+
+/**
+ * @brief Copia un'istantanea coerente (anche da SHM agganciata in sola lettura).
+ *
+ * @return 0 successo, -1 se nulla è stato ancora pubblicato o lo scrittore
+ *         era attivo in tutti i LIVE_STATISTICS_READ_RETRIES tentativi.
+ */
+int live_statistics_read(const LiveStatistics *live, LiveStatisticsData *out);
+
+#endif /* LIVE_STATISTICS_H */
@@ -0,0 +1,103 @@
+/**
+ * @file log.h
+ * @brief Log della simulazione con livelli a compile-time e filtro per ruolo a runtime.
+ *
+ * Due filtri in cascata:
+ * - compile-time: `make LOG_LEVEL=error|warn|info|debug` definisce
+ *   LOG_COMPILE_LEVEL; i messaggi più dettagliati sono in un ramo costante
+ *   falso e vengono eliminati dal compilatore insieme ai loro argomenti;
+ * - runtime: ogni processo ha un ruolo (log_set_role) e confronta il livello
+ *   del messaggio con quello configurato per il ruolo (LOG_LEVEL_* nel .conf,
+ *   letti dalla SHM). Il controllo è inline: un messaggio scartato costa una
+ *   lettura e un confronto, senza chiamate, senza valutare gli argomenti né
+ *   toccare stdout.
+ *
+ * I report statistici e l'output dei comandi di mensa_trace non sono log e
+ * restano su printf.
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+/* ==========================================================================
+ *                        SEZIONE: LIVELLI E RUOLI
+ * ========================================================================== */
+
+/** Livelli di log, dal più severo al più dettagliato */
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN  1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_DEBUG 3
+
+/** Livello massimo compilato (make LOG_LEVEL=...), default: tutto */
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+/**
+ * @brief Ruolo del processo, per il filtro a runtime.
+ */
+typedef enum {
+    LOG_ROLE_MASTER = 0,                /**< Responsabile Mensa */
+    LOG_ROLE_OPERATOR,                  /**< Operatori di stazione */
+    LOG_ROLE_CASHIER,                   /**< Operatori di cassa */
+    LOG_ROLE_USER,                      /**< Utenti (processi, host, event loop, zygote) */
+    LOG_ROLE_TOOL,                      /**< Utility esterne (add_users, communication_disorder, mensa_trace) */
+    LOG_ROLE_COUNT
+} LogRole;
+
+/**
+ * @brief Livello del ruolo corrente (voce di role_levels, di norma in SHM).
+ *
+ * Aggiornato da log_set_role() e log_bind_levels(); punta alla voce e non ne
+ * copia il valore, così segue i livelli collegati senza altre chiamate.
+ */
+extern const int *log_current_level;
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Imposta il ruolo del processo (default LOG_ROLE_TOOL).
+ */
+void log_set_role(LogRole role);
+
+/**
+ * @brief Collega i livelli per ruolo (di norma configuration.log_levels in SHM).
+ *
+ * Fino alla chiamata valgono i livelli di default (tutto abilitato).
+ */
+void log_bind_levels(const int *levels);
+
+/**
+ * @brief Converte un nome di livello (error, warn, info, debug) o una cifra.
+ *
+ * @return Il livello, o -1 se il nome non è valido.
+ */
+int log_level_from_name(const char *name);
+
+/**
+ * @brief true se il ruolo del processo ammette messaggi di livello `level`.
+ */
+static inline int log_is_enabled(int level) {
+    return level <= *log_current_level;
+}
+
+/**
+ * @brief Scrive un messaggio su stdout (già filtrato dai macro LOG_*).
+ */
+void log_write(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+/** Messaggio di livello `level`: eliminato a compile-time o filtrato per ruolo. */
+#define LOG_AT(level, ...)                                                      \
+    do {                                                                        \
+        if ((level) <= LOG_COMPILE_LEVEL && log_is_enabled(level)) log_write(__VA_ARGS__); \
+    } while (0)
+
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...)  LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#endif /* LOG_H */
@@ -25,6 +25,12 @@
 /** Messaggio per la gestione dinamica degli utenti (add_users -> Master) */
 #define MSG_TYPE_CONTROL 2
 
+/** Richiesta di spawn di gruppi utente (Master/add_users -> Zygote) */
+#define MSG_TYPE_ZYGOTE_SPAWN 3
+
+/** Gruppi trasportati al massimo da una singola richiesta allo zygote */
+#define ZYGOTE_BATCH_MAX_GROUPS 16
+
 /* ==========================================================================
  *                           SEZIONE: ENUMERAZIONI
  * ========================================================================== */
@@ -41,6 +47,20 @@ typedef enum {
  *                         SEZIONE: STRUTTURE PAYLOAD
  * ========================================================================== */
 
+/**
+ * @brief Intestazione di instradamento comune ai payload Stazione/Cassa.
+ *
+ * StationPayload e CashierPayload iniziano con gli stessi campi, così il
+ * canale di stazione può instradare la risposta senza conoscere il tipo.
+ */
+typedef struct {
+    pid_t user_pid;               /**< PID utente (mtype della risposta su coda System V) */
+    int reply_slot_index;         /**< Casella di risposta in SHM (backend ring) */
+    unsigned long long enqueue_tick; /**< Tick dell'invio dell'ordine (timbrato dal canale) */
+    unsigned long long dequeue_tick; /**< Tick del prelievo da parte dell'operatore (timbrato dal canale) */
+    unsigned long long reply_tick;   /**< Tick della risposta dell'operatore (timbrato dal canale) */
+} ChannelRoutingHeader;
+
 /**
  * @brief Payload per comunicazione Stazione <-> Utente.
  * 
@@ -48,6 +68,10 @@ typedef enum {
  */
 typedef struct {
     pid_t user_pid;               /**< PID utente (usato come mtype per risposta mirata) */
+    int reply_slot_index;         /**< Casella di risposta in SHM (backend ring) */
+    unsigned long long enqueue_tick; /**< Tick dell'invio (ChannelRoutingHeader) */
+    unsigned long long dequeue_tick; /**< Tick del prelievo (ChannelRoutingHeader) */
+    unsigned long long reply_tick;   /**< Tick della risposta (ChannelRoutingHeader) */
     int dish_index;               /**< Indice del piatto scelto nella categoria */
     int status;                   /**< Esito dell'ordine (OrderStatus) */
 } StationPayload;
@@ -61,6 +85,25 @@ typedef struct {
     int users_count;              /**< Numero di utenti da aggiungere alla simulazione */
 } ControlPayload;
 
+/**
+ * @brief Descrizione di un gruppo da generare tramite lo zygote.
+ */
+typedef struct {
+    int group_size;               /**< Numero di membri (il primo è il leader) */
+    int group_index;              /**< Indice del gruppo nel pool di sincronizzazione */
+    int is_late_joiner;           /**< 1 se il gruppo entra a simulazione in corso (add_users) */
+} ZygoteGroupRequest;
+
+/**
+ * @brief Payload per richieste di spawn allo zygote utenti.
+ *
+ * Inviato dal Master e da add_users tramite zygote_queue_id.
+ */
+typedef struct {
+    int group_count;              /**< Gruppi validi in groups[] */
+    ZygoteGroupRequest groups[ZYGOTE_BATCH_MAX_GROUPS]; /**< Gruppi da generare */
+} ZygoteSpawnPayload;
+
 /**
  * @brief Payload per il pagamento in Cassa.
  * 
@@ -68,6 +111,10 @@ typedef struct {
  */
 typedef struct {
     pid_t user_pid;               /**< PID utente (usato come mtype per lo scontrino) */
+    int reply_slot_index;         /**< Casella di risposta in SHM (backend ring) */
+    unsigned long long enqueue_tick; /**< Tick dell'invio (ChannelRoutingHeader) */
+    unsigned long long dequeue_tick; /**< Tick del prelievo (ChannelRoutingHeader) */
+    unsigned long long reply_tick;   /**< Tick della risposta (ChannelRoutingHeader) */
     bool had_first;               /**< true se ha consumato un primo piatto */
     bool had_second;              /**< true se ha consumato un secondo piatto */
     bool want_coffee;             /**< true se desidera caffè/dolce */
@@ -0,0 +1,85 @@
+/**
+ * @file mutex.h
+ * @brief Astrazione dei mutex globali della simulazione (MutexSemaphoreIndex).
+ *
+ * Le sezioni critiche della memoria condivisa sono protette da mutex
+ * identificati tramite MutexSemaphoreIndex. Il backend è selezionabile
+ * a tempo di compilazione:
+ * - Default: semafori System V binari con SEM_UNDO (set IPC_KEY_SEMAPHORE_MUTEX).
+ * - `make MUTEX_BACKEND=pthread` (USE_PTHREAD_MUTEX): pthread_mutex_t
+ *   process-shared e robusti residenti in SHM, senza syscall nel caso
+ *   non conteso. La morte del proprietario (EOWNERDEAD) viene recuperata
+ *   con pthread_mutex_consistent(), equivalente al ripristino di SEM_UNDO.
+ *
+ * MUTEX_ADD_USERS_PERMISSION non è un mutex ma un semaforo a conteggio
+ * (permessi rilasciati dal Master): resta sempre sul set System V e va
+ * gestito con reserve_sem/release_sem.
+ */
+
+#ifndef MUTEX_H
+#define MUTEX_H
+
+#include "common.h"
+
+/* ==========================================================================
+ *                    SEZIONE: INIZIALIZZAZIONE E RIMOZIONE
+ * ========================================================================== */
+
+/**
+ * @brief Inizializza i mutex binari del backend selezionato.
+ *
+ * Da invocare dal Master dopo la creazione del set semafori mutex.
+ * Con il backend System V imposta i semafori a 1, con il backend pthread
+ * inizializza i mutex in SHM con attributi PTHREAD_PROCESS_SHARED e
+ * PTHREAD_MUTEX_ROBUST.
+ *
+ * @param shared_memory_ptr Puntatore alla memoria condivisa.
+ * @return int 0 successo, -1 errore.
+ */
+int initialize_simulation_mutexes(MainSharedMemory *shared_memory_ptr);
+
+/**
+ * @brief Distrugge i mutex del backend pthread (no-op con System V).
+ * @param shared_memory_ptr Puntatore alla memoria condivisa.
+ */
+void destroy_simulation_mutexes(MainSharedMemory *shared_memory_ptr);
+
+/* ==========================================================================
+ *                       SEZIONE: ACQUISIZIONE E RILASCIO
+ * ========================================================================== */
+
+/**
+ * @brief Acquisisce il mutex indicato (bloccante).
+ *
+ * @param shared_memory_ptr Puntatore alla memoria condivisa.
+ * @param mutex_index Indice del mutex (escluso MUTEX_ADD_USERS_PERMISSION).
+ * @return int 0 successo, -1 errore critico.
+ */
+int lock_simulation_mutex(MainSharedMemory *shared_memory_ptr, MutexSemaphoreIndex mutex_index);
+
+/**
+ * @brief Rilascia il mutex indicato.
+ *
+ * @param shared_memory_ptr Puntatore alla memoria condivisa.
+ * @param mutex_index Indice del mutex (escluso MUTEX_ADD_USERS_PERMISSION).
+ * @return int 0 successo, -1 errore.
+ */
+int unlock_simulation_mutex(MainSharedMemory *shared_memory_ptr, MutexSemaphoreIndex mutex_index);
+
+/* ==========================================================================
+ *                         SEZIONE: LOCK PER DOMINIO
+ * ========================================================================== */
+
+/**
+ * @brief Lock a strisce che protegge lo stato del gruppo indicato.
+ * @param group_id Indice del gruppo in group_statuses[].
+ * @return MutexSemaphoreIndex Indice del mutex (MUTEX_GROUP_STRIPE_BASE + group_id % stripes).
+ */
+MutexSemaphoreIndex group_mutex_index(int group_id);
+
+/**
+ * @brief Lock della stazione indicata (0 Primi, 1 Secondi, 2 Caffè, 3 Cassa).
+ */
+MutexSemaphoreIndex station_mutex_index(int station_type);
+
+#endif /* MUTEX_H */
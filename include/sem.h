@@ -60,6 +60,18 @@ int create_sem_set(key_t key, int sem_num, int flags);
  */
 int init_sem_val(int sem_id, int sem_num, int init_val);
 
+/**
+ * @brief Inizializza in blocco tutti i semafori del set (semctl SETALL).
+ * 
+ * Sostituisce N chiamate a init_sem_val con una sola syscall; i valori
+ * vengono scritti atomicamente rispetto alle altre operazioni sul set.
+ * 
+ * @param sem_id ID del set di semafori.
+ * @param values Array con un valore per ogni semaforo del set (nsems elementi).
+ * @return int 0 successo, -1 errore.
+ */
+int init_sem_set_all(int sem_id, unsigned short *values);
+
 /**
  * @brief Rimuove definitivamente un set di semafori dal sistema.
  * 
@@ -137,6 +149,12 @@ int release_sem_no_undo(int sem_id, int semaphore_index);
  */
 int reserve_sem_try_no_undo(int sem_id, int semaphore_index);
 
+/**
+ * @brief Come reserve_sem_try_no_undo() ma con SEM_UNDO (risorse trattenute dal processo).
+ * @return int 0 successo, -1 con errno EAGAIN se la risorsa non è disponibile.
+ */
+int reserve_sem_try(int sem_id, int semaphore_index);
+
 /* ==========================================================================
  *                       SEZIONE: ATTESA E UTILITY
  * ========================================================================== */
@@ -168,11 +186,27 @@ int get_sem_val(int sem_id, int sem_num);
  */
 int reserve_sem_interruptible(int sem_id, int semaphore_index);
 
+/**
+ * @brief Come reserve_sem_interruptible() ma senza SEM_UNDO.
+ * Per semafori di segnalazione alimentati da V senza UNDO (es. canali di attesa tavoli).
+ */
+int reserve_sem_interruptible_no_undo(int sem_id, int semaphore_index);
+
 /**
  * @brief Attende lo zero ma non riprova su EINTR.
  */
 int wait_for_zero_interruptible(int sem_id, int semaphore_index);
 
+/**
+ * @brief Attende lo zero per al più `timeout_ns` nanosecondi (semtimedop).
+ *
+ * Non riprova su EINTR. Permette a chi attende una barriera di servire altri
+ * eventi tra un tentativo e l'altro.
+ *
+ * @return int 0 se il semaforo vale 0, -1 con errno EAGAIN allo scadere del timeout.
+ */
+int wait_for_zero_timed(int sem_id, int semaphore_index, long timeout_ns);
+
 /* ==========================================================================
  *                     SEZIONE: BARRIERE DI SINCRONIZZAZIONE
  * ========================================================================== */
@@ -215,4 +249,33 @@ int open_barrier_gate(int sem_id, int gate_idx);
  */
 int sync_child_start(int sem_id, int ready_idx, int gate_idx);
 
+/**
+ * @brief Come sync_child_start() per un processo che rappresenta `count` partecipanti.
+ *
+ * Decrementa il semaforo dei pronti di `count` (a blocchi entro SEMVMX) e attende il cancello.
+ *
+ * @param sem_id ID del set di semafori di avvio.
+ * @param ready_idx Indice del semaforo su cui segnalare la disponibilità.
+ * @param gate_idx Indice del semaforo cancello da attendere.
+ * @param count Numero di partecipanti rappresentati dal chiamante.
+ * @return int 0 successo, -1 errore.
+ */
+int sync_children_start(int sem_id, int ready_idx, int gate_idx, int count);
+
+/**
+ * @brief Come sync_child_start(), ma l'arrivo è registrato con SEM_UNDO.
+ *
+ * Per i partecipanti la cui morte viene compensata dal Master (utenti, host,
+ * operatori): se il processo termina prima che la barriera venga reimpostata,
+ * il kernel ne annulla gli arrivi e la compensazione del Master (una P per
+ * partecipante) resta esatta anche per chi era già arrivato. Il reset della
+ * barriera (SETVAL) azzera l'annullamento pendente in tutti i processi.
+ */
+int sync_child_start_undo(int sem_id, int ready_idx, int gate_idx);
+
+/**
+ * @brief Come sync_children_start(), con arrivi registrati con SEM_UNDO (vedi sync_child_start_undo()).
+ */
+int sync_children_start_undo(int sem_id, int ready_idx, int gate_idx, int count);
+
 #endif /* SEM_H */
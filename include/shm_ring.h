@@ -0,0 +1,158 @@
+/**
+ * @file shm_ring.h
+ * @brief Ring buffer MPMC limitato in memoria condivisa con park/wake su futex.
+ *
+ * Alternativa alle code di messaggi System V per il percorso ordine/risposta
+ * delle stazioni: gli slot risiedono in SHM, produttori e consumatori si
+ * coordinano con numeri di sequenza atomici (schema Vyukov) e si
+ * sospendono su futex condivisi solo quando la ring è vuota o piena.
+ * Nel caso non conteso un ordine non richiede alcuna syscall.
+ *
+ * Le risposte viaggiano su ReplySlot dedicati (uno per utente), anch'essi
+ * con attesa su futex.
+ *
+ * @see station_channel.h per la selezione del backend a tempo di compilazione.
+ */
+
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/** Numero di slot per ring (potenza di 2 per il mascheramento dell'indice) */
+#define ORDER_RING_CAPACITY 1024
+
+/** Dimensione massima in byte di un payload trasportato da ring e reply slot */
+#define RING_PAYLOAD_SIZE 40
+
+/* ==========================================================================
+ *                        SEZIONE: TIPI E STRUTTURE
+ * ========================================================================== */
+
+/**
+ * @brief Singolo slot della ring con numero di sequenza (schema Vyukov).
+ */
+typedef struct {
+    _Atomic unsigned long sequence;             /**< Turno dello slot (pos = libero, pos+1 = pieno) */
+    unsigned char payload[RING_PAYLOAD_SIZE];   /**< Copia del payload (StationPayload/CashierPayload) */
+} OrderRingSlot;
+
+/**
+ * @brief Ring MPMC limitata residente in SHM.
+ *
+ * Le posizioni di enqueue/dequeue sono su cache line separate per evitare
+ * false sharing tra produttori (utenti) e consumatori (operatori).
+ */
+typedef struct {
+    _Atomic unsigned long enqueue_position __attribute__((aligned(64))); /**< Prossima posizione da scrivere */
+    _Atomic unsigned long dequeue_position __attribute__((aligned(64))); /**< Prossima posizione da leggere */
+    _Atomic uint32_t items_futex __attribute__((aligned(64)));           /**< Futex: incrementato ad ogni enqueue */
+    _Atomic uint32_t space_futex;               /**< Futex: incrementato ad ogni dequeue */
+    _Atomic uint32_t waiting_consumers;         /**< Consumatori sospesi su items_futex */
+    _Atomic uint32_t waiting_producers;         /**< Produttori sospesi su space_futex */
+    OrderRingSlot slots[ORDER_RING_CAPACITY];   /**< Buffer circolare */
+} OrderRing;
+
+/**
+ * @brief Casella di risposta dedicata a un singolo utente.
+ */
+typedef struct {
+    _Atomic pid_t owner_pid;                    /**< PID proprietario (0 = libero) */
+    _Atomic uint32_t ready;                     /**< Futex: 0 = vuoto, 1 = risposta disponibile */
+    _Atomic uint32_t waiting;                   /**< Thread sospesi su ready (wake solo se > 0) */
+    unsigned char payload[RING_PAYLOAD_SIZE];   /**< Payload della risposta */
+} ReplySlot;
+
+/* ==========================================================================
+ *                          SEZIONE: ORDER RING
+ * ========================================================================== */
+
+/**
+ * @brief Inizializza i numeri di sequenza della ring (da invocare una volta dal Master).
+ * @param ring Ring da inizializzare (memoria già azzerata).
+ */
+void order_ring_init(OrderRing *ring);
+
+/**
+ * @brief Accoda un payload nella ring.
+ *
+ * Se la ring è piena il chiamante si sospende sul futex di spazio libero,
+ * salvo IPC_NOWAIT. L'attesa è interrompibile da segnali (nessun retry).
+ *
+ * @param ring Ring di destinazione.
+ * @param payload Dati da copiare.
+ * @param payload_size Dimensione (<= RING_PAYLOAD_SIZE).
+ * @param flags 0 oppure IPC_NOWAIT.
+ * @return int 0 successo, -1 errore (errno EINTR, EAGAIN o EINVAL).
+ */
+int order_ring_enqueue(OrderRing *ring, const void *payload, size_t payload_size, int flags);
+
+/**
+ * @brief Estrae il payload più vecchio dalla ring (FIFO).
+ *
+ * Se la ring è vuota il chiamante si sospende sul futex degli elementi,
+ * salvo IPC_NOWAIT. L'attesa è interrompibile da segnali (nessun retry).
+ *
+ * @param ring Ring sorgente.
+ * @param payload Buffer di destinazione.
+ * @param payload_size Dimensione (<= RING_PAYLOAD_SIZE).
+ * @param flags 0 oppure IPC_NOWAIT.
+ * @return ssize_t Byte copiati, o -1 (errno EINTR, ENOMSG o EINVAL).
+ */
+ssize_t order_ring_dequeue(OrderRing *ring, void *payload, size_t payload_size, int flags);
+
+/**
+ * @brief Numero di elementi attualmente accodati (lettura senza lock).
+ */
+int order_ring_length(OrderRing *ring);
+
+/* ==========================================================================
+ *                          SEZIONE: REPLY SLOT
+ * ========================================================================== */
+
+/**
+ * @brief Assegna una casella di risposta libera al processo indicato.
+ *
+ * La scansione parte da `owner_pid % slots_count`; vengono riutilizzate anche
+ * le caselle il cui proprietario non esiste più (kill(pid, 0) == ESRCH).
+ *
+ * @return int Indice della casella, o -1 se il pool è esaurito.
+ */
+int reply_slot_claim(ReplySlot *slots, int slots_count, pid_t owner_pid);
+
+/**
+ * @brief Restituisce la casella al pool (solo se posseduta da owner_pid).
+ */
+void reply_slot_release(ReplySlot *slot, pid_t owner_pid);
+
+/**
+ * @brief Svuota la casella prima di un nuovo ordine.
+ */
+void reply_slot_reset(ReplySlot *slot);
+
+/**
+ * @brief Deposita la risposta e risveglia il proprietario, se sospeso.
+ *
+ * Come per la ring, la futex_wake parte solo se waiting > 0: un utente che
+ * trova la risposta già pronta non costa una syscall all'operatore.
+ *
+ * @return int 0 successo, -1 errore (errno EINVAL).
+ */
+int reply_slot_post(ReplySlot *slot, const void *payload, size_t payload_size);
+
+/**
+ * @brief Attende la risposta nella propria casella.
+ *
+ * @param flags 0 (attesa interrompibile) oppure IPC_NOWAIT.
+ * @return ssize_t Byte copiati, o -1 (errno EINTR, ENOMSG o EINVAL).
+ */
+ssize_t reply_slot_wait(ReplySlot *slot, void *payload, size_t payload_size, int flags);
+
+#endif /* SHM_RING_H */
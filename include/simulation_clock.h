@@ -0,0 +1,91 @@
+/**
+ * @file simulation_clock.h
+ * @brief Orologio simulato condiviso: contatore di tick pubblicato dal Master in SHM.
+ *
+ * Il Master (clock_ticker.c) è l'unico scrittore: pubblica un contatore di tick
+ * monotono dall'avvio della simulazione, con ticks_per_minute tick per minuto
+ * simulato. I processi misurano attese e durate leggendo una sola parola in SHM
+ * e possono sospendersi fino a un tick assoluto senza timer propri.
+ *
+ * Il contatore risiede su una cache line dedicata, separata dai parametri di
+ * sola lettura, e ha una parola futex (32 bit bassi del tick) per chi attende.
+ */
+
+#ifndef SIMULATION_CLOCK_H
+#define SIMULATION_CLOCK_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/** Durata reale minima di un tick (limita i risvegli del ticker a scale veloci) */
+#define SIMULATION_CLOCK_MIN_TICK_NS 50000L
+
+/** Risoluzione massima: un tick per secondo simulato */
+#define SIMULATION_CLOCK_MAX_TICKS_PER_MINUTE 60
+
+/* ==========================================================================
+ *                        SEZIONE: TIPI E STRUTTURE
+ * ========================================================================== */
+
+/**
+ * @brief Orologio simulato residente in SHM.
+ */
+typedef struct {
+    _Atomic unsigned long long tick __attribute__((aligned(64))); /**< Tick dall'avvio (solo Master) */
+    _Atomic uint32_t tick_futex;        /**< Futex: 32 bit bassi di tick */
+    _Atomic uint32_t waiters;           /**< Processi sospesi su tick_futex */
+
+    long tick_ns __attribute__((aligned(64))); /**< Durata reale di un tick (sola lettura) */
+    int ticks_per_minute;               /**< Tick per minuto simulato (sola lettura) */
+} __attribute__((aligned(64))) SimulationClock;
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Inizializza l'orologio a tick 0 e ne calcola la risoluzione.
+ *
+ * Un tick vale un secondo simulato, ridotto fino a rispettare SIMULATION_CLOCK_MIN_TICK_NS.
+ *
+ * @param nanoseconds_per_minute Scala NNANOSECS della simulazione.
+ */
+void simulation_clock_init(SimulationClock *clock, long nanoseconds_per_minute);
+
+/**
+ * @brief Tick corrente (una lettura atomica).
+ */
+unsigned long long simulation_clock_now(const SimulationClock *clock);
+
+/**
+ * @brief Pubblica un nuovo tick e sveglia chi attende. Riservata al Master.
+ *
+ * Valori non successivi al tick corrente vengono ignorati (monotonia).
+ */
+void simulation_clock_publish(SimulationClock *clock, unsigned long long tick);
+
+/**
+ * @brief Attende che l'orologio raggiunga `target_tick`.
+ *
+ * Con CLOCK_MODE=virtual l'attesa è registrata sull'orologio virtuale.
+ *
+ * @return 0 al raggiungimento, -1 con errno EINTR se interrotta da un segnale
+ *         o ENOSPC (CLOCK_MODE=virtual) se gli slot di risveglio sono esauriti.
+ */
+int simulation_clock_wait_until(SimulationClock *clock, unsigned long long target_tick);
+
+/**
+ * @brief Minuti simulati trascorsi da `start_tick` al tick corrente.
+ */
+double simulation_clock_minutes_since(const SimulationClock *clock, unsigned long long start_tick);
+
+/**
+ * @brief Minuti simulati tra due tick (0 se `to` precede `from`).
+ */
+double simulation_clock_minutes_between(const SimulationClock *clock, unsigned long long from, unsigned long long to);
+
+#endif /* SIMULATION_CLOCK_H */
@@ -0,0 +1,136 @@
+/**
+ * @file station_channel.h
+ * @brief Canale ordine/risposta tra Utenti e Stazioni (Primi, Secondi, Caffè, Cassa).
+ *
+ * Interfaccia unica usata da utente, operatore, cassiere e Master per il
+ * percorso degli ordini. Il trasporto è selezionabile a tempo di compilazione:
+ * - Default: code di messaggi System V (queue.h). La coda ordini è FIFO pura;
+ *   le risposte viaggiano su STATION_REPLY_QUEUE_SHARDS code dedicate,
+ *   shard = PID % K, con mtype = PID utente.
+ * - `make QUEUE_BACKEND=ring` (USE_SHM_RINGS): ring MPMC in SHM con park/wake
+ *   su futex e caselle di risposta dedicate per utente (shm_ring.h).
+ *
+ * I payload (StationPayload, CashierPayload) iniziano con ChannelRoutingHeader:
+ * il chiamante compila user_pid e reply_slot_index, il canale li usa per
+ * instradare la risposta.
+ */
+
+#ifndef STATION_CHANNEL_H
+#define STATION_CHANNEL_H
+
+#include <sys/types.h>
+#include "common.h"
+
+/* ==========================================================================
+ *                           SEZIONE: ENUMERAZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Identificativo del canale di stazione.
+ * I valori coincidono con i codici stazione usati nelle statistiche di attesa.
+ */
+typedef enum {
+    STATION_CHANNEL_FIRST_COURSE = 0,   /**< Stazione Primi */
+    STATION_CHANNEL_SECOND_COURSE,      /**< Stazione Secondi */
+    STATION_CHANNEL_COFFEE_DESSERT,     /**< Stazione Caffè/Dolci */
+    STATION_CHANNEL_CASHIER,            /**< Cassa */
+    STATION_CHANNEL_COUNT               /**< Numero di canali */
+} StationChannelIndex;
+
+/* ==========================================================================
+ *                         SEZIONE: REGISTRAZIONE UTENTE
+ * ========================================================================== */
+
+/**
+ * @brief Registra l'utente sul canale (assegna la casella di risposta).
+ *
+ * @param shm_ptr Puntatore alla memoria condivisa.
+ * @param user_pid PID (identità) dell'utente.
+ * @return int Indice della casella di risposta (0 con backend System V), -1 se esaurite.
+ */
+int station_channel_attach_user(MainSharedMemory *shm_ptr, pid_t user_pid);
+
+/**
+ * @brief Rilascia la casella di risposta dell'utente (no-op con System V).
+ */
+void station_channel_detach_user(MainSharedMemory *shm_ptr, int reply_slot_index, pid_t user_pid);
+
+/* ==========================================================================
+ *                      SEZIONE: LATO UTENTE (ORDINE/RISPOSTA)
+ * ========================================================================== */
+
+/**
+ * @brief Invia un ordine alla stazione (interrompibile, nessun retry su EINTR).
+ *
+ * Timbra enqueue_tick nell'intestazione con l'orologio simulato.
+ *
+ * @param payload Payload con ChannelRoutingHeader compilato.
+ * @param payload_size sizeof(StationPayload) o sizeof(CashierPayload).
+ * @return int 0 successo, -1 errore.
+ */
+int station_channel_send_order(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                               void *payload, size_t payload_size);
+
+/**
+ * @brief Attende la risposta al proprio ordine (singola attesa interrompibile).
+ *
+ * @param payload In ingresso contiene l'intestazione di instradamento
+ *                dell'ordine, in uscita la risposta della stazione.
+ * @return ssize_t Byte ricevuti, o -1 (errno EINTR se interrotto da segnale).
+ */
+ssize_t station_channel_receive_reply(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                                      void *payload, size_t payload_size);
+
+/**
+ * @brief Variante non bloccante di station_channel_send_order().
+ * @return int 0 successo, -1 errore (errno EAGAIN se il canale è pieno).
+ */
+int station_channel_try_send_order(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                                   void *payload, size_t payload_size);
+
+/**
+ * @brief Variante non bloccante di station_channel_receive_reply().
+ * @return ssize_t Byte ricevuti, o -1 (errno EAGAIN se la risposta non è ancora arrivata).
+ */
+ssize_t station_channel_try_receive_reply(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                                          void *payload, size_t payload_size);
+
+/**
+ * @brief Numero di ordini in attesa sul canale (soglia di pazienza utenti).
+ * @return int Lunghezza della coda, -1 in caso di errore.
+ */
+int station_channel_pending_orders(MainSharedMemory *shm_ptr, StationChannelIndex channel);
+
+/* ==========================================================================
+ *                    SEZIONE: LATO STAZIONE (RICEZIONE/RISPOSTA)
+ * ========================================================================== */
+
+/**
+ * @brief Preleva il prossimo ordine in ordine FIFO (bloccante, interrompibile).
+ *
+ * Timbra dequeue_tick: dequeue_tick - enqueue_tick è l'attesa in coda.
+ * @return ssize_t Byte ricevuti, o -1 (errno EINTR se interrotto da segnale).
+ */
+ssize_t station_channel_receive_order(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                                      void *payload, size_t payload_size);
+
+/**
+ * @brief Recapita la risposta all'utente indicato nell'intestazione del payload.
+ *
+ * Timbra reply_tick: chi controlla la risposta in ritardo misura comunque l'attesa esatta.
+ * @return int 0 successo, -1 errore.
+ */
+int station_channel_send_reply(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                               void *payload, size_t payload_size);
+
+/* ==========================================================================
+ *                          SEZIONE: MANUTENZIONE
+ * ========================================================================== */
+
+/**
+ * @brief Svuota ordini e risposte orfane di tutti i canali (inizio giornata).
+ * @return int Numero di messaggi rimossi.
+ */
+int station_channel_flush_all(MainSharedMemory *shm_ptr);
+
+#endif /* STATION_CHANNEL_H */
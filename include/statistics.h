@@ -5,6 +5,9 @@
  * Questo modulo definisce le strutture dati per tracciare:
  * - Piatti serviti e avanzati (giornalieri e totali)
  * - Tempi di attesa medi per stazione
+ * - Distribuzioni (p50/p95/p99) delle attese a stazioni, cassa, ticket e tavoli
+ * - Durata di ogni fase del percorso utente e del percorso completo
+ * - Attesa in coda, tempo di servizio e utilizzo per stazione e per operatore
  * - Flussi clienti (serviti, non serviti, con/senza ticket)
  * - Performance operatori e incassi
  * 
@@ -14,6 +17,10 @@
 #ifndef STATISTICS_H
 #define STATISTICS_H
 
+#include <sys/types.h>
+#include <stdatomic.h>
+#include "latency_histogram.h"
+
 /** Forward declaration per evitare dipendenze circolari con common.h */
 struct MainSharedMemory;
 
@@ -31,6 +38,42 @@ typedef enum {
     TERMINATION_REASON_SIGNAL            /**< Terminazione manuale via segnale (es. SIGINT) */
 } TerminationReason;
 
+/**
+ * @brief Attese di cui si registra la distribuzione.
+ *
+ * I primi quattro coincidono con il parametro `type` di record_wait_time().
+ */
+typedef enum {
+    LATENCY_METRIC_FIRST_COURSE = 0,     /**< Ordine->risposta stazione Primi */
+    LATENCY_METRIC_SECOND_COURSE,        /**< Ordine->risposta stazione Secondi */
+    LATENCY_METRIC_COFFEE_DESSERT,       /**< Ordine->risposta stazione Caffè/Dolci */
+    LATENCY_METRIC_CASHIER,              /**< Pagamento->ricevuta alla Cassa */
+    LATENCY_METRIC_TICKET,               /**< Coda e validazione ticket */
+    LATENCY_METRIC_TABLE,                /**< Ricerca del tavolo (o attesa del leader) */
+    LATENCY_METRIC_COUNT
+} LatencyMetric;
+
+/**
+ * @brief Fasi del percorso giornaliero di un utente, più il percorso completo.
+ *
+ * Le fasi seguono l'ordine di esegui_percorso_mensa_giornaliero() (e di
+ * TracePhase in trace.h); JOURNEY_END_TO_END va dall'ingresso alla coda
+ * ticket all'uscita, solo per gli utenti serviti.
+ */
+typedef enum {
+    JOURNEY_TICKET = 0,                  /**< Validazione ticket */
+    JOURNEY_FIRST_COURSE,                /**< Stazione Primi */
+    JOURNEY_SECOND_COURSE,               /**< Stazione Secondi */
+    JOURNEY_REGROUP,                     /**< Riunione del gruppo prima della cassa */
+    JOURNEY_CASHIER,                     /**< Pagamento */
+    JOURNEY_TABLE,                       /**< Ricerca del tavolo */
+    JOURNEY_EAT,                         /**< Consumazione */
+    JOURNEY_COFFEE,                      /**< Stazione Caffè/Dolci */
+    JOURNEY_EXIT,                        /**< Attesa del gruppo all'uscita */
+    JOURNEY_END_TO_END,                  /**< Tempo totale in mensa */
+    JOURNEY_METRIC_COUNT
+} JourneyMetric;
+
 /* ==========================================================================
  *                         SEZIONE: STRUTTURE PIATTI
  * ========================================================================== */
@@ -87,6 +130,67 @@ typedef struct {
     double average_wait_global;         /**< Tempo medio globale (tutte le stazioni) */
 } StatisticsWaitTimes;
 
+/* ==========================================================================
+ *                  SEZIONE: STRUTTURE CODA E SERVIZIO OPERATORI
+ * ========================================================================== */
+
+/** Punti di servizio: tre stazioni e cassa (indici di StationChannelIndex e LatencyMetric) */
+#define SERVICE_POINT_COUNT (LATENCY_METRIC_CASHIER + 1)
+
+/** Slot per operatore/cassiere in SHM */
+#define MAX_OPERATOR_ACTIVITY 256
+
+/**
+ * @brief Tempi di un operatore, in minuti simulati.
+ *
+ * Ordine servito: attesa in coda = prelievo - invio, servizio = risposta -
+ * prelievo. Il tempo in postazione si divide in servizio (occupato) e
+ * attesa di ordini (inattivo); le pause e le attese del rifornimento
+ * (cancello di refill chiuso) sono escluse.
+ */
+typedef struct {
+    int orders;                         /**< Ordini prelevati e risposti */
+    double queue_minutes;               /**< Somma delle attese in coda degli ordini */
+    double service_minutes;             /**< Somma dei tempi di servizio (tempo occupato) */
+    double idle_minutes;                /**< Tempo in postazione in attesa di ordini */
+} ServiceTimingCounters;
+
+/**
+ * @brief Slot di un operatore o cassiere, scritto senza lock dal solo proprietario.
+ *
+ * Alla terminazione il proprietario rilascia lo slot ma i tempi restano nel
+ * report; quando lo slot viene riassegnato (rilasciato o con proprietario
+ * morto) i suoi tempi confluiscono nella base per stazione delle statistiche.
+ */
+typedef struct {
+    _Atomic pid_t owner_pid;            /**< PID proprietario attivo (0 = libero) */
+    pid_t operator_pid;                 /**< Ultimo proprietario, riportato anche dopo il rilascio (0 = mai usato) */
+    int service_point;                  /**< Stazione o cassa (StationChannelIndex) */
+    ServiceTimingCounters daily;        /**< Tempi del giorno corrente */
+    ServiceTimingCounters total;        /**< Tempi dell'intera simulazione */
+} __attribute__((aligned(64))) OperatorActivity;
+
+/**
+ * @brief Riepilogo dei tempi di una stazione o di un operatore.
+ */
+typedef struct {
+    int orders;                         /**< Ordini serviti */
+    double average_queue_delay;         /**< Attesa media in coda (Wq) */
+    double average_service_time;        /**< Tempo medio di servizio (S) */
+    double busy_minutes;                /**< Tempo occupato */
+    double idle_minutes;                /**< Tempo in attesa di ordini */
+    double utilisation;                 /**< busy / (busy + idle) */
+} ServiceTimingSummary;
+
+/**
+ * @brief Riepilogo complessivo di un singolo operatore.
+ */
+typedef struct {
+    pid_t operator_pid;                 /**< PID dell'operatore */
+    int service_point;                  /**< Stazione o cassa (StationChannelIndex) */
+    ServiceTimingSummary timing;        /**< Tempi dell'intera simulazione */
+} OperatorTimingSummary;
+
 /* ==========================================================================
  *                    SEZIONE: STRUTTURE CLIENTI E OPERATORI
  * ========================================================================== */
@@ -155,6 +259,24 @@ typedef struct {
     
     WaitTimeAccumulator daily_wait_accumulators;  /**< Accumulatori per il giorno corrente */
     WaitTimeAccumulator total_wait_accumulators;  /**< Accumulatori storici per l'intera simulazione */
+
+    LatencyHistogram daily_latency_histograms[LATENCY_METRIC_COUNT]; /**< Distribuzioni del giorno corrente */
+    LatencyHistogram total_latency_histograms[LATENCY_METRIC_COUNT]; /**< Distribuzioni dell'intera simulazione */
+    LatencyPercentiles daily_latency_percentiles[LATENCY_METRIC_COUNT]; /**< Percentili del giorno corrente */
+    LatencyPercentiles total_latency_percentiles[LATENCY_METRIC_COUNT]; /**< Percentili complessivi */
+
+    LatencyHistogram daily_journey_histograms[JOURNEY_METRIC_COUNT]; /**< Durate delle fasi del giorno corrente */
+    LatencyHistogram total_journey_histograms[JOURNEY_METRIC_COUNT]; /**< Durate delle fasi dell'intera simulazione */
+    LatencyPercentiles daily_journey_percentiles[JOURNEY_METRIC_COUNT]; /**< Riepilogo fasi del giorno corrente */
+    LatencyPercentiles total_journey_percentiles[JOURNEY_METRIC_COUNT]; /**< Riepilogo fasi complessivo */
+
+    ServiceTimingCounters daily_retired_service[SERVICE_POINT_COUNT]; /**< Tempi degli slot operatore riassegnati, oggi */
+    ServiceTimingCounters total_retired_service[SERVICE_POINT_COUNT]; /**< Tempi degli slot operatore riassegnati, totale */
+    ServiceTimingSummary daily_service_points[SERVICE_POINT_COUNT]; /**< Coda/servizio per stazione, oggi */
+    ServiceTimingSummary total_service_points[SERVICE_POINT_COUNT]; /**< Coda/servizio per stazione, totale */
+    double daily_open_minutes;          /**< Minuti simulati della giornata alla raccolta (tasso di arrivo) */
+    int operator_timings_count;         /**< Elementi validi in operator_timings */
+    OperatorTimingSummary operator_timings[MAX_OPERATOR_ACTIVITY]; /**< Tempi per operatore */
     
     StatisticsClientData clients_statistics;
     StatisticsOperatorData operators_statistics;
@@ -163,6 +285,62 @@ typedef struct {
     TerminationReason reason_for_termination; /**< Causa della fine della simulazione */
 } SimulationStatistics;
 
+/* ==========================================================================
+ *                    SEZIONE: SHARD CONTATORI PER PROCESSO
+ * ========================================================================== */
+
+/**
+ * @brief Contatori incrementati dai processi durante la giornata.
+ *
+ * Sottoinsieme "caldo" di SimulationStatistics: ogni processo scrive solo
+ * nel proprio shard, il Master li somma in collect_simulation_statistics().
+ */
+typedef struct {
+    StatisticsPlateCounts served_plates;  /**< Piatti serviti */
+    WaitTimeAccumulator wait_accumulators; /**< Accumulatori tempi di attesa */
+    int clients_served;                   /**< Clienti serviti */
+    int clients_not_served;               /**< Clienti che hanno rinunciato */
+    int clients_with_ticket;              /**< Clienti serviti con ticket */
+    int clients_without_ticket;           /**< Clienti serviti senza ticket */
+    int active_operators;                 /**< Attivazioni operatore/cassiere */
+    int breaks_taken;                     /**< Pause effettuate */
+    double income;                        /**< Incasso */
+} StatisticsCounters;
+
+/**
+ * @brief Shard di contatori di un singolo processo, allineato a cache line.
+ *
+ * Scritto senza lock dal solo proprietario. Quando il proprietario termina
+ * lo shard viene ripiegato nella base condivisa (sotto MUTEX_SIMULATION_STATS)
+ * e torna disponibile.
+ */
+typedef struct {
+    _Atomic pid_t owner_pid;              /**< PID proprietario (0 = libero) */
+    StatisticsCounters daily;             /**< Contatori del giorno corrente */
+    StatisticsCounters total;             /**< Contatori dell'intera simulazione */
+} __attribute__((aligned(64))) StatisticsShard;
+
+/* ==========================================================================
+ *                    SEZIONE: ISTOGRAMMI DELLE ATTESE IN SHM
+ * ========================================================================== */
+
+/** Numero di stripe di istogrammi in SHM (i thread scelgono per TID) */
+#define MAX_LATENCY_STRIPES 16
+
+/**
+ * @brief Istogrammi delle attese condivisi da un sottoinsieme di thread.
+ *
+ * Un istogramma per processo come gli shard occuperebbe troppa SHM: i thread
+ * si distribuiscono su poche stripe e incrementano i bucket con operazioni
+ * atomiche relaxed, senza lock. collect_simulation_statistics() le fonde.
+ */
+typedef struct {
+    LatencyHistogram daily[LATENCY_METRIC_COUNT]; /**< Attese del giorno corrente */
+    LatencyHistogram total[LATENCY_METRIC_COUNT]; /**< Attese dell'intera simulazione */
+    LatencyHistogram daily_journey[JOURNEY_METRIC_COUNT]; /**< Durate delle fasi del giorno corrente */
+    LatencyHistogram total_journey[JOURNEY_METRIC_COUNT]; /**< Durate delle fasi dell'intera simulazione */
+} __attribute__((aligned(64))) LatencyStripe;
+
 /* ==========================================================================
  *                         SEZIONE: FUNZIONI PUBBLICHE
  * ========================================================================== */
@@ -175,6 +353,68 @@ typedef struct {
  */
 SimulationStatistics collect_simulation_statistics(struct MainSharedMemory *shared_memory_ptr);
 
+/**
+ * @brief Azzera la parte giornaliera di base condivisa e di tutti gli shard.
+ *
+ * Da invocare dal Master a inizio giornata, con i processi fermi sulla barriera.
+ */
+void reset_daily_statistics_counters(struct MainSharedMemory *shared_memory_ptr);
+
+/**
+ * @brief Shard del processo chiamante (assegnato al primo utilizzo).
+ *
+ * Il puntatore è memorizzato in una variabile thread-local; in caso di
+ * pool esaurito si ritorna NULL e gli aggiornamenti ricadono sulla base
+ * condivisa protetta da MUTEX_SIMULATION_STATS.
+ */
+StatisticsShard *get_local_statistics_shard(struct MainSharedMemory *shared_memory_ptr);
+
+/** @brief Registra un piatto servito dalla stazione indicata (0 Primi, 1 Secondi, 2 Caffè). */
+void record_served_plate(struct MainSharedMemory *shared_memory_ptr, int station_type);
+
+/** @brief Registra un tempo di attesa (type: 0 Primi, 1 Secondi, 2 Caffè, 3 Cassa), media e distribuzione. */
+void record_wait_time(struct MainSharedMemory *shared_memory_ptr, double wait_minutes, int type);
+
+/** @brief Registra un'attesa nella distribuzione `metric` (lock-free, senza shard). */
+void record_latency(struct MainSharedMemory *shared_memory_ptr, LatencyMetric metric, double wait_minutes);
+
+/** @brief Registra la durata di una fase del percorso utente (o del percorso completo). */
+void record_journey_time(struct MainSharedMemory *shared_memory_ptr, JourneyMetric metric, double minutes);
+
+/**
+ * @brief Assegna uno slot OperatorActivity al processo chiamante.
+ *
+ * Preferisce gli slot mai usati; poi riassegna quelli rilasciati o con
+ * proprietario terminato (kill/ESRCH), come get_local_statistics_shard().
+ *
+ * @return Lo slot, o NULL se esauriti (i tempi dell'operatore non vengono registrati).
+ */
+OperatorActivity *claim_operator_activity(struct MainSharedMemory *shared_memory_ptr, int service_point);
+
+/** @brief Rilascia lo slot alla terminazione dell'operatore (i tempi restano nel report; NULL ignorato). */
+void release_operator_activity(OperatorActivity *activity);
+
+/** @brief Registra un ordine servito: attesa in coda e tempo di servizio (slot NULL ignorato). */
+void record_operator_service(OperatorActivity *activity, double queue_minutes, double service_minutes);
+
+/** @brief Registra tempo in postazione trascorso in attesa di ordini (slot NULL ignorato). */
+void record_operator_idle(OperatorActivity *activity, double idle_minutes);
+
+/** @brief Registra un cliente servito, con o senza ticket. */
+void record_client_served(struct MainSharedMemory *shared_memory_ptr, int has_ticket);
+
+/** @brief Registra un cliente che ha rinunciato al pasto. */
+void record_client_not_served(struct MainSharedMemory *shared_memory_ptr);
+
+/** @brief Registra la prima attivazione giornaliera di un operatore o cassiere. */
+void record_operator_active(struct MainSharedMemory *shared_memory_ptr);
+
+/** @brief Registra una pausa di operatore o cassiere. */
+void record_operator_break(struct MainSharedMemory *shared_memory_ptr);
+
+/** @brief Registra un incasso della cassa. */
+void record_income(struct MainSharedMemory *shared_memory_ptr, double amount);
+
 /**
  * @brief Visualizza a terminale un report dettagliato dei dati giornalieri.
  * 
@@ -190,17 +430,4 @@ void display_daily_statistics_report(SimulationStatistics statistics, int simula
  */
 void display_final_simulation_report(SimulationStatistics s, int total_days);
 
-/**
- * @brief Salva le statistiche giornaliere in un file CSV.
- * 
- * Se il file non esiste, viene creato con l'header. Se esiste, i dati vengono
- * appesi in coda.
- * 
- * @param statistics Struttura contenente i dati da salvare.
- * @param simulation_day Indice del giorno corrente (partendo da 0).
- * @param filepath Percorso del file CSV di destinazione.
- * @return int 0 se successo, -1 se errore.
- */
-int save_statistics_to_csv(SimulationStatistics statistics, int simulation_day, const char *filepath);
-
 #endif /* STATISTICS_H */
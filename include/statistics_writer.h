@@ -0,0 +1,93 @@
+/**
+ * @file statistics_writer.h
+ * @brief Esportazione su file delle statistiche giornaliere (CSV o JSON lines).
+ *
+ * Il Master apre il file una sola volta prima del ciclo dei giorni e lo
+ * chiude a simulazione terminata. Ogni record contiene tutti i campi di
+ * SimulationStatistics (esclusi gli istogrammi grezzi, riassunti dai
+ * percentili): il thread principale lo formatta in memoria e lo accoda a un
+ * thread di scrittura, che lo scrive e lo sincronizza su disco. La chiusura
+ * della giornata non attende mai l'I/O.
+ *
+ * Schema (STATISTICS_SCHEMA_VERSION):
+ * - ogni record inizia con schema_version, record ("day" o "final") e day (da 1);
+ * - i nomi dei campi sono costruiti dalla tabella in statistics_writer.c,
+ *   nello stesso ordine per CSV (intestazione) e JSON lines (chiavi);
+ * - i tempi per operatore (numero variabile) sono presenti solo in JSON
+ *   lines, come array "operators";
+ * - valori non finiti: campo vuoto in CSV, null in JSON.
+ *
+ * Il record "final" è scritto dopo la terminazione e copre anche l'ultimo
+ * giorno, che non passa dal report serale.
+ */
+
+#ifndef STATISTICS_WRITER_H
+#define STATISTICS_WRITER_H
+
+#include "config.h"
+#include "statistics.h"
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/** Versione dello schema: da incrementare a ogni cambio di campi o significato */
+#define STATISTICS_SCHEMA_VERSION 3
+
+/** File di destinazione (directory corrente, riscritti a ogni esecuzione) */
+#define STATISTICS_CSV_FILE_PATH "statistics_report.csv"
+#define STATISTICS_JSONL_FILE_PATH "statistics_report.jsonl"
+
+/* ==========================================================================
+ *                        SEZIONE: TIPI E STRUTTURE
+ * ========================================================================== */
+
+/**
+ * @brief Formato del file (STATISTICS_FORMAT nel .conf).
+ */
+typedef enum {
+    STATISTICS_FORMAT_CSV = 0,          /**< Intestazione + una riga per record */
+    STATISTICS_FORMAT_JSONL             /**< Un oggetto JSON per riga */
+} StatisticsFormat;
+
+/**
+ * @brief Tipo di record.
+ */
+typedef enum {
+    STATISTICS_RECORD_DAY = 0,          /**< Report serale di un giorno */
+    STATISTICS_RECORD_FINAL             /**< Report finale a simulazione terminata */
+} StatisticsRecordKind;
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Converte un nome di formato (csv, jsonl).
+ *
+ * @return Il formato, o -1 se il nome non è valido.
+ */
+int statistics_format_from_name(const char *name);
+
+/**
+ * @brief Apre (troncando) il file del formato configurato e avvia il thread di scrittura.
+ *
+ * @return 0 successo, -1 errore (la simulazione prosegue senza esportazione).
+ */
+int statistics_writer_open(const SimulationConfiguration *config);
+
+/**
+ * @brief Formatta un record e lo accoda al thread di scrittura (no-op se il file non è aperto).
+ *
+ * @param statistics Statistiche raccolte da collect_simulation_statistics().
+ * @param simulation_day Indice del giorno (partendo da 0).
+ * @param kind Giorno concluso o report finale.
+ */
+void statistics_writer_append(const SimulationStatistics *statistics, int simulation_day, StatisticsRecordKind kind);
+
+/**
+ * @brief Attende la scrittura dei record accodati, ferma il thread e chiude il file.
+ */
+void statistics_writer_close(void);
+
+#endif /* STATISTICS_WRITER_H */
@@ -0,0 +1,99 @@
+/**
+ * @file timeseries.h
+ * @brief Serie temporale intra-giornaliera su file mappato in memoria.
+ *
+ * Con TIMESERIES_INTERVAL=N (minuti simulati, 0 = disattivato) il Master
+ * apre TIMESERIES_FILE_PATH, lo prealloca per l'intera simulazione e lo
+ * mappa con MAP_SHARED. Ogni N minuti il thread dell'orologio copia
+ * l'istantanea live appena pubblicata (live_statistics.h) in un record a
+ * lunghezza fissa: un campione costa una memcpy, senza chiamate di sistema.
+ * Si campiona solo durante il pasto (minuti 0..SIM_PASTO_DURATION).
+ * Alla chiusura il file viene troncato ai record effettivamente scritti.
+ *
+ * `mensa_series <file> [csv]` converte il file in CSV.
+ */
+
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <stdint.h>
+#include "config.h"
+#include "menu.h"
+#include "live_statistics.h"
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/** File della serie temporale (directory corrente, come statistics_report.csv) */
+#define TIMESERIES_FILE_PATH "timeseries.bin"
+
+/** Identificativo iniziale del file */
+#define TIMESERIES_FILE_MAGIC "MNSSERIE"
+
+/** Versione del formato (intestazione + TimeSeriesRecord in sequenza) */
+#define TIMESERIES_FILE_VERSION 1
+
+/** Record di margine per giorno oltre SIM_PASTO_DURATION / TIMESERIES_INTERVAL + 1 */
+#define TIMESERIES_SLACK_RECORDS_PER_DAY 4
+
+/* ==========================================================================
+ *                        SEZIONE: TIPI E STRUTTURE
+ * ========================================================================== */
+
+/**
+ * @brief Intestazione del file, seguita da `capacity` record.
+ */
+typedef struct {
+    char magic[8];                      /**< TIMESERIES_FILE_MAGIC (senza terminatore) */
+    uint32_t version;                   /**< TIMESERIES_FILE_VERSION */
+    uint32_t record_size;               /**< sizeof(TimeSeriesRecord) */
+    uint32_t capacity;                  /**< Record preallocati */
+    uint32_t record_count;              /**< Record scritti (aggiornato a ogni campione) */
+    uint32_t interval_minutes;          /**< Passo di campionamento */
+    uint32_t dropped;                   /**< Campioni persi a file pieno */
+    uint32_t dish_counts[2];            /**< Piatti contati: Primi, Secondi */
+    char dish_names[2][MAX_DISHES_PER_CATEGORY][MAX_DISH_NAME_LENGTH]; /**< Nomi per le colonne CSV */
+} TimeSeriesHeader;
+
+/**
+ * @brief Un campione: stato al minuto `minute` del giorno `day`.
+ */
+typedef struct {
+    uint64_t tick;                      /**< Tick simulato del campione */
+    int32_t day;                        /**< Giorno (da 0) */
+    int32_t minute;                     /**< Minuto del giorno */
+    int32_t pending_orders[LIVE_STATION_COUNT]; /**< Ordini in coda per stazione e cassa */
+    int32_t busy_posts[LIVE_STATION_COUNT];     /**< Operatori/cassieri in postazione */
+    int32_t portions[2][MAX_DISHES_PER_CATEGORY]; /**< Porzioni residue: Primi, Secondi */
+    int32_t occupied_seats;             /**< Posti a sedere occupati */
+    int32_t tables_in_use;              /**< Tavoli con almeno un posto occupato */
+    int32_t waiting_groups;             /**< Leader in attesa di un tavolo */
+    int32_t total_users;                /**< Utenti nella simulazione */
+    int32_t clients_served_total;       /**< Clienti serviti dall'inizio (cumulativo) */
+    int32_t clients_not_served_total;   /**< Rinunce dall'inizio (cumulativo) */
+} TimeSeriesRecord;
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Crea, prealloca e mappa il file (no-op se TIMESERIES_INTERVAL è 0).
+ * @return 0 successo o serie disattivata, -1 errore (la simulazione prosegue senza serie).
+ */
+int timeseries_open(const char *path, const SimulationConfiguration *config, const SimulationMenu *menu);
+
+/**
+ * @brief Accoda un campione se è trascorso l'intervallo dall'ultimo.
+ *
+ * Da chiamare dal solo thread che pubblica l'istantanea live, subito dopo la pubblicazione.
+ */
+void timeseries_sample(const LiveStatisticsData *data);
+
+/**
+ * @brief Tronca il file ai record scritti e lo chiude. Da chiamare a orologio fermo.
+ */
+void timeseries_close(void);
+
+#endif /* TIMESERIES_H */
@@ -0,0 +1,157 @@
+/**
+ * @file trace.h
+ * @brief Tracciamento binario degli eventi della simulazione in ring per thread.
+ *
+ * Ogni thread (processo utente, thread di un host, operatore, Master) scrive
+ * eventi a dimensione fissa nella propria ring SPSC, all'interno di un
+ * segmento SHM dedicato creato dal Master. Il consumatore è `mensa_trace
+ * record`, che svuota periodicamente le ring su file; `mensa_trace decode`
+ * ricostruisce poi timeline per utente e riepiloghi per stazione.
+ *
+ * Il tracciamento si attiva e disattiva a runtime (trace_enabled in SHM).
+ * Spento, ogni punto di traccia costa una lettura atomica rilassata: la ring
+ * viene assegnata e il segmento collegato solo al primo evento registrato.
+ * Se la ring è piena l'evento viene scartato e conteggiato, senza attese.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/* Includes di sistema */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+
+/* Includes del progetto */
+#include "common.h"
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/**
+ * Ring oltre a quelle degli utenti (operatori, cassieri, Master, host, utility).
+ * Il segmento ne contiene user_capacity + TRACE_NON_USER_RINGS, come gli shard
+ * statistici: ogni utente vivo, processo o thread, ha la propria ring.
+ */
+#define TRACE_NON_USER_RINGS 256
+
+/** Eventi per ring (potenza di 2) */
+#define TRACE_RING_CAPACITY 1024
+
+/** Attesa minima su un mutex globale perché venga registrato un LOCK_WAIT */
+#define TRACE_LOCK_WAIT_MIN_NS 1000L
+
+/* ==========================================================================
+ *                        SEZIONE: TIPI E STRUTTURE
+ * ========================================================================== */
+
+/**
+ * @brief Tipo di evento.
+ */
+typedef enum {
+    TRACE_EVENT_PHASE_ENTER = 1,        /**< Utente entra in una fase (object: TracePhase) */
+    TRACE_EVENT_PHASE_EXIT,             /**< Utente esce dalla fase (object: TracePhase) */
+    TRACE_EVENT_ENQUEUE,                /**< Ordine inviato (actor: utente, object: canale) */
+    TRACE_EVENT_DEQUEUE,                /**< Ordine prelevato (actor: utente, object: canale, arg: operatore) */
+    TRACE_EVENT_LOCK_WAIT,              /**< Attesa su mutex globale (object: indice, arg: microsecondi) */
+    TRACE_EVENT_REFILL,                 /**< Refill stazione completato (object: stazione, arg: minuti) */
+    TRACE_EVENT_DAY_START,              /**< Apertura giornata (Master) */
+    TRACE_EVENT_DAY_END,                /**< Chiusura giornata (Master) */
+    TRACE_EVENT_TYPE_COUNT
+} TraceEventType;
+
+/**
+ * @brief Fasi del percorso utente (stesso ordine degli stati dell'event loop).
+ */
+typedef enum {
+    TRACE_PHASE_TICKET = 0,
+    TRACE_PHASE_FIRST_COURSE,
+    TRACE_PHASE_SECOND_COURSE,
+    TRACE_PHASE_REGROUP,
+    TRACE_PHASE_CASHIER,
+    TRACE_PHASE_TABLE,
+    TRACE_PHASE_EAT,
+    TRACE_PHASE_COFFEE,
+    TRACE_PHASE_EXIT,
+    TRACE_PHASE_COUNT
+} TracePhase;
+
+/**
+ * @brief Evento registrato (24 byte, formato anche del file di traccia).
+ */
+typedef struct {
+    uint64_t tick;                      /**< Tick dell'orologio simulato */
+    int32_t actor;                      /**< PID/TID dell'attore (utente per fasi e code) */
+    uint16_t type;                      /**< TraceEventType */
+    uint16_t object;                    /**< Fase, canale, stazione o mutex */
+    int32_t arg;                        /**< Argomento dipendente dal tipo */
+    uint32_t day;                       /**< Giorno della simulazione (da 0) */
+} TraceEvent;
+
+/**
+ * @brief Ring SPSC di un thread: scrive il proprietario, svuota mensa_trace.
+ *
+ * I contatori sono monotoni (indice = contatore % capacità) e non vengono
+ * mai azzerati, così una ring riassegnata non interferisce con il drain.
+ */
+typedef struct {
+    _Atomic pid_t owner_tid __attribute__((aligned(64))); /**< Proprietario (0: libera) */
+    _Atomic uint64_t head;              /**< Eventi scritti (solo proprietario) */
+    _Atomic uint64_t dropped;           /**< Eventi scartati a ring piena */
+    _Atomic uint64_t tail __attribute__((aligned(64)));   /**< Eventi letti (solo drain) */
+    TraceEvent events[TRACE_RING_CAPACITY] __attribute__((aligned(64)));
+} TraceRing;
+
+/**
+ * @brief Segmento SHM delle ring (IPC_KEY_SHARED_MEMORY_TRACE).
+ */
+typedef struct {
+    _Atomic uint64_t unassigned_drops;  /**< Eventi persi per ring esaurite */
+    int rings_count;                    /**< Ring nel segmento, fissato dal Master alla creazione */
+    TraceRing rings[];                  /**< rings_count elementi */
+} TraceSegment;
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Dimensione del segmento per `rings_count` ring.
+ */
+static inline size_t trace_segment_size(int rings_count) {
+    return sizeof(TraceSegment) + (size_t)rings_count * sizeof(TraceRing);
+}
+
+/**
+ * @brief true se il tracciamento è attivo (una lettura atomica rilassata).
+ */
+static inline bool trace_is_enabled(MainSharedMemory *shm_ptr) {
+    return atomic_load_explicit(&shm_ptr->trace_enabled, memory_order_relaxed) != 0;
+}
+
+/**
+ * @brief Registra un evento nella ring del thread chiamante.
+ *
+ * Al primo evento collega il segmento e assegna la ring (recuperando quelle
+ * di thread terminati già svuotate). Non si blocca mai.
+ */
+void trace_record(MainSharedMemory *shm_ptr, TraceEventType type, pid_t actor, int object, int arg);
+
+/** Registra un evento solo se il tracciamento è attivo. */
+#define TRACE_EVENT(shm_ptr, type, actor, object, arg)                          \
+    do {                                                                        \
+        if (trace_is_enabled(shm_ptr)) trace_record((shm_ptr), (type), (actor), (object), (arg)); \
+    } while (0)
+
+/**
+ * @brief Copia in `out` fino a `max_events` eventi non ancora letti della ring.
+ *
+ * Riservata al drain (un solo consumatore per segmento).
+ *
+ * @return Numero di eventi copiati.
+ */
+size_t trace_ring_drain(TraceRing *ring, TraceEvent *out, size_t max_events);
+
+#endif /* TRACE_H */
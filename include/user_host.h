@@ -0,0 +1,57 @@
+/**
+ * @file user_host.h
+ * @brief Host utenti: più utenti come thread di un unico processo (`USERS_PER_HOST`).
+ *
+ * Con USERS_PER_HOST > 0 il Master non crea un processo per utente ma impacchetta
+ * gruppi interi in processi host da al più USERS_PER_HOST utenti. Ogni host è un
+ * processo `utente` avviato con:
+ *
+ *     utente <shm_id> host <primo_gruppo> <dim_gruppo_0> <dim_gruppo_1> ...
+ *
+ * I gruppi di un host hanno indici consecutivi a partire da <primo_gruppo>; il
+ * primo membro di ogni gruppo è il leader. Ogni utente gira in un thread con il
+ * proprio StatoUtente e usa il TID come identità (vedi StatoUtente::user_pid).
+ *
+ * Gli host fanno parte del gruppo di processi GROUP_USERS: i segnali di fine
+ * giornata e di terminazione vengono ricevuti dal thread principale dell'host e
+ * inoltrati ai thread utente con USER_HOST_WAKE_SIGNAL.
+ *
+ * Con USER_HOST_EVENT_LOOP=1 l'host viene avviato in modalità USER_ENGINE_MODE_ARG
+ * (stessi argomenti): gli utenti non sono thread ma macchine a stati eseguite da
+ * un unico event loop, vedi user_engine.c. Con CLOCK_MODE=virtual l'opzione è
+ * ignorata (thread): i tentativi a ogni tick forzerebbero l'orologio virtuale ad
+ * avanzare di un tick alla volta.
+ *
+ * Ogni host si registra nel registry (user_registry.h) con i suoi gruppi e
+ * utenti prima di avviarli: alla morte anomala di un host il Master compensa
+ * le barriere per tutti gli utenti ospitati e azzera active_members dei gruppi.
+ */
+
+#ifndef USER_HOST_H
+#define USER_HOST_H
+
+/** Argomento di linea di comando che avvia `utente` in modalità host */
+#define USER_HOST_MODE_ARG "host"
+
+/** Argomento di linea di comando che avvia `utente` come event loop di utenti */
+#define USER_ENGINE_MODE_ARG "engine"
+
+/**
+ * Base delle identità virtuali degli utenti dell'event loop (oltre PID_MAX_LIMIT
+ * a 64 bit, quindi mai uguali a un PID reale): base + gruppo * MAX_USERS_PER_GROUP + membro.
+ */
+#define USER_ENGINE_IDENTITY_BASE (1 << 22)
+
+/** Stack dei thread utente: il percorso in mensa non ha ricorsione né buffer grandi */
+#define USER_HOST_THREAD_STACK_SIZE (256 * 1024)
+
+struct MainSharedMemory;
+
+/**
+ * @brief Registra il processo corrente come host dei gruppi indicati (MUTEX_USER_REGISTRY).
+ *
+ * Con registry pieno stampa un avviso: la morte dell'host verrà compensata come un solo processo.
+ */
+void register_user_host(struct MainSharedMemory *shm, int first_group, int group_count, int user_count);
+
+#endif /* USER_HOST_H */
@@ -0,0 +1,108 @@
+/**
+ * @file user_registry.h
+ * @brief Registry PID -> gruppo dei processi utente, con accesso O(1).
+ *
+ * Un processo utente occupa una voce con un gruppo e un utente; un host
+ * (USERS_PER_HOST) occupa una sola voce con i suoi gruppi consecutivi, interi,
+ * e il numero di utenti ancora attivi, così che il Master ne compensi la morte
+ * per tutti gli utenti ospitati.
+ *
+ * Gli slot occupati sono indicizzati da una tabella hash a indirizzamento
+ * aperto (linear probing, cancellazione con backward shift, nessuna lapide).
+ * Gli slot liberi sono gestiti da uno stack: gli slot mai usati si allocano
+ * avanzando `high_water_mark`, quelli rilasciati vengono riciclati dallo stack.
+ * Registrazione e rimozione non dipendono quindi da MAX_USERS_REGISTRY.
+ *
+ * Lo stato tutto-a-zero (SHM appena azzerata) è un registry vuoto valido.
+ *
+ * Le funzioni non acquisiscono lock: il chiamante deve detenere MUTEX_USER_REGISTRY.
+ */
+
+#ifndef USER_REGISTRY_H
+#define USER_REGISTRY_H
+
+#include <sys/types.h>
+#include <stdbool.h>
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/** Capacità massima del registry per il tracciamento dei processi utente */
+#define MAX_USERS_REGISTRY 4096
+
+/** Bucket della tabella hash (potenza di 2, fattore di carico massimo 0.5) */
+#define USER_REGISTRY_HASH_SIZE (2 * MAX_USERS_REGISTRY)
+
+_Static_assert((USER_REGISTRY_HASH_SIZE & (USER_REGISTRY_HASH_SIZE - 1)) == 0,
+               "USER_REGISTRY_HASH_SIZE deve essere una potenza di 2");
+
+/* ==========================================================================
+ *                        SEZIONE: TIPI E STRUTTURE
+ * ========================================================================== */
+
+/**
+ * @brief Informazioni di tracciamento per ogni processo utente o host.
+ * Usato dal Master per gestire la morte asincrona e le barriere di gruppo.
+ */
+typedef struct {
+    pid_t pid;                          /**< PID del processo (0: slot libero) */
+    int group_index;                    /**< Indice del (primo) gruppo di appartenenza */
+    int group_count;                    /**< Gruppi consecutivi del processo (1 per un utente) */
+    int user_count;                     /**< Utenti del processo attesi alle barriere (1 per un utente) */
+    bool is_host;                       /**< Host: i gruppi sono interamente nel processo */
+} UserProcessMetadata;
+
+/**
+ * @brief Registry dei processi utente in SHM.
+ */
+typedef struct {
+    UserProcessMetadata entries[MAX_USERS_REGISTRY]; /**< Slot dei processi registrati */
+    int pid_index[USER_REGISTRY_HASH_SIZE];  /**< Hash PID -> slot + 1 (0: bucket vuoto) */
+    int free_slots[MAX_USERS_REGISTRY];      /**< Stack degli slot rilasciati */
+    int free_top;                            /**< Elementi nello stack free_slots */
+    int high_water_mark;                     /**< Slot mai usati a partire da questo indice */
+} UserRegistry;
+
+/* ==========================================================================
+ *                        SEZIONE: FUNZIONI PUBBLICHE
+ * ========================================================================== */
+
+/**
+ * @brief Registra un processo utente.
+ *
+ * @param registry Registry in SHM.
+ * @param pid PID del processo.
+ * @param group_index Indice del gruppo di appartenenza.
+ * @return int Slot assegnato, -1 se il registry è pieno.
+ */
+int user_registry_insert(UserRegistry *registry, pid_t pid, int group_index);
+
+/**
+ * @brief Registra un host con i suoi gruppi interi.
+ *
+ * @param first_group Indice del primo gruppo ospitato.
+ * @param group_count Gruppi consecutivi ospitati.
+ * @param user_count Utenti ospitati.
+ * @return int Slot assegnato, -1 se il registry è pieno.
+ */
+int user_registry_insert_host(UserRegistry *registry, pid_t pid, int first_group, int group_count, int user_count);
+
+/**
+ * @brief Toglie un utente mai avviato dal conteggio di un host registrato.
+ *
+ * @return int Utenti rimasti all'host, -1 se il PID non è registrato.
+ */
+int user_registry_release_user(UserRegistry *registry, pid_t pid);
+
+/**
+ * @brief Rimuove un processo dal registry.
+ *
+ * @param registry Registry in SHM.
+ * @param pid PID del processo terminato.
+ * @param removed Destinazione della voce rimossa (gruppi e utenti da compensare).
+ * @return int 0 successo, -1 se il PID non è registrato.
+ */
+int user_registry_remove(UserRegistry *registry, pid_t pid, UserProcessMetadata *removed);
+
+#endif /* USER_REGISTRY_H */
@@ -0,0 +1,41 @@
+/**
+ * @file user_zygote.h
+ * @brief Lancio dei processi utente tramite zygote (`make USER_LAUNCHER=zygote`).
+ *
+ * Lo zygote è un processo `utente` avviato dal Master in modalità ZYGOTE_MODE_ARG:
+ * aggancia la SHM e installa i gestori di segnale una sola volta, poi riceve
+ * richieste di spawn a lotti su zygote_queue_id e genera ogni utente con una
+ * doppia fork, senza exec. Il nipote entra direttamente in run_utente_simulation
+ * e, essendo il Master un child subreaper, viene adottato dal Master: SIGCHLD
+ * e compensazione delle barriere restano invariati.
+ *
+ * Lo zygote è leader del gruppo di processi GROUP_USERS, per cui riceve anche
+ * i segnali di fine giornata e di terminazione diretti agli utenti.
+ */
+
+#ifndef USER_ZYGOTE_H
+#define USER_ZYGOTE_H
+
+#include "common.h"
+#include "queue.h"
+
+/** Argomento di linea di comando che avvia `utente` in modalità zygote */
+#define ZYGOTE_MODE_ARG "zygote"
+
+_Static_assert(sizeof(ZygoteSpawnPayload) <= MAX_MESSAGE_TEXT_SIZE,
+               "ZygoteSpawnPayload deve stare in un SimulationMessage");
+
+/**
+ * @brief Richiede allo zygote lo spawn di `count` gruppi.
+ *
+ * I gruppi vengono inviati in lotti da ZYGOTE_BATCH_MAX_GROUPS; lo stato dei
+ * gruppi in SHM (active_members) deve essere già impostato dal chiamante.
+ *
+ * @param shm Puntatore alla memoria condivisa.
+ * @param groups Gruppi da generare.
+ * @param count Numero di gruppi.
+ * @return int 0 in caso di successo, -1 se l'invio di un lotto fallisce.
+ */
+int user_zygote_request_groups(MainSharedMemory *shm, const ZygoteGroupRequest *groups, int count);
+
+#endif /* USER_ZYGOTE_H */
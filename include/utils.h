@@ -6,12 +6,15 @@
  * - Gestione errori critici
  * - Generazione numeri casuali
  * - Simulazione del passaggio del tempo
+ * - Avvio dei thread di servizio del Master
  */
 
 #ifndef UTILS_H
 #define UTILS_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
 
 /* ==========================================================================
  *                         SEZIONE: GESTIONE ERRORI
@@ -28,8 +31,55 @@ void display_critical_error(const char *error_message);
  *                       SEZIONE: GENERAZIONE CASUALE
  * ========================================================================== */
 
+/*
+ * Ogni thread estrae da un proprio flusso xoshiro256** (nessun lock, nessuno
+ * stato condiviso). Il flusso è determinato dal seme della simulazione
+ * (RANDOM_SEED) e dalla coppia ruolo/indice del chiamante: a parità di seme
+ * ogni processo riceve la stessa sequenza a ogni esecuzione.
+ */
+
+/**
+ * @brief Ruolo del processo o thread che possiede un flusso casuale.
+ */
+typedef enum {
+    RANDOM_STREAM_MASTER,           /**< Responsabile Mensa */
+    RANDOM_STREAM_OPERATOR,         /**< Operatore di stazione (indice: ordinale dell'operatore) */
+    RANDOM_STREAM_CASHIER,          /**< Operatore di cassa (indice: ordinale del cassiere) */
+    RANDOM_STREAM_USER,             /**< Utente iniziale (indice: gruppo e posizione nel gruppo) */
+    RANDOM_STREAM_LATE_USER,        /**< Utente aggiunto da add_users (indice: giorno, gruppo, posizione) */
+    RANDOM_STREAM_USER_ENGINE,      /**< Event loop utenti (indice: primo gruppo ospitato) */
+    RANDOM_STREAM_ADD_USERS         /**< Utility add_users (indice: giorno corrente) */
+} RandomStreamRole;
+
+/**
+ * @brief Inizializza il flusso casuale del thread chiamante.
+ *
+ * Un thread che estrae senza averlo inizializzato riceve un flusso non
+ * riproducibile derivato da orario e TID.
+ *
+ * @param master_seed Seme della simulazione (configuration.random_seed).
+ * @param role Ruolo del chiamante.
+ * @param index Indice stabile del chiamante all'interno del ruolo.
+ */
+void seed_random_stream(uint64_t master_seed, RandomStreamRole role, uint64_t index);
+
+/**
+ * @brief Estrae 64 bit uniformi dal flusso del thread chiamante.
+ */
+uint64_t generate_random_bits(void);
+
+/**
+ * @brief Riempie `values` con `count` interi uniformi in [min, max] (estrazione a blocchi).
+ *
+ * Equivale a `count` chiamate a generate_random_integer() ma mantiene lo
+ * stato del generatore nei registri per tutto il blocco.
+ */
+void generate_random_integers(int *values, int count, int minimum_value, int maximum_value);
+
 /**
  * @brief Genera un numero intero casuale all'interno di un intervallo.
+ *
+ * Estrazione senza bias di modulo (moltiplicazione a 64 bit con rigetto).
  * 
  * @param minimum_value Valore minimo (incluso).
  * @param maximum_value Valore massimo (incluso).
@@ -64,7 +114,8 @@ bool evaluate_probability_event(int success_percentage_rate);
 /**
  * @brief Simula il trascorrere del tempo in base ai parametri della simulazione.
  * 
- * Trasforma i minuti/unità della simulazione in nanosecondi reali utilizzando nanosleep.
+ * Trasforma i minuti/unità della simulazione in nanosecondi reali utilizzando nanosleep
+ * (con CLOCK_MODE=virtual attende invece l'avanzamento dell'orologio virtuale).
  * Gestisce automaticamente le interruzioni dovute ai segnali (EINTR).
  * 
  * @param simulated_minutes Minuti simulati da attendere.
@@ -81,4 +132,19 @@ void simulate_time_passage(int simulated_minutes, long nanoseconds_per_minute);
  */
 void simulate_seconds_passage(int simulated_seconds, long nanoseconds_per_minute);
 
+/* ==========================================================================
+ *                      SEZIONE: THREAD DI SERVIZIO
+ * ========================================================================== */
+
+/**
+ * @brief Avvia un thread di servizio con tutti i segnali bloccati.
+ *
+ * Il thread eredita la maschera piena, così i segnali del processo restano
+ * consegnati al thread principale; la maschera del chiamante è ripristinata
+ * subito dopo la creazione.
+ *
+ * @return int 0 successo, altrimenti il codice d'errore di pthread_create.
+ */
+int spawn_master_thread(pthread_t *thread, void *(*start_routine)(void *), void *arg);
+
 #endif /* UTILS_H */
@@ -0,0 +1,115 @@
+/**
+ * @file virtual_clock.h
+ * @brief Orologio virtuale condiviso per la modalità a eventi discreti (CLOCK_MODE=virtual).
+ *
+ * Con -DUSE_VIRTUAL_CLOCK le attese simulate non dormono in tempo reale: chi
+ * attende registra in SHM l'istante virtuale di risveglio e si sospende su un
+ * futex. Quando tutti i processi della simulazione sono bloccati il Master
+ * porta l'orologio al risveglio più vicino e sveglia i dormienti (vedi
+ * virtual_time.c), per cui la simulazione procede alla velocità della CPU
+ * rispettando l'ordine delle scadenze.
+ *
+ * Il tempo virtuale è espresso negli stessi nanosecondi "reali" della scala
+ * NNANOSECS, così le conversioni minuti/secondi simulati restano invariate.
+ */
+
+#ifndef VIRTUAL_CLOCK_H
+#define VIRTUAL_CLOCK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/**
+ * Slot di attesa oltre a quelli degli utenti (operatori, cassieri, thread del
+ * Master, utility): l'orologio ne ha user_capacity + VIRTUAL_CLOCK_NON_USER_SLEEPERS.
+ */
+#define VIRTUAL_CLOCK_NON_USER_SLEEPERS 256
+
+/** Valore di uno slot di attesa libero */
+#define VIRTUAL_CLOCK_NO_WAKEUP 0
+
+/* ==========================================================================
+ *                        SEZIONE: TIPI E STRUTTURE
+ * ========================================================================== */
+
+/**
+ * @brief Orologio virtuale residente in SHM.
+ *
+ * `epoch` è la parola futex su cui attendono i dormienti: viene incrementata
+ * dopo ogni avanzamento di `now_ns`. Ogni attesa occupa uno slot di risveglio;
+ * gli slot sono dimensionati sulla popolazione e risiedono nello stesso
+ * segmento, a `wakeups_offset` byte dall'orologio (virtual_clock_wakeups()).
+ */
+typedef struct {
+    _Atomic long long now_ns __attribute__((aligned(64)));  /**< Istante virtuale corrente */
+    _Atomic uint32_t epoch __attribute__((aligned(64)));    /**< Futex: incrementato a ogni avanzamento */
+    int sleepers_count;                 /**< Slot di risveglio disponibili */
+    ptrdiff_t wakeups_offset;           /**< Posizione degli slot rispetto all'orologio */
+} VirtualClock;
+
+/** Risvegli registrati (sleepers_count elementi, 0: slot libero). */
+static inline _Atomic long long *virtual_clock_wakeups(VirtualClock *clock) {
+    return (_Atomic long long *)((char *)clock + clock->wakeups_offset);
+}
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Collega all'orologio gli slot di risveglio (Master, memoria già azzerata).
+ *
+ * @param wakeups Slot nello stesso segmento SHM dell'orologio.
+ * @param sleepers_count Numero di slot.
+ */
+void virtual_clock_init(VirtualClock *clock, _Atomic long long *wakeups, int sleepers_count);
+
+/**
+ * @brief Associa il processo all'orologio virtuale in SHM.
+ *
+ * Dopo il bind le attese simulate e la lettura del tempo (utils.h) usano
+ * l'orologio virtuale. Chiamata da attach_to_simulation_shared_memory.
+ */
+void virtual_clock_bind(VirtualClock *clock);
+
+/**
+ * @brief Orologio virtuale associato al processo (NULL se non associato).
+ */
+VirtualClock *virtual_clock_bound(void);
+
+/**
+ * @brief Legge l'istante virtuale corrente come timespec.
+ */
+void virtual_clock_gettime(const VirtualClock *clock, struct timespec *now);
+
+/**
+ * @brief Attende che l'orologio virtuale avanzi di `duration_ns`.
+ *
+ * @param interruptible Se true ritorna -1 con errno EINTR all'arrivo di un
+ *                      segnale, altrimenti riprende l'attesa (come nanosleep in loop).
+ * @return 0 allo scadere, -1 su interruzione o slot esauriti (errno ENOSPC).
+ */
+int virtual_clock_sleep(VirtualClock *clock, long long duration_ns, bool interruptible);
+
+/**
+ * @brief Risveglio registrato più vicino successivo a now_ns.
+ *
+ * @return Istante virtuale del risveglio, -1 se nessuno è in attesa.
+ */
+long long virtual_clock_next_wakeup(VirtualClock *clock);
+
+/**
+ * @brief Porta l'orologio a `target_ns` e sveglia tutti i dormienti.
+ *
+ * Riservata al Master; un target non successivo a now_ns viene ignorato.
+ */
+void virtual_clock_advance(VirtualClock *clock, long long target_ns);
+
+#endif /* VIRTUAL_CLOCK_H */
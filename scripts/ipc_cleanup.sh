@@ -116,6 +116,11 @@ remove_queue 2100 "Coda secondi piatti"
 remove_queue 2200 "Coda caffè/dolci"
 remove_queue 2300 "Coda cassa"
 remove_queue 2400 "Coda controllo"
+for base in 2000 2100 2200 2300; do
+    for shard in 1 2 3 4; do
+        remove_queue $((base + shard)) "Risposte stazione ${base} (shard $((shard - 1)))"
+    done
+done
 
 echo ""
 echo "Rimozione MEMORIA CONDIVISA..."
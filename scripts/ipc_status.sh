@@ -143,6 +143,11 @@ show_queue 2100 "Ordini secondi piatti"
 show_queue 2200 "Ordini caffè/dolci"
 show_queue 2300 "Pagamenti cassa"
 show_queue 2400 "Controllo add_users"
+for base in 2000 2100 2200 2300; do
+    for shard in 1 2 3 4; do
+        show_queue $((base + shard)) "Risposte stazione ${base} (shard $((shard - 1)))"
+    done
+done
 
 echo ""
 echo "MEMORIA CONDIVISA"
@@ -17,7 +17,9 @@
 #include "common.h"
 #include "shm.h"
 #include "sem.h"
+#include "mutex.h"
 #include "queue.h"
+#include "log.h"
 
 /* ==========================================================================
  *                     SEZIONE: GESTIONE MEMORIA CONDIVISA
@@ -29,9 +31,90 @@ MainSharedMemory* attach_to_simulation_shared_memory(int shared_memory_id) {
         perror("[ERROR] Impossibile collegarsi alla memoria condivisa");
         exit(EXIT_FAILURE);
     }
+#ifdef USE_VIRTUAL_CLOCK
+    virtual_clock_bind(&shm_ptr->virtual_clock);
+#endif
+    log_bind_levels(shm_ptr->configuration.log_levels);
     return shm_ptr;
 }
 
+/* ==========================================================================
+ *                     SEZIONE: INVENTARIO PORZIONI (LOCK-FREE)
+ * ========================================================================== */
+
+bool take_station_portion(FoodDistributionStation *station, int dish_index) {
+    int current = atomic_load(&station->portions[dish_index]);
+
+    /* Su fallimento della CAS `current` viene ricaricato col valore aggiornato */
+    while (current > 0) {
+        if (atomic_compare_exchange_weak(&station->portions[dish_index], &current, current - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int get_station_portions(FoodDistributionStation *station, int dish_index) {
+    return atomic_load(&station->portions[dish_index]);
+}
+
+void refill_station_portions(FoodDistributionStation *station, int dish_index, int amount, int maximum) {
+    int current = atomic_load(&station->portions[dish_index]);
+    int updated;
+
+    do {
+        updated = current + amount;
+        if (updated > maximum) updated = maximum;
+    } while (!atomic_compare_exchange_weak(&station->portions[dish_index], &current, updated));
+}
+
+void set_station_portions(FoodDistributionStation *station, int dish_index, int amount) {
+    atomic_store(&station->portions[dish_index], amount);
+}
+
+/* ==========================================================================
+ *                   SEZIONE: COMPENSAZIONE UTENTI PERSI
+ * ========================================================================== */
+
+void compensate_lost_barrier_arrivals(MainSharedMemory *shm, int count) {
+    for (int i = 0; i < count; i++) {
+        reserve_sem_try_no_undo(shm->semaphore_sync_id, BARRIER_STARTUP_READY);
+        reserve_sem_try_no_undo(shm->semaphore_sync_id, BARRIER_MORNING_READY);
+        reserve_sem_try_no_undo(shm->semaphore_sync_id, BARRIER_EVENING_READY);
+    }
+}
+
+void withdraw_lost_users(MainSharedMemory *shm, int count) {
+    compensate_lost_barrier_arrivals(shm, count);
+    if (!shm->is_simulation_running) return;
+
+    lock_simulation_mutex(shm, MUTEX_SHARED_DATA);
+    shm->current_total_users -= count;
+    if (shm->current_total_users < 0) shm->current_total_users = 0;
+    unlock_simulation_mutex(shm, MUTEX_SHARED_DATA);
+}
+
+int withdraw_lost_group_members(MainSharedMemory *shm, int group_index, int members, pid_t member_pid) {
+    GroupStatus *group = &shm->group_statuses[group_index];
+    MutexSemaphoreIndex group_lock = group_mutex_index(group_index);
+
+    lock_simulation_mutex(shm, group_lock);
+    int removed = (members < 0 || members > group->active_members) ? group->active_members : members;
+    group->active_members -= removed;
+    if (members < 0 || (member_pid != 0 && group->group_leader_pid == member_pid)) {
+        group->group_leader_pid = 0;
+    }
+    unlock_simulation_mutex(shm, group_lock);
+
+    /* I compagni rimasti non attendono più i membri persi */
+    int base = group_index * GROUP_SEMS_PER_ENTRY;
+    for (int i = 0; i < removed; i++) {
+        reserve_sem_try_no_undo(shm->group_sync_semaphore_id, base + GROUP_SEM_PRE_CASHIER);
+        reserve_sem_try_no_undo(shm->group_sync_semaphore_id, base + GROUP_SEM_EXIT);
+    }
+    return removed;
+}
+
 /* ==========================================================================
  *                       SEZIONE: CLEANUP E TERMINAZIONE
  * ========================================================================== */
@@ -49,6 +132,13 @@ void cleanup_ipc_resources(MainSharedMemory *shared_memory_ptr) {
     remove_message_queue(shared_memory_ptr->coffee_dessert_station.message_queue_id);
     remove_message_queue(shared_memory_ptr->register_station.message_queue_id);
     remove_message_queue(shared_memory_ptr->control_queue_id);
+    remove_message_queue(shared_memory_ptr->zygote_queue_id);
+    for (int k = 0; k < STATION_REPLY_QUEUE_SHARDS; k++) {
+        remove_message_queue(shared_memory_ptr->first_course_station.reply_queue_ids[k]);
+        remove_message_queue(shared_memory_ptr->second_course_station.reply_queue_ids[k]);
+        remove_message_queue(shared_memory_ptr->coffee_dessert_station.reply_queue_ids[k]);
+        remove_message_queue(shared_memory_ptr->register_station.reply_queue_ids[k]);
+    }
 
     /* 2. Set semafori stazioni */
     delete_sem_set(shared_memory_ptr->first_course_station.semaphore_set_id);
@@ -59,11 +149,17 @@ void cleanup_ipc_resources(MainSharedMemory *shared_memory_ptr) {
     /* 3. Risorse globali (barriere, mutex, ticket, posti) */
     delete_sem_set(shared_memory_ptr->semaphore_sync_id);
     delete_sem_set(shared_memory_ptr->semaphore_mutex_id);
+    destroy_simulation_mutexes(shared_memory_ptr);
     delete_sem_set(shared_memory_ptr->semaphore_ticket_id);
     delete_sem_set(shared_memory_ptr->seat_area.condition_semaphore_id);
     delete_sem_set(shared_memory_ptr->group_sync_semaphore_id);
 
-    /* 4. Memoria condivisa (detach prima, remove dopo) */
+    /* 4. Segmento di traccia (chi è ancora collegato, es. mensa_trace, completa il drain) */
+    if (shared_memory_ptr->trace_shared_memory_id != -1) {
+        remove_shared_memory_segment(shared_memory_ptr->trace_shared_memory_id);
+    }
+
+    /* 5. Memoria condivisa (detach prima, remove dopo) */
     int shmid = shared_memory_ptr->shared_memory_id;
     detach_shared_memory_segment(shared_memory_ptr);
     remove_shared_memory_segment(shmid);
@@ -75,7 +171,7 @@ void cleanup_ipc_resources(MainSharedMemory *shared_memory_ptr) {
  */
 void terminate_simulation_gracefully(MainSharedMemory *shared_memory_ptr, int exit_code) {
     (void)exit_code;
-    printf("\n[SYSTEM] Terminazione simulazione in corso...\n");
+    LOG_INFO("\n[SYSTEM] Terminazione simulazione in corso...\n");
 
     /* Invia SIGTERM a tutti i gruppi di processi per sbloccare eventuali figli in attesa */
     for (int i = 0; i < MAX_PROCESS_GROUPS; i++) {
@@ -0,0 +1,114 @@
+/**
+ * @file dining_area.c
+ * @brief Implementazione dell'indice dei posti liberi dell'area refezione.
+ *
+ * @see dining_area.h per la documentazione delle funzioni pubbliche.
+ */
+
+/* Includes di sistema */
+#include <string.h>
+
+/* Includes del progetto */
+#include "dining_area.h"
+#include "sem.h"
+
+/* ==========================================================================
+ *                          SEZIONE: FUNZIONI PRIVATE
+ * ========================================================================== */
+
+/** Bucket di appartenenza di un tavolo (posti liberi, saturato a TABLE_MAX_CAPACITY). */
+static int table_bucket(const Table *table) {
+    int free_seats = table->capacity - table->occupied_seats;
+    if (free_seats < 0) return 0;
+    return (free_seats > TABLE_MAX_CAPACITY) ? TABLE_MAX_CAPACITY : free_seats;
+}
+
+static void bucket_insert(TableFreeBucket *bucket, int table_id) {
+    int w = table_id / 64;
+    bucket->words[w] |= (1ULL << (table_id % 64));
+    bucket->summary |= (1ULL << w);
+}
+
+static void bucket_remove(TableFreeBucket *bucket, int table_id) {
+    int w = table_id / 64;
+    bucket->words[w] &= ~(1ULL << (table_id % 64));
+    if (bucket->words[w] == 0) {
+        bucket->summary &= ~(1ULL << w);
+    }
+}
+
+/** Tavolo di indice minimo nel bucket, -1 se vuoto. */
+static int bucket_first(const TableFreeBucket *bucket) {
+    if (bucket->summary == 0) return -1;
+    int w = __builtin_ctzll(bucket->summary);
+    return w * 64 + __builtin_ctzll(bucket->words[w]);
+}
+
+/** Esiste almeno un tavolo con `seats` o più posti liberi. */
+static int seats_available(const DiningArea *area, int seats) {
+    for (int b = seats; b <= TABLE_MAX_CAPACITY; b++) {
+        if (area->free_buckets[b].summary != 0) return 1;
+    }
+    return 0;
+}
+
+/* ==========================================================================
+ *                        SEZIONE: FUNZIONI PUBBLICHE
+ * ========================================================================== */
+
+void dining_area_reset(DiningArea *area) {
+    unsigned short channel_values[DINING_WAIT_CHANNELS] = {0};
+
+    memset(area->free_buckets, 0, sizeof(area->free_buckets));
+    memset(area->waiting_leaders, 0, sizeof(area->waiting_leaders));
+
+    for (int i = 0; i < area->active_tables_count; i++) {
+        area->tables[i].occupied_seats = 0;
+        bucket_insert(&area->free_buckets[table_bucket(&area->tables[i])], i);
+    }
+
+    /* Segnalazioni residue del giorno precedente non più valide */
+    init_sem_set_all(area->condition_semaphore_id, channel_values);
+}
+
+int dining_area_reserve(DiningArea *area, int seats) {
+    if (seats <= 0 || seats > TABLE_MAX_CAPACITY) return -1;
+
+    /* Best fit: il bucket più piccolo sufficiente lascia liberi i tavoli grandi */
+    for (int b = seats; b <= TABLE_MAX_CAPACITY; b++) {
+        int table_id = bucket_first(&area->free_buckets[b]);
+        if (table_id != -1) {
+            Table *table = &area->tables[table_id];
+            bucket_remove(&area->free_buckets[b], table_id);
+            table->occupied_seats += seats;
+            bucket_insert(&area->free_buckets[table_bucket(table)], table_id);
+            return table_id;
+        }
+    }
+    return -1;
+}
+
+void dining_area_release(DiningArea *area, int table_id, int seats) {
+    if (table_id < 0 || table_id >= area->active_tables_count) return;
+
+    Table *table = &area->tables[table_id];
+    bucket_remove(&area->free_buckets[table_bucket(table)], table_id);
+    table->occupied_seats -= seats;
+    if (table->occupied_seats < 0) table->occupied_seats = 0;
+    bucket_insert(&area->free_buckets[table_bucket(table)], table_id);
+}
+
+int dining_area_register_waiter(DiningArea *area, int seats) {
+    int channel = (seats >= 1 && seats <= TABLE_MAX_CAPACITY) ? seats : 0;
+    area->waiting_leaders[channel]++;
+    return channel;
+}
+
+void dining_area_wake_fitting_waiters(DiningArea *area) {
+    for (int s = 1; s <= TABLE_MAX_CAPACITY; s++) {
+        if (area->waiting_leaders[s] > 0 && seats_available(area, s)) {
+            area->waiting_leaders[s]--;
+            release_sem_no_undo(area->condition_semaphore_id, s);
+        }
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file user_registry.c
+ * @brief Implementazione del registry PID -> gruppo dei processi utente.
+ *
+ * @see user_registry.h per la documentazione delle funzioni pubbliche.
+ */
+
+/* Includes di sistema */
+#include <stdint.h>
+
+/* Includes del progetto */
+#include "user_registry.h"
+
+#define HASH_MASK (USER_REGISTRY_HASH_SIZE - 1)
+
+/* ==========================================================================
+ *                          SEZIONE: FUNZIONI PRIVATE
+ * ========================================================================== */
+
+/** Bucket iniziale di un PID (hash moltiplicativo di Fibonacci). */
+static int pid_home(pid_t pid) {
+    return (int)(((uint32_t)pid * 2654435761u) & HASH_MASK);
+}
+
+/** Bucket che contiene il PID, -1 se assente. */
+static int find_bucket(const UserRegistry *registry, pid_t pid) {
+    int b = pid_home(pid);
+    while (registry->pid_index[b] != 0) {
+        if (registry->entries[registry->pid_index[b] - 1].pid == pid) return b;
+        b = (b + 1) & HASH_MASK;
+    }
+    return -1;
+}
+
+/** Svuota il bucket compattando la catena di probing successiva (backward shift). */
+static void erase_bucket(UserRegistry *registry, int hole) {
+    int b = hole;
+    for (;;) {
+        b = (b + 1) & HASH_MASK;
+        if (registry->pid_index[b] == 0) break;
+
+        int home = pid_home(registry->entries[registry->pid_index[b] - 1].pid);
+        /* L'elemento può riempire il buco se la sua home non cade in (hole, b] */
+        int home_in_range = (hole <= b) ? (home > hole && home <= b)
+                                        : (home > hole || home <= b);
+        if (!home_in_range) {
+            registry->pid_index[hole] = registry->pid_index[b];
+            hole = b;
+        }
+    }
+    registry->pid_index[hole] = 0;
+}
+
+/* ==========================================================================
+ *                        SEZIONE: FUNZIONI PUBBLICHE
+ * ========================================================================== */
+
+int user_registry_insert(UserRegistry *registry, pid_t pid, int group_index) {
+    int slot = user_registry_insert_host(registry, pid, group_index, 1, 1);
+    if (slot != -1) registry->entries[slot].is_host = false;
+    return slot;
+}
+
+int user_registry_insert_host(UserRegistry *registry, pid_t pid, int first_group, int group_count, int user_count) {
+    if (pid <= 0) return -1;
+
+    int slot;
+    if (registry->free_top > 0) {
+        slot = registry->free_slots[--registry->free_top];
+    } else if (registry->high_water_mark < MAX_USERS_REGISTRY) {
+        slot = registry->high_water_mark++;
+    } else {
+        return -1;
+    }
+
+    registry->entries[slot].pid = pid;
+    registry->entries[slot].group_index = first_group;
+    registry->entries[slot].group_count = group_count;
+    registry->entries[slot].user_count = user_count;
+    registry->entries[slot].is_host = true;
+
+    int b = pid_home(pid);
+    while (registry->pid_index[b] != 0) {
+        b = (b + 1) & HASH_MASK;
+    }
+    registry->pid_index[b] = slot + 1;
+    return slot;
+}
+
+int user_registry_release_user(UserRegistry *registry, pid_t pid) {
+    if (pid <= 0) return -1;
+
+    int b = find_bucket(registry, pid);
+    if (b == -1) return -1;
+
+    UserProcessMetadata *entry = &registry->entries[registry->pid_index[b] - 1];
+    if (entry->user_count > 0) entry->user_count--;
+    return entry->user_count;
+}
+
+int user_registry_remove(UserRegistry *registry, pid_t pid, UserProcessMetadata *removed) {
+    if (pid <= 0) return -1;
+
+    int b = find_bucket(registry, pid);
+    if (b == -1) return -1;
+
+    int slot = registry->pid_index[b] - 1;
+    *removed = registry->entries[slot];
+
+    erase_bucket(registry, b);
+    registry->entries[slot].pid = 0;
+    registry->free_slots[registry->free_top++] = slot;
+    return 0;
+}
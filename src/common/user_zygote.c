@@ -0,0 +1,37 @@
+/**
+ * @file user_zygote.c
+ * @brief Lato client delle richieste di spawn allo zygote utenti.
+ *
+ * @see user_zygote.h per la documentazione delle funzioni pubbliche.
+ * @see programs/utente/zygote.c per il ciclo dello zygote.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <string.h>
+
+/* Includes del progetto */
+#include "user_zygote.h"
+
+/* ==========================================================================
+ *                        SEZIONE: FUNZIONI PUBBLICHE
+ * ========================================================================== */
+
+int user_zygote_request_groups(MainSharedMemory *shm, const ZygoteGroupRequest *groups, int count) {
+    for (int first = 0; first < count; first += ZYGOTE_BATCH_MAX_GROUPS) {
+        int batch = count - first;
+        if (batch > ZYGOTE_BATCH_MAX_GROUPS) batch = ZYGOTE_BATCH_MAX_GROUPS;
+
+        SimulationMessage msg;
+        msg.message_type = MSG_TYPE_ZYGOTE_SPAWN;
+        ZygoteSpawnPayload *payload = (ZygoteSpawnPayload *)msg.message_text;
+        payload->group_count = batch;
+        memcpy(payload->groups, &groups[first], (size_t)batch * sizeof(ZygoteGroupRequest));
+
+        if (send_message_to_queue(shm->zygote_queue_id, &msg, sizeof(ZygoteSpawnPayload), 0) == -1) {
+            fprintf(stderr, "[ERROR] Invio richiesta di spawn allo zygote fallito.\n");
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -15,6 +15,8 @@
 
 /* Includes del progetto */
 #include "config.h"
+#include "log.h"
+#include "statistics_writer.h"
 
 /* ==========================================================================
  *                          SEZIONE: COSTANTI LOCALI
@@ -42,6 +44,8 @@ typedef enum {
     KEY_NUMBER_OF_NEW_USERS_BATCH, 
     KEY_NUMBER_OF_PAUSE, 
     KEY_MAXIMUM_USERS_PER_GROUP,
+    KEY_USERS_PER_HOST,
+    KEY_USER_HOST_EVENT_LOOP,
     
     /* Seats */
     KEY_SEATS_PRIMI, 
@@ -66,6 +70,8 @@ typedef enum {
     KEY_AVERAGE_SERVICE_TICKET,
     KEY_AVERAGE_REFILL_TIME, 
     KEY_STOP_DURATION,
+    KEY_TIMESERIES_INTERVAL,
+    KEY_STATISTICS_FORMAT,
       
     /* Thresholds */
     KEY_OVERLOAD_THRESHOLD,
@@ -73,9 +79,22 @@ typedef enum {
     KEY_MAXIMUM_PORTIONS_SECONDI,
     KEY_REFILL_AMOUNT_PRIMI, 
     KEY_REFILL_AMOUNT_SECONDI,
-    KEY_QUEUE_PATIENCE_THRESHOLD
+    KEY_QUEUE_PATIENCE_THRESHOLD,
+
+    /* Random */
+    KEY_RANDOM_SEED,
+
+    /* Log (livello per ruolo) */
+    KEY_LOG_LEVEL_MASTER,
+    KEY_LOG_LEVEL_OPERATORS,
+    KEY_LOG_LEVEL_CASHIERS,
+    KEY_LOG_LEVEL_USERS,
+    KEY_LOG_LEVEL_TOOLS
 } ConfigurationKey;
 
+_Static_assert(KEY_LOG_LEVEL_TOOLS - KEY_LOG_LEVEL_MASTER == LOG_ROLE_TOOL,
+               "Le chiavi LOG_LEVEL_* seguono l'ordine di LogRole");
+
 /* ==========================================================================
  *                      SEZIONE: TABELLA DI LOOKUP
  * ========================================================================== */
@@ -95,6 +114,8 @@ static const ConfigurationKeyMap configuration_mapping_table[] = {
     {"N_NEW_USERS", KEY_NUMBER_OF_NEW_USERS_BATCH},
     {"NOF_PAUSE", KEY_NUMBER_OF_PAUSE},
     {"MAX_USERS_PER_GROUP", KEY_MAXIMUM_USERS_PER_GROUP},
+    {"USERS_PER_HOST", KEY_USERS_PER_HOST},
+    {"USER_HOST_EVENT_LOOP", KEY_USER_HOST_EVENT_LOOP},
     
     {"NOF_WK_SEATS_PRIMI", KEY_SEATS_PRIMI},
     {"NOF_WK_SEATS_SECONDI", KEY_SEATS_SECONDI},
@@ -116,6 +137,8 @@ static const ConfigurationKeyMap configuration_mapping_table[] = {
     {"AVG_SRVC_TICKET", KEY_AVERAGE_SERVICE_TICKET},
     {"AVG_REFILL_TIME", KEY_AVERAGE_REFILL_TIME},
     {"STOP_DURATION", KEY_STOP_DURATION},
+    {"TIMESERIES_INTERVAL", KEY_TIMESERIES_INTERVAL},
+    {"STATISTICS_FORMAT", KEY_STATISTICS_FORMAT},
     
     {"OVERLOAD_THRESHOLD", KEY_OVERLOAD_THRESHOLD},
     {"MAX_PORZIONI_PRIMI", KEY_MAXIMUM_PORTIONS_PRIMI},
@@ -123,6 +146,14 @@ static const ConfigurationKeyMap configuration_mapping_table[] = {
     {"AVG_REFILL_PRIMI", KEY_REFILL_AMOUNT_PRIMI},
     {"AVG_REFILL_SECONDI", KEY_REFILL_AMOUNT_SECONDI},
     {"QUEUE_PATIENCE_THRESHOLD", KEY_QUEUE_PATIENCE_THRESHOLD},
+
+    {"RANDOM_SEED", KEY_RANDOM_SEED},
+
+    {"LOG_LEVEL_MASTER", KEY_LOG_LEVEL_MASTER},
+    {"LOG_LEVEL_OPERATORS", KEY_LOG_LEVEL_OPERATORS},
+    {"LOG_LEVEL_CASHIERS", KEY_LOG_LEVEL_CASHIERS},
+    {"LOG_LEVEL_USERS", KEY_LOG_LEVEL_USERS},
+    {"LOG_LEVEL_TOOLS", KEY_LOG_LEVEL_TOOLS},
     
     {NULL, KEY_UNKNOWN}  /* Terminatore */
 };
@@ -157,6 +188,9 @@ static ConfigurationKey resolve_configuration_key(const char *key_string) {
 SimulationConfiguration load_simulation_configuration(const char *filepath) {
     SimulationConfiguration configuration;
     memset(&configuration, 0, sizeof(SimulationConfiguration));
+    for (int role = 0; role < LOG_ROLE_COUNT; role++) {
+        configuration.log_levels[role] = LOG_LEVEL_DEBUG;
+    }
 
     const char *target_path = (filepath != NULL) ? filepath : CONFIGURATION_FILE_PATH;
 
@@ -173,7 +207,7 @@ SimulationConfiguration load_simulation_configuration(const char *filepath) {
     }
     
     if (filepath != NULL) {
-        printf("[CONFIG] Caricamento da file personalizzato: %s\n", filepath);
+        LOG_INFO("[CONFIG] Caricamento da file personalizzato: %s\n", filepath);
     }
 
     char line_buffer[MAX_LINE_LENGTH];
@@ -200,6 +234,8 @@ SimulationConfiguration load_simulation_configuration(const char *filepath) {
                     case KEY_NUMBER_OF_NEW_USERS_BATCH: configuration.quantities.number_of_new_users_batch = (int)variable_value; break;
                     case KEY_NUMBER_OF_PAUSE: configuration.quantities.number_of_allowed_breaks = (int)variable_value; break;
                     case KEY_MAXIMUM_USERS_PER_GROUP: configuration.quantities.maximum_users_per_group = (int)variable_value; break;
+                    case KEY_USERS_PER_HOST: configuration.quantities.users_per_host = (int)variable_value; break;
+                    case KEY_USER_HOST_EVENT_LOOP: configuration.quantities.user_host_event_loop = (int)variable_value; break;
                     
                     case KEY_SEATS_PRIMI: configuration.seats.seats_first_course = (int)variable_value; break;
                     case KEY_SEATS_SECONDI: configuration.seats.seats_second_course = (int)variable_value; break;
@@ -221,6 +257,7 @@ SimulationConfiguration load_simulation_configuration(const char *filepath) {
                     case KEY_AVERAGE_SERVICE_TICKET: configuration.timings.average_service_time_ticket = (int)variable_value; break;
                     case KEY_AVERAGE_REFILL_TIME: configuration.timings.average_refill_time = (int)variable_value; break;
                     case KEY_STOP_DURATION: configuration.timings.stop_duration_minutes = (int)variable_value; break;
+                    case KEY_TIMESERIES_INTERVAL: configuration.timings.timeseries_interval_minutes = (int)variable_value; break;
                     
                     case KEY_OVERLOAD_THRESHOLD: configuration.thresholds.overload_threshold = (int)variable_value; break;
                     case KEY_MAXIMUM_PORTIONS_PRIMI: configuration.thresholds.maximum_portions_primi = (int)variable_value; break;
@@ -228,6 +265,35 @@ SimulationConfiguration load_simulation_configuration(const char *filepath) {
                     case KEY_REFILL_AMOUNT_PRIMI: configuration.thresholds.refill_amount_primi = (int)variable_value; break;
                     case KEY_REFILL_AMOUNT_SECONDI: configuration.thresholds.refill_amount_secondi = (int)variable_value; break;
                     case KEY_QUEUE_PATIENCE_THRESHOLD: configuration.thresholds.queue_patience_threshold = (int)variable_value; break;
+
+                    /* Il seme occupa tutti i 64 bit: niente conversione via atol */
+                    case KEY_RANDOM_SEED: configuration.random_seed = strtoull(value_part, NULL, 10); break;
+
+                    /* Formato statistiche: nome (csv, jsonl); invalido ignorato */
+                    case KEY_STATISTICS_FORMAT: {
+                        int format = statistics_format_from_name(value_part);
+                        if (format == -1) {
+                            fprintf(stderr, "[CONFIG] Formato statistiche non valido, uso csv.\n");
+                        } else {
+                            configuration.statistics_format = format;
+                        }
+                        break;
+                    }
+
+                    /* Livelli di log: nome (error, warn, info, debug) o cifra; invalidi ignorati */
+                    case KEY_LOG_LEVEL_MASTER:
+                    case KEY_LOG_LEVEL_OPERATORS:
+                    case KEY_LOG_LEVEL_CASHIERS:
+                    case KEY_LOG_LEVEL_USERS:
+                    case KEY_LOG_LEVEL_TOOLS: {
+                        int level = log_level_from_name(value_part);
+                        if (level == -1) {
+                            fprintf(stderr, "[CONFIG] Livello di log non valido per %s, uso debug.\n", key_part);
+                        } else {
+                            configuration.log_levels[identified_key - KEY_LOG_LEVEL_MASTER] = level;
+                        }
+                        break;
+                    }
                     
                     default: break;
                 }
@@ -236,6 +302,16 @@ SimulationConfiguration load_simulation_configuration(const char *filepath) {
     }
 
     fclose(config_file);
-    printf("[CONFIG] Parametri caricati correttamente.\n");
+
+#ifdef USE_VIRTUAL_CLOCK
+    /* L'event loop ritenta le risorse esterne a ogni tick: col tempo virtuale ogni
+     * tick costa due scansioni di /proc (circa 14 volte più lento dei thread) */
+    if (configuration.quantities.user_host_event_loop) {
+        fprintf(stderr, "[CONFIG] USER_HOST_EVENT_LOOP non supportato con CLOCK_MODE=virtual, uso i thread.\n");
+        configuration.quantities.user_host_event_loop = 0;
+    }
+#endif
+
+    LOG_INFO("[CONFIG] Parametri caricati correttamente.\n");
     return configuration;
 }
\ No newline at end of file
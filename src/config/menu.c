@@ -15,6 +15,7 @@
 
 /* Includes del progetto */
 #include "menu.h"
+#include "log.h"
 
 /* ==========================================================================
  *                          SEZIONE: TIPI E MAPPING
@@ -142,7 +143,7 @@ SimulationMenu load_simulation_menu() {
     }
 
     fclose(menu_config_file);
-    printf("[MENU] Configurazione menu caricata correttamente.\n");
+    LOG_INFO("[MENU] Configurazione menu caricata correttamente.\n");
     return menu_data;
 }
 
@@ -0,0 +1,31 @@
+/**
+ * @file futex.c
+ * @brief Implementazione dei wrapper futex.
+ *
+ * @see futex.h per la documentazione delle funzioni pubbliche.
+ */
+
+/* Includes di sistema */
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/* Includes del progetto */
+#include "futex.h"
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+int futex_wait(_Atomic uint32_t *word, uint32_t expected) {
+    return (int)syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, expected, NULL, NULL, 0);
+}
+
+void futex_wake(_Atomic uint32_t *word, int count) {
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, count, NULL, NULL, 0);
+}
+
+void futex_wake_all(_Atomic uint32_t *word) {
+    futex_wake(word, INT_MAX);
+}
@@ -0,0 +1,148 @@
+/**
+ * @file mutex.c
+ * @brief Implementazione dei mutex globali (System V o pthread robusti in SHM).
+ *
+ * @see mutex.h per la documentazione delle funzioni pubbliche.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+/* Includes del progetto */
+#include "mutex.h"
+#include "sem.h"
+#include "trace.h"
+
+/* ==========================================================================
+ *                    SEZIONE: INIZIALIZZAZIONE E RIMOZIONE
+ * ========================================================================== */
+
+int initialize_simulation_mutexes(MainSharedMemory *shared_memory_ptr) {
+#ifdef USE_PTHREAD_MUTEX
+    pthread_mutexattr_t attr;
+    int result = 0;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+
+    for (int i = 0; i < MUTEX_SEMAPHORE_COUNT && result == 0; i++) {
+        if (i == MUTEX_ADD_USERS_PERMISSION) continue;
+
+        int err = pthread_mutex_init(&shared_memory_ptr->simulation_mutexes[i], &attr);
+        if (err != 0) {
+            fprintf(stderr, "[ERROR] pthread_mutex_init fallita (indice %d): %s\n", i, strerror(err));
+            result = -1;
+        }
+    }
+
+    pthread_mutexattr_destroy(&attr);
+    return result;
+#else
+    int semid = shared_memory_ptr->semaphore_mutex_id;
+    for (int i = 0; i < MUTEX_SEMAPHORE_COUNT; i++) {
+        if (i == MUTEX_ADD_USERS_PERMISSION) continue;
+        if (init_sem_val(semid, i, 1) == -1) return -1;
+    }
+    return 0;
+#endif
+}
+
+void destroy_simulation_mutexes(MainSharedMemory *shared_memory_ptr) {
+#ifdef USE_PTHREAD_MUTEX
+    for (int i = 0; i < MUTEX_SEMAPHORE_COUNT; i++) {
+        if (i == MUTEX_ADD_USERS_PERMISSION) continue;
+        pthread_mutex_destroy(&shared_memory_ptr->simulation_mutexes[i]);
+    }
+#else
+    (void)shared_memory_ptr;
+#endif
+}
+
+/* ==========================================================================
+ *                       SEZIONE: ACQUISIZIONE E RILASCIO
+ * ========================================================================== */
+
+/**
+ * Acquisizione sul backend selezionato. Con `try_only` non attende e
+ * restituisce 1 se il lock è occupato.
+ */
+static int acquire_simulation_mutex(MainSharedMemory *shared_memory_ptr, MutexSemaphoreIndex mutex_index,
+                                    bool try_only) {
+#ifdef USE_PTHREAD_MUTEX
+    pthread_mutex_t *mutex = &shared_memory_ptr->simulation_mutexes[mutex_index];
+    int err = try_only ? pthread_mutex_trylock(mutex) : pthread_mutex_lock(mutex);
+
+    if (err == EBUSY) return 1;
+    if (err == EOWNERDEAD) {
+        /* Il proprietario è morto in sezione critica: il lock è nostro, lo rendiamo
+           nuovamente consistente come farebbe SEM_UNDO sul backend System V. */
+        pthread_mutex_consistent(mutex);
+        err = 0;
+    }
+
+    if (err != 0) {
+        fprintf(stderr, "[ERROR] pthread_mutex_lock fallita (indice %d): %s\n", mutex_index, strerror(err));
+        return -1;
+    }
+    return 0;
+#else
+    if (try_only) {
+        if (reserve_sem_try(shared_memory_ptr->semaphore_mutex_id, mutex_index) == 0) return 0;
+        return (errno == EAGAIN) ? 1 : -1;
+    }
+    return reserve_sem(shared_memory_ptr->semaphore_mutex_id, mutex_index);
+#endif
+}
+
+int lock_simulation_mutex(MainSharedMemory *shared_memory_ptr, MutexSemaphoreIndex mutex_index) {
+    if (!trace_is_enabled(shared_memory_ptr)) {
+        return acquire_simulation_mutex(shared_memory_ptr, mutex_index, false);
+    }
+
+    /* Tracciamento attivo: si misura solo l'attesa effettiva (lock occupato) */
+    int res = acquire_simulation_mutex(shared_memory_ptr, mutex_index, true);
+    if (res != 1) return res;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    res = acquire_simulation_mutex(shared_memory_ptr, mutex_index, false);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    long long waited_ns = (long long)(end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec);
+    if (res == 0 && waited_ns >= TRACE_LOCK_WAIT_MIN_NS) {
+        long long waited_us = waited_ns / 1000;
+        trace_record(shared_memory_ptr, TRACE_EVENT_LOCK_WAIT, gettid(), mutex_index,
+                     (int)(waited_us > INT32_MAX ? INT32_MAX : waited_us));
+    }
+    return res;
+}
+
+int unlock_simulation_mutex(MainSharedMemory *shared_memory_ptr, MutexSemaphoreIndex mutex_index) {
+#ifdef USE_PTHREAD_MUTEX
+    int err = pthread_mutex_unlock(&shared_memory_ptr->simulation_mutexes[mutex_index]);
+    if (err != 0) {
+        fprintf(stderr, "[ERROR] pthread_mutex_unlock fallita (indice %d): %s\n", mutex_index, strerror(err));
+        return -1;
+    }
+    return 0;
+#else
+    return release_sem(shared_memory_ptr->semaphore_mutex_id, mutex_index);
+#endif
+}
+
+/* ==========================================================================
+ *                         SEZIONE: LOCK PER DOMINIO
+ * ========================================================================== */
+
+MutexSemaphoreIndex group_mutex_index(int group_id) {
+    return (MutexSemaphoreIndex)(MUTEX_GROUP_STRIPE_BASE + (group_id % GROUP_MUTEX_STRIPES));
+}
+
+MutexSemaphoreIndex station_mutex_index(int station_type) {
+    return (MutexSemaphoreIndex)(MUTEX_STATION_FIRST_COURSE + station_type);
+}
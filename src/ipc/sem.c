@@ -12,6 +12,8 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <errno.h>
+#include <limits.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <sys/sem.h>
@@ -67,6 +69,18 @@ int init_sem_val(int sem_id, int sem_num, int init_val) {
     return 0;
 }
 
+/** Inizializza tutti i semafori del set con una sola semctl(SETALL). */
+int init_sem_set_all(int sem_id, unsigned short *values) {
+    union semun arg;
+    arg.array = values;
+
+    if (semctl(sem_id, 0, SETALL, arg) == -1) {
+        perror("IPC Error: semctl SETALL failed");
+        return -1;
+    }
+    return 0;
+}
+
 /** Rimuove un set di semafori dal sistema. */
 int delete_sem_set(int sem_id) {
     if (semctl(sem_id, 0, IPC_RMID) == -1) {
@@ -101,6 +115,11 @@ int reserve_sem_try_no_undo(int sem_id, int semaphore_index) {
     return _execute_sem_op(sem_id, semaphore_index, -1, IPC_NOWAIT);
 }
 
+/** P non bloccante con UNDO. */
+int reserve_sem_try(int sem_id, int semaphore_index) {
+    return _execute_sem_op(sem_id, semaphore_index, -1, SEM_UNDO | IPC_NOWAIT);
+}
+
 /* ==========================================================================
  *                      SEZIONE: OPERAZIONI V (RELEASE)
  * ========================================================================== */
@@ -144,6 +163,15 @@ int reserve_sem_interruptible(int sem_id, int semaphore_index) {
     return semop(sem_id, &sb, 1);
 }
 
+/** Riserva interrompibile senza UNDO (ritorna su EINTR) */
+int reserve_sem_interruptible_no_undo(int sem_id, int semaphore_index) {
+    struct sembuf sb;
+    sb.sem_num = (unsigned short)semaphore_index;
+    sb.sem_op = -1;
+    sb.sem_flg = 0;
+    return semop(sem_id, &sb, 1);
+}
+
 /** Attesa zero interrompibile (ritorna su EINTR) */
 int wait_for_zero_interruptible(int sem_id, int semaphore_index) {
     struct sembuf sb;
@@ -153,6 +181,19 @@ int wait_for_zero_interruptible(int sem_id, int semaphore_index) {
     return semop(sem_id, &sb, 1);
 }
 
+/** Attende lo zero con timeout relativo, senza retry su EINTR. */
+int wait_for_zero_timed(int sem_id, int semaphore_index, long timeout_ns) {
+    struct sembuf sb;
+    sb.sem_num = (unsigned short)semaphore_index;
+    sb.sem_op = 0;
+    sb.sem_flg = 0;
+
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ns / 1000000000L;
+    timeout.tv_nsec = timeout_ns % 1000000000L;
+    return semtimedop(sem_id, &sb, 1, &timeout);
+}
+
 /** Legge il valore corrente di un semaforo. */
 int get_sem_val(int sem_id, int sem_num) {
     int val = semctl(sem_id, sem_num, GETVAL);
@@ -184,3 +225,29 @@ int sync_child_start(int sem_id, int ready_idx, int gate_idx) {
     if (reserve_sem_no_undo(sem_id, ready_idx) == -1) return -1;
     return wait_for_zero(sem_id, gate_idx);
 }
+
+/** Decrementa ready di `count` a blocchi (sem_op è uno short) e attende gate=0. */
+static int sync_participants_start(int sem_id, int ready_idx, int gate_idx, int count, short flags) {
+    while (count > 0) {
+        int chunk = (count > SHRT_MAX) ? SHRT_MAX : count;
+        if (_execute_sem_op(sem_id, ready_idx, (short)(-chunk), flags) == -1) return -1;
+        count -= chunk;
+    }
+    return wait_for_zero(sem_id, gate_idx);
+}
+
+/** Sincronizza `count` partecipanti di uno stesso processo: decrementa ready di count, attende gate=0. */
+int sync_children_start(int sem_id, int ready_idx, int gate_idx, int count) {
+    /* Senza UNDO come sync_child_start */
+    return sync_participants_start(sem_id, ready_idx, gate_idx, count, 0);
+}
+
+/** Come sync_child_start, con UNDO: arrivi annullati se il processo muore prima del reset. */
+int sync_child_start_undo(int sem_id, int ready_idx, int gate_idx) {
+    return sync_participants_start(sem_id, ready_idx, gate_idx, 1, SEM_UNDO);
+}
+
+/** Come sync_children_start, con UNDO. */
+int sync_children_start_undo(int sem_id, int ready_idx, int gate_idx, int count) {
+    return sync_participants_start(sem_id, ready_idx, gate_idx, count, SEM_UNDO);
+}
@@ -0,0 +1,253 @@
+/**
+ * @file shm_ring.c
+ * @brief Implementazione della ring MPMC in SHM e delle caselle di risposta.
+ *
+ * Protocollo anti lost-wakeup: il consumatore legge il contatore futex PRIMA
+ * del tentativo di estrazione e si sospende solo se il contatore non è
+ * cambiato; il produttore incrementa il contatore DOPO la pubblicazione e
+ * risveglia solo se qualcuno è registrato come in attesa (atomici seq_cst).
+ *
+ * @see shm_ring.h per la documentazione delle funzioni pubbliche.
+ */
+
+/* Includes di sistema */
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ipc.h>
+
+/* Includes del progetto */
+#include "futex.h"
+#include "shm_ring.h"
+
+#define ORDER_RING_MASK (ORDER_RING_CAPACITY - 1)
+
+/* ==========================================================================
+ *                          SEZIONE: FUNZIONI PRIVATE
+ * ========================================================================== */
+
+/** Tentativo non bloccante di enqueue. Ritorna 0 se accodato, -1 se piena. */
+static int try_enqueue(OrderRing *ring, const void *payload, size_t payload_size) {
+    unsigned long pos = atomic_load_explicit(&ring->enqueue_position, memory_order_relaxed);
+    OrderRingSlot *slot;
+
+    for (;;) {
+        slot = &ring->slots[pos & ORDER_RING_MASK];
+        unsigned long seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        long diff = (long)seq - (long)pos;
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->enqueue_position, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -1;
+        } else {
+            pos = atomic_load_explicit(&ring->enqueue_position, memory_order_relaxed);
+        }
+    }
+
+    memcpy(slot->payload, payload, payload_size);
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+    return 0;
+}
+
+/** Tentativo non bloccante di dequeue. Ritorna 0 se estratto, -1 se vuota. */
+static int try_dequeue(OrderRing *ring, void *payload, size_t payload_size) {
+    unsigned long pos = atomic_load_explicit(&ring->dequeue_position, memory_order_relaxed);
+    OrderRingSlot *slot;
+
+    for (;;) {
+        slot = &ring->slots[pos & ORDER_RING_MASK];
+        unsigned long seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        long diff = (long)seq - (long)(pos + 1);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->dequeue_position, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -1;
+        } else {
+            pos = atomic_load_explicit(&ring->dequeue_position, memory_order_relaxed);
+        }
+    }
+
+    memcpy(payload, slot->payload, payload_size);
+    atomic_store_explicit(&slot->sequence, pos + ORDER_RING_CAPACITY, memory_order_release);
+    return 0;
+}
+
+/* ==========================================================================
+ *                          SEZIONE: ORDER RING
+ * ========================================================================== */
+
+void order_ring_init(OrderRing *ring) {
+    atomic_store(&ring->enqueue_position, 0);
+    atomic_store(&ring->dequeue_position, 0);
+    atomic_store(&ring->items_futex, 0);
+    atomic_store(&ring->space_futex, 0);
+    atomic_store(&ring->waiting_consumers, 0);
+    atomic_store(&ring->waiting_producers, 0);
+
+    for (unsigned long i = 0; i < ORDER_RING_CAPACITY; i++) {
+        atomic_store(&ring->slots[i].sequence, i);
+    }
+}
+
+int order_ring_enqueue(OrderRing *ring, const void *payload, size_t payload_size, int flags) {
+    if (payload_size > RING_PAYLOAD_SIZE) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (;;) {
+        uint32_t seen = atomic_load(&ring->space_futex);
+
+        if (try_enqueue(ring, payload, payload_size) == 0) {
+            atomic_fetch_add(&ring->items_futex, 1);
+            if (atomic_load(&ring->waiting_consumers) > 0) {
+                futex_wake(&ring->items_futex, 1);
+            }
+            return 0;
+        }
+
+        if (flags & IPC_NOWAIT) {
+            errno = EAGAIN;
+            return -1;
+        }
+
+        /* Ring piena: parcheggio finché un consumatore non libera spazio */
+        atomic_fetch_add(&ring->waiting_producers, 1);
+        int res = futex_wait(&ring->space_futex, seen);
+        int saved_errno = errno;
+        atomic_fetch_sub(&ring->waiting_producers, 1);
+
+        if (res == -1 && saved_errno == EINTR) {
+            errno = EINTR;
+            return -1;
+        }
+    }
+}
+
+ssize_t order_ring_dequeue(OrderRing *ring, void *payload, size_t payload_size, int flags) {
+    if (payload_size > RING_PAYLOAD_SIZE) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (;;) {
+        uint32_t seen = atomic_load(&ring->items_futex);
+
+        if (try_dequeue(ring, payload, payload_size) == 0) {
+            atomic_fetch_add(&ring->space_futex, 1);
+            if (atomic_load(&ring->waiting_producers) > 0) {
+                futex_wake(&ring->space_futex, 1);
+            }
+            return (ssize_t)payload_size;
+        }
+
+        if (flags & IPC_NOWAIT) {
+            errno = ENOMSG;
+            return -1;
+        }
+
+        /* Ring vuota: parcheggio finché un produttore non pubblica */
+        atomic_fetch_add(&ring->waiting_consumers, 1);
+        int res = futex_wait(&ring->items_futex, seen);
+        int saved_errno = errno;
+        atomic_fetch_sub(&ring->waiting_consumers, 1);
+
+        if (res == -1 && saved_errno == EINTR) {
+            errno = EINTR;
+            return -1;
+        }
+    }
+}
+
+int order_ring_length(OrderRing *ring) {
+    unsigned long head = atomic_load_explicit(&ring->dequeue_position, memory_order_relaxed);
+    unsigned long tail = atomic_load_explicit(&ring->enqueue_position, memory_order_relaxed);
+    return (tail > head) ? (int)(tail - head) : 0;
+}
+
+/* ==========================================================================
+ *                          SEZIONE: REPLY SLOT
+ * ========================================================================== */
+
+int reply_slot_claim(ReplySlot *slots, int slots_count, pid_t owner_pid) {
+    int start = (int)(owner_pid % slots_count);
+
+    for (int i = 0; i < slots_count; i++) {
+        ReplySlot *slot = &slots[(start + i) % slots_count];
+        pid_t current = atomic_load(&slot->owner_pid);
+
+        /* Casella libera o appartenente a un processo non più esistente */
+        if (current == 0 || (kill(current, 0) == -1 && errno == ESRCH)) {
+            if (atomic_compare_exchange_strong(&slot->owner_pid, &current, owner_pid)) {
+                atomic_store(&slot->ready, 0);
+                atomic_store(&slot->waiting, 0);
+                return (start + i) % slots_count;
+            }
+        }
+    }
+    return -1;
+}
+
+void reply_slot_release(ReplySlot *slot, pid_t owner_pid) {
+    pid_t expected = owner_pid;
+    atomic_compare_exchange_strong(&slot->owner_pid, &expected, 0);
+}
+
+void reply_slot_reset(ReplySlot *slot) {
+    atomic_store(&slot->ready, 0);
+}
+
+int reply_slot_post(ReplySlot *slot, const void *payload, size_t payload_size) {
+    if (payload_size > RING_PAYLOAD_SIZE) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memcpy(slot->payload, payload, payload_size);
+    atomic_store(&slot->ready, 1);
+    if (atomic_load(&slot->waiting) > 0) {
+        futex_wake(&slot->ready, INT_MAX);
+    }
+    return 0;
+}
+
+ssize_t reply_slot_wait(ReplySlot *slot, void *payload, size_t payload_size, int flags) {
+    if (payload_size > RING_PAYLOAD_SIZE) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (;;) {
+        if (atomic_load_explicit(&slot->ready, memory_order_acquire) == 1) {
+            memcpy(payload, slot->payload, payload_size);
+            atomic_store(&slot->ready, 0);
+            return (ssize_t)payload_size;
+        }
+
+        if (flags & IPC_NOWAIT) {
+            errno = ENOMSG;
+            return -1;
+        }
+
+        /* Registrazione prima della futex_wait: il kernel ricontrolla ready == 0 */
+        atomic_fetch_add(&slot->waiting, 1);
+        int res = futex_wait(&slot->ready, 0);
+        int saved_errno = errno;
+        atomic_fetch_sub(&slot->waiting, 1);
+
+        if (res == -1 && saved_errno == EINTR) {
+            errno = EINTR;
+            return -1;
+        }
+    }
+}
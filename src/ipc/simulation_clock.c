@@ -0,0 +1,86 @@
+/**
+ * @file simulation_clock.c
+ * @brief Implementazione dell'orologio simulato condiviso.
+ *
+ * Protocollo anti lost-wakeup: chi attende si registra in `waiters`, legge
+ * tick_futex e si sospende solo se il tick non ha raggiunto il target; il
+ * Master aggiorna tick e tick_futex e risveglia solo se ci sono attese.
+ *
+ * @see simulation_clock.h per la documentazione delle funzioni pubbliche.
+ */
+
+/* Includes di sistema */
+#include <errno.h>
+#include <unistd.h>
+
+/* Includes del progetto */
+#include "futex.h"
+#include "simulation_clock.h"
+#include "virtual_clock.h"
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+void simulation_clock_init(SimulationClock *clock, long nanoseconds_per_minute) {
+    int ticks_per_minute = SIMULATION_CLOCK_MAX_TICKS_PER_MINUTE;
+    while (ticks_per_minute > 1 && nanoseconds_per_minute / ticks_per_minute < SIMULATION_CLOCK_MIN_TICK_NS) {
+        ticks_per_minute--;
+    }
+
+    clock->ticks_per_minute = ticks_per_minute;
+    clock->tick_ns = nanoseconds_per_minute / ticks_per_minute;
+    if (clock->tick_ns <= 0) clock->tick_ns = 1;
+
+    atomic_store(&clock->tick, 0);
+    atomic_store(&clock->tick_futex, 0);
+    atomic_store(&clock->waiters, 0);
+}
+
+unsigned long long simulation_clock_now(const SimulationClock *clock) {
+    return atomic_load(&clock->tick);
+}
+
+void simulation_clock_publish(SimulationClock *clock, unsigned long long tick) {
+    if (tick <= atomic_load(&clock->tick)) return;
+
+    atomic_store(&clock->tick, tick);
+    atomic_store(&clock->tick_futex, (uint32_t)tick);
+    if (atomic_load(&clock->waiters) > 0) {
+        futex_wake_all(&clock->tick_futex);
+    }
+}
+
+int simulation_clock_wait_until(SimulationClock *clock, unsigned long long target_tick) {
+#ifdef USE_VIRTUAL_CLOCK
+    VirtualClock *virtual_clock = virtual_clock_bound();
+    if (virtual_clock != NULL) {
+        /* Il Master pubblica il tick prima di far avanzare l'orologio virtuale */
+        long long remaining_ns = (long long)target_tick * clock->tick_ns - atomic_load(&virtual_clock->now_ns);
+        return virtual_clock_sleep(virtual_clock, remaining_ns, true);
+    }
+#endif
+    int result = 0;
+    atomic_fetch_add(&clock->waiters, 1);
+    for (;;) {
+        uint32_t seen = atomic_load(&clock->tick_futex);
+        if (atomic_load(&clock->tick) >= target_tick) break;
+
+        if (futex_wait(&clock->tick_futex, seen) == -1 && errno == EINTR) {
+            result = -1;
+            break;
+        }
+    }
+    atomic_fetch_sub(&clock->waiters, 1);
+    if (result == -1) errno = EINTR;
+    return result;
+}
+
+double simulation_clock_minutes_since(const SimulationClock *clock, unsigned long long start_tick) {
+    unsigned long long now = atomic_load(&clock->tick);
+    return (now > start_tick) ? (double)(now - start_tick) / clock->ticks_per_minute : 0.0;
+}
+
+double simulation_clock_minutes_between(const SimulationClock *clock, unsigned long long from, unsigned long long to) {
+    return (to > from) ? (double)(to - from) / clock->ticks_per_minute : 0.0;
+}
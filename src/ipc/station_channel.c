@@ -0,0 +1,278 @@
+/**
+ * @file station_channel.c
+ * @brief Implementazione del canale di stazione (code System V o ring in SHM).
+ *
+ * @see station_channel.h per la documentazione delle funzioni pubbliche.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <sys/ipc.h>
+
+/* Includes del progetto */
+#include "station_channel.h"
+#include "queue.h"
+#include "shm_ring.h"
+#include "trace.h"
+
+/* Entrambi i payload devono condividere l'intestazione e stare in uno slot */
+_Static_assert(offsetof(StationPayload, reply_slot_index) == offsetof(ChannelRoutingHeader, reply_slot_index),
+               "StationPayload deve iniziare con ChannelRoutingHeader");
+_Static_assert(offsetof(CashierPayload, reply_slot_index) == offsetof(ChannelRoutingHeader, reply_slot_index),
+               "CashierPayload deve iniziare con ChannelRoutingHeader");
+_Static_assert(offsetof(StationPayload, dequeue_tick) == offsetof(ChannelRoutingHeader, dequeue_tick) &&
+               offsetof(CashierPayload, dequeue_tick) == offsetof(ChannelRoutingHeader, dequeue_tick),
+               "I tick di invio/prelievo fanno parte di ChannelRoutingHeader");
+_Static_assert(offsetof(StationPayload, reply_tick) == offsetof(ChannelRoutingHeader, reply_tick) &&
+               offsetof(CashierPayload, reply_tick) == offsetof(ChannelRoutingHeader, reply_tick),
+               "Il tick di risposta fa parte di ChannelRoutingHeader");
+_Static_assert(sizeof(StationPayload) <= RING_PAYLOAD_SIZE, "StationPayload eccede RING_PAYLOAD_SIZE");
+_Static_assert(sizeof(CashierPayload) <= RING_PAYLOAD_SIZE, "CashierPayload eccede RING_PAYLOAD_SIZE");
+
+/* ==========================================================================
+ *                          SEZIONE: FUNZIONI PRIVATE
+ * ========================================================================== */
+
+#ifdef USE_SHM_RINGS
+
+/** Ring degli ordini associata al canale. */
+static OrderRing *channel_ring(MainSharedMemory *shm_ptr, StationChannelIndex channel) {
+    switch (channel) {
+        case STATION_CHANNEL_FIRST_COURSE:   return &shm_ptr->first_course_station.order_ring;
+        case STATION_CHANNEL_SECOND_COURSE:  return &shm_ptr->second_course_station.order_ring;
+        case STATION_CHANNEL_COFFEE_DESSERT: return &shm_ptr->coffee_dessert_station.order_ring;
+        default:                             return &shm_ptr->register_station.order_ring;
+    }
+}
+
+/** Casella di risposta indicata dall'intestazione, NULL se non valida. */
+static ReplySlot *routed_reply_slot(MainSharedMemory *shm_ptr, const void *payload) {
+    const ChannelRoutingHeader *routing = (const ChannelRoutingHeader *)payload;
+    if (routing->reply_slot_index < 0 || routing->reply_slot_index >= shm_ptr->reply_slots_count) {
+        return NULL;
+    }
+    return &shm_reply_slots(shm_ptr)[routing->reply_slot_index];
+}
+
+#else
+
+/** Coda System V degli ordini associata al canale (solo FIFO). */
+static int channel_queue_id(MainSharedMemory *shm_ptr, StationChannelIndex channel) {
+    switch (channel) {
+        case STATION_CHANNEL_FIRST_COURSE:   return shm_ptr->first_course_station.message_queue_id;
+        case STATION_CHANNEL_SECOND_COURSE:  return shm_ptr->second_course_station.message_queue_id;
+        case STATION_CHANNEL_COFFEE_DESSERT: return shm_ptr->coffee_dessert_station.message_queue_id;
+        default:                             return shm_ptr->register_station.message_queue_id;
+    }
+}
+
+/** Coda di risposta (shard pid % K) del canale per l'utente indicato. */
+static int channel_reply_queue_id(MainSharedMemory *shm_ptr, StationChannelIndex channel, pid_t user_pid) {
+    int shard = (int)(user_pid % STATION_REPLY_QUEUE_SHARDS);
+    switch (channel) {
+        case STATION_CHANNEL_FIRST_COURSE:   return shm_ptr->first_course_station.reply_queue_ids[shard];
+        case STATION_CHANNEL_SECOND_COURSE:  return shm_ptr->second_course_station.reply_queue_ids[shard];
+        case STATION_CHANNEL_COFFEE_DESSERT: return shm_ptr->coffee_dessert_station.reply_queue_ids[shard];
+        default:                             return shm_ptr->register_station.reply_queue_ids[shard];
+    }
+}
+
+#endif
+
+/* ==========================================================================
+ *                         SEZIONE: REGISTRAZIONE UTENTE
+ * ========================================================================== */
+
+int station_channel_attach_user(MainSharedMemory *shm_ptr, pid_t user_pid) {
+#ifdef USE_SHM_RINGS
+    return reply_slot_claim(shm_reply_slots(shm_ptr), shm_ptr->reply_slots_count, user_pid);
+#else
+    (void)shm_ptr;
+    (void)user_pid;
+    return 0;
+#endif
+}
+
+void station_channel_detach_user(MainSharedMemory *shm_ptr, int reply_slot_index, pid_t user_pid) {
+#ifdef USE_SHM_RINGS
+    if (reply_slot_index >= 0 && reply_slot_index < shm_ptr->reply_slots_count) {
+        reply_slot_release(&shm_reply_slots(shm_ptr)[reply_slot_index], user_pid);
+    }
+#else
+    (void)shm_ptr;
+    (void)reply_slot_index;
+    (void)user_pid;
+#endif
+}
+
+/* ==========================================================================
+ *                      SEZIONE: LATO UTENTE (ORDINE/RISPOSTA)
+ * ========================================================================== */
+
+/** Invio ordine con flag di trasporto (0 o IPC_NOWAIT). */
+static int send_order(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                      void *payload, size_t payload_size, int flags) {
+    int res;
+    ((ChannelRoutingHeader *)payload)->enqueue_tick = simulation_clock_now(&shm_ptr->simulation_clock);
+#ifdef USE_SHM_RINGS
+    ReplySlot *reply = routed_reply_slot(shm_ptr, payload);
+    if (reply == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* Una sola richiesta pendente per utente: la casella riparte vuota */
+    reply_slot_reset(reply);
+    res = order_ring_enqueue(channel_ring(shm_ptr, channel), payload, payload_size, flags);
+#else
+    SimulationMessage msg;
+    msg.message_type = MSG_TYPE_ORDER;
+    memcpy(msg.message_text, payload, payload_size);
+    res = send_message_to_queue_interruptible(channel_queue_id(shm_ptr, channel), &msg, payload_size, flags);
+#endif
+    if (res != -1) {
+        TRACE_EVENT(shm_ptr, TRACE_EVENT_ENQUEUE, ((ChannelRoutingHeader *)payload)->user_pid, channel, 0);
+    }
+    return res;
+}
+
+/** Ricezione risposta con flag di trasporto (0 o IPC_NOWAIT). */
+static ssize_t receive_reply(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                             void *payload, size_t payload_size, int flags) {
+    ssize_t res;
+#ifdef USE_SHM_RINGS
+    (void)channel;
+    ReplySlot *reply = routed_reply_slot(shm_ptr, payload);
+    if (reply == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    res = reply_slot_wait(reply, payload, payload_size, flags);
+#else
+    SimulationMessage msg;
+    pid_t user_pid = ((ChannelRoutingHeader *)payload)->user_pid;
+    res = receive_message_from_queue(channel_reply_queue_id(shm_ptr, channel, user_pid),
+                                     &msg, payload_size, user_pid, flags);
+    if (res != -1) {
+        memcpy(payload, msg.message_text, payload_size);
+    }
+#endif
+    /* Risposta non ancora arrivata (IPC_NOWAIT): stessa semantica dell'invio */
+    if (res == -1 && errno == ENOMSG) {
+        errno = EAGAIN;
+    }
+    return res;
+}
+
+int station_channel_send_order(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                               void *payload, size_t payload_size) {
+    return send_order(shm_ptr, channel, payload, payload_size, 0);
+}
+
+int station_channel_try_send_order(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                                   void *payload, size_t payload_size) {
+    return send_order(shm_ptr, channel, payload, payload_size, IPC_NOWAIT);
+}
+
+ssize_t station_channel_receive_reply(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                                      void *payload, size_t payload_size) {
+    return receive_reply(shm_ptr, channel, payload, payload_size, 0);
+}
+
+ssize_t station_channel_try_receive_reply(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                                          void *payload, size_t payload_size) {
+    return receive_reply(shm_ptr, channel, payload, payload_size, IPC_NOWAIT);
+}
+
+int station_channel_pending_orders(MainSharedMemory *shm_ptr, StationChannelIndex channel) {
+#ifdef USE_SHM_RINGS
+    return order_ring_length(channel_ring(shm_ptr, channel));
+#else
+    return get_message_queue_length(channel_queue_id(shm_ptr, channel));
+#endif
+}
+
+/* ==========================================================================
+ *                    SEZIONE: LATO STAZIONE (RICEZIONE/RISPOSTA)
+ * ========================================================================== */
+
+ssize_t station_channel_receive_order(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                                      void *payload, size_t payload_size) {
+    ssize_t res;
+#ifdef USE_SHM_RINGS
+    res = order_ring_dequeue(channel_ring(shm_ptr, channel), payload, payload_size, 0);
+#else
+    SimulationMessage msg;
+    res = receive_message_from_queue(channel_queue_id(shm_ptr, channel), &msg, payload_size, MSG_TYPE_ORDER, 0);
+    if (res != -1) {
+        memcpy(payload, msg.message_text, payload_size);
+    }
+#endif
+    if (res != -1) {
+        ((ChannelRoutingHeader *)payload)->dequeue_tick = simulation_clock_now(&shm_ptr->simulation_clock);
+        TRACE_EVENT(shm_ptr, TRACE_EVENT_DEQUEUE, ((ChannelRoutingHeader *)payload)->user_pid, channel, getpid());
+    }
+    return res;
+}
+
+int station_channel_send_reply(MainSharedMemory *shm_ptr, StationChannelIndex channel,
+                               void *payload, size_t payload_size) {
+    ((ChannelRoutingHeader *)payload)->reply_tick = simulation_clock_now(&shm_ptr->simulation_clock);
+#ifdef USE_SHM_RINGS
+    (void)channel;
+    ReplySlot *reply = routed_reply_slot(shm_ptr, payload);
+    if (reply == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    return reply_slot_post(reply, payload, payload_size);
+#else
+    SimulationMessage msg;
+    pid_t user_pid = ((ChannelRoutingHeader *)payload)->user_pid;
+    msg.message_type = user_pid;
+    memcpy(msg.message_text, payload, payload_size);
+    return send_message_to_queue(channel_reply_queue_id(shm_ptr, channel, user_pid), &msg, payload_size, 0);
+#endif
+}
+
+/* ==========================================================================
+ *                          SEZIONE: MANUTENZIONE
+ * ========================================================================== */
+
+int station_channel_flush_all(MainSharedMemory *shm_ptr) {
+    int flushed_count = 0;
+    unsigned char buffer[RING_PAYLOAD_SIZE];
+
+#ifdef USE_SHM_RINGS
+    for (int c = 0; c < STATION_CHANNEL_COUNT; c++) {
+        while (order_ring_dequeue(channel_ring(shm_ptr, c), buffer, sizeof(buffer), IPC_NOWAIT) != -1) {
+            flushed_count++;
+        }
+    }
+    ReplySlot *reply_slots = shm_reply_slots(shm_ptr);
+    for (int i = 0; i < shm_ptr->reply_slots_count; i++) {
+        if (atomic_load(&reply_slots[i].ready)) {
+            reply_slot_reset(&reply_slots[i]);
+            flushed_count++;
+        }
+    }
+#else
+    SimulationMessage msg;
+    for (int c = 0; c < STATION_CHANNEL_COUNT; c++) {
+        while (receive_message_from_queue(channel_queue_id(shm_ptr, c), &msg, sizeof(buffer), 0, IPC_NOWAIT) != -1) {
+            flushed_count++;
+        }
+        /* Risposte non ritirate: lo shard dipende solo dal PID, basta scorrere i K valori */
+        for (pid_t shard = 0; shard < STATION_REPLY_QUEUE_SHARDS; shard++) {
+            int reply_qid = channel_reply_queue_id(shm_ptr, c, shard);
+            while (receive_message_from_queue(reply_qid, &msg, sizeof(buffer), 0, IPC_NOWAIT) != -1) {
+                flushed_count++;
+            }
+        }
+    }
+#endif
+
+    return flushed_count;
+}
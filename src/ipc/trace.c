@@ -0,0 +1,152 @@
+/**
+ * @file trace.c
+ * @brief Implementazione del tracciamento eventi in ring SHM per thread.
+ *
+ * @see trace.h per il formato degli eventi e il protocollo delle ring.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/shm.h>
+
+/* Includes del progetto */
+#include "trace.h"
+
+_Static_assert(sizeof(TraceEvent) == 24, "TraceEvent fa parte del formato del file di traccia");
+_Static_assert((TRACE_RING_CAPACITY & (TRACE_RING_CAPACITY - 1)) == 0, "TRACE_RING_CAPACITY deve essere potenza di 2");
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Eventi da lasciar passare prima di ritentare l'assegnazione di una ring */
+#define TRACE_CLAIM_RETRY_INTERVAL 256
+
+/** Segmento delle ring, collegato al primo evento (ereditato dai figli di fork) */
+static _Atomic(TraceSegment *) trace_segment = NULL;
+
+/** Ring del thread chiamante */
+static __thread TraceRing *local_trace_ring = NULL;
+
+/** Eventi rimanenti prima di un nuovo tentativo di assegnazione */
+static __thread unsigned claim_backoff = 0;
+
+static pthread_once_t trace_atfork_once = PTHREAD_ONCE_INIT;
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+/** Nel figlio di una fork il TID cambia: la ring del padre non è sua. */
+static void reset_trace_ring_in_child(void) {
+    local_trace_ring = NULL;
+    claim_backoff = 0;
+}
+
+static void register_trace_atfork(void) {
+    pthread_atfork(NULL, NULL, reset_trace_ring_in_child);
+}
+
+/** Segmento delle ring del processo, collegato alla prima richiesta. */
+static TraceSegment *get_trace_segment(MainSharedMemory *shm_ptr) {
+    TraceSegment *segment = atomic_load(&trace_segment);
+    if (segment != NULL) return segment;
+
+    void *address = shmat(shm_ptr->trace_shared_memory_id, NULL, 0);
+    if (address == (void *)-1) return NULL;
+
+    TraceSegment *expected = NULL;
+    if (!atomic_compare_exchange_strong(&trace_segment, &expected, (TraceSegment *)address)) {
+        /* Un altro thread del processo l'ha già collegato */
+        shmdt(address);
+        return expected;
+    }
+    pthread_once(&trace_atfork_once, register_trace_atfork);
+    return (TraceSegment *)address;
+}
+
+/**
+ * Assegna una ring al thread chiamante, come get_local_statistics_shard():
+ * prima una libera, poi una di un thread terminato purché già svuotata.
+ */
+static TraceRing *claim_trace_ring(TraceSegment *segment) {
+    pid_t self = gettid();
+    int rings_count = segment->rings_count;
+    int start = (int)(self % rings_count);
+
+    for (int i = 0; i < rings_count; i++) {
+        TraceRing *ring = &segment->rings[(start + i) % rings_count];
+        pid_t current = atomic_load(&ring->owner_tid);
+
+        if (current == 0 ||
+            (kill(current, 0) == -1 && errno == ESRCH &&
+             atomic_load(&ring->tail) == atomic_load(&ring->head))) {
+            if (atomic_compare_exchange_strong(&ring->owner_tid, &current, self)) {
+                return ring;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+void trace_record(MainSharedMemory *shm_ptr, TraceEventType type, pid_t actor, int object, int arg) {
+    TraceRing *ring = local_trace_ring;
+
+    if (ring == NULL) {
+        TraceSegment *segment = get_trace_segment(shm_ptr);
+        if (segment == NULL) return;
+
+        if (claim_backoff > 0) {
+            claim_backoff--;
+            atomic_fetch_add_explicit(&segment->unassigned_drops, 1, memory_order_relaxed);
+            return;
+        }
+        ring = claim_trace_ring(segment);
+        if (ring == NULL) {
+            claim_backoff = TRACE_CLAIM_RETRY_INTERVAL;
+            atomic_fetch_add_explicit(&segment->unassigned_drops, 1, memory_order_relaxed);
+            return;
+        }
+        local_trace_ring = ring;
+    }
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= TRACE_RING_CAPACITY) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    TraceEvent *event = &ring->events[head & (TRACE_RING_CAPACITY - 1)];
+    event->tick = simulation_clock_now(&shm_ptr->simulation_clock);
+    event->actor = (int32_t)actor;
+    event->type = (uint16_t)type;
+    event->object = (uint16_t)object;
+    event->arg = (int32_t)arg;
+    event->day = (uint32_t)shm_ptr->current_simulation_day;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+size_t trace_ring_drain(TraceRing *ring, TraceEvent *out, size_t max_events) {
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    size_t count = (size_t)(head - tail);
+    if (count > max_events) count = max_events;
+
+    for (size_t i = 0; i < count; i++) {
+        out[i] = ring->events[(tail + i) & (TRACE_RING_CAPACITY - 1)];
+    }
+
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+    return count;
+}
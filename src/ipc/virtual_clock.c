@@ -0,0 +1,113 @@
+/**
+ * @file virtual_clock.c
+ * @brief Implementazione dell'orologio virtuale condiviso.
+ *
+ * Protocollo anti lost-wakeup: il dormiente legge `epoch` PRIMA di confrontare
+ * now_ns con il proprio risveglio e si sospende solo se `epoch` non è
+ * cambiato; il Master pubblica now_ns, incrementa `epoch` e poi risveglia.
+ *
+ * @see virtual_clock.h per la documentazione delle funzioni pubbliche.
+ */
+
+/* Includes di sistema */
+#include <errno.h>
+#include <unistd.h>
+
+/* Includes del progetto */
+#include "futex.h"
+#include "virtual_clock.h"
+
+/** Orologio associato al processo (condiviso da tutti i thread). */
+static VirtualClock *bound_clock = NULL;
+
+/* ==========================================================================
+ *                          SEZIONE: FUNZIONI PRIVATE
+ * ========================================================================== */
+
+/** Occupa uno slot libero con il risveglio `wakeup_ns`. Ritorna l'indice o -1. */
+static int claim_wakeup_slot(VirtualClock *clock, long long wakeup_ns) {
+    /* Partenza dipendente dal TID per distribuire le CAS tra i chiamanti */
+    _Atomic long long *wakeups = virtual_clock_wakeups(clock);
+    int start = (int)(gettid() % clock->sleepers_count);
+
+    for (int i = 0; i < clock->sleepers_count; i++) {
+        int slot = (start + i) % clock->sleepers_count;
+        long long expected = VIRTUAL_CLOCK_NO_WAKEUP;
+        if (atomic_compare_exchange_strong(&wakeups[slot], &expected, wakeup_ns)) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+void virtual_clock_init(VirtualClock *clock, _Atomic long long *wakeups, int sleepers_count) {
+    clock->sleepers_count = sleepers_count;
+    clock->wakeups_offset = (char *)wakeups - (char *)clock;
+}
+
+void virtual_clock_bind(VirtualClock *clock) {
+    bound_clock = clock;
+}
+
+VirtualClock *virtual_clock_bound(void) {
+    return bound_clock;
+}
+
+void virtual_clock_gettime(const VirtualClock *clock, struct timespec *now) {
+    long long now_ns = atomic_load(&clock->now_ns);
+    now->tv_sec = (time_t)(now_ns / 1000000000LL);
+    now->tv_nsec = (long)(now_ns % 1000000000LL);
+}
+
+int virtual_clock_sleep(VirtualClock *clock, long long duration_ns, bool interruptible) {
+    if (duration_ns <= 0) return 0;
+
+    long long wakeup_ns = atomic_load(&clock->now_ns) + duration_ns;
+    int slot = claim_wakeup_slot(clock, wakeup_ns);
+    if (slot == -1) {
+        errno = ENOSPC;
+        return -1;
+    }
+
+    int result = 0;
+    for (;;) {
+        uint32_t seen = atomic_load(&clock->epoch);
+        if (atomic_load(&clock->now_ns) >= wakeup_ns) break;
+
+        if (futex_wait(&clock->epoch, seen) == -1 && errno == EINTR && interruptible) {
+            result = -1;
+            break;
+        }
+    }
+
+    atomic_store(&virtual_clock_wakeups(clock)[slot], VIRTUAL_CLOCK_NO_WAKEUP);
+    if (result == -1) errno = EINTR;
+    return result;
+}
+
+long long virtual_clock_next_wakeup(VirtualClock *clock) {
+    _Atomic long long *wakeups = virtual_clock_wakeups(clock);
+    long long now_ns = atomic_load(&clock->now_ns);
+    long long next = -1;
+
+    /* Gli slot già scaduti appartengono a dormienti svegliati ma non ancora ripartiti */
+    for (int i = 0; i < clock->sleepers_count; i++) {
+        long long wakeup_ns = atomic_load_explicit(&wakeups[i], memory_order_relaxed);
+        if (wakeup_ns > now_ns && (next == -1 || wakeup_ns < next)) {
+            next = wakeup_ns;
+        }
+    }
+    return next;
+}
+
+void virtual_clock_advance(VirtualClock *clock, long long target_ns) {
+    if (target_ns <= atomic_load(&clock->now_ns)) return;
+
+    atomic_store(&clock->now_ns, target_ns);
+    atomic_fetch_add(&clock->epoch, 1);
+    futex_wake_all(&clock->epoch);
+}
@@ -12,7 +12,6 @@
 #include <unistd.h>
 #include <signal.h>
 #include <string.h>
-#include <time.h>
 #include <errno.h>
 #include <sys/ipc.h>
 #include <sys/shm.h>
@@ -21,16 +20,21 @@
 #include "common.h"
 #include "shm.h"
 #include "sem.h"
+#include "mutex.h"
 #include "queue.h"
 #include "utils.h"
 #include "add_users.h"
 #include "ipc_keys.h"
+#include "user_zygote.h"
+#include "log.h"
 
 /* ==========================================================================
  *                             SEZIONE: MAIN
  * ========================================================================== */
 
 int main(int argc, char *argv[]) {
+    log_set_role(LOG_ROLE_TOOL);
+
     /* Validazione argomenti */
     if (argc > 3) {
         fprintf(stderr, "Uso: %s [numero_utenti]\n", argv[0]);
@@ -56,31 +60,31 @@ int main(int argc, char *argv[]) {
     }
 
     /* 4. Attesa autorizzazione */
-    printf("[DEBUG-ADD_USERS] Attendo permesso dal Master...\n");
+    LOG_DEBUG("[DEBUG-ADD_USERS] Attendo permesso dal Master...\n");
     if (wait_for_master_permission(shm) != 0) {
         return EXIT_FAILURE;
     }
-    printf("[DEBUG-ADD_USERS] Permesso ricevuto, current_total_users=%d, richiesti=%d\n",
-           shm->current_total_users, users_to_add);
+    LOG_DEBUG("[DEBUG-ADD_USERS] Permesso ricevuto, current_total_users=%d, richiesti=%d\n",
+              shm->current_total_users, users_to_add);
 
     /* 5. Spawn dei gruppi utenti */
-    printf("[DEBUG-ADD_USERS] Inizio spawn di %d utenti...\n", users_to_add);
+    LOG_DEBUG("[DEBUG-ADD_USERS] Inizio spawn di %d utenti...\n", users_to_add);
     int spawned = spawn_user_groups(shm, users_to_add);
-    printf("[DEBUG-ADD_USERS] Spawn completato: richiesti=%d, effettivi=%d\n", users_to_add, spawned);
+    LOG_DEBUG("[DEBUG-ADD_USERS] Spawn completato: richiesti=%d, effettivi=%d\n", users_to_add, spawned);
 
     /* 6. Aggiorna current_total_users con il numero EFFETTIVO di utenti spawnati */
-    reserve_sem(shm->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    lock_simulation_mutex(shm, MUTEX_SHARED_DATA);
     int old_total = shm->current_total_users;
     shm->current_total_users += spawned;
-    printf("[DEBUG-ADD_USERS] current_total_users: %d -> %d\n", old_total, shm->current_total_users);
-    release_sem(shm->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    LOG_DEBUG("[DEBUG-ADD_USERS] current_total_users: %d -> %d\n", old_total, shm->current_total_users);
+    unlock_simulation_mutex(shm, MUTEX_SHARED_DATA);
 
     /* 7. Sincronizzazione barriera: segnala spawn completato e attende via libera */
-    printf("[DEBUG-ADD_USERS] Chiamo sync_child_start su BARRIER_ADD_USERS...\n");
+    LOG_DEBUG("[DEBUG-ADD_USERS] Chiamo sync_child_start su BARRIER_ADD_USERS...\n");
     sync_child_start(shm->semaphore_sync_id, BARRIER_ADD_USERS_READY, BARRIER_ADD_USERS_GATE);
-    printf("[DEBUG-ADD_USERS] sync_child_start completato, gate aperto\n");
+    LOG_DEBUG("[DEBUG-ADD_USERS] sync_child_start completato, gate aperto\n");
 
-    printf("[ADD_USERS] Completato. %d utenti aggiunti.\n", spawned);
+    LOG_INFO("[ADD_USERS] Completato. %d utenti aggiunti.\n", spawned);
     return EXIT_SUCCESS;
 }
 
@@ -88,11 +92,21 @@ int main(int argc, char *argv[]) {
  *                    SEZIONE: IMPLEMENTAZIONE FUNZIONI
  * ========================================================================== */
 
-int find_free_group_index(MainSharedMemory *shm) {
+int claim_free_group_index(MainSharedMemory *shm, int group_size) {
     for (int i = 0; i < shm->group_pool_size; i++) {
-        if (shm->group_statuses[i].active_members == 0) {
-            return i;
+        /* Lettura senza lock per scartare gli slot occupati, conferma sotto lo stripe */
+        if (shm->group_statuses[i].active_members != 0) continue;
+
+        MutexSemaphoreIndex group_lock = group_mutex_index(i);
+        lock_simulation_mutex(shm, group_lock);
+        bool claimed = (shm->group_statuses[i].active_members == 0);
+        if (claimed) {
+            shm->group_statuses[i].active_members = group_size;
+            shm->group_statuses[i].group_leader_pid = 0;
         }
+        unlock_simulation_mutex(shm, group_lock);
+
+        if (claimed) return i;
     }
     return -1;
 }
@@ -107,7 +121,8 @@ int connect_to_simulation(MainSharedMemory **shm_out, int *shmid_out) {
 
     *shm_out = attach_to_simulation_shared_memory(shmid);
     *shmid_out = shmid;
-    srand(time(NULL) ^ getpid());
+    seed_random_stream((*shm_out)->configuration.random_seed, RANDOM_STREAM_ADD_USERS,
+                       (uint64_t)(*shm_out)->current_simulation_day);
     
     return 0;
 }
@@ -119,7 +134,7 @@ int parse_users_count(int argc, char *argv[], MainSharedMemory *shm) {
         users_to_add = atoi(argv[1]);
     } else {
         users_to_add = shm->configuration.quantities.number_of_new_users_batch;
-        printf("[ADD_USERS] Nessun valore specificato. Uso default: %d\n", users_to_add);
+        LOG_INFO("[ADD_USERS] Nessun valore specificato. Uso default: %d\n", users_to_add);
     }
 
     if (users_to_add <= 0) {
@@ -147,36 +162,28 @@ int send_add_users_request(MainSharedMemory *shm, int users_count) {
         return -1;
     }
 
-    printf("[ADD_USERS] Richiesti %d utenti. Attesa fine giornata...\n", users_count);
+    LOG_INFO("[ADD_USERS] Richiesti %d utenti. Attesa fine giornata...\n", users_count);
     return 0;
 }
 
 int wait_for_master_permission(MainSharedMemory *shm) {
-    printf("[ADD_USERS] In attesa del permesso dal Master...\n");
+    LOG_INFO("[ADD_USERS] In attesa del permesso dal Master...\n");
     
     if (reserve_sem(shm->semaphore_mutex_id, MUTEX_ADD_USERS_PERMISSION) == -1) {
         perror("[ERROR] Attesa permesso fallita");
         return -1;
     }
 
-    printf("[ADD_USERS] Autorizzazione ricevuta. Avvio spawn...\n");
+    LOG_INFO("[ADD_USERS] Autorizzazione ricevuta. Avvio spawn...\n");
     return 0;
 }
 
 void register_user_in_registry(MainSharedMemory *shm, pid_t pid, int group_index) {
-    reserve_sem(shm->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    lock_simulation_mutex(shm, MUTEX_USER_REGISTRY);
     
-    bool registered = false;
-    for (int r = 0; r < MAX_USERS_REGISTRY; r++) {
-        if (shm->user_registry[r].pid == 0) {
-            shm->user_registry[r].pid = pid;
-            shm->user_registry[r].group_index = group_index;
-            registered = true;
-            break;
-        }
-    }
+    bool registered = (user_registry_insert(&shm->user_registry, pid, group_index) != -1);
     
-    release_sem(shm->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    unlock_simulation_mutex(shm, MUTEX_USER_REGISTRY);
     
     if (!registered) {
         fprintf(stderr, "[WARNING] Registro pieno. PID %d non tracciato.\n", pid);
@@ -190,18 +197,18 @@ void spawn_single_user(MainSharedMemory *shm, int group_size,
     if (pid == 0) {
         setpgid(0, shm->process_group_pids[GROUP_USERS]);
 
-        char shm_str[24], gsize_str[24], gindex_str[24], is_leader_str[8], late_joiner_str[8];
+        char shm_str[24], gsize_str[24], gindex_str[24], member_str[12], late_joiner_str[8];
         sprintf(shm_str, "%d", shm->shared_memory_id);
         sprintf(gsize_str, "%d", group_size);
         sprintf(gindex_str, "%d", sync_index);
-        sprintf(is_leader_str, "%d", (member_index == 0));
+        sprintf(member_str, "%d", member_index);
         sprintf(late_joiner_str, "1"); /* Sempre late joiner quando creato da add_users */
 
-        printf("[DEBUG-SPAWN] Lancio utente con args: %s %s %s %s %s\n",
-               shm_str, gsize_str, gindex_str, is_leader_str, late_joiner_str);
+        LOG_DEBUG("[DEBUG-SPAWN] Lancio utente con args: %s %s %s %s %s\n",
+                  shm_str, gsize_str, gindex_str, member_str, late_joiner_str);
         fflush(stdout);
 
-        execl("./bin/utente", "utente", shm_str, gsize_str, gindex_str, is_leader_str, late_joiner_str, (char *)NULL);
+        execl("./bin/utente", "utente", shm_str, gsize_str, gindex_str, member_str, late_joiner_str, (char *)NULL);
         /* Se arriviamo qui, execl è fallita */
         char cwd[1024];
         getcwd(cwd, sizeof(cwd));
@@ -218,33 +225,60 @@ void spawn_single_user(MainSharedMemory *shm, int group_size,
 
 int spawn_user_groups(MainSharedMemory *shm, int total_users) {
     int users_spawned = 0;
-
-    while (users_spawned < total_users) {
-        int group_size = (rand() % MAX_USERS_PER_GROUP) + 1;
-        if (users_spawned + group_size > total_users) {
-            group_size = total_users - users_spawned;
+    int users_planned = 0;
+#ifdef USE_USER_ZYGOTE
+    /* Gruppi accumulati e inviati allo zygote a lotti */
+    ZygoteGroupRequest batch[ZYGOTE_BATCH_MAX_GROUPS];
+    int batch_count = 0;
+    int batch_users = 0;
+#endif
+
+    while (users_planned < total_users) {
+        int group_size = generate_random_integer(1, MAX_USERS_PER_GROUP);
+        if (users_planned + group_size > total_users) {
+            group_size = total_users - users_planned;
         }
 
-        reserve_sem(shm->semaphore_mutex_id, MUTEX_SHARED_DATA);
-        int sync_index = find_free_group_index(shm);
+        int sync_index = claim_free_group_index(shm, group_size);
         
         if (sync_index == -1) {
             fprintf(stderr, "[ERROR] Pool gruppi saturo.\n");
-            release_sem(shm->semaphore_mutex_id, MUTEX_SHARED_DATA);
             break;
         }
-        
-        shm->group_statuses[sync_index].active_members = group_size;
-        shm->group_statuses[sync_index].group_leader_pid = 0;
-        release_sem(shm->semaphore_mutex_id, MUTEX_SHARED_DATA);
 
+#ifdef USE_USER_ZYGOTE
+        batch[batch_count].group_size = group_size;
+        batch[batch_count].group_index = sync_index;
+        batch[batch_count].is_late_joiner = 1; /* Sempre late joiner quando creato da add_users */
+        batch_count++;
+        batch_users += group_size;
+
+        /* Gli utenti contano come spawnati solo a lotto consegnato */
+        if (batch_count == ZYGOTE_BATCH_MAX_GROUPS) {
+            if (user_zygote_request_groups(shm, batch, batch_count) == -1) {
+                batch_count = 0;
+                break;
+            }
+            users_spawned += batch_users;
+            batch_count = 0;
+            batch_users = 0;
+        }
+#else
         for (int i = 0; i < group_size; i++) {
-            printf("Creo un utente\n");
+            LOG_DEBUG("Creo un utente\n");
             spawn_single_user(shm, group_size, sync_index, i);
         }
         
         users_spawned += group_size;
+#endif
+        users_planned += group_size;
+    }
+
+#ifdef USE_USER_ZYGOTE
+    if (batch_count > 0 && user_zygote_request_groups(shm, batch, batch_count) == 0) {
+        users_spawned += batch_users;
     }
+#endif
 
     return users_spawned;
 }
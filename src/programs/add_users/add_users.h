@@ -22,10 +22,16 @@
  * ========================================================================== */
 
 /**
- * @brief Cerca uno slot libero nel pool di sincronizzazione gruppi.
- * @return Indice del gruppo libero o -1 se pieno.
+ * @brief Cerca uno slot libero nel pool di sincronizzazione gruppi e lo occupa.
+ *
+ * Lo slot è confermato e assegnato sotto il solo stripe del gruppo, lo stesso
+ * lock con cui gli utenti decrementano active_members: due add_users
+ * concorrenti non possono occupare lo stesso slot e non serve MUTEX_SHARED_DATA.
+ *
+ * @param group_size Membri del nuovo gruppo (active_members iniziale).
+ * @return Indice del gruppo occupato o -1 se il pool è pieno.
  */
-int find_free_group_index(MainSharedMemory *shm);
+int claim_free_group_index(MainSharedMemory *shm, int group_size);
 
 /**
  * @brief Connette alla memoria condivisa della simulazione tramite ftok.
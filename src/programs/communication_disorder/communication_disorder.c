@@ -25,6 +25,7 @@
 #include "sem.h"
 #include "communication_disorder.h"
 #include "ipc_keys.h"
+#include "log.h"
 
 /* ==========================================================================
  *                             SEZIONE: MAIN
@@ -34,7 +35,8 @@ int main(int argc, char *argv[]) {
     (void)argc;
     (void)argv;
     
-    printf("[DISORDER] Communication Disorder in avvio...\n");
+    log_set_role(LOG_ROLE_TOOL);
+    LOG_INFO("[DISORDER] Communication Disorder in avvio...\n");
 
     /* 1. Connessione alla simulazione */
     MainSharedMemory *shm;
@@ -45,7 +47,7 @@ int main(int argc, char *argv[]) {
 
     /* 2. Lettura configurazione */
     int stop_duration = shm->configuration.timings.stop_duration_minutes;
-    printf("[DISORDER] Durata blocco casse: %d secondi.\n", stop_duration);
+    LOG_INFO("[DISORDER] Durata blocco casse: %d secondi.\n", stop_duration);
 
     /* 3. Esecuzione Disorder */
     trigger_disorder(shm, stop_duration);
@@ -76,22 +78,22 @@ int connect_to_simulation(MainSharedMemory **shm_out, int *shmid_out) {
 
 void trigger_disorder(MainSharedMemory *shm, int duration_seconds) {
     /* 1. Blocco casse: V() sul semaforo stop */
-    printf("[DISORDER] ATTIVAZIONE BLOCCO CASSE...\n");
+    LOG_INFO("[DISORDER] ATTIVAZIONE BLOCCO CASSE...\n");
     if (release_sem(shm->register_station.semaphore_set_id, STATION_SEM_STOP_GATE) == -1) {
         perror("[ERROR] Impossibile attivare blocco casse");
         return;
     }
     
-    printf("[DISORDER] Casse BLOCCATE. Attesa di %d secondi...\n", duration_seconds);
+    LOG_INFO("[DISORDER] Casse BLOCCATE. Attesa di %d secondi...\n", duration_seconds);
 
     /* 2. Attesa (simulazione durata guasto) */
     sleep(duration_seconds);
 
     /* 3. Ripristino casse: P() sul semaforo stop */
-    printf("[DISORDER] RIPRISTINO CASSE...\n");
+    LOG_INFO("[DISORDER] RIPRISTINO CASSE...\n");
     if (reserve_sem(shm->register_station.semaphore_set_id, STATION_SEM_STOP_GATE) == -1) {
         perror("[ERROR] Impossibile rimuovere blocco casse");
     } else {
-        printf("[DISORDER] Casse RIPRISTINATE. Operatività normale.\n");
+        LOG_INFO("[DISORDER] Casse RIPRISTINATE. Operatività normale.\n");
     }
 }
@@ -0,0 +1,155 @@
+/**
+ * @file mensa_series.c
+ * @brief Utility esterna che converte la serie temporale del Master in CSV.
+ *
+ * Il file viene mappato in sola lettura; si convertono i record indicati da
+ * record_count, quindi anche un file non troncato (Master terminato in modo
+ * anomalo) o ancora in scrittura è leggibile.
+ *
+ * @see mensa_series.h per l'uso.
+ */
+
+/* Includes di sistema */
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Includes del progetto */
+#include "mensa_series.h"
+#include "log.h"
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Suffissi delle colonne per stazione (StationChannelIndex) */
+static const char *const station_keys[LIVE_STATION_COUNT] = {
+    "first", "second", "coffee", "cashier"
+};
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI PRIVATI
+ * ========================================================================== */
+
+static void write_csv_header(const TimeSeriesHeader *header, FILE *out);
+static void write_csv_record(const TimeSeriesHeader *header, const TimeSeriesRecord *record, FILE *out);
+
+/* ==========================================================================
+ *                             SEZIONE: MAIN
+ * ========================================================================== */
+
+int main(int argc, char *argv[]) {
+    log_set_role(LOG_ROLE_TOOL);
+
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s <file> [csv]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE *out = stdout;
+    if (argc >= 3) {
+        out = fopen(argv[2], "w");
+        if (out == NULL) {
+            perror("[ERROR] Apertura file CSV fallita");
+            return EXIT_FAILURE;
+        }
+    }
+
+    int result = convert_timeseries_to_csv(argv[1], out);
+    if (out != stdout) {
+        fclose(out);
+        if (result == 0) LOG_INFO("[SERIES] CSV scritto su %s.\n", argv[2]);
+    }
+    return (result == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE FUNZIONI
+ * ========================================================================== */
+
+int convert_timeseries_to_csv(const char *path, FILE *out) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        perror("[ERROR] Apertura serie temporale fallita");
+        return -1;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == -1 || (size_t)info.st_size < sizeof(TimeSeriesHeader)) {
+        fprintf(stderr, "[ERROR] %s non è una serie temporale valida.\n", path);
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("[ERROR] mmap serie temporale fallita");
+        return -1;
+    }
+
+    const TimeSeriesHeader *header = (const TimeSeriesHeader *)map;
+    size_t available = ((size_t)info.st_size - sizeof(TimeSeriesHeader)) / sizeof(TimeSeriesRecord);
+    if (memcmp(header->magic, TIMESERIES_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != TIMESERIES_FILE_VERSION || header->record_size != sizeof(TimeSeriesRecord) ||
+        header->dish_counts[0] > MAX_DISHES_PER_CATEGORY || header->dish_counts[1] > MAX_DISHES_PER_CATEGORY) {
+        fprintf(stderr, "[ERROR] %s non è una serie temporale valida.\n", path);
+        munmap(map, (size_t)info.st_size);
+        return -1;
+    }
+
+    size_t count = header->record_count;
+    if (count > available) count = available;
+
+    const TimeSeriesRecord *records = (const TimeSeriesRecord *)((const char *)map + sizeof(TimeSeriesHeader));
+    write_csv_header(header, out);
+    for (size_t i = 0; i < count; i++) {
+        write_csv_record(header, &records[i], out);
+    }
+
+    /* Diagnostica su stderr: stdout può essere il CSV stesso */
+    if (header->dropped > 0) {
+        fprintf(stderr, "[SERIES] Attenzione: %u campioni scartati a file pieno.\n", header->dropped);
+    }
+    munmap(map, (size_t)info.st_size);
+    return 0;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+static void write_csv_header(const TimeSeriesHeader *header, FILE *out) {
+    fprintf(out, "day,minute,tick");
+    for (int i = 0; i < LIVE_STATION_COUNT; i++) fprintf(out, ",queue_%s", station_keys[i]);
+    for (int i = 0; i < LIVE_STATION_COUNT; i++) fprintf(out, ",busy_%s", station_keys[i]);
+    fprintf(out, ",active_operators");
+    for (int c = 0; c < 2; c++) {
+        for (uint32_t d = 0; d < header->dish_counts[c]; d++) {
+            fprintf(out, ",portions_%s_%.*s", station_keys[c], MAX_DISH_NAME_LENGTH, header->dish_names[c][d]);
+        }
+    }
+    fprintf(out, ",occupied_seats,tables_in_use,waiting_groups,users,served_total,not_served_total\n");
+}
+
+static void write_csv_record(const TimeSeriesHeader *header, const TimeSeriesRecord *record, FILE *out) {
+    int active_operators = 0;
+
+    fprintf(out, "%d,%d,%llu", record->day + 1, record->minute, (unsigned long long)record->tick);
+    for (int i = 0; i < LIVE_STATION_COUNT; i++) fprintf(out, ",%d", record->pending_orders[i]);
+    for (int i = 0; i < LIVE_STATION_COUNT; i++) {
+        fprintf(out, ",%d", record->busy_posts[i]);
+        active_operators += record->busy_posts[i];
+    }
+    fprintf(out, ",%d", active_operators);
+    for (int c = 0; c < 2; c++) {
+        for (uint32_t d = 0; d < header->dish_counts[c]; d++) {
+            fprintf(out, ",%d", record->portions[c][d]);
+        }
+    }
+    fprintf(out, ",%d,%d,%d,%d,%d,%d\n", record->occupied_seats, record->tables_in_use, record->waiting_groups,
+            record->total_users, record->clients_served_total, record->clients_not_served_total);
+}
@@ -0,0 +1,29 @@
+/**
+ * @file mensa_series.h
+ * @brief Header per l'utility mensa_series (conversione della serie temporale in CSV).
+ *
+ * Uso: `mensa_series <file> [csv]`. Senza destinazione il CSV va su stdout.
+ * Una riga per campione: code e operatori per stazione, porzioni per piatto,
+ * tavoli, utenti e clienti serviti/rinunciatari cumulativi.
+ *
+ * @see timeseries.h per il formato del file.
+ * @see mensa_series.c per l'implementazione.
+ */
+
+#ifndef MENSA_SERIES_H
+#define MENSA_SERIES_H
+
+#include <stdio.h>
+#include "timeseries.h"
+
+/* ==========================================================================
+ *                       SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Converte il file della serie temporale `path` in CSV su `out`.
+ * @return 0 successo, -1 errore (file assente o formato non valido).
+ */
+int convert_timeseries_to_csv(const char *path, FILE *out);
+
+#endif /* MENSA_SERIES_H */
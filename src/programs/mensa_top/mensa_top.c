@@ -0,0 +1,164 @@
+/**
+ * @file mensa_top.c
+ * @brief Monitor live in sola lettura di una simulazione in corso.
+ *
+ * Protocollo:
+ * 1. Aggancio della SHM con SHM_RDONLY (nessuna scrittura possibile).
+ * 2. A ogni intervallo: copia dell'istantanea via seqlock e stampa.
+ * 3. Uscita alla fine della simulazione, a SIGINT o dopo N aggiornamenti.
+ *
+ * @see mensa_top.h per l'uso.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+/* Includes del progetto */
+#include "common.h"
+#include "shm.h"
+#include "ipc_keys.h"
+#include "station_channel.h"
+#include "mensa_top.h"
+#include "log.h"
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Etichette dei punti di servizio, allineate alla colonna (StationChannelIndex) */
+static const char *const station_labels[LIVE_STATION_COUNT] = {
+    "Primi:     ", "Secondi:   ", "Caffè/D:   ", "Cassa:     "
+};
+
+/** Flag di arresto del monitor (SIGINT/SIGTERM). */
+static volatile sig_atomic_t stop_requested = 0;
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI PRIVATI
+ * ========================================================================== */
+
+static void handle_stop_signal(int sig);
+static void print_station_portions(const MenuDish *dishes, const LiveStationView *view);
+
+/* ==========================================================================
+ *                             SEZIONE: MAIN
+ * ========================================================================== */
+
+int main(int argc, char *argv[]) {
+    log_set_role(LOG_ROLE_TOOL);
+
+    int interval_ms = (argc > 1) ? atoi(argv[1]) : MENSA_TOP_DEFAULT_INTERVAL_MS;
+    int refreshes = (argc > 2) ? atoi(argv[2]) : 0;
+    if (interval_ms <= 0 || refreshes < 0) {
+        fprintf(stderr, "Uso: %s [intervallo_ms] [aggiornamenti]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const MainSharedMemory *shm = connect_to_simulation_read_only();
+    if (shm == NULL) {
+        return EXIT_FAILURE;
+    }
+    log_bind_levels(shm->configuration.log_levels);
+
+    struct sigaction sa;
+    sa.sa_handler = handle_stop_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    /* Lo schermo si ridisegna solo su terminale; su file le schermate si accodano */
+    bool redraw = isatty(STDOUT_FILENO);
+    pid_t master_pid = shm->master_pid;
+    struct timespec interval = { interval_ms / 1000, (long)(interval_ms % 1000) * 1000000L };
+
+    for (int shown = 0; !stop_requested && (refreshes == 0 || shown < refreshes); shown++) {
+        if (!shm->is_simulation_running || kill(master_pid, 0) == -1) break;
+
+        LiveStatisticsData data;
+        if (redraw) printf("\033[H\033[2J");
+        if (live_statistics_read(&shm->live_statistics, &data) == 0) {
+            render_live_statistics(shm, &data);
+        } else {
+            printf("[MENSA TOP] In attesa della prima istantanea dal Master...\n");
+        }
+        fflush(stdout);
+
+        nanosleep(&interval, NULL);
+    }
+
+    LOG_INFO("[MENSA TOP] Monitor terminato.\n");
+    detach_shared_memory_segment(shm);
+    return EXIT_SUCCESS;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE FUNZIONI
+ * ========================================================================== */
+
+const MainSharedMemory *connect_to_simulation_read_only(void) {
+    int shmid = shmget(IPC_KEY_SHARED_MEMORY, 0, 0);
+    if (shmid == -1) {
+        fprintf(stderr, "[ERROR] Impossibile trovare la memoria condivisa.\n");
+        fprintf(stderr, "La simulazione è stata avviata?\n");
+        return NULL;
+    }
+    return (const MainSharedMemory *)attach_shared_memory_segment(shmid, true);
+}
+
+void render_live_statistics(const MainSharedMemory *shm, const LiveStatisticsData *data) {
+    printf("=== MENSA TOP === Giorno %d, minuto %d (tick %llu) | Utenti: %d\n",
+           data->day + 1, data->minute, data->tick, data->total_users);
+
+    printf("\n[STAZIONI]\n");
+    printf("  Stazione:  | In coda | Postazioni occupate | Porzioni residue\n");
+    printf("  -----------|---------|---------------------|-----------------\n");
+    for (int i = 0; i < LIVE_STATION_COUNT; i++) {
+        const LiveStationView *view = &data->stations[i];
+        int portions = 0;
+        for (int d = 0; d < view->dish_count; d++) portions += view->portions[d];
+
+        printf("  %s| %7d | %9d / %-7d | ", station_labels[i], view->pending_orders,
+               view->busy_posts, view->total_posts);
+        if (view->dish_count > 0) printf("%16d\n", portions);
+        else printf("%16s\n", "-");
+    }
+
+    printf("\n[PORZIONI PER PIATTO]\n");
+    print_station_portions(shm->food_menu.first_courses, &data->stations[STATION_CHANNEL_FIRST_COURSE]);
+    print_station_portions(shm->food_menu.second_courses, &data->stations[STATION_CHANNEL_SECOND_COURSE]);
+
+    double seat_occupancy = (data->total_seats > 0) ? (double)data->occupied_seats * 100.0 / data->total_seats : 0.0;
+    printf("\n[TAVOLI]\n");
+    printf("  Tavoli in uso:      %d / %d\n", data->tables_in_use, data->tables_count);
+    printf("  Posti occupati:     %d / %d (%.1f%%)\n", data->occupied_seats, data->total_seats, seat_occupancy);
+    printf("  Gruppi in attesa:   %d\n", data->waiting_groups);
+
+    printf("\n[CLIENTI OGGI]\n");
+    printf("  Serviti:            %d\n", data->clients_served_today);
+    printf("  Rinunce:            %d\n", data->clients_not_served_today);
+    printf("  Throughput:         %.2f clienti/min (ultimi %d min)\n",
+           data->throughput_per_minute, data->throughput_window_minutes);
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+static void handle_stop_signal(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+/** Una riga per piatto con le porzioni residue. */
+static void print_station_portions(const MenuDish *dishes, const LiveStationView *view) {
+    for (int d = 0; d < view->dish_count; d++) {
+        printf("  %-40s %5d\n", dishes[d].name, view->portions[d]);
+    }
+}
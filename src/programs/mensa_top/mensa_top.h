@@ -0,0 +1,43 @@
+/**
+ * @file mensa_top.h
+ * @brief Header per l'utility mensa_top (monitor live in sola lettura).
+ *
+ * Uso: `mensa_top [intervallo_ms] [aggiornamenti]` (default 1000 ms, 0 = fino
+ * alla fine della simulazione). A ogni aggiornamento stampa code, postazioni
+ * occupate, porzioni residue, occupazione dei tavoli e throughput mobile
+ * dall'istantanea pubblicata dal Master (live_statistics.h).
+ *
+ * La SHM è agganciata con SHM_RDONLY e l'istantanea è letta tramite seqlock:
+ * il monitor non prende lock, non scrive in SHM e non invia segnali.
+ *
+ * @see mensa_top.c per l'implementazione.
+ */
+
+#ifndef MENSA_TOP_H
+#define MENSA_TOP_H
+
+#include "common.h"
+
+/* ==========================================================================
+ *                           SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/** Intervallo di aggiornamento predefinito (millisecondi reali) */
+#define MENSA_TOP_DEFAULT_INTERVAL_MS 1000
+
+/* ==========================================================================
+ *                       SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Aggancia in sola lettura la memoria condivisa della simulazione.
+ * @return Il segmento agganciato, o NULL se la simulazione non è attiva.
+ */
+const MainSharedMemory *connect_to_simulation_read_only(void);
+
+/**
+ * @brief Stampa una schermata dell'istantanea.
+ */
+void render_live_statistics(const MainSharedMemory *shm, const LiveStatisticsData *data);
+
+#endif /* MENSA_TOP_H */
@@ -0,0 +1,411 @@
+/**
+ * @file mensa_trace.c
+ * @brief Utility esterna per registrare e decodificare le tracce eventi.
+ *
+ * Registrazione:
+ * 1. Connessione alla SHM e al segmento delle ring (trace.h).
+ * 2. Accensione di trace_enabled e drain periodico delle ring su file.
+ * 3. Alla terminazione del Master (o a SIGINT): ultimo drain e spegnimento.
+ *
+ * Decodifica: gli eventi vengono ordinati per attore e tick, poi accoppiati
+ * (ingresso/uscita fase, accodamento/prelievo ordine) per ricavare durate
+ * di fase e attese in coda per stazione.
+ *
+ * @see mensa_trace.h per i comandi e il formato del file.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+/* Includes del progetto */
+#include "common.h"
+#include "shm.h"
+#include "ipc_keys.h"
+#include "mensa_trace.h"
+#include "log.h"
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Numero di stazioni/canali distinti negli eventi (StationChannelIndex) */
+#define TRACE_STATION_COUNT 4
+
+static const char *const station_names[TRACE_STATION_COUNT] = {
+    "Primi", "Secondi", "Caffe/Dolci", "Cassa"
+};
+
+static const char *const phase_names[TRACE_PHASE_COUNT] = {
+    "ticket", "primi", "secondi", "riunione", "cassa", "tavolo", "pasto", "caffe", "uscita"
+};
+
+static const char *const event_names[TRACE_EVENT_TYPE_COUNT] = {
+    "?", "ENTRA", "ESCE", "ACCODA", "PRELEVATO", "LOCK_WAIT", "REFILL", "INIZIO_GIORNO", "FINE_GIORNO"
+};
+
+/** Accumulatore di durate (tick o microsecondi). */
+typedef struct {
+    unsigned long count;
+    unsigned long long sum;
+    unsigned long long max;
+} DurationSummary;
+
+/** Flag di arresto della registrazione (SIGINT/SIGTERM). */
+static volatile sig_atomic_t stop_requested = 0;
+
+/* Array di eventi decodificati, per il confronto di qsort */
+static const TraceEvent *sort_events = NULL;
+
+/* ==========================================================================
+ *                         SEZIONE: PROTOTIPI PRIVATI
+ * ========================================================================== */
+
+static void handle_stop_signal(int sig);
+static size_t drain_all_rings(TraceSegment *segment, FILE *out);
+static void add_duration(DurationSummary *summary, unsigned long long value);
+static int compare_by_actor_and_tick(const void *a, const void *b);
+static const char *event_object_name(const TraceEvent *event);
+
+/* ==========================================================================
+ *                             SEZIONE: MAIN
+ * ========================================================================== */
+
+int main(int argc, char *argv[]) {
+    log_set_role(LOG_ROLE_TOOL);
+
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s on|off|record <file>|decode <file> [timeline]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (strcmp(argv[1], "decode") == 0 && argc >= 3) {
+        bool timelines = (argc >= 4 && strcmp(argv[3], "timeline") == 0);
+        return decode_trace(argv[2], timelines) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    MainSharedMemory *shm;
+    int shmid;
+    if (connect_to_simulation(&shm, &shmid) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_SUCCESS;
+    if (strcmp(argv[1], "on") == 0 || strcmp(argv[1], "off") == 0) {
+        int enable = (strcmp(argv[1], "on") == 0);
+        atomic_store(&shm->trace_enabled, enable);
+        LOG_INFO("[TRACE] Tracciamento %s.\n", enable ? "attivato" : "disattivato");
+    } else if (strcmp(argv[1], "record") == 0 && argc >= 3) {
+        result = (record_trace(shm, argv[2]) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    } else {
+        fprintf(stderr, "Uso: %s on|off|record <file>|decode <file> [timeline]\n", argv[0]);
+        result = EXIT_FAILURE;
+    }
+
+    detach_shared_memory_segment(shm);
+    return result;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE FUNZIONI
+ * ========================================================================== */
+
+int connect_to_simulation(MainSharedMemory **shm_out, int *shmid_out) {
+    int shmid = shmget(IPC_KEY_SHARED_MEMORY, 0, 0);
+    if (shmid == -1) {
+        fprintf(stderr, "[ERROR] Impossibile trovare la memoria condivisa.\n");
+        fprintf(stderr, "La simulazione è stata avviata?\n");
+        return -1;
+    }
+
+    *shm_out = attach_to_simulation_shared_memory(shmid);
+    *shmid_out = shmid;
+
+    return 0;
+}
+
+int record_trace(MainSharedMemory *shm, const char *path) {
+    TraceSegment *segment = (TraceSegment *)attach_shared_memory_segment(shm->trace_shared_memory_id, false);
+    if (segment == NULL) {
+        return -1;
+    }
+
+    FILE *out = fopen(path, "wb");
+    if (out == NULL) {
+        perror("[ERROR] Apertura file di traccia fallita");
+        detach_shared_memory_segment(segment);
+        return -1;
+    }
+
+    TraceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_FILE_VERSION;
+    header.event_size = sizeof(TraceEvent);
+    header.tick_ns = shm->simulation_clock.tick_ns;
+    header.ticks_per_minute = shm->simulation_clock.ticks_per_minute;
+    fwrite(&header, sizeof(header), 1, out);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    /* Eventi rimasti da una sessione precedente sono comunque validi: si parte dal drain */
+    pid_t master_pid = shm->master_pid;
+    atomic_store(&shm->trace_enabled, 1);
+    LOG_INFO("[TRACE] Registrazione su %s (Master PID %d). Ctrl+C per terminare.\n", path, master_pid);
+
+    size_t written = 0;
+    struct timespec interval = {0, TRACE_DRAIN_INTERVAL_NS};
+    while (!stop_requested && kill(master_pid, 0) == 0) {
+        written += drain_all_rings(segment, out);
+        nanosleep(&interval, NULL);
+    }
+
+    atomic_store(&shm->trace_enabled, 0);
+    written += drain_all_rings(segment, out);
+    fclose(out);
+
+    unsigned long long dropped = atomic_load(&segment->unassigned_drops);
+    for (int i = 0; i < segment->rings_count; i++) {
+        dropped += atomic_load(&segment->rings[i].dropped);
+    }
+    LOG_INFO("[TRACE] Registrazione conclusa: %zu eventi scritti, %llu scartati.\n", written, dropped);
+
+    detach_shared_memory_segment(segment);
+    return 0;
+}
+
+int decode_trace(const char *path, bool print_timelines) {
+    FILE *in = fopen(path, "rb");
+    if (in == NULL) {
+        perror("[ERROR] Apertura file di traccia fallita");
+        return -1;
+    }
+
+    TraceFileHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        memcmp(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRACE_FILE_VERSION || header.event_size != sizeof(TraceEvent)) {
+        fprintf(stderr, "[ERROR] %s non è un file di traccia valido.\n", path);
+        fclose(in);
+        return -1;
+    }
+    double ticks_per_minute = header.ticks_per_minute > 0 ? header.ticks_per_minute : 1;
+
+    /* Lettura completa degli eventi */
+    size_t capacity = 4096, count = 0;
+    TraceEvent *events = malloc(capacity * sizeof(TraceEvent));
+    while (events != NULL) {
+        if (count == capacity) {
+            capacity *= 2;
+            TraceEvent *grown = realloc(events, capacity * sizeof(TraceEvent));
+            if (grown == NULL) {
+                free(events);
+                events = NULL;
+                break;
+            }
+            events = grown;
+        }
+        size_t n = fread(&events[count], sizeof(TraceEvent), capacity - count, in);
+        count += n;
+        if (n == 0) break;
+    }
+    fclose(in);
+
+    size_t *order = events != NULL ? malloc((count + 1) * sizeof(size_t)) : NULL;
+    if (order == NULL) {
+        fprintf(stderr, "[ERROR] Memoria insufficiente per %zu eventi.\n", count);
+        free(events);
+        return -1;
+    }
+    /* Tick di apertura di ogni giornata (timeline in minuti dall'apertura) */
+    uint32_t days = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (events[i].day + 1 > days) days = events[i].day + 1;
+    }
+    uint64_t *day_start = calloc(days + 1, sizeof(uint64_t));
+    if (day_start == NULL) {
+        free(order);
+        free(events);
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (events[i].type == TRACE_EVENT_DAY_START) day_start[events[i].day] = events[i].tick;
+    }
+
+    for (size_t i = 0; i < count; i++) order[i] = i;
+    sort_events = events;
+    qsort(order, count, sizeof(size_t), compare_by_actor_and_tick);
+
+    /* Accoppiamento per attore: fasi e attese in coda */
+    unsigned long type_counts[TRACE_EVENT_TYPE_COUNT] = {0};
+    DurationSummary phases[TRACE_PHASE_COUNT] = {{0}};
+    DurationSummary queue_waits[TRACE_STATION_COUNT] = {{0}};
+    DurationSummary lock_waits[MUTEX_SEMAPHORE_COUNT] = {{0}};
+    unsigned long enqueues[TRACE_STATION_COUNT] = {0};
+    unsigned long refills[TRACE_STATION_COUNT] = {0};
+    const TraceEvent *phase_open[TRACE_PHASE_COUNT];
+    const TraceEvent *enqueue_open[TRACE_STATION_COUNT];
+
+    for (size_t i = 0; i < count; i++) {
+        const TraceEvent *ev = &events[order[i]];
+        if (i == 0 || ev->actor != events[order[i - 1]].actor) {
+            memset(phase_open, 0, sizeof(phase_open));
+            memset(enqueue_open, 0, sizeof(enqueue_open));
+            if (print_timelines) printf("\nAttore %d:\n", ev->actor);
+        }
+        if (ev->type < TRACE_EVENT_TYPE_COUNT) type_counts[ev->type]++;
+
+        switch (ev->type) {
+            case TRACE_EVENT_PHASE_ENTER:
+                if (ev->object < TRACE_PHASE_COUNT) phase_open[ev->object] = ev;
+                break;
+            case TRACE_EVENT_PHASE_EXIT:
+                if (ev->object < TRACE_PHASE_COUNT && phase_open[ev->object] != NULL &&
+                    phase_open[ev->object]->day == ev->day) {
+                    add_duration(&phases[ev->object], ev->tick - phase_open[ev->object]->tick);
+                }
+                if (ev->object < TRACE_PHASE_COUNT) phase_open[ev->object] = NULL;
+                break;
+            case TRACE_EVENT_ENQUEUE:
+                if (ev->object < TRACE_STATION_COUNT) {
+                    enqueues[ev->object]++;
+                    enqueue_open[ev->object] = ev;
+                }
+                break;
+            case TRACE_EVENT_DEQUEUE:
+                if (ev->object < TRACE_STATION_COUNT && enqueue_open[ev->object] != NULL &&
+                    enqueue_open[ev->object]->day == ev->day) {
+                    add_duration(&queue_waits[ev->object], ev->tick - enqueue_open[ev->object]->tick);
+                }
+                if (ev->object < TRACE_STATION_COUNT) enqueue_open[ev->object] = NULL;
+                break;
+            case TRACE_EVENT_LOCK_WAIT:
+                if (ev->object < MUTEX_SEMAPHORE_COUNT) add_duration(&lock_waits[ev->object], (unsigned long long)ev->arg);
+                break;
+            case TRACE_EVENT_REFILL:
+                if (ev->object < TRACE_STATION_COUNT) refills[ev->object]++;
+                break;
+            default:
+                break;
+        }
+
+        if (print_timelines) {
+            printf("  g%-2u %9.2f min  %-13s %-12s arg=%d\n", ev->day + 1,
+                   (ev->tick - day_start[ev->day]) / ticks_per_minute,
+                   ev->type < TRACE_EVENT_TYPE_COUNT ? event_names[ev->type] : "?",
+                   event_object_name(ev), ev->arg);
+        }
+    }
+
+    /* Riepiloghi */
+    printf("\n========== TRACCIA %s ==========\n", path);
+    printf("Eventi: %zu (tick = %.3f ms, %d tick/min)\n", count, header.tick_ns / 1e6, header.ticks_per_minute);
+    for (int t = 1; t < TRACE_EVENT_TYPE_COUNT; t++) {
+        printf("  %-13s %lu\n", event_names[t], type_counts[t]);
+    }
+
+    printf("\n--- Stazioni (attesa in coda, minuti simulati) ---\n");
+    for (int s = 0; s < TRACE_STATION_COUNT; s++) {
+        DurationSummary *q = &queue_waits[s];
+        printf("  %-12s accodati: %-6lu prelevati: %-6lu attesa media: %6.2f  max: %6.2f  refill: %lu\n",
+               station_names[s], enqueues[s], q->count,
+               q->count ? (q->sum / ticks_per_minute) / q->count : 0.0, q->max / ticks_per_minute, refills[s]);
+    }
+
+    printf("\n--- Fasi utente (durata, minuti simulati) ---\n");
+    for (int p = 0; p < TRACE_PHASE_COUNT; p++) {
+        DurationSummary *d = &phases[p];
+        printf("  %-10s n: %-6lu media: %6.2f  max: %6.2f\n", phase_names[p], d->count,
+               d->count ? (d->sum / ticks_per_minute) / d->count : 0.0, d->max / ticks_per_minute);
+    }
+
+    printf("\n--- Attese sui mutex globali (microsecondi reali) ---\n");
+    for (int m = 0; m < MUTEX_SEMAPHORE_COUNT; m++) {
+        DurationSummary *l = &lock_waits[m];
+        if (l->count == 0) continue;
+        printf("  mutex %-3d n: %-6lu media: %8.1f  max: %llu\n", m, l->count, (double)l->sum / l->count, l->max);
+    }
+
+    free(day_start);
+    free(order);
+    free(events);
+    return 0;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+static void handle_stop_signal(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+/** Svuota tutte le ring sul file; restituisce il numero di eventi scritti. */
+static size_t drain_all_rings(TraceSegment *segment, FILE *out) {
+    static TraceEvent buffer[TRACE_RING_CAPACITY];
+    size_t total = 0;
+
+    for (int i = 0; i < segment->rings_count; i++) {
+        size_t n = trace_ring_drain(&segment->rings[i], buffer, TRACE_RING_CAPACITY);
+        if (n > 0) {
+            fwrite(buffer, sizeof(TraceEvent), n, out);
+            total += n;
+        }
+    }
+    return total;
+}
+
+static void add_duration(DurationSummary *summary, unsigned long long value) {
+    summary->count++;
+    summary->sum += value;
+    if (value > summary->max) summary->max = value;
+}
+
+/**
+ * Ordine per attore, poi tick, poi posizione nel file (ordine di scrittura
+ * nella ring). Il prelievo arriva dalla ring dell'operatore, che può essere
+ * svuotata prima di quella dell'utente: a parità di tick va dopo l'accodamento.
+ */
+static int compare_by_actor_and_tick(const void *a, const void *b) {
+    size_t ia = *(const size_t *)a, ib = *(const size_t *)b;
+    const TraceEvent *ea = &sort_events[ia], *eb = &sort_events[ib];
+
+    if (ea->actor != eb->actor) return ea->actor < eb->actor ? -1 : 1;
+    if (ea->tick != eb->tick) return ea->tick < eb->tick ? -1 : 1;
+    int da = (ea->type == TRACE_EVENT_DEQUEUE), db = (eb->type == TRACE_EVENT_DEQUEUE);
+    if (da != db) return da - db;
+    return ia < ib ? -1 : (ia > ib);
+}
+
+/** Nome dell'oggetto di un evento (fase, stazione o mutex). */
+static const char *event_object_name(const TraceEvent *event) {
+    static char mutex_name[16];
+
+    switch (event->type) {
+        case TRACE_EVENT_PHASE_ENTER:
+        case TRACE_EVENT_PHASE_EXIT:
+            return event->object < TRACE_PHASE_COUNT ? phase_names[event->object] : "?";
+        case TRACE_EVENT_ENQUEUE:
+        case TRACE_EVENT_DEQUEUE:
+        case TRACE_EVENT_REFILL:
+            return event->object < TRACE_STATION_COUNT ? station_names[event->object] : "?";
+        case TRACE_EVENT_LOCK_WAIT:
+            snprintf(mutex_name, sizeof(mutex_name), "mutex %u", event->object);
+            return mutex_name;
+        default:
+            return "-";
+    }
+}
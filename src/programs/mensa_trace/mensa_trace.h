@@ -0,0 +1,70 @@
+/**
+ * @file mensa_trace.h
+ * @brief Header per l'utility mensa_trace (registrazione e decodifica tracce).
+ *
+ * Comandi:
+ * - `mensa_trace on|off`: accende o spegne il tracciamento a runtime.
+ * - `mensa_trace record <file>`: accende il tracciamento e svuota le ring
+ *   su file fino alla fine della simulazione (o a SIGINT).
+ * - `mensa_trace decode <file> [timeline]`: riepiloghi per stazione, fase e
+ *   mutex; con `timeline` anche la sequenza di eventi di ogni attore.
+ *
+ * @see trace.h per il formato degli eventi.
+ * @see mensa_trace.c per l'implementazione.
+ */
+
+#ifndef MENSA_TRACE_H
+#define MENSA_TRACE_H
+
+#include <stdint.h>
+#include "common.h"
+#include "trace.h"
+
+/* ==========================================================================
+ *                          SEZIONE: FORMATO FILE
+ * ========================================================================== */
+
+/** Identificativo iniziale del file di traccia */
+#define TRACE_FILE_MAGIC "MNSTRACE"
+
+/** Versione del formato (intestazione + TraceEvent in sequenza) */
+#define TRACE_FILE_VERSION 1
+
+/** Intervallo tra due drain delle ring durante la registrazione */
+#define TRACE_DRAIN_INTERVAL_NS 10000000L
+
+/**
+ * @brief Intestazione del file, seguita dagli eventi nell'ordine di drain.
+ */
+typedef struct {
+    char magic[8];                      /**< TRACE_FILE_MAGIC (senza terminatore) */
+    uint32_t version;                   /**< TRACE_FILE_VERSION */
+    uint32_t event_size;                /**< sizeof(TraceEvent) */
+    int64_t tick_ns;                    /**< Durata reale di un tick */
+    int32_t ticks_per_minute;           /**< Tick per minuto simulato */
+    uint32_t reserved;
+} TraceFileHeader;
+
+/* ==========================================================================
+ *                       SEZIONE: PROTOTIPI FUNZIONI
+ * ========================================================================== */
+
+/**
+ * @brief Connette alla memoria condivisa della simulazione.
+ * @return 0 successo, -1 errore.
+ */
+int connect_to_simulation(MainSharedMemory **shm_out, int *shmid_out);
+
+/**
+ * @brief Registra gli eventi su `path` finché la simulazione è in corso.
+ * @return 0 successo, -1 errore.
+ */
+int record_trace(MainSharedMemory *shm, const char *path);
+
+/**
+ * @brief Stampa i riepiloghi (e opzionalmente le timeline) di un file di traccia.
+ * @return 0 successo, -1 errore.
+ */
+int decode_trace(const char *path, bool print_timelines);
+
+#endif /* MENSA_TRACE_H */
@@ -20,10 +20,14 @@
 /* Includes del progetto */
 #include "operatore.h"
 #include "sem.h"
+#include "mutex.h"
+#include "statistics.h"
 #include "shm.h"
 #include "utils.h"
 #include "queue.h"
 #include "message.h"
+#include "station_channel.h"
+#include "log.h"
 
 /* ==========================================================================
  *                        VARIABILI GLOBALI (SEGNALI)
@@ -44,6 +48,8 @@ static void handle_operatore_signals(int sig);
 int main(int argc, char *argv[]) {
     StatoOperatore operatore;
     
+    log_set_role(LOG_ROLE_OPERATOR);
+
     /* 1. Inizializzazione Stato e Risorse */
     init_operatore(&operatore, argc, argv);
 
@@ -51,15 +57,16 @@ int main(int argc, char *argv[]) {
     setup_operatore_signals();
 
     /* 3. Sincronizzazione di Startup Globale */
-    sync_child_start(operatore.shm_ptr->semaphore_sync_id, BARRIER_STARTUP_READY, BARRIER_STARTUP_GATE);
-    printf("[OPERATORE] PID %d: Initializzazione completata. Pronto.\n", getpid());
+    sync_child_start_undo(operatore.shm_ptr->semaphore_sync_id, BARRIER_STARTUP_READY, BARRIER_STARTUP_GATE);
+    LOG_INFO("[OPERATORE] PID %d: Initializzazione completata. Pronto.\n", getpid());
 
     /* 4. Avvio Cicli di Simulazione */
     run_operatore_simulation(&operatore);
 
     /* 5. Cleanup */
+    release_operator_activity(operatore.activity);
     detach_shared_memory_segment(operatore.shm_ptr);
-    printf("[OPERATORE] PID %d: Terminazione pulita.\n", getpid());
+    LOG_INFO("[OPERATORE] PID %d: Terminazione pulita.\n", getpid());
     return EXIT_SUCCESS;
 }
 
@@ -69,7 +76,7 @@ int main(int argc, char *argv[]) {
 
 void init_operatore(StatoOperatore *operatore, int argc, char *argv[]) {
     if (argc < 3) {
-        fprintf(stderr, "Uso: %s <shm_id> <station_type>\n", argv[0]);
+        fprintf(stderr, "Uso: %s <shm_id> <station_type> [worker_index]\n", argv[0]);
         exit(EXIT_FAILURE);
     }
     
@@ -81,6 +88,11 @@ void init_operatore(StatoOperatore *operatore, int argc, char *argv[]) {
 
     /* Attach SHM */
     operatore->shm_ptr = attach_to_simulation_shared_memory(operatore->shared_memory_id);
+    operatore->activity = claim_operator_activity(operatore->shm_ptr, operatore->station_type);
+
+    /* Flusso casuale per ordinale dell'operatore (PID se lanciato a mano) */
+    uint64_t worker_index = (argc > 3) ? (uint64_t)atoi(argv[3]) : (uint64_t)getpid();
+    seed_random_stream(operatore->shm_ptr->configuration.random_seed, RANDOM_STREAM_OPERATOR, worker_index);
 }
 
 void run_operatore_simulation(StatoOperatore *operatore) {
@@ -91,9 +103,9 @@ void run_operatore_simulation(StatoOperatore *operatore) {
 
         /* [INIZIO GIORNATA] Sincronizzazione Mattutina */
         local_daily_cycle_is_active = 1;
-        sync_child_start(operatore->shm_ptr->semaphore_sync_id, BARRIER_MORNING_READY, BARRIER_MORNING_GATE);
+        sync_child_start_undo(operatore->shm_ptr->semaphore_sync_id, BARRIER_MORNING_READY, BARRIER_MORNING_GATE);
         
-        printf("[OPERATORE] PID %d: Inizio giornata %d.\n", getpid(), operatore->shm_ptr->current_simulation_day + 1);
+        LOG_INFO("[OPERATORE] PID %d: Inizio giornata %d.\n", getpid(), operatore->shm_ptr->current_simulation_day + 1);
 
         /* Configurazione Riferimenti Stazione e Tempi */
         FoodDistributionStation *stazione_ptr = NULL;
@@ -107,15 +119,12 @@ void run_operatore_simulation(StatoOperatore *operatore) {
             
             if (res != -1) {
                 is_at_work = 1; /* Turno iniziato */
-                printf("[OPERATORE] PID %d: Postazione acquisita.\n", getpid());
+                LOG_DEBUG("[OPERATORE] PID %d: Postazione acquisita.\n", getpid());
 
                 /* Tracciamento Operatore Attivo (Una volta al giorno) */
                 if (!already_counted_active_today) {
-                    reserve_sem(operatore->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
-                    operatore->shm_ptr->statistics.operators_statistics.daily_active_operators++;
-                    operatore->shm_ptr->statistics.operators_statistics.total_active_operators_all_time++;
+                    record_operator_active(operatore->shm_ptr);
                     already_counted_active_today = true;
-                    release_sem(operatore->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
                 }
 
                 /* LOOP 3: Ciclo di Servizio */
@@ -134,7 +143,7 @@ void run_operatore_simulation(StatoOperatore *operatore) {
 
         /* [FINE GIORNATA] Sincronizzazione Serale (skip se simulazione terminata) */
         if (operatore->shm_ptr->is_simulation_running) {
-            sync_child_start(operatore->shm_ptr->semaphore_sync_id, BARRIER_EVENING_READY, BARRIER_EVENING_GATE);
+            sync_child_start_undo(operatore->shm_ptr->semaphore_sync_id, BARRIER_EVENING_READY, BARRIER_EVENING_GATE);
         }
     }
 }
@@ -153,6 +162,8 @@ void prepare_station_context(StatoOperatore *operatore, FoodDistributionStation
 }
 
 void fase_lavoro_stazione(StatoOperatore *operatore, FoodDistributionStation *stazione_ptr, int avg_service_time) {
+    const SimulationClock *clock = &operatore->shm_ptr->simulation_clock;
+
     while (local_daily_cycle_is_active && is_at_work) {
         /* [DESIGN] Probabilità spontanea di richiedere pausa tra un cliente e l'altro */
         if (generate_random_integer(1, 100) <= 10) {
@@ -161,29 +172,36 @@ void fase_lavoro_stazione(StatoOperatore *operatore, FoodDistributionStation *st
         }
         
         if (local_daily_cycle_is_active && is_at_work) {
-            /* Check Cancello Refill (Interrompibile) */
+            unsigned long long idle_start = 0;
+            bool got_order = false;
+
+            /* Check Cancello Refill (Interrompibile): l'attesa del rifornimento non è tempo inattivo */
             int wait_res = wait_for_zero_interruptible(stazione_ptr->semaphore_set_id, STATION_SEM_REFILL_GATE);
             
             if (wait_res == 0) {
+                /* Da qui al prelievo dell'ordine l'operatore è in postazione senza lavoro */
+                idle_start = simulation_clock_now(clock);
+
                 /* Cancello OK: attendi ordine */
-                SimulationMessage msg;
+                StationPayload order;
                 /* Ricezione Ordine */
-                ssize_t result = receive_message_from_queue(stazione_ptr->message_queue_id, &msg, sizeof(StationPayload), MSG_TYPE_ORDER, 0);
+                ssize_t result = station_channel_receive_order(operatore->shm_ptr, (StationChannelIndex)operatore->station_type,
+                                                               &order, sizeof(StationPayload));
                 
                 if (result != -1) {
-                    StationPayload *payload = (StationPayload *)msg.message_text;
+                    StationPayload *payload = &order;
+                    got_order = true;
+                    record_operator_idle(operatore->activity,
+                                         simulation_clock_minutes_between(clock, idle_start, payload->dequeue_tick));
                     
-                    /* Verifica Disponibilità Porzioni */
-                    reserve_sem(operatore->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+                    /* Verifica Disponibilità Porzioni (decremento atomico, senza lock) */
                     bool available = false;
                     
                     if (operatore->station_type == 2) {
                         available = true; /* Caffè/Dessert sempre disponibili */
-                    } else if (stazione_ptr->portions[payload->dish_index] > 0) {
-                        stazione_ptr->portions[payload->dish_index]--;
-                        available = true;
+                    } else {
+                        available = take_station_portion(stazione_ptr, payload->dish_index);
                     }
-                    release_sem(operatore->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
 
                     /* Simulazione Tempo e Feedback */
                     if (available) {
@@ -196,29 +214,19 @@ void fase_lavoro_stazione(StatoOperatore *operatore, FoodDistributionStation *st
                         simulate_seconds_passage(varied_time, operatore->shm_ptr->configuration.timings.nanoseconds_per_tick);
                         operatore->total_portions_served++;
 
-                        /* Aggiornamento Statistiche Globali (PROTEZIONE MUTEX_SIMULATION_STATS) */
-                        reserve_sem(operatore->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
-                        if (operatore->station_type == 0) {
-                            operatore->shm_ptr->statistics.daily_served_plates.first_course_count++;
-                            operatore->shm_ptr->statistics.total_served_plates.first_course_count++;
-                        } else if (operatore->station_type == 1) {
-                            operatore->shm_ptr->statistics.daily_served_plates.second_course_count++;
-                            operatore->shm_ptr->statistics.total_served_plates.second_course_count++;
-                        } else {
-                            operatore->shm_ptr->statistics.daily_served_plates.coffee_dessert_count++;
-                            operatore->shm_ptr->statistics.total_served_plates.coffee_dessert_count++;
-                        }
-                        operatore->shm_ptr->statistics.daily_served_plates.total_plates_count++;
-                        operatore->shm_ptr->statistics.total_served_plates.total_plates_count++;
-                        release_sem(operatore->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+                        /* Aggiornamento Statistiche (shard del processo, senza lock) */
+                        record_served_plate(operatore->shm_ptr, operatore->station_type);
 
                     } else {
                         payload->status = ORDER_STATUS_OUT_OF_STOCK;
                     }
 
                     /* Risposta all'Utente */
-                    msg.message_type = payload->user_pid;
-                    send_message_to_queue(stazione_ptr->message_queue_id, &msg, sizeof(StationPayload), 0);
+                    station_channel_send_reply(operatore->shm_ptr, (StationChannelIndex)operatore->station_type,
+                                               payload, sizeof(StationPayload));
+                    record_operator_service(operatore->activity,
+                                            simulation_clock_minutes_between(clock, payload->enqueue_tick, payload->dequeue_tick),
+                                            simulation_clock_minutes_since(clock, payload->dequeue_tick));
                     
                 } else if (errno != EINTR) {
                     /* Se l'errore non è un'interruzione (EINTR), usciamo dal turno */
@@ -232,16 +240,21 @@ void fase_lavoro_stazione(StatoOperatore *operatore, FoodDistributionStation *st
                  is_at_work = 0;
             }
             /* Se EINTR su wait_for_zero, loop riprende e ricontrolla flag */
+
+            if (wait_res == 0 && !got_order) {
+                record_operator_idle(operatore->activity, simulation_clock_minutes_since(clock, idle_start));
+            }
         }
     }
 }
 
 void fase_decisione_pausa_atomica(StatoOperatore *operatore, FoodDistributionStation *stazione_ptr) {
-    reserve_sem(operatore->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    MutexSemaphoreIndex station_lock = station_mutex_index(operatore->station_type);
+    lock_simulation_mutex(operatore->shm_ptr, station_lock);
     
     if (!local_daily_cycle_is_active) {
         release_sem(stazione_ptr->semaphore_set_id, STATION_SEM_AVAILABLE_POSTS);
-        printf("[OPERATORE] PID %d: Fine giornata, postazione rilasciata.\n", getpid());
+        LOG_DEBUG("[OPERATORE] PID %d: Fine giornata, postazione rilasciata.\n", getpid());
     } else {
         int total_seats = (operatore->station_type == 0) ? operatore->shm_ptr->configuration.seats.seats_first_course :
                           (operatore->station_type == 1) ? operatore->shm_ptr->configuration.seats.seats_second_course :
@@ -253,28 +266,25 @@ void fase_decisione_pausa_atomica(StatoOperatore *operatore, FoodDistributionSta
         if (current_active_operators > 1 && operatore->daily_breaks_taken < operatore->shm_ptr->configuration.quantities.number_of_allowed_breaks) {
             release_sem(stazione_ptr->semaphore_set_id, STATION_SEM_AVAILABLE_POSTS);
             is_at_work = 0; /* Pausa concessa: esce dal Loop 3 */
-            printf("[OPERATORE] PID %d: Pausa concessa (%d active), postazione rilasciata.\n", getpid(), current_active_operators);
+            LOG_DEBUG("[OPERATORE] PID %d: Pausa concessa (%d active), postazione rilasciata.\n", getpid(), current_active_operators);
         } else {
             is_at_work = 1; /* Negato: resta attivo */
-            printf("[OPERATORE] PID %d: Pausa negata (ultimo attivo o fine permessi). Resto attivo.\n", getpid());
+            LOG_DEBUG("[OPERATORE] PID %d: Pausa negata (ultimo attivo o fine permessi). Resto attivo.\n", getpid());
         }
     }
     
-    release_sem(operatore->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    unlock_simulation_mutex(operatore->shm_ptr, station_lock);
 }
 
 void esegui_pausa_operatore(StatoOperatore *operatore) {
-    printf("[OPERATORE] PID %d: Inizio simulazione riposo.\n", getpid());
+    LOG_DEBUG("[OPERATORE] PID %d: Inizio simulazione riposo.\n", getpid());
     int break_mins = generate_random_integer(2, 5);
     
     operatore->daily_breaks_taken++;
-    reserve_sem(operatore->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
-    operatore->shm_ptr->statistics.operators_statistics.daily_breaks_taken++;
-    operatore->shm_ptr->statistics.operators_statistics.total_breaks_taken++;
-    release_sem(operatore->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+    record_operator_break(operatore->shm_ptr);
 
     simulate_time_passage(break_mins, operatore->shm_ptr->configuration.timings.nanoseconds_per_tick);
-    printf("[OPERATORE] PID %d: Fine pausa (%d min simulati), torno a competere per un posto.\n", getpid(), break_mins);
+    LOG_DEBUG("[OPERATORE] PID %d: Fine pausa (%d min simulati), torno a competere per un posto.\n", getpid(), break_mins);
 }
 
 static void handle_operatore_signals(int sig) {
@@ -29,6 +29,7 @@ typedef struct {
     int daily_breaks_taken;             /**< Statistica: numero di pause effettuate oggi */
 
     MainSharedMemory *shm_ptr;          /**< Puntatore alla memoria condivisa agganciata */
+    OperatorActivity *activity;         /**< Slot dei tempi di coda/servizio (NULL se esauriti) */
 } StatoOperatore;
 
 /**
@@ -23,10 +23,14 @@
 /* Includes del progetto */
 #include "operatore_cassa.h"
 #include "sem.h"
+#include "mutex.h"
+#include "statistics.h"
 #include "shm.h"
 #include "utils.h"
 #include "queue.h"
+#include "station_channel.h"
 #include "message.h"
+#include "log.h"
 
 /* ==========================================================================
  *                        VARIABILI GLOBALI (SEGNALI)
@@ -46,6 +50,8 @@ static void handle_cassiere_signals(int sig);
 int main(int argc, char *argv[]) {
     StatoCassiere cassiere;
     
+    log_set_role(LOG_ROLE_CASHIER);
+
     /* 1. Inizializzazione Stato e Risorse */
     init_cassiere(&cassiere, argc, argv);
 
@@ -53,15 +59,16 @@ int main(int argc, char *argv[]) {
     setup_cassiere_signals();
 
     /* 3. Sincronizzazione di Startup Globale */
-    sync_child_start(cassiere.shm_ptr->semaphore_sync_id, BARRIER_STARTUP_READY, BARRIER_STARTUP_GATE);
-    printf("[CASSIERE] PID %d: Inizializzazione completata. Pronto.\n", getpid());
+    sync_child_start_undo(cassiere.shm_ptr->semaphore_sync_id, BARRIER_STARTUP_READY, BARRIER_STARTUP_GATE);
+    LOG_INFO("[CASSIERE] PID %d: Inizializzazione completata. Pronto.\n", getpid());
 
     /* 4. Avvio Cicli di Simulazione */
     run_cassiere_simulation(&cassiere);
 
     /* 5. Cleanup */
+    release_operator_activity(cassiere.activity);
     detach_shared_memory_segment(cassiere.shm_ptr);
-    printf("[CASSIERE] PID %d: Terminazione pulita.\n", getpid());
+    LOG_INFO("[CASSIERE] PID %d: Terminazione pulita.\n", getpid());
     return EXIT_SUCCESS;
 }
 
@@ -71,7 +78,7 @@ int main(int argc, char *argv[]) {
 
 void init_cassiere(StatoCassiere *cassiere, int argc, char *argv[]) {
     if (argc < 2) {
-        fprintf(stderr, "Uso: %s <shm_id>\n", argv[0]);
+        fprintf(stderr, "Uso: %s <shm_id> [cashier_index]\n", argv[0]);
         exit(EXIT_FAILURE);
     }
     cassiere->shared_memory_id = atoi(argv[1]);
@@ -80,6 +87,11 @@ void init_cassiere(StatoCassiere *cassiere, int argc, char *argv[]) {
 
     /* Attach SHM */
     cassiere->shm_ptr = attach_to_simulation_shared_memory(cassiere->shared_memory_id);
+    cassiere->activity = claim_operator_activity(cassiere->shm_ptr, STATION_CHANNEL_CASHIER);
+
+    /* Flusso casuale per ordinale del cassiere (PID se lanciato a mano) */
+    uint64_t cashier_index = (argc > 2) ? (uint64_t)atoi(argv[2]) : (uint64_t)getpid();
+    seed_random_stream(cassiere->shm_ptr->configuration.random_seed, RANDOM_STREAM_CASHIER, cashier_index);
 }
 
 void setup_cassiere_signals(void) {
@@ -101,9 +113,9 @@ void run_cassiere_simulation(StatoCassiere *cassiere) {
 
         /* [INIZIO GIORNATA] Sincronizzazione Mattutina */
         local_daily_cycle_is_active = 1;
-        sync_child_start(cassiere->shm_ptr->semaphore_sync_id, BARRIER_MORNING_READY, BARRIER_MORNING_GATE);
+        sync_child_start_undo(cassiere->shm_ptr->semaphore_sync_id, BARRIER_MORNING_READY, BARRIER_MORNING_GATE);
         
-        printf("[CASSIERE] PID %d: Inizio giornata %d.\n", getpid(), cassiere->shm_ptr->current_simulation_day + 1);
+        LOG_INFO("[CASSIERE] PID %d: Inizio giornata %d.\n", getpid(), cassiere->shm_ptr->current_simulation_day + 1);
 
         /* LOOP 2: Ciclo "Giornaliero" */
         while (local_daily_cycle_is_active) {
@@ -115,11 +127,8 @@ void run_cassiere_simulation(StatoCassiere *cassiere) {
 
                 /* Tracciamento Cassiere Attivo nelle statistiche globali */
                 if (!already_counted_active_today) {
-                    reserve_sem(cassiere->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
-                    cassiere->shm_ptr->statistics.operators_statistics.daily_active_operators++;
-                    cassiere->shm_ptr->statistics.operators_statistics.total_active_operators_all_time++;
+                    record_operator_active(cassiere->shm_ptr);
                     already_counted_active_today = true;
-                    release_sem(cassiere->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
                 }
 
                 /* LOOP 3: Fase di Lavoro */
@@ -137,13 +146,14 @@ void run_cassiere_simulation(StatoCassiere *cassiere) {
 
         /* [FINE GIORNATA] Sincronizzazione Serale (skip se simulazione terminata) */
         if (cassiere->shm_ptr->is_simulation_running) {
-            sync_child_start(cassiere->shm_ptr->semaphore_sync_id, BARRIER_EVENING_READY, BARRIER_EVENING_GATE);
+            sync_child_start_undo(cassiere->shm_ptr->semaphore_sync_id, BARRIER_EVENING_READY, BARRIER_EVENING_GATE);
         }
     }
 }
 
 void fase_lavoro_cassa(StatoCassiere *cassiere) {
     int avg_service_time = cassiere->shm_ptr->configuration.timings.average_service_time_cassa;
+    const SimulationClock *clock = &cassiere->shm_ptr->simulation_clock;
 
     while (local_daily_cycle_is_active && is_at_work) {
         /* [DESIGN] Probabilità spontanea di richiedere pausa tra un cliente e l'altro */
@@ -153,19 +163,25 @@ void fase_lavoro_cassa(StatoCassiere *cassiere) {
         }
 
         if (local_daily_cycle_is_active && is_at_work) {
-            SimulationMessage msg;
+            CashierPayload order;
+            /* Da qui al prelievo del pagamento il cassiere è in postazione senza lavoro */
+            unsigned long long idle_start = simulation_clock_now(clock);
+            bool got_order = false;
             
             /* [COMMUNICATION DISORDER] Attesa se il gate è bloccato (Interrompibile) */
             int wait_res = wait_for_zero_interruptible(cassiere->shm_ptr->register_station.semaphore_set_id, STATION_SEM_STOP_GATE);
             
             if (wait_res == 0) {
-                /* Gate aperto: Ricezione Dati Pagamento (MSQ Cassa) - Bloccante ma interrompibile */
-                ssize_t result = receive_message_from_queue(cassiere->shm_ptr->register_station.message_queue_id, 
-                                                           &msg, sizeof(CashierPayload), MSG_TYPE_ORDER, 0);
+                /* Gate aperto: Ricezione Dati Pagamento (canale Cassa) - Bloccante ma interrompibile */
+                ssize_t result = station_channel_receive_order(cassiere->shm_ptr, STATION_CHANNEL_CASHIER,
+                                                               &order, sizeof(CashierPayload));
                 
                 if (result != -1) {   
-                    CashierPayload *payload = (CashierPayload *)msg.message_text;
+                    CashierPayload *payload = &order;
                     double amount = 0.0;
+                    got_order = true;
+                    record_operator_idle(cassiere->activity,
+                                         simulation_clock_minutes_between(clock, idle_start, payload->dequeue_tick));
 
                     /* [PUNTO 4.1] Calcolo Importo in base ai prezzi configurati */
                     if (payload->had_first)  amount += cassiere->shm_ptr->configuration.prices.price_first_course;
@@ -178,16 +194,13 @@ void fase_lavoro_cassa(StatoCassiere *cassiere) {
                     }
 
                     /* [PUNTO 4.2] Aggiornamento Incassi (Protezione Mutex) */
-                    reserve_sem(cassiere->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+                    lock_simulation_mutex(cassiere->shm_ptr, MUTEX_CASHIER_LEDGER);
                     cassiere->shm_ptr->register_station.daily_income += amount;
                     cassiere->shm_ptr->register_station.total_income += amount;
-                    release_sem(cassiere->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+                    unlock_simulation_mutex(cassiere->shm_ptr, MUTEX_CASHIER_LEDGER);
 
-                    /* Aggiornamento Statistiche Globali (PROTEZIONE MUTEX_SIMULATION_STATS) */
-                    reserve_sem(cassiere->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
-                    cassiere->shm_ptr->statistics.income_statistics.current_daily_income += amount;
-                    cassiere->shm_ptr->statistics.income_statistics.accumulated_total_income += amount;
-                    release_sem(cassiere->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+                    /* Aggiornamento Statistiche (shard del processo, senza lock) */
+                    record_income(cassiere->shm_ptr, amount);
 
                     /* [PUNTO 4.3] Simulazione Tempo di Servizio */
                     int varied_time = calculate_varied_time(avg_service_time, 20);
@@ -195,12 +208,14 @@ void fase_lavoro_cassa(StatoCassiere *cassiere) {
                     cassiere->total_customers_processed++;
 
                     /* Invio Ricevuta (Feedback all'Utente) */
-                    msg.message_type = payload->user_pid;
-                    send_message_to_queue(cassiere->shm_ptr->register_station.message_queue_id, 
-                                         &msg, sizeof(CashierPayload), 0);
+                    station_channel_send_reply(cassiere->shm_ptr, STATION_CHANNEL_CASHIER,
+                                               payload, sizeof(CashierPayload));
+                    record_operator_service(cassiere->activity,
+                                            simulation_clock_minutes_between(clock, payload->enqueue_tick, payload->dequeue_tick),
+                                            simulation_clock_minutes_since(clock, payload->dequeue_tick));
                     
-                    printf("[CASSIERE] PID %d: Gestito Utente %d. Incassato: %.2f EUR.\n", 
-                           getpid(), payload->user_pid, amount);
+                    LOG_DEBUG("[CASSIERE] PID %d: Gestito Utente %d. Incassato: %.2f EUR.\n", 
+                              getpid(), payload->user_pid, amount);
                 } else if (errno != EINTR) {
                     perror("[CASSIERE] Errore critico ricezione messaggio");
                     is_at_work = 0; /* Errore grave, termina turno */
@@ -211,12 +226,16 @@ void fase_lavoro_cassa(StatoCassiere *cassiere) {
                 is_at_work = 0;
             }
             /* Se EINTR su wait_for_zero, il loop riprende */
+
+            if (!got_order) {
+                record_operator_idle(cassiere->activity, simulation_clock_minutes_since(clock, idle_start));
+            }
         }
     }
 }
 
 void fase_decisione_pausa_cassa(StatoCassiere *cassiere) {
-    reserve_sem(cassiere->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    lock_simulation_mutex(cassiere->shm_ptr, MUTEX_STATION_CASHIER);
     
     if (!local_daily_cycle_is_active) {
         release_sem(cassiere->shm_ptr->register_station.semaphore_set_id, STATION_SEM_AVAILABLE_POSTS);
@@ -229,25 +248,22 @@ void fase_decisione_pausa_cassa(StatoCassiere *cassiere) {
         if (current_active > 1 && cassiere->daily_breaks_taken < cassiere->shm_ptr->configuration.quantities.number_of_allowed_breaks) {
             release_sem(cassiere->shm_ptr->register_station.semaphore_set_id, STATION_SEM_AVAILABLE_POSTS);
             is_at_work = 0; /* Pausa concessa: esce dal Loop 3 */
-            printf("[CASSIERE] PID %d: Pausa concessa, cassa rilasciata.\n", getpid());
+            LOG_DEBUG("[CASSIERE] PID %d: Pausa concessa, cassa rilasciata.\n", getpid());
         } else {
             is_at_work = 1; /* Negato: resta alla cassa */
-            printf("[CASSIERE] PID %d: Pausa negata (ultima cassa attiva o fine permessi).\n", getpid());
+            LOG_DEBUG("[CASSIERE] PID %d: Pausa negata (ultima cassa attiva o fine permessi).\n", getpid());
         }
     }
     
-    release_sem(cassiere->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    unlock_simulation_mutex(cassiere->shm_ptr, MUTEX_STATION_CASHIER);
 }
 
 void esegui_pausa_cassa(StatoCassiere *cassiere) {
-    printf("[CASSIERE] PID %d: In pausa...\n", getpid());
+    LOG_DEBUG("[CASSIERE] PID %d: In pausa...\n", getpid());
     int break_mins = generate_random_integer(2, 5);
     
     cassiere->daily_breaks_taken++;
-    reserve_sem(cassiere->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
-    cassiere->shm_ptr->statistics.operators_statistics.daily_breaks_taken++;
-    cassiere->shm_ptr->statistics.operators_statistics.total_breaks_taken++;
-    release_sem(cassiere->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+    record_operator_break(cassiere->shm_ptr);
 
     simulate_time_passage(break_mins, cassiere->shm_ptr->configuration.timings.nanoseconds_per_tick);
 }
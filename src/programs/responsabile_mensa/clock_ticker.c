@@ -0,0 +1,190 @@
+/**
+ * @file clock_ticker.c
+ * @brief Thread ticker del Master e allarmi sull'orologio simulato.
+ *
+ * Il ticker dorme fino al confine del tick successivo su CLOCK_MONOTONIC
+ * (scadenze assolute, senza deriva) e pubblica il numero di tick trascorsi
+ * dall'avvio: un risveglio in ritardo recupera i tick persi in un solo passo.
+ *
+ * @see clock_ticker.h
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <sys/prctl.h>
+#include <sys/eventfd.h>
+
+/* Includes del progetto */
+#include "clock_ticker.h"
+#include "simulation_clock.h"
+#include "timeseries.h"
+#include "utils.h"
+#ifdef USE_VIRTUAL_CLOCK
+#include "virtual_time.h"
+#include "log.h"
+#endif
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Scadenze degli allarmi in tick (0: disarmato). */
+static _Atomic unsigned long long alarm_ticks[CLOCK_ALARM_COUNT];
+
+/** Un eventfd per allarme, creato una volta e riusato a ogni arm. */
+static int alarm_fds[CLOCK_ALARM_COUNT] = { -1, -1 };
+
+/** Tick di inizio della giornata corrente. */
+static _Atomic unsigned long long day_start_tick = 0;
+
+/** Giorno e minuto dell'ultima istantanea live pubblicata (solo thread dell'orologio). */
+static int live_published_day = -1;
+static int live_published_minute = -1;
+
+#ifndef USE_VIRTUAL_CLOCK
+/** Stato del thread ticker. */
+static pthread_t ticker_thread;
+static atomic_bool ticker_running = false;
+#endif
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+#ifndef USE_VIRTUAL_CLOCK
+/** Corpo del thread ticker. */
+static void *clock_ticker_main(void *arg) {
+    MainSharedMemory *shm = (MainSharedMemory *)arg;
+    SimulationClock *clock = &shm->simulation_clock;
+    long long tick_ns = clock->tick_ns;
+
+    /* Il tick pubblicato è relativo all'origine, che riparte dal tick corrente */
+    struct timespec origin;
+    clock_gettime(CLOCK_MONOTONIC, &origin);
+    unsigned long long base_tick = simulation_clock_now(clock);
+    unsigned long long elapsed_ticks = 0;
+
+    /* Risvegli precisi: lo slack predefinito (50 µs) è pari al tick minimo */
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+
+    while (atomic_load(&ticker_running)) {
+        long long next_ns = (long long)(elapsed_ticks + 1) * tick_ns + origin.tv_nsec;
+        struct timespec next_wakeup;
+        next_wakeup.tv_sec = origin.tv_sec + (time_t)(next_ns / 1000000000LL);
+        next_wakeup.tv_nsec = (long)(next_ns % 1000000000LL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next_wakeup, NULL);
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long long elapsed_ns = (now.tv_sec - origin.tv_sec) * 1000000000LL + (now.tv_nsec - origin.tv_nsec);
+        elapsed_ticks = (unsigned long long)(elapsed_ns / tick_ns);
+
+        publish_simulation_tick(shm, base_tick + elapsed_ticks);
+    }
+    return NULL;
+}
+#endif
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+void init_clock_alarms(void) {
+    for (int i = 0; i < CLOCK_ALARM_COUNT; i++) {
+        if (alarm_fds[i] != -1) continue;
+        alarm_fds[i] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (alarm_fds[i] == -1) {
+            perror("[ERROR] MASTER: eventfd allarme fallita");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+int clock_alarm_fd(ClockAlarm alarm) {
+    return alarm_fds[alarm];
+}
+
+void start_clock_ticker(MainSharedMemory *shm) {
+#ifdef USE_VIRTUAL_CLOCK
+    start_virtual_time_driver(shm);
+#else
+    atomic_store(&ticker_running, true);
+    int err = spawn_master_thread(&ticker_thread, clock_ticker_main, shm);
+
+    if (err != 0) {
+        atomic_store(&ticker_running, false);
+        fprintf(stderr, "[ERROR] MASTER: avvio ticker orologio fallito (errno %d)\n", err);
+        exit(EXIT_FAILURE);
+    }
+#endif
+    LOG_INFO("[MASTER] Orologio simulato attivo: %d tick/min, %ld ns per tick.\n",
+             shm->simulation_clock.ticks_per_minute, shm->simulation_clock.tick_ns);
+}
+
+void stop_clock_ticker(void) {
+#ifdef USE_VIRTUAL_CLOCK
+    stop_virtual_time_driver();
+#else
+    if (!atomic_exchange(&ticker_running, false)) return;
+    pthread_join(ticker_thread, NULL);
+#endif
+}
+
+void mark_simulation_day_start(MainSharedMemory *shm) {
+    atomic_store(&day_start_tick, simulation_clock_now(&shm->simulation_clock));
+    shm->simulation_minutes_passed = 0;
+}
+
+void arm_clock_alarm(MainSharedMemory *shm, ClockAlarm alarm, int simulated_minutes) {
+    const SimulationClock *clock = &shm->simulation_clock;
+    unsigned long long delay = (unsigned long long)(simulated_minutes > 0 ? simulated_minutes : 0) *
+                               (unsigned long long)clock->ticks_per_minute;
+    if (delay == 0) delay = 1;
+
+    atomic_store(&alarm_ticks[alarm], simulation_clock_now(clock) + delay);
+}
+
+unsigned long long next_clock_alarm_tick(void) {
+    unsigned long long next = 0;
+    for (int i = 0; i < CLOCK_ALARM_COUNT; i++) {
+        unsigned long long deadline = atomic_load(&alarm_ticks[i]);
+        if (deadline > 0 && (next == 0 || deadline < next)) next = deadline;
+    }
+    return next;
+}
+
+void publish_simulation_tick(MainSharedMemory *shm, unsigned long long tick) {
+    SimulationClock *clock = &shm->simulation_clock;
+    simulation_clock_publish(clock, tick);
+
+    unsigned long long now = simulation_clock_now(clock);
+    unsigned long long day_start = atomic_load(&day_start_tick);
+    shm->simulation_minutes_passed = (int)((now - day_start) / (unsigned long long)clock->ticks_per_minute);
+
+    /* Istantanea per mensa_top (e campione della serie temporale): una pubblicazione per minuto simulato */
+    if (shm->is_simulation_running &&
+        (shm->simulation_minutes_passed != live_published_minute || shm->current_simulation_day != live_published_day)) {
+        live_published_minute = shm->simulation_minutes_passed;
+        live_published_day = shm->current_simulation_day;
+        live_statistics_publish(shm);
+        timeseries_sample(&shm->live_statistics.data);
+    }
+
+    /* Una scrittura sull'eventfd per scadenza: il loop del Master la legge via epoll */
+    for (int i = 0; i < CLOCK_ALARM_COUNT; i++) {
+        unsigned long long deadline = atomic_load(&alarm_ticks[i]);
+        if (deadline > 0 && deadline <= now &&
+            atomic_compare_exchange_strong(&alarm_ticks[i], &deadline, 0)) {
+            uint64_t one = 1;
+            if (write(alarm_fds[i], &one, sizeof(one)) == -1) {
+                perror("[ERROR] MASTER: notifica allarme fallita");
+            }
+        }
+    }
+}
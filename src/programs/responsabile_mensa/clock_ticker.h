@@ -0,0 +1,82 @@
+/**
+ * @file clock_ticker.h
+ * @brief Pubblicazione dell'orologio simulato e allarmi del Master.
+ *
+ * Il ticker è un thread del Master che pubblica in SHM il tick corrente
+ * (simulation_clock.h) e aggiorna simulation_minutes_passed. Gli allarmi di
+ * fine giornata e di refill sono scadenze in tick controllate a ogni
+ * pubblicazione e consegnate al Master scrivendo su un eventfd per allarme,
+ * osservato dal loop epoll del Master (master_events.h). A ogni cambio di
+ * minuto il ticker pubblica anche l'istantanea live (live_statistics.h) e ne
+ * accoda un campione alla serie temporale su file (timeseries.h).
+ *
+ * Con CLOCK_MODE=virtual i tick vengono pubblicati dal thread del tempo
+ * virtuale (virtual_time.h) a ogni avanzamento dell'orologio.
+ */
+
+#ifndef CLOCK_TICKER_H
+#define CLOCK_TICKER_H
+
+/* Includes del progetto */
+#include "common.h"
+
+/**
+ * @brief Allarmi del Master sull'orologio simulato.
+ */
+typedef enum {
+    CLOCK_ALARM_DAY_END,        /**< Fine giornata */
+    CLOCK_ALARM_REFILL,         /**< Refill periodico */
+    CLOCK_ALARM_COUNT
+} ClockAlarm;
+
+/**
+ * @brief Crea gli eventfd degli allarmi (non bloccanti, uno per allarme).
+ *
+ * Da chiamare prima di start_clock_ticker(); chiamate successive non hanno effetto.
+ */
+void init_clock_alarms(void);
+
+/**
+ * @brief Descrittore eventfd su cui viene notificata la scadenza di `alarm`.
+ *
+ * Ogni scadenza aggiunge 1 al contatore; la lettura lo azzera.
+ */
+int clock_alarm_fd(ClockAlarm alarm);
+
+/**
+ * @brief Avvia il thread che fa avanzare l'orologio simulato.
+ *
+ * Il thread blocca tutti i segnali: restano al thread principale del Master.
+ */
+void start_clock_ticker(MainSharedMemory *shm);
+
+/**
+ * @brief Arresta e attende il thread dell'orologio.
+ */
+void stop_clock_ticker(void);
+
+/**
+ * @brief Segna il tick corrente come inizio della giornata (simulation_minutes_passed = 0).
+ */
+void mark_simulation_day_start(MainSharedMemory *shm);
+
+/**
+ * @brief Arma un allarme a `simulated_minutes` dal tick corrente.
+ *
+ * Alla scadenza viene notificato clock_alarm_fd(alarm); un nuovo arm sostituisce il precedente.
+ */
+void arm_clock_alarm(MainSharedMemory *shm, ClockAlarm alarm, int simulated_minutes);
+
+/**
+ * @brief Tick dell'allarme armato più vicino (0 se nessuno è armato).
+ */
+unsigned long long next_clock_alarm_tick(void);
+
+/**
+ * @brief Pubblica `tick`, aggiorna i minuti del giorno e consegna gli allarmi scaduti.
+ *
+ * Al primo tick di ogni minuto pubblica l'istantanea live (live_statistics_publish).
+ */
+void publish_simulation_tick(MainSharedMemory *shm, unsigned long long tick);
+
+#endif /* CLOCK_TICKER_H */
@@ -0,0 +1,137 @@
+/**
+ * @file master_events.c
+ * @brief Implementazione del loop eventi del Master (epoll + signalfd + eventfd).
+ *
+ * Le sorgenti sono fisse e create una sola volta: un signalfd e un eventfd
+ * per allarme. Gli allarmi riarmati riusano lo stesso descrittore.
+ *
+ * @see master_events.h
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+
+/* Includes del progetto */
+#include "master_events.h"
+#include "clock_ticker.h"
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Identificativo della sorgente in epoll_event.data.u32 (gli allarmi seguono). */
+#define MASTER_SOURCE_SIGNALS 0U
+#define MASTER_SOURCE_ALARM_BASE 1U
+
+static int epoll_fd = -1;
+static int signal_fd = -1;
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+/** Registra `fd` in lettura con identificativo `source`. */
+static void add_event_source(int fd, uint32_t source) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = source;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+        perror("[ERROR] MASTER: epoll_ctl fallita");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/** Legge tutti i segnali in coda sul signalfd. */
+static void drain_signals(MasterEvents *events) {
+    struct signalfd_siginfo info[8];
+    ssize_t bytes;
+
+    while ((bytes = read(signal_fd, info, sizeof(info))) > 0) {
+        size_t count = (size_t)bytes / sizeof(info[0]);
+        for (size_t i = 0; i < count; i++) {
+            switch (info[i].ssi_signo) {
+                case SIGINT:
+                case SIGTERM: events->terminate = true; break;
+                case SIGUSR1: events->add_users = true; break;
+                case SIGCHLD: events->children_exited = true; break;
+                default: break;
+            }
+        }
+    }
+}
+
+/** Azzera il contatore dell'eventfd di un allarme; true se era scaduto. */
+static bool drain_alarm(ClockAlarm alarm) {
+    uint64_t expirations = 0;
+    return read(clock_alarm_fd(alarm), &expirations, sizeof(expirations)) == (ssize_t)sizeof(expirations) &&
+           expirations > 0;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+void setup_master_event_loop(void) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGUSR1);
+    sigaddset(&mask, SIGCHLD);
+
+    if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1) {
+        perror("[ERROR] MASTER: sigprocmask fallita");
+        exit(EXIT_FAILURE);
+    }
+
+    signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (signal_fd == -1 || epoll_fd == -1) {
+        perror("[ERROR] MASTER: creazione signalfd/epoll fallita");
+        exit(EXIT_FAILURE);
+    }
+
+    init_clock_alarms();
+    add_event_source(signal_fd, MASTER_SOURCE_SIGNALS);
+    for (int i = 0; i < CLOCK_ALARM_COUNT; i++) {
+        add_event_source(clock_alarm_fd((ClockAlarm)i), MASTER_SOURCE_ALARM_BASE + (uint32_t)i);
+    }
+}
+
+void reset_child_signal_mask(void) {
+    sigset_t empty;
+    sigemptyset(&empty);
+    sigprocmask(SIG_SETMASK, &empty, NULL);
+}
+
+bool poll_master_events(int timeout_ms, MasterEvents *events) {
+    memset(events, 0, sizeof(*events));
+
+    struct epoll_event ready[1 + CLOCK_ALARM_COUNT];
+    int n = epoll_wait(epoll_fd, ready, 1 + CLOCK_ALARM_COUNT, timeout_ms);
+    if (n == -1) {
+        if (errno != EINTR) perror("[ERROR] MASTER: epoll_wait fallita");
+        return false;
+    }
+
+    for (int i = 0; i < n; i++) {
+        uint32_t source = ready[i].data.u32;
+        if (source == MASTER_SOURCE_SIGNALS) {
+            drain_signals(events);
+        } else if (source - MASTER_SOURCE_ALARM_BASE == CLOCK_ALARM_DAY_END) {
+            events->day_end |= drain_alarm(CLOCK_ALARM_DAY_END);
+        } else if (source - MASTER_SOURCE_ALARM_BASE == CLOCK_ALARM_REFILL) {
+            events->refill |= drain_alarm(CLOCK_ALARM_REFILL);
+        }
+    }
+    return n > 0;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file master_events.h
+ * @brief Loop eventi del Master: segnali e allarmi multiplexati su epoll.
+ *
+ * SIGINT, SIGTERM, SIGUSR1 e SIGCHLD restano bloccati nel Master e vengono
+ * letti da un signalfd; gli allarmi dell'orologio simulato arrivano sui loro
+ * eventfd (clock_ticker.h). Tutto viene gestito in modo sincrono dal thread
+ * principale, senza handler asincroni: nessuna rientranza e nessun EINTR
+ * nelle attese del Master.
+ */
+
+#ifndef MASTER_EVENTS_H
+#define MASTER_EVENTS_H
+
+/* Includes di sistema */
+#include <stdbool.h>
+
+/**
+ * @brief Eventi raccolti da una chiamata a poll_master_events().
+ */
+typedef struct {
+    bool day_end;               /**< Scaduto l'allarme di fine giornata */
+    bool refill;                /**< Scaduto l'allarme di refill */
+    bool terminate;             /**< Ricevuto SIGINT o SIGTERM */
+    bool add_users;             /**< Ricevuto SIGUSR1 da add_users */
+    bool children_exited;       /**< Ricevuto SIGCHLD: ci sono figli da raccogliere */
+} MasterEvents;
+
+/**
+ * @brief Blocca i segnali del Master e crea signalfd, eventfd degli allarmi ed epoll.
+ *
+ * Va chiamata prima di creare figli e thread, che ereditano la maschera.
+ */
+void setup_master_event_loop(void);
+
+/**
+ * @brief Ripristina una maschera vuota. Da chiamare nei figli tra fork() ed exec().
+ */
+void reset_child_signal_mask(void);
+
+/**
+ * @brief Attende eventi per al più `timeout_ms` millisecondi (-1: senza limite).
+ *
+ * Drena tutte le sorgenti pronte e ne riassume l'esito in `events`.
+ *
+ * @return true se almeno un evento è stato raccolto.
+ */
+bool poll_master_events(int timeout_ms, MasterEvents *events);
+
+#endif /* MASTER_EVENTS_H */
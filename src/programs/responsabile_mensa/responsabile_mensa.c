@@ -23,6 +23,11 @@
 #include "config.h"
 #include "menu.h"
 #include "statistics.h"
+#include "clock_ticker.h"
+#include "timeseries.h"
+#include "statistics_writer.h"
+#include "utils.h"
+#include "log.h"
 
 /* ==========================================================================
  *                             SEZIONE: MAIN
@@ -31,29 +36,42 @@
 int main(int argc, char *argv[]) {
     const char *config_path = (argc > 1) ? argv[1] : NULL;
     
-    printf("[MASTER] Responsabile Mensa in avvio...\n");
+    log_set_role(LOG_ROLE_MASTER);
+    LOG_INFO("[MASTER] Responsabile Mensa in avvio...\n");
 
     /* 1. Caricamento Configurazione e Menu */
     SimulationConfiguration config = load_simulation_configuration(config_path);
+    log_bind_levels(config.log_levels);
     SimulationMenu menu = load_simulation_menu();
+
+    /* Seme dei flussi casuali: scelto ora se assente, e stampato per poter ripetere l'esecuzione */
+    if (config.random_seed == 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        config.random_seed = (((unsigned long long)now.tv_sec << 32) ^ (unsigned long long)now.tv_nsec ^
+                              (unsigned long long)getpid()) | 1ULL;
+    }
+    LOG_INFO("[MASTER] Seme casuale: %llu (RANDOM_SEED per ripetere l'esecuzione)\n", config.random_seed);
+    seed_random_stream(config.random_seed, RANDOM_STREAM_MASTER, 0);
     
     /* 2. Setup SHM e Risorse IPC */
     /* Calcoliamo il pool dei gruppi basandoci sul numero di utenti iniziali + margine di espansione */
     int users_to_assign = config.quantities.number_of_initial_users;
-    int dynamic_group_pool_size = users_to_assign + 100; 
+    int dynamic_group_pool_size = users_to_assign + SPARE_GROUP_SLOTS;
+    int user_capacity = users_to_assign + SPARE_GROUP_SLOTS * MAX_USERS_PER_GROUP;
 
-    MainSharedMemory *shm_ptr = initialize_simulation_shared_memory(dynamic_group_pool_size);
+    MainSharedMemory *shm_ptr = initialize_simulation_shared_memory(dynamic_group_pool_size, user_capacity);
     shm_ptr->configuration = config;
     shm_ptr->food_menu = menu;
+    log_bind_levels(shm_ptr->configuration.log_levels);
     
-    printf("[MASTER] SHM Inizializzata. ID: %d\n", shm_ptr->shared_memory_id);
+    LOG_INFO("[MASTER] SHM Inizializzata. ID: %d\n", shm_ptr->shared_memory_id);
     
     /* Inizializzazione di base delle risorse IPC globali */
     initialize_ipc_sources(shm_ptr);
     
-    /* Configurazione handler dei segnali (SIGCHLD per zombie, SIGINT/SIGALRM per master) */
-    setup_sigchld_handler(shm_ptr);
-    setup_signal_close_day(shm_ptr);
+    /* Segnali e allarmi sul loop eventi del Master (maschera ereditata da figli e thread) */
+    setup_master_signals(shm_ptr);
 
     /* 3. Inizializzazione Sincronizzazione Gruppi */
     int total_required_groups = calculate_initial_groups_count(shm_ptr);
@@ -80,16 +98,23 @@ int main(int argc, char *argv[]) {
     synchronize_prework_barrier(shm_ptr);
 
     /* 6. Avvio Ciclo della Simulazione (Loop dei giorni) */
+    statistics_writer_open(&shm_ptr->configuration);
+    timeseries_open(TIMESERIES_FILE_PATH, &shm_ptr->configuration, &shm_ptr->food_menu);
+    start_clock_ticker(shm_ptr);
     start_simulation(shm_ptr);
 
     /* 7. Terminazione Coordinata */
-    printf("[MASTER] Fine simulazione rilevata. Notifica ai figli e rimozione risorse...\n");
+    LOG_INFO("[MASTER] Fine simulazione rilevata. Notifica ai figli e rimozione risorse...\n");
     terminate_simulation_gracefully(shm_ptr, EXIT_SUCCESS);
+    stop_clock_ticker();
+    timeseries_close();
 
     /* 8. Report Finale (figli terminati, SHM ancora valida) */
-    printf("\n[MASTER] Elaborazione report finale in corso...\n");
+    LOG_INFO("\n[MASTER] Elaborazione report finale in corso...\n");
     SimulationStatistics final_stats = collect_simulation_statistics(shm_ptr);
     display_final_simulation_report(final_stats, shm_ptr->current_simulation_day);
+    statistics_writer_append(&final_stats, shm_ptr->current_simulation_day, STATISTICS_RECORD_FINAL);
+    statistics_writer_close();
 
     /* 9. Cleanup risorse IPC */
     cleanup_ipc_resources(shm_ptr);
@@ -121,29 +146,18 @@ void setup_daily_barriers(MainSharedMemory *shm_ptr) {
 }
 
 void synchronize_prework_barrier(MainSharedMemory *shm_ptr) {
-    printf("[MASTER] In attesa dei figli per il via libera globale (Startup Barrier)...\n");
+    LOG_INFO("[MASTER] In attesa dei figli per il via libera globale (Startup Barrier)...\n");
     
-    /* Attesa interrompibile: controlla is_simulation_running dopo ogni EINTR */
-    int barrier_reached = 0;
-    int critical_error = 0;
-    
-    while (shm_ptr->is_simulation_running && !barrier_reached && !critical_error) {
-        if (wait_for_zero_interruptible(shm_ptr->semaphore_sync_id, BARRIER_STARTUP_READY) == 0) {
-            barrier_reached = 1;
-        } else if (errno != EINTR) {
-            perror("[MASTER] Errore critico su startup barrier");
-            critical_error = 1;
-        }
-        /* EINTR: segnale ricevuto, ricontrolla is_simulation_running nel while */
-    }
+    /* Attesa che serve gli eventi: SIGINT o figli terminati durante lo startup */
+    int barrier_reached = (wait_barrier_serving_events(shm_ptr, BARRIER_STARTUP_READY) == 0);
     
     /* Sblocco del cancello (GATE -> 0) per permettere ai figli di procedere */
     open_barrier_gate(shm_ptr->semaphore_sync_id, BARRIER_STARTUP_GATE);
     
     if (shm_ptr->is_simulation_running && barrier_reached) {
-        printf("[MASTER] Startup completata! Inizio servizio mensa.\n");
+        LOG_INFO("[MASTER] Startup completata! Inizio servizio mensa.\n");
     } else {
-        printf("[MASTER] Startup interrotta da segnale.\n");
+        LOG_INFO("[MASTER] Startup interrotta.\n");
     }
 }
 
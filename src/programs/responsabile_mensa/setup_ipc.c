@@ -20,11 +20,14 @@
 /* Includes del progetto */
 #include "common.h"
 #include "sem.h"
+#include "mutex.h"
 #include "shm.h"
 #include "queue.h"
 #include "utils.h"
 #include "setup_ipc.h"
 #include "ipc_keys.h"
+#include "trace.h"
+#include "log.h"
 
 /* ==========================================================================
  *                       SEZIONE: PROTOTIPI PRIVATI
@@ -38,23 +41,41 @@
  */
 static void init_station_resource(FoodDistributionStation *station, key_t queue_key, key_t sem_key);
 
+/**
+ * @brief Crea le STATION_REPLY_QUEUE_SHARDS code di risposta di una stazione.
+ * @param reply_queue_ids Array di destinazione degli ID.
+ * @param queue_key Chiave della coda ordini (gli shard usano le chiavi successive).
+ */
+static void init_reply_queue_shards(int *reply_queue_ids, key_t queue_key);
+
 /* ==========================================================================
  *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
  * ========================================================================== */
 
-MainSharedMemory* initialize_simulation_shared_memory(int group_pool_size) {
+/** Arrotonda un offset al multiplo di 64 byte (linea di cache, allineamento di StatisticsShard). */
+static size_t align_cache_line(size_t offset) {
+    return (offset + 63) & ~(size_t)63;
+}
+
+MainSharedMemory* initialize_simulation_shared_memory(int group_pool_size, int user_capacity) {
     int shmid;
     MainSharedMemory *shm_ptr;
     
-    /* Calcolo della dimensione totale: struct + pool dinamico (Flexible Array Member) */
-    size_t shm_size = sizeof(MainSharedMemory) + (group_pool_size * sizeof(GroupStatus));
+    /* Calcolo della dimensione totale: struct + pool dinamico (Flexible Array Member) +
+     * caselle di risposta, shard statistici e slot dell'orologio virtuale dimensionati sulla popolazione */
+    int statistics_shards_count = user_capacity + NON_USER_STATISTICS_SHARDS;
+    int virtual_sleepers_count = user_capacity + VIRTUAL_CLOCK_NON_USER_SLEEPERS;
+    size_t reply_slots_offset = align_cache_line(sizeof(MainSharedMemory) + (group_pool_size * sizeof(GroupStatus)));
+    size_t statistics_shards_offset = align_cache_line(reply_slots_offset + (size_t)user_capacity * sizeof(ReplySlot));
+    size_t virtual_wakeups_offset = align_cache_line(statistics_shards_offset + (size_t)statistics_shards_count * sizeof(StatisticsShard));
+    size_t shm_size = virtual_wakeups_offset + (size_t)virtual_sleepers_count * sizeof(_Atomic long long);
 
     /* ==========================================================================
      *  TAULA RASA: Pulizia pre-emptiva risorse orfane della sessione precedente
      * ========================================================================== */
     int old_shmid = shmget(IPC_KEY_SHARED_MEMORY, 0, 0);
     if (old_shmid != -1) {
-        printf("[MASTER] Tabula Rasa: Trovata SHM orfana (ID: %d). Rimozione in corso...\n", old_shmid);
+        LOG_INFO("[MASTER] Tabula Rasa: Trovata SHM orfana (ID: %d). Rimozione in corso...\n", old_shmid);
         if (shmctl(old_shmid, IPC_RMID, NULL) == -1) {
             perror("[WARNING] Impossibile rimuovere SHM orfana");
         }
@@ -79,8 +100,16 @@ MainSharedMemory* initialize_simulation_shared_memory(int group_pool_size) {
     memset(shm_ptr, 0, shm_size);
     shm_ptr->shared_memory_id = shmid;
     shm_ptr->group_pool_size = group_pool_size;
+    shm_ptr->user_capacity = user_capacity;
+    shm_ptr->reply_slots_count = user_capacity;
+    shm_ptr->reply_slots_offset = reply_slots_offset;
+    shm_ptr->statistics_shards_count = statistics_shards_count;
+    shm_ptr->statistics_shards_offset = statistics_shards_offset;
+    virtual_clock_init(&shm_ptr->virtual_clock, (_Atomic long long *)((char *)shm_ptr + virtual_wakeups_offset),
+                       virtual_sleepers_count);
     shm_ptr->is_simulation_running = 1;
     shm_ptr->master_pid = getpid();
+    shm_ptr->trace_shared_memory_id = -1;
 
     return shm_ptr;
 }
@@ -111,17 +140,16 @@ void initialize_global_simulation_mutexes(MainSharedMemory *shared_memory_ptr) {
         exit(EXIT_FAILURE);
     }
 
-    /* Mutex binari (inizializzati a 1) */
-    init_sem_val(semid, MUTEX_SIMULATION_STATS, 1);
-    init_sem_val(semid, MUTEX_SHARED_DATA, 1);
+    shared_memory_ptr->semaphore_mutex_id = semid;
 
     /* Semaforo di controllo per add_users (inizializzato a 0, sbloccato dal Master) */
     init_sem_val(semid, MUTEX_ADD_USERS_PERMISSION, 0);
 
-    /* Mutex per la scansione dei tavoli (inizializzato a 1) */
-    init_sem_val(semid, MUTEX_TABLES, 1);
-
-    shared_memory_ptr->semaphore_mutex_id = semid;
+    /* Mutex binari (Stats, Shared Data, Tavoli) sul backend selezionato a compile-time */
+    if (initialize_simulation_mutexes(shared_memory_ptr) == -1) {
+        perror("[ERROR] Inizializzazione mutex globali fallita");
+        exit(EXIT_FAILURE);
+    }
 }
 
 void initialize_distribution_stations(MainSharedMemory *shared_memory_ptr) {
@@ -137,14 +165,13 @@ void initialize_distribution_stations(MainSharedMemory *shared_memory_ptr) {
 }
 
 void initialize_dining_area_seats_semaphores(MainSharedMemory *shared_memory_ptr) {
-    int semid = create_sem_set(IPC_KEY_SEMAPHORE_DINING_AREA, 1, IPC_CREAT | 0666);
+    int semid = create_sem_set(IPC_KEY_SEMAPHORE_DINING_AREA, DINING_WAIT_CHANNELS, IPC_CREAT | 0666);
     if (semid == -1) {
         perror("[ERROR] Creazione semaforo posti a sedere fallita");
         exit(EXIT_FAILURE);
     }
 
-    /* Il valore reale verrà impostato dal Master dopo il caricamento della configurazione */
-    init_sem_val(semid, 0, 0);
+    /* Canali di attesa azzerati da dining_area_reset() a topologia generata */
     shared_memory_ptr->seat_area.condition_semaphore_id = semid;
 }
 
@@ -189,12 +216,22 @@ void initialize_cashier_checkout_message_queue(MainSharedMemory *shared_memory_p
         msgctl(msqid, IPC_SET, &ds);
     }
     shared_memory_ptr->register_station.message_queue_id = msqid;
+
+    /* Code di risposta (ricevute pagamento) separate dalla coda FIFO */
+    init_reply_queue_shards(shared_memory_ptr->register_station.reply_queue_ids, IPC_KEY_QUEUE_REGISTER_STATION);
+
+    /* Ring pagamenti in SHM (usata con QUEUE_BACKEND=ring) */
+    order_ring_init(&shared_memory_ptr->register_station.order_ring);
 }
 
 void initialize_control_structures(MainSharedMemory *shm_ptr) {
     shm_ptr->current_total_users = shm_ptr->configuration.quantities.number_of_initial_users;
     shm_ptr->add_users_flag = 0;
 
+    /* Orologio simulato: pubblicato dal ticker, letto dai figli fin dall'avvio */
+    simulation_clock_init(&shm_ptr->simulation_clock, shm_ptr->configuration.timings.nanoseconds_per_tick);
+    shm_ptr->simulation_minutes_passed = 0;
+
     /* Coda di comunicazione Master <-> add_users.c */
     int msqid = create_message_queue(IPC_KEY_QUEUE_CONTROL, IPC_CREAT | 0666);
     if (msqid == -1) {
@@ -209,6 +246,44 @@ void initialize_control_structures(MainSharedMemory *shm_ptr) {
         msgctl(msqid, IPC_SET, &ds);
     }
     shm_ptr->control_queue_id = msqid;
+
+    /* Coda richieste di spawn verso lo zygote utenti (USER_LAUNCHER=zygote) */
+    int zygote_msqid = create_message_queue(IPC_KEY_QUEUE_USER_ZYGOTE, IPC_CREAT | 0666);
+    if (zygote_msqid == -1) {
+        perror("[ERROR] Creazione coda zygote fallita");
+        exit(EXIT_FAILURE);
+    }
+    shm_ptr->zygote_queue_id = zygote_msqid;
+}
+
+void initialize_event_trace_segment(MainSharedMemory *shm_ptr) {
+    /* Tabula Rasa anche per il segmento di traccia di una sessione precedente */
+    int old_shmid = shmget(IPC_KEY_SHARED_MEMORY_TRACE, 0, 0);
+    if (old_shmid != -1) {
+        shmctl(old_shmid, IPC_RMID, NULL);
+    }
+
+    /* Una ring per ogni utente che la popolazione può raggiungere, più gli altri attori */
+    int rings_count = shm_ptr->user_capacity + TRACE_NON_USER_RINGS;
+
+    /* Il kernel azzera il segmento: ring libere e contatori a 0 */
+    int shmid = create_shared_memory_segment(IPC_KEY_SHARED_MEMORY_TRACE, trace_segment_size(rings_count),
+                                             IPC_CREAT | IPC_EXCL | 0666);
+    if (shmid == -1) {
+        perror("[ERROR] Creazione segmento di traccia fallita");
+        exit(EXIT_FAILURE);
+    }
+
+    TraceSegment *segment = (TraceSegment *)attach_shared_memory_segment(shmid, false);
+    if (segment == NULL) {
+        perror("[ERROR] Collegamento segmento di traccia fallito");
+        exit(EXIT_FAILURE);
+    }
+    segment->rings_count = rings_count;
+    detach_shared_memory_segment(segment);
+
+    shm_ptr->trace_shared_memory_id = shmid;
+    atomic_store(&shm_ptr->trace_enabled, 0);
 }
 
 void initialize_group_sync_pool(MainSharedMemory *shm_ptr, int pool_size) {
@@ -220,13 +295,22 @@ void initialize_group_sync_pool(MainSharedMemory *shm_ptr, int pool_size) {
         exit(EXIT_FAILURE);
     }
 
-    /* Inizializzazione di massa del pool */
+    /* Inizializzazione di massa del pool (singola semctl SETALL) */
+    unsigned short *values = malloc((size_t)total_sems * sizeof(unsigned short));
+    if (values == NULL) {
+        perror("[ERROR] Allocazione valori pool gruppi fallita");
+        exit(EXIT_FAILURE);
+    }
     for (int i = 0; i < pool_size; i++) {
         int base = i * GROUP_SEMS_PER_ENTRY;
-        init_sem_val(semid, base + GROUP_SEM_PRE_CASHIER, 0);  /* Bloccato finché tutti pronti */
-        init_sem_val(semid, base + GROUP_SEM_TABLE_GATE, 1);   /* Chiuso (1) finché leader non prenota */
-        init_sem_val(semid, base + GROUP_SEM_EXIT, 0);         /* Bloccato finché tutti finito */
+        values[base + GROUP_SEM_PRE_CASHIER] = 0;  /* Bloccato finché tutti pronti */
+        values[base + GROUP_SEM_TABLE_GATE] = 1;   /* Chiuso (1) finché leader non prenota */
+        values[base + GROUP_SEM_EXIT] = 0;         /* Bloccato finché tutti finito */
     }
+    if (init_sem_set_all(semid, values) == -1) {
+        exit(EXIT_FAILURE);
+    }
+    free(values);
 
     shm_ptr->group_sync_semaphore_id = semid;
     shm_ptr->group_pool_size = pool_size;
@@ -241,6 +325,7 @@ void initialize_ipc_sources(MainSharedMemory *shm_ptr) {
     initialize_ticket_validation_semaphores(shm_ptr);
     initialize_cashier_checkout_message_queue(shm_ptr);
     initialize_control_structures(shm_ptr);
+    initialize_event_trace_segment(shm_ptr);
 }
 
 /* ==========================================================================
@@ -262,6 +347,9 @@ static void init_station_resource(FoodDistributionStation *station, key_t queue_
         msgctl(station->message_queue_id, IPC_SET, &ds);
     }
 
+    /* Code di risposta: la coda ordini resta FIFO pura */
+    init_reply_queue_shards(station->reply_queue_ids, queue_key);
+
     /* 2. Set Semafori Stazione */
     station->semaphore_set_id = create_sem_set(sem_key, STATION_SEM_COUNT, IPC_CREAT | 0666);
     if (station->semaphore_set_id == -1) {
@@ -274,4 +362,24 @@ static void init_station_resource(FoodDistributionStation *station, key_t queue_
     init_sem_val(station->semaphore_set_id, STATION_SEM_USER_QUEUE, 0);
     init_sem_val(station->semaphore_set_id, STATION_SEM_REFILL_GATE, 0);
     init_sem_val(station->semaphore_set_id, STATION_SEM_REFILL_ACK, 0);
+
+    /* 3. Ring ordini in SHM (usata con QUEUE_BACKEND=ring) */
+    order_ring_init(&station->order_ring);
+}
+
+static void init_reply_queue_shards(int *reply_queue_ids, key_t queue_key) {
+    for (int k = 0; k < STATION_REPLY_QUEUE_SHARDS; k++) {
+        key_t shard_key = queue_key + IPC_KEY_REPLY_QUEUE_OFFSET + k;
+        reply_queue_ids[k] = create_message_queue(shard_key, IPC_CREAT | 0666);
+        if (reply_queue_ids[k] == -1) {
+            perror("[ERROR] Creazione coda di risposta stazione fallita");
+            exit(EXIT_FAILURE);
+        }
+
+        struct msqid_ds ds;
+        if (msgctl(reply_queue_ids[k], IPC_STAT, &ds) != -1) {
+            ds.msg_qbytes = 65536;
+            msgctl(reply_queue_ids[k], IPC_SET, &ds);
+        }
+    }
 }
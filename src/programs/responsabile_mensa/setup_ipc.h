@@ -25,9 +25,10 @@
  * dedicato allo stato dei gruppi.
  * 
  * @param group_pool_size Numero di slot per lo stato dei gruppi nel pool.
+ * @param user_capacity Utenti contemporanei massimi: una casella di risposta e uno shard statistico ciascuno.
  * @return MainSharedMemory* Puntatore all'area di memoria condivisa agganciata.
  */
-MainSharedMemory* initialize_simulation_shared_memory(int group_pool_size);
+MainSharedMemory* initialize_simulation_shared_memory(int group_pool_size, int user_capacity);
 
 /**
  * @brief Orchestratore globale per l'inizializzazione di tutte le risorse IPC.
@@ -106,4 +107,14 @@ void initialize_cashier_checkout_message_queue(MainSharedMemory *shared_memory_p
  */
 void initialize_control_structures(MainSharedMemory *shm_ptr);
 
+/**
+ * @brief Crea il segmento delle ring di tracciamento eventi (trace.h).
+ * 
+ * Il tracciamento parte spento: lo accende `mensa_trace` a runtime.
+ * Il numero di ring segue shm_ptr->user_capacity (già impostato).
+ * 
+ * @param shm_ptr Puntatore alla memoria condivisa.
+ */
+void initialize_event_trace_segment(MainSharedMemory *shm_ptr);
+
 #endif /* SETUP_IPC_H */
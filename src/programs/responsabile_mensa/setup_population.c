@@ -11,14 +11,21 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <signal.h>
 #include <sys/wait.h>
 #include <string.h>
+#include <sys/prctl.h>
 
 /* Includes del progetto */
 #include "common.h"
 #include "setup_population.h"
 #include "utils.h"
 #include "sem.h"
+#include "mutex.h"
+#include "user_zygote.h"
+#include "user_host.h"
+#include "master_events.h"
+#include "log.h"
 
 /* ==========================================================================
  *                        VARIABILI GLOBALI (PRIVATE)
@@ -39,7 +46,7 @@ static int *planned_group_sizes = NULL;
  * @param shmid ID della SHM.
  * @param station_type Tipo di stazione (0, 1, 2).
  */
-static void exec_worker(int shmid, int station_type);
+static void exec_worker(int shmid, int station_type, int worker_index);
 
 /* ==========================================================================
  *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
@@ -97,18 +104,21 @@ void launch_simulation_operators(MainSharedMemory *shared_memory_ptr) {
     };
     int groups[] = { GROUP_FIRST_COURSES, GROUP_SECOND_COURSES, GROUP_DESSERT_COFFEE };
     
-    /* 1. Lancio Operatori di Stazione */
+    /* 1. Lancio Operatori di Stazione (ordinale globale: indice del flusso casuale) */
+    int worker_index = 0;
     for (int s = 0; s < 3; s++) {
         pid_t pgid = 0;
         for (int i = 0; i < station_operators[s]; i++) {
             pid_t pid = fork();
             if (pid == 0) {
+                reset_child_signal_mask();
                 setpgid(0, pgid); /* Assegna al PGID della stazione */
-                exec_worker(shmid, s);
+                exec_worker(shmid, s, worker_index);
             } else if (pid > 0) {
                 if (i == 0) pgid = pid; /* Il primo figlio definisce il PGID del gruppo */
                 setpgid(pid, pgid); /* Padre imposta PGID (race condition fix) */
             }
+            worker_index++;
         }
         shared_memory_ptr->process_group_pids[groups[s]] = pgid;
     }
@@ -120,10 +130,12 @@ void launch_simulation_operators(MainSharedMemory *shared_memory_ptr) {
     for (int i = 0; i < num_cashiers; i++) {
         pid_t pid = fork();
         if (pid == 0) {
+            reset_child_signal_mask();
             setpgid(0, cassa_pgid);
-            char shm_str[20];
+            char shm_str[20], index_str[20];
             sprintf(shm_str, "%d", shmid);
-            execl("./bin/operatore_cassa", "operatore_cassa", shm_str, (char *)NULL);
+            sprintf(index_str, "%d", i);
+            execl("./bin/operatore_cassa", "operatore_cassa", shm_str, index_str, (char *)NULL);
             perror("[ERROR] execl operatore_cassa fallita");
             exit(EXIT_FAILURE);
         } else if (pid > 0) {
@@ -144,9 +156,12 @@ int calculate_initial_groups_count(MainSharedMemory *shm_ptr) {
         exit(EXIT_FAILURE);
     }
 
+    /* Un'estrazione per gruppo, al più una per utente: tutte in un blocco */
+    generate_random_integers(planned_group_sizes, users_to_assign, 1, MAX_USERS_PER_GROUP);
+
     planned_groups_count = 0;
     while (users_to_assign > 0) {
-        int g_size = generate_random_integer(1, MAX_USERS_PER_GROUP);
+        int g_size = planned_group_sizes[planned_groups_count];
         if (g_size > users_to_assign) g_size = users_to_assign;
         
         planned_group_sizes[planned_groups_count] = g_size;
@@ -154,37 +169,85 @@ int calculate_initial_groups_count(MainSharedMemory *shm_ptr) {
         users_to_assign -= g_size;
     }
     
-    /* Margine extra di 100 slot per nuovi gruppi creati tramite add_users utility */
-    return planned_groups_count + 100;
+    /* Margine extra di slot per nuovi gruppi creati tramite add_users utility */
+    return planned_groups_count + SPARE_GROUP_SLOTS;
 }
 
-void launch_simulation_users(MainSharedMemory *shared_memory_ptr) {
-    int shmid = shared_memory_ptr->shared_memory_id;
-    int current_sync_index = 0;
+#ifdef USE_USER_ZYGOTE
+/**
+ * @brief Avvia lo zygote utenti come leader del gruppo di processi GROUP_USERS.
+ *
+ * Il Master diventa child subreaper: gli utenti generati dallo zygote con
+ * doppia fork vengono adottati dal Master, che ne legge il SIGCHLD dal loop eventi.
+ */
+static void launch_user_zygote(MainSharedMemory *shared_memory_ptr) {
+    if (prctl(PR_SET_CHILD_SUBREAPER, 1) == -1) {
+        perror("[ERROR] prctl(PR_SET_CHILD_SUBREAPER) fallita");
+        exit(EXIT_FAILURE);
+    }
 
-    printf("[MASTER] Lancio popolazione utenti (%d gruppi)...\n", planned_groups_count);
+    pid_t pid = fork();
+    if (pid == 0) {
+        reset_child_signal_mask();
+        setpgid(0, 0);
+        char shm_str[24];
+        sprintf(shm_str, "%d", shared_memory_ptr->shared_memory_id);
+        execl("./bin/utente", "utente", shm_str, ZYGOTE_MODE_ARG, (char *)NULL);
+        perror("[ERROR] execl zygote utenti fallita");
+        exit(EXIT_FAILURE);
+    } else if (pid > 0) {
+        setpgid(pid, pid); /* Padre imposta PGID (race condition fix) */
+        shared_memory_ptr->process_group_pids[GROUP_USERS] = pid;
+    } else {
+        perror("[ERROR] fork zygote utenti fallita");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/** Genera un processo per utente tramite lo zygote. */
+static void launch_user_processes(MainSharedMemory *shared_memory_ptr) {
+    ZygoteGroupRequest *requests = (ZygoteGroupRequest *)malloc(planned_groups_count * sizeof(ZygoteGroupRequest));
+    if (requests == NULL && planned_groups_count > 0) {
+        perror("[ERROR] Allocazione richieste zygote fallita");
+        exit(EXIT_FAILURE);
+    }
 
     for (int g = 0; g < planned_groups_count; g++) {
-        int group_size = planned_group_sizes[g];
+        requests[g].group_size = planned_group_sizes[g];
+        requests[g].group_index = g;
+        requests[g].is_late_joiner = 0;
+    }
+
+    /* Registrazione nel registry a carico degli utenti stessi (vedi zygote.c) */
+    if (user_zygote_request_groups(shared_memory_ptr, requests, planned_groups_count) == -1) {
+        exit(EXIT_FAILURE);
+    }
+    free(requests);
+}
+#else
+/** Genera un processo per utente tramite fork+exec. */
+static void launch_user_processes(MainSharedMemory *shared_memory_ptr) {
+    int shmid = shared_memory_ptr->shared_memory_id;
 
-        /* Setup stato del gruppo in SHM prima della creazione dei processi */
-        shared_memory_ptr->group_statuses[current_sync_index].active_members = group_size;
-        shared_memory_ptr->group_statuses[current_sync_index].group_leader_pid = 0;
+    for (int current_sync_index = 0; current_sync_index < planned_groups_count; current_sync_index++) {
+        int group_size = planned_group_sizes[current_sync_index];
 
         for (int i = 0; i < group_size; i++) {
             pid_t pid = fork();
             if (pid == 0) {
+                reset_child_signal_mask();
+
                 /* Aggancio al PGID globale degli utenti per segnali broadcast */
                 pid_t users_global_pgid = shared_memory_ptr->process_group_pids[GROUP_USERS];
                 setpgid(0, users_global_pgid);
 
-                char shm_str[24], gsize_str[24], gindex_str[24], is_leader_str[8];
+                char shm_str[24], gsize_str[24], gindex_str[24], member_str[12];
                 sprintf(shm_str, "%d", shmid);
                 sprintf(gsize_str, "%d", group_size);
                 sprintf(gindex_str, "%d", current_sync_index);
-                sprintf(is_leader_str, "%d", (i == 0)); /* Il primo del gruppo è il leader */
+                sprintf(member_str, "%d", i); /* Il primo del gruppo (0) è il leader */
 
-                execl("./bin/utente", "utente", shm_str, gsize_str, gindex_str, is_leader_str, (char *)NULL);
+                execl("./bin/utente", "utente", shm_str, gsize_str, gindex_str, member_str, (char *)NULL);
                 perror("[ERROR] execl utente fallita");
                 exit(EXIT_FAILURE);
             } else if (pid > 0) {
@@ -196,27 +259,121 @@ void launch_simulation_users(MainSharedMemory *shared_memory_ptr) {
                 /* Padre imposta PGID (race condition fix) */
                 setpgid(pid, shared_memory_ptr->process_group_pids[GROUP_USERS]);
 
-                /* Registrazione nel registro di sistema per gestione zombie e deadlock */
-                reserve_sem(shared_memory_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
-                int registered = 0;
-                for (int r = 0; r < MAX_USERS_REGISTRY && !registered; r++) {
-                    if (shared_memory_ptr->user_registry[r].pid == 0) {
-                        shared_memory_ptr->user_registry[r].pid = pid;
-                        shared_memory_ptr->user_registry[r].group_index = current_sync_index;
-                        registered = 1;
-                    }
+                /*
+                 * Registrazione nel registro di sistema per gestione zombie e deadlock.
+                 * SIGCHLD è letto dal loop eventi: nessun handler concorrente sul mutex.
+                 */
+                lock_simulation_mutex(shared_memory_ptr, MUTEX_USER_REGISTRY);
+                if (user_registry_insert(&shared_memory_ptr->user_registry, pid, current_sync_index) == -1) {
+                    fprintf(stderr, "[WARNING] Registro pieno. PID %d non tracciato.\n", pid);
                 }
-                release_sem(shared_memory_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+                unlock_simulation_mutex(shared_memory_ptr, MUTEX_USER_REGISTRY);
             }
         }
-        current_sync_index++;
     }
+}
+#endif
 
-    /* Cleanup memoria temporanea pianificazione */
-    if (planned_group_sizes != NULL) {
-        free(planned_group_sizes);
-        planned_group_sizes = NULL;
+/**
+ * @brief Esegue l'execv di un host utenti per i gruppi [first_group, first_group + group_count).
+ * @see user_host.h per il formato degli argomenti.
+ */
+static void exec_user_host(int shmid, const char *mode, int first_group, int group_count) {
+    char **args = (char **)malloc((group_count + 5) * sizeof(char *));
+    char *numbers = (char *)malloc((group_count + 2) * 24);
+    if (args == NULL || numbers == NULL) {
+        perror("[ERROR] Allocazione argomenti host fallita");
+        exit(EXIT_FAILURE);
     }
+
+    args[0] = "utente";
+    args[1] = numbers;
+    sprintf(args[1], "%d", shmid);
+    args[2] = (char *)mode;
+    args[3] = numbers + 24;
+    sprintf(args[3], "%d", first_group);
+    for (int g = 0; g < group_count; g++) {
+        args[4 + g] = numbers + 24 * (g + 2);
+        sprintf(args[4 + g], "%d", planned_group_sizes[first_group + g]);
+    }
+    args[4 + group_count] = NULL;
+
+    execv("./bin/utente", args);
+    perror("[ERROR] execv host utenti fallita");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Impacchetta i gruppi in host da al più USERS_PER_HOST utenti.
+ *
+ * Un gruppo non viene mai diviso tra host; un gruppo più grande del limite
+ * occupa un host da solo.
+ */
+static void launch_user_hosts(MainSharedMemory *shared_memory_ptr) {
+    int users_per_host = shared_memory_ptr->configuration.quantities.users_per_host;
+    const char *mode = shared_memory_ptr->configuration.quantities.user_host_event_loop ?
+                       USER_ENGINE_MODE_ARG : USER_HOST_MODE_ARG;
+    int hosts = 0;
+    int first_group = 0;
+
+    while (first_group < planned_groups_count) {
+        int end_group = first_group;
+        int host_users = 0;
+        while (end_group < planned_groups_count &&
+               (end_group == first_group || host_users + planned_group_sizes[end_group] <= users_per_host)) {
+            host_users += planned_group_sizes[end_group];
+            end_group++;
+        }
+
+        /* Registrazione nel registry (gruppi e utenti) a carico dell'host stesso, vedi user_host.c */
+        pid_t pid = fork();
+        if (pid == 0) {
+            reset_child_signal_mask();
+            setpgid(0, shared_memory_ptr->process_group_pids[GROUP_USERS]);
+            exec_user_host(shared_memory_ptr->shared_memory_id, mode, first_group, end_group - first_group);
+        } else if (pid > 0) {
+            if (shared_memory_ptr->process_group_pids[GROUP_USERS] == 0) {
+                shared_memory_ptr->process_group_pids[GROUP_USERS] = pid;
+            }
+            setpgid(pid, shared_memory_ptr->process_group_pids[GROUP_USERS]); /* Race condition fix */
+            hosts++;
+        } else {
+            perror("[ERROR] fork host utenti fallita");
+            exit(EXIT_FAILURE);
+        }
+        first_group = end_group;
+    }
+
+    LOG_INFO("[MASTER] %d host utenti avviati (max %d utenti per host, modalità %s).\n",
+             hosts, users_per_host, mode);
+}
+
+void launch_simulation_users(MainSharedMemory *shared_memory_ptr) {
+    int users_per_host = shared_memory_ptr->configuration.quantities.users_per_host;
+
+    LOG_INFO("[MASTER] Lancio popolazione utenti (%d gruppi%s)...\n", planned_groups_count,
+             users_per_host > 0 ? ", host multi-utente" : "");
+
+#ifdef USE_USER_ZYGOTE
+    /* Lo zygote serve comunque ai late joiner di add_users */
+    launch_user_zygote(shared_memory_ptr);
+#endif
+
+    /* Setup stato dei gruppi in SHM prima della creazione degli utenti */
+    for (int g = 0; g < planned_groups_count; g++) {
+        shared_memory_ptr->group_statuses[g].active_members = planned_group_sizes[g];
+        shared_memory_ptr->group_statuses[g].group_leader_pid = 0;
+    }
+
+    if (users_per_host > 0) {
+        launch_user_hosts(shared_memory_ptr);
+    } else {
+        launch_user_processes(shared_memory_ptr);
+    }
+
+    /* Cleanup memoria temporanea pianificazione */
+    free(planned_group_sizes);
+    planned_group_sizes = NULL;
 }
 
 /**
@@ -245,8 +402,9 @@ static void initialize_table_topology(MainSharedMemory *shm_ptr) {
         table_idx++;
     }
     shm_ptr->seat_area.active_tables_count = table_idx;
-    printf("[MASTER] Topologia tavoli: %d tavoli pronti (Capacità Tot: %d).\n", 
-           table_idx, shm_ptr->configuration.seats.total_dining_seats);
+    dining_area_reset(&shm_ptr->seat_area);
+    LOG_INFO("[MASTER] Topologia tavoli: %d tavoli pronti (Capacità Tot: %d).\n", 
+             table_idx, shm_ptr->configuration.seats.total_dining_seats);
 }
 
 void initialize_station_operator_semaphores(MainSharedMemory *shm_ptr) {
@@ -268,9 +426,6 @@ void initialize_station_operator_semaphores(MainSharedMemory *shm_ptr) {
                  STATION_SEM_AVAILABLE_POSTS, 
                  shm_ptr->configuration.seats.seats_cash_desk);
  
-    /* Semaforo di condizione (segnalazione) per i tavoli della mensa */
-    init_sem_val(shm_ptr->seat_area.condition_semaphore_id, 0, 0);
-
     /* Inizializza l'array dei tavoli (Step 2 Social Seating) */
     initialize_table_topology(shm_ptr);
 }
@@ -279,13 +434,15 @@ void initialize_station_operator_semaphores(MainSharedMemory *shm_ptr) {
  *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
  * ========================================================================== */
 
-static void exec_worker(int shmid, int station_type) {
+static void exec_worker(int shmid, int station_type, int worker_index) {
     char shm_str[24];
     char type_str[10];
+    char index_str[24];
     sprintf(shm_str, "%d", shmid);
     sprintf(type_str, "%d", station_type);
+    sprintf(index_str, "%d", worker_index);
     
-    execl("./bin/operatore", "operatore", shm_str, type_str, (char *)NULL);
+    execl("./bin/operatore", "operatore", shm_str, type_str, index_str, (char *)NULL);
     perror("[ERROR] execl operatore fallita");
     exit(EXIT_FAILURE);
 }
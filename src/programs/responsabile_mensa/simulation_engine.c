@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <stdbool.h>
 #include <signal.h>
 #include <time.h>
 #include <sys/wait.h>
@@ -23,33 +24,44 @@
 #include "common.h"
 #include "simulation_engine.h"
 #include "sem.h"
+#include "mutex.h"
 #include "utils.h"
 #include "statistics.h"
+#include "statistics_writer.h"
 #include "queue.h"
 #include "message.h"
+#include "station_channel.h"
+#include "trace.h"
+#include "clock_ticker.h"
+#include "master_events.h"
+#include "log.h"
+
+/* ==========================================================================
+ *                              COSTANTI (PRIVATE)
+ * ========================================================================== */
+
+/** Intervallo reale tra due controlli degli eventi durante l'attesa di una barriera. */
+#define MASTER_BARRIER_POLL_NS 10000000L
 
 /* ==========================================================================
  *                        VARIABILI GLOBALI (STATO ENGINE)
  * ========================================================================== */
 
-/** Flag atomica per il ciclo giornaliero. */
-static volatile sig_atomic_t daily_cycle_is_active = 0;
+/** Flag del ciclo giornaliero (solo thread principale, aggiornata dal loop eventi). */
+static bool daily_cycle_is_active = false;
 
-/** Flag atomica per la richiesta di refill asincrono. */
-static volatile sig_atomic_t refill_requested = 0;
+/** Richiesta di refill dall'allarme periodico. */
+static bool refill_requested = false;
 
-/** Riferimento globale alla SHM per gli handler dei segnali. */
+/** Riferimento globale alla SHM per il riarmo del refill. */
 static MainSharedMemory *global_shm_ref = NULL;
 
 /* ==========================================================================
  *                       SEZIONE: PROTOTIPI PRIVATI
  * ========================================================================== */
 
-static void handle_daily_cycle_end(int sig);
-static void handle_emergency_termination(int sig);
-static void handle_add_users_request(int sig);
-static void handle_refill_signal(int sig);
-static void handle_sigchld(int sig);
+static void process_master_events(MainSharedMemory *shm, int timeout_ms);
+static void reap_terminated_children(MainSharedMemory *shm);
 
 static void reset_daily_statistics(MainSharedMemory *shm);
 static void reset_dining_area_tables(MainSharedMemory *shm);
@@ -63,32 +75,23 @@ static void process_add_users_requests(MainSharedMemory *shm);
  * ========================================================================== */
 
 void run_simulation_loop(MainSharedMemory *shm) {
-    printf("[MASTER] Engine in esecuzione. Avvio loop settimanale...\n");
+    LOG_INFO("[MASTER] Engine in esecuzione. Avvio loop settimanale...\n");
     global_shm_ref = shm;
 
     /* LOOP SETTIMANALE: Gestione dei simulation_duration_days */
     while (shm->is_simulation_running && shm->current_simulation_day < shm->configuration.timings.simulation_duration_days) {
         
         /* 1. Fase Preparazione Giorno */
-        int morning_barrier_ok = 0;
-        int morning_critical_err = 0;
-        while (shm->is_simulation_running && !morning_barrier_ok && !morning_critical_err) {
-            if (wait_for_zero_interruptible(shm->semaphore_sync_id, BARRIER_MORNING_READY) == 0) {
-                morning_barrier_ok = 1;
-            } else if (errno != EINTR) {
-                perror("[MASTER] Errore critico su barriera mattutina");
-                morning_critical_err = 1;
-            }
-            /* EINTR: segnale ricevuto, ricontrolla is_simulation_running nel while */
-        }
+        wait_barrier_serving_events(shm, BARRIER_MORNING_READY);
 
         if (shm->is_simulation_running) {
-            printf("[MASTER] --- INIZIO GIORNO %d ---\n", shm->current_simulation_day + 1);
+            LOG_INFO("[MASTER] --- INIZIO GIORNO %d ---\n", shm->current_simulation_day + 1);
 
             reset_daily_statistics(shm);
             perform_initial_daily_refill(shm);
             setup_group_barriers(shm);
             setup_refill_signal();
+            refill_requested = false;
 
             /* Setup barriera serale in base alla popolazione attuale */
             int evening_count = shm->configuration.quantities.number_of_workers +
@@ -97,18 +100,20 @@ void run_simulation_loop(MainSharedMemory *shm) {
             setup_barrier(shm->semaphore_sync_id, BARRIER_EVENING_READY, BARRIER_EVENING_GATE, evening_count);
 
             /* 2. Fase Operativa Attiva */
-            daily_cycle_is_active = 1;
+            daily_cycle_is_active = true;
+            mark_simulation_day_start(shm);
+            TRACE_EVENT(shm, TRACE_EVENT_DAY_START, getpid(), 0, 0);
             reset_dining_area_tables(shm);
             flush_message_queues(shm);
             arm_daily_timer(shm);
             open_barrier_gate(shm->semaphore_sync_id, BARRIER_MORNING_GATE);
 
             while (daily_cycle_is_active && shm->is_simulation_running) {
-                pause(); /* Attesa segnali (Timer, Refill, Emergenza) */
+                process_master_events(shm, -1); /* Allarmi, figli terminati, emergenza */
 
                 if (daily_cycle_is_active && shm->is_simulation_running && refill_requested) {
                     handle_refill_cycle(shm);
-                    refill_requested = 0;
+                    refill_requested = false;
                     setup_refill_signal(); /* Ri-arma per il prossimo evento casuale */
                 }
             }
@@ -121,20 +126,11 @@ void run_simulation_loop(MainSharedMemory *shm) {
 
             /* Notifica figli (Fine turno o Fine Simulazione) */
             int end_sig = (shm->is_simulation_running) ? SIGUSR2 : SIGTERM;
+            TRACE_EVENT(shm, TRACE_EVENT_DAY_END, getpid(), 0, 0);
             broadcast_signal_to_all_groups(shm, end_sig);
 
             /* Sincronizzazione serale */
-            int evening_barrier_ok = 0;
-            int evening_critical_err = 0;
-            while (shm->is_simulation_running && !evening_barrier_ok && !evening_critical_err) {
-                if (wait_for_zero_interruptible(shm->semaphore_sync_id, BARRIER_EVENING_READY) == 0) {
-                    evening_barrier_ok = 1;
-                } else if (errno != EINTR) {
-                    perror("[MASTER] Errore critico su barriera serale");
-                    evening_critical_err = 1;
-                }
-                /* EINTR: segnale ricevuto, ricontrolla is_simulation_running nel while */
-            }
+            wait_barrier_serving_events(shm, BARRIER_EVENING_READY);
 
             if (shm->is_simulation_running) {
                 /* Elaborazione richieste add_users e preparazione barriera mattutina */
@@ -150,18 +146,18 @@ void run_simulation_loop(MainSharedMemory *shm) {
 
                 /* Controllo OVERLOAD (Sez 5.6 della Consegna) */
                 if (daily_stats.clients_statistics.daily_clients_not_served > shm->configuration.thresholds.overload_threshold) {
-                    printf("[MASTER] TERMINAZIONE PER OVERLOAD: %d utenti rinunciatari oggi (Soglia: %d)\n",
-                           daily_stats.clients_statistics.daily_clients_not_served,
-                           shm->configuration.thresholds.overload_threshold);
+                    LOG_WARN("[MASTER] TERMINAZIONE PER OVERLOAD: %d utenti rinunciatari oggi (Soglia: %d)\n",
+                             daily_stats.clients_statistics.daily_clients_not_served,
+                             shm->configuration.thresholds.overload_threshold);
                     shm->is_simulation_running = 0;
                     shm->statistics.reason_for_termination = TERMINATION_REASON_OVERLOAD;
                 }
 
                 display_daily_statistics_report(daily_stats, shm->current_simulation_day);
-                save_statistics_to_csv(daily_stats, shm->current_simulation_day, "statistics_report.csv");
+                statistics_writer_append(&daily_stats, shm->current_simulation_day, STATISTICS_RECORD_DAY);
 
                 shm->current_simulation_day++;
-                printf("[MASTER] --- FINE GIORNO %d ---\n", shm->current_simulation_day);
+                LOG_INFO("[MASTER] --- FINE GIORNO %d ---\n", shm->current_simulation_day);
             } else {
                 open_barrier_gate(shm->semaphore_sync_id, BARRIER_EVENING_GATE);
                 open_barrier_gate(shm->semaphore_sync_id, BARRIER_MORNING_GATE);
@@ -180,51 +176,28 @@ void handle_refill_cycle(MainSharedMemory *shm) {
     /* Refill Primi */
     release_sem(shm->first_course_station.semaphore_set_id, STATION_SEM_REFILL_GATE);
     for (int i = 0; i < shm->food_menu.number_of_first_courses; i++) {
-        shm->first_course_station.portions[i] += shm->configuration.thresholds.refill_amount_primi;
-        if (shm->first_course_station.portions[i] > shm->configuration.thresholds.maximum_portions_primi) {
-            shm->first_course_station.portions[i] = shm->configuration.thresholds.maximum_portions_primi;
-        }
+        refill_station_portions(&shm->first_course_station, i,
+                                shm->configuration.thresholds.refill_amount_primi,
+                                shm->configuration.thresholds.maximum_portions_primi);
     }
     reserve_sem(shm->first_course_station.semaphore_set_id, STATION_SEM_REFILL_GATE);
+    TRACE_EVENT(shm, TRACE_EVENT_REFILL, getpid(), STATION_CHANNEL_FIRST_COURSE, varied_refill_time);
 
     /* Refill Secondi */
     release_sem(shm->second_course_station.semaphore_set_id, STATION_SEM_REFILL_GATE);
     for (int i = 0; i < shm->food_menu.number_of_second_courses; i++) {
-        shm->second_course_station.portions[i] += shm->configuration.thresholds.refill_amount_secondi;
-        if (shm->second_course_station.portions[i] > shm->configuration.thresholds.maximum_portions_secondi) {
-            shm->second_course_station.portions[i] = shm->configuration.thresholds.maximum_portions_secondi;
-        }
+        refill_station_portions(&shm->second_course_station, i,
+                                shm->configuration.thresholds.refill_amount_secondi,
+                                shm->configuration.thresholds.maximum_portions_secondi);
     }
     reserve_sem(shm->second_course_station.semaphore_set_id, STATION_SEM_REFILL_GATE);
+    TRACE_EVENT(shm, TRACE_EVENT_REFILL, getpid(), STATION_CHANNEL_SECOND_COURSE, varied_refill_time);
 
-    printf("[MASTER] Refill completato in %d min.\n", varied_refill_time);
+    LOG_INFO("[MASTER] Refill completato in %d min.\n", varied_refill_time);
 }
 
 void arm_daily_timer(MainSharedMemory *shm) {
-    struct sigevent sev;
-    timer_t timerid;
-    struct itimerspec its;
-    struct sigaction sa;
-
-    sa.sa_handler = handle_daily_cycle_end;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
-    sigaction(SIGALRM, &sa, NULL);
-
-    sev.sigev_notify = SIGEV_SIGNAL;
-    sev.sigev_signo = SIGALRM;
-    sev.sigev_value.sival_ptr = &timerid;
-    timer_create(CLOCK_REALTIME, &sev, &timerid);
-
-    long long meal_ns = (long long)shm->configuration.timings.meal_duration_minutes * 
-                         shm->configuration.timings.nanoseconds_per_tick;
-
-    its.it_value.tv_sec = (time_t)(meal_ns / 1000000000LL);
-    its.it_value.tv_nsec = (long)(meal_ns % 1000000000LL);
-    its.it_interval.tv_sec = 0;
-    its.it_interval.tv_nsec = 0;
-
-    timer_settime(timerid, 0, &its, NULL);
+    arm_clock_alarm(shm, CLOCK_ALARM_DAY_END, shm->configuration.timings.meal_duration_minutes);
 }
 
 void broadcast_signal_to_all_groups(MainSharedMemory *shm, int signal) {
@@ -236,135 +209,119 @@ void broadcast_signal_to_all_groups(MainSharedMemory *shm, int signal) {
     }
 }
 
-void setup_sigchld_handler(MainSharedMemory *shm) {
-    struct sigaction sa;
+void setup_master_signals(MainSharedMemory *shm) {
     global_shm_ref = shm;
-    sa.sa_handler = handle_sigchld;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = SA_NOCLDSTOP;
-    sigaction(SIGCHLD, &sa, NULL);
+    setup_master_event_loop();
 }
 
-void setup_signal_close_day(MainSharedMemory *shm) {
-    struct sigaction sa;
-    global_shm_ref = shm;
-    sa.sa_handler = handle_emergency_termination;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
-    sigaction(SIGINT, &sa, NULL);
-    sigaction(SIGTERM, &sa, NULL);
-
-    sa.sa_handler = handle_add_users_request;
-    sigaction(SIGUSR1, &sa, NULL);
+int wait_barrier_serving_events(MainSharedMemory *shm, int semaphore_index) {
+    while (shm->is_simulation_running) {
+        if (wait_for_zero_timed(shm->semaphore_sync_id, semaphore_index, MASTER_BARRIER_POLL_NS) == 0) {
+            return 0;
+        }
+        if (errno != EAGAIN && errno != EINTR) {
+            fprintf(stderr, "[MASTER] Errore critico su barriera %d: %s\n", semaphore_index, strerror(errno));
+            return -1;
+        }
+        /* Figli terminati durante l'attesa: la compensazione sblocca la barriera */
+        process_master_events(shm, 0);
+    }
+    return -1;
 }
 
 void setup_refill_signal(void) {
-    struct sigevent sev;
-    timer_t timerid;
-    struct itimerspec its;
-    struct sigaction sa;
-
-    sa.sa_handler = handle_refill_signal;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
-    sigaction(SIGRTMIN + 1, &sa, NULL);
-
-    sev.sigev_notify = SIGEV_SIGNAL;
-    sev.sigev_signo = SIGRTMIN + 1;
-    sev.sigev_value.sival_ptr = &timerid;
-    timer_create(CLOCK_REALTIME, &sev, &timerid);
-
     /* [CONSEGNA 5.2] Trigger refill ogni 10 minuti simulati */
     int trigger_minutes = 10;
-    long long refill_ns = (long long)trigger_minutes * global_shm_ref->configuration.timings.nanoseconds_per_tick;
-
-    its.it_value.tv_sec = (time_t)(refill_ns / 1000000000LL);
-    its.it_value.tv_nsec = (long)(refill_ns % 1000000000LL);
-    its.it_interval.tv_sec = 0;
-    its.it_interval.tv_nsec = 0;
-
-    timer_settime(timerid, 0, &its, NULL);
+    arm_clock_alarm(global_shm_ref, CLOCK_ALARM_REFILL, trigger_minutes);
 }
 
 void setup_group_barriers(MainSharedMemory *shm_ptr) {
-    for (int i = 0; i < shm_ptr->group_pool_size; i++) {
-        int active = shm_ptr->group_statuses[i].active_members;
-        if (active > 0) {
+    int total_sems = shm_ptr->group_pool_size * GROUP_SEMS_PER_ENTRY;
+    unsigned short *values = malloc((size_t)total_sems * sizeof(unsigned short));
+    if (values == NULL) {
+        /* Nessuna barriera del giorno precedente deve sopravvivere: ripiego su SETVAL per gruppo */
+        perror("[MASTER] Allocazione valori barriere gruppi fallita, uso SETVAL per gruppo");
+        for (int i = 0; i < shm_ptr->group_pool_size; i++) {
+            int active = shm_ptr->group_statuses[i].active_members;
             int base = i * GROUP_SEMS_PER_ENTRY;
             init_sem_val(shm_ptr->group_sync_semaphore_id, base + GROUP_SEM_PRE_CASHIER, active);
             init_sem_val(shm_ptr->group_sync_semaphore_id, base + GROUP_SEM_TABLE_GATE, 1);
             init_sem_val(shm_ptr->group_sync_semaphore_id, base + GROUP_SEM_EXIT, active);
         }
+        return;
     }
+
+    /* Gli slot inattivi tornano allo stato di riposo (0, 1, 0) del pool */
+    for (int i = 0; i < shm_ptr->group_pool_size; i++) {
+        int active = shm_ptr->group_statuses[i].active_members;
+        int base = i * GROUP_SEMS_PER_ENTRY;
+        values[base + GROUP_SEM_PRE_CASHIER] = (unsigned short)active;
+        values[base + GROUP_SEM_TABLE_GATE] = 1;
+        values[base + GROUP_SEM_EXIT] = (unsigned short)active;
+    }
+
+    /* Una sola semctl(SETALL) al posto di 3 SETVAL per gruppo */
+    init_sem_set_all(shm_ptr->group_sync_semaphore_id, values);
+    free(values);
 }
 
 /* ==========================================================================
  *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
  * ========================================================================== */
 
-static void handle_daily_cycle_end(int sig) {
-    (void)sig;
-    daily_cycle_is_active = 0;
-}
-
-static void handle_emergency_termination(int sig) {
-    (void)sig;
-    if (global_shm_ref != NULL) {
-        global_shm_ref->is_simulation_running = 0;
-        global_shm_ref->statistics.reason_for_termination = TERMINATION_REASON_SIGNAL;
+/**
+ * Raccoglie gli eventi pronti e li applica in ordine fisso: prima la
+ * compensazione dei figli terminati, poi allarmi e richieste esterne.
+ */
+static void process_master_events(MainSharedMemory *shm, int timeout_ms) {
+    MasterEvents events;
+    if (!poll_master_events(timeout_ms, &events)) return;
+
+    if (events.children_exited) reap_terminated_children(shm);
+    if (events.add_users) shm->add_users_flag = 1;
+    if (events.refill) refill_requested = true;
+    if (events.day_end) daily_cycle_is_active = false;
+
+    if (events.terminate) {
+        shm->is_simulation_running = 0;
+        shm->statistics.reason_for_termination = TERMINATION_REASON_SIGNAL;
+        daily_cycle_is_active = false;
     }
-    daily_cycle_is_active = 0;
-}
-
-static void handle_add_users_request(int sig) {
-    (void)sig;
-    if (global_shm_ref != NULL) global_shm_ref->add_users_flag = 1;
-}
-
-static void handle_refill_signal(int sig) {
-    (void)sig;
-    refill_requested = 1;
 }
 
-static void handle_sigchld(int sig) {
-    (void)sig;
+/**
+ * Raccoglie i figli terminati e compensa barriere e gruppi che li attendevano.
+ * Gli utenti adottati (zygote, add_users) arrivano qui come figli del subreaper.
+ */
+static void reap_terminated_children(MainSharedMemory *shm) {
     int status;
     pid_t pid;
 
     while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
-        if (global_shm_ref != NULL) {
-            /* Compensazione barriere */
-            reserve_sem_try_no_undo(global_shm_ref->semaphore_sync_id, BARRIER_MORNING_READY);
-            reserve_sem_try_no_undo(global_shm_ref->semaphore_sync_id, BARRIER_EVENING_READY);
-
-            /* Compensazione gruppi */
-            int found = 0;
-            for (int r = 0; r < MAX_USERS_REGISTRY && !found; r++) {
-                if (global_shm_ref->user_registry[r].pid == pid) {
-                    int g_idx = global_shm_ref->user_registry[r].group_index;
-                    int base = g_idx * GROUP_SEMS_PER_ENTRY;
-                    
-                    if (global_shm_ref->group_statuses[g_idx].active_members > 0) {
-                        global_shm_ref->group_statuses[g_idx].active_members--;
-                    }
-                    
-                    reserve_sem_try_no_undo(global_shm_ref->group_sync_semaphore_id, base + GROUP_SEM_PRE_CASHIER);
-                    reserve_sem_try_no_undo(global_shm_ref->group_sync_semaphore_id, base + GROUP_SEM_EXIT);
-                    
-                    if (global_shm_ref->group_statuses[g_idx].group_leader_pid == pid) {
-                        global_shm_ref->group_statuses[g_idx].group_leader_pid = 0;
-                    }
-
-                    global_shm_ref->user_registry[r].pid = 0; 
-                    found = 1;
-                }
-            }
+        /* Lookup O(1) nel registry: processo utente o host con i suoi utenti */
+        UserProcessMetadata lost;
+        lock_simulation_mutex(shm, MUTEX_USER_REGISTRY);
+        int found = user_registry_remove(&shm->user_registry, pid, &lost);
+        unlock_simulation_mutex(shm, MUTEX_USER_REGISTRY);
+
+        if (found == -1) {
+            /* Operatori, zygote e processi non tracciati: un solo arrivo alle barriere */
+            compensate_lost_barrier_arrivals(shm, 1);
+            continue;
+        }
+
+        /* Compensazione barriere e popolazione per tutti gli utenti del processo */
+        withdraw_lost_users(shm, lost.user_count);
+
+        /* Compensazione gruppi: un host porta con sé tutti i membri rimasti dei suoi gruppi */
+        for (int g = 0; g < lost.group_count; g++) {
+            withdraw_lost_group_members(shm, lost.group_index + g, lost.is_host ? -1 : 1, pid);
         }
     }
 }
 
 static void reset_daily_statistics(MainSharedMemory *shm) {
-    reserve_sem(shm->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+    lock_simulation_mutex(shm, MUTEX_SIMULATION_STATS);
     
     /* Reset Utenti Giornalieri */
     shm->statistics.clients_statistics.daily_clients_served = 0;
@@ -383,25 +340,29 @@ static void reset_daily_statistics(MainSharedMemory *shm) {
     
     /* Reset Accumulatori Tempi del Giorno */
     memset(&shm->statistics.daily_wait_accumulators, 0, sizeof(WaitTimeAccumulator));
+    memset(shm->statistics.daily_retired_service, 0, sizeof(shm->statistics.daily_retired_service));
     
-    release_sem(shm->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+    unlock_simulation_mutex(shm, MUTEX_SIMULATION_STATS);
+
+    /* Shard per processo: tutti i figli sono fermi sulla barriera mattutina */
+    reset_daily_statistics_counters(shm);
 }
 
 /**
  * Calcola i piatti avanzati nelle stazioni alla fine della giornata.
  */
 static void calculate_food_waste_and_teardown(MainSharedMemory *shm) {
-    reserve_sem(shm->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
-    reserve_sem(shm->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    lock_simulation_mutex(shm, MUTEX_SIMULATION_STATS);
     
+    /* Inventario lock-free: a fine giornata gli operatori non prelevano più */
     int first_waste = 0;
     for (int i = 0; i < shm->food_menu.number_of_first_courses; i++) {
-        first_waste += shm->first_course_station.portions[i];
+        first_waste += get_station_portions(&shm->first_course_station, i);
     }
     
     int second_waste = 0;
     for (int i = 0; i < shm->food_menu.number_of_second_courses; i++) {
-        second_waste += shm->second_course_station.portions[i];
+        second_waste += get_station_portions(&shm->second_course_station, i);
     }
     
     /* Caffè/Dolci: quantità illimitata (consegna sez. 5.2), non contano come waste */
@@ -418,8 +379,7 @@ static void calculate_food_waste_and_teardown(MainSharedMemory *shm) {
     shm->statistics.total_leftover_plates.coffee_dessert_count += 0;
     shm->statistics.total_leftover_plates.total_plates_count += (first_waste + second_waste);
 
-    release_sem(shm->semaphore_mutex_id, MUTEX_SHARED_DATA);
-    release_sem(shm->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+    unlock_simulation_mutex(shm, MUTEX_SIMULATION_STATS);
 }
 
 
@@ -428,29 +388,29 @@ static void perform_initial_daily_refill(MainSharedMemory *shm) {
     /* Primi */
     release_sem(shm->first_course_station.semaphore_set_id, STATION_SEM_REFILL_GATE);
     for (int i = 0; i < shm->food_menu.number_of_first_courses; i++) {
-        shm->first_course_station.portions[i] = shm->configuration.thresholds.refill_amount_primi;
+        set_station_portions(&shm->first_course_station, i, shm->configuration.thresholds.refill_amount_primi);
     }
     reserve_sem(shm->first_course_station.semaphore_set_id, STATION_SEM_REFILL_GATE);
 
     /* Secondi */
     release_sem(shm->second_course_station.semaphore_set_id, STATION_SEM_REFILL_GATE);
     for (int i = 0; i < shm->food_menu.number_of_second_courses; i++) {
-        shm->second_course_station.portions[i] = shm->configuration.thresholds.refill_amount_secondi;
+        set_station_portions(&shm->second_course_station, i, shm->configuration.thresholds.refill_amount_secondi);
     }
     reserve_sem(shm->second_course_station.semaphore_set_id, STATION_SEM_REFILL_GATE);
 
     /* Caffè e Dessert */
     release_sem(shm->coffee_dessert_station.semaphore_set_id, STATION_SEM_REFILL_GATE);
     for (int i = 0; i < 4; i++) {
-        shm->coffee_dessert_station.portions[i] = 100; /* Abbondante per caffè/dolci */
+        set_station_portions(&shm->coffee_dessert_station, i, 100); /* Abbondante per caffè/dolci */
     }
     reserve_sem(shm->coffee_dessert_station.semaphore_set_id, STATION_SEM_REFILL_GATE);
 }
 
 static void process_add_users_requests(MainSharedMemory *shm) {
     int processed = 0;
-    printf("[DEBUG-MASTER] process_add_users_requests: add_users_flag=%d, current_total_users=%d\n",
-           shm->add_users_flag, shm->current_total_users);
+    LOG_DEBUG("[DEBUG-MASTER] process_add_users_requests: add_users_flag=%d, current_total_users=%d\n",
+              shm->add_users_flag, shm->current_total_users);
 
     if (shm->add_users_flag) {
         SimulationMessage msg;
@@ -458,51 +418,41 @@ static void process_add_users_requests(MainSharedMemory *shm) {
             processed++;
             /* NON incrementiamo current_total_users qui - lo farà add_users dopo lo spawn */
         }
-        printf("[DEBUG-MASTER] Letti %d messaggi dalla coda\n", processed);
+        LOG_DEBUG("[DEBUG-MASTER] Letti %d messaggi dalla coda\n", processed);
     }
 
     if (processed > 0) {
         shm->add_users_flag = 0;
 
-        printf("[DEBUG-MASTER] Configuro BARRIER_ADD_USERS con count=%d\n", processed);
+        LOG_DEBUG("[DEBUG-MASTER] Configuro BARRIER_ADD_USERS con count=%d\n", processed);
         setup_barrier(shm->semaphore_sync_id, BARRIER_ADD_USERS_READY, BARRIER_ADD_USERS_GATE, processed);
 
-        printf("[DEBUG-MASTER] Rilascio %d permessi MUTEX_ADD_USERS_PERMISSION\n", processed);
+        LOG_DEBUG("[DEBUG-MASTER] Rilascio %d permessi MUTEX_ADD_USERS_PERMISSION\n", processed);
         for (int i = 0; i < processed; i++) {
             release_sem(shm->semaphore_mutex_id, MUTEX_ADD_USERS_PERMISSION);
         }
 
-        printf("[DEBUG-MASTER] Attendo BARRIER_ADD_USERS_READY = 0...\n");
-        int add_users_barrier_ok = 0;
-        int add_users_critical_err = 0;
-        while (shm->is_simulation_running && !add_users_barrier_ok && !add_users_critical_err) {
-            if (wait_for_zero_interruptible(shm->semaphore_sync_id, BARRIER_ADD_USERS_READY) == 0) {
-                add_users_barrier_ok = 1;
-            } else if (errno != EINTR) {
-                perror("[MASTER] Errore critico su barriera add_users");
-                add_users_critical_err = 1;
-            }
-            /* EINTR: segnale ricevuto, ricontrolla is_simulation_running nel while */
-        }
-        printf("[DEBUG-MASTER] BARRIER_ADD_USERS_READY raggiunto 0, current_total_users=%d\n",
-               shm->current_total_users);
+        LOG_DEBUG("[DEBUG-MASTER] Attendo BARRIER_ADD_USERS_READY = 0...\n");
+        wait_barrier_serving_events(shm, BARRIER_ADD_USERS_READY);
+        LOG_DEBUG("[DEBUG-MASTER] BARRIER_ADD_USERS_READY raggiunto 0, current_total_users=%d\n",
+                  shm->current_total_users);
     }
 
     /* Configura la barriera mattutina PRIMA di aprire i gate - così è pronta quando i nuovi utenti partono */
     int next_morning_count = shm->configuration.quantities.number_of_workers +
                              shm->configuration.seats.seats_cash_desk +
                              shm->current_total_users;
-    printf("[DEBUG-MASTER] Configuro BARRIER_MORNING: workers=%d + casse=%d + users=%d = %d\n",
-           shm->configuration.quantities.number_of_workers,
-           shm->configuration.seats.seats_cash_desk,
-           shm->current_total_users,
-           next_morning_count);
+    LOG_DEBUG("[DEBUG-MASTER] Configuro BARRIER_MORNING: workers=%d + casse=%d + users=%d = %d\n",
+              shm->configuration.quantities.number_of_workers,
+              shm->configuration.seats.seats_cash_desk,
+              shm->current_total_users,
+              next_morning_count);
     setup_barrier(shm->semaphore_sync_id, BARRIER_MORNING_READY, BARRIER_MORNING_GATE, next_morning_count);
 
     if (processed > 0) {
-        printf("[DEBUG-MASTER] Apro BARRIER_ADD_USERS_GATE\n");
+        LOG_DEBUG("[DEBUG-MASTER] Apro BARRIER_ADD_USERS_GATE\n");
         open_barrier_gate(shm->semaphore_sync_id, BARRIER_ADD_USERS_GATE);
-        printf("[MASTER] Elaborati %d blocchi add_users. Spawn completato.\n", processed);
+        LOG_INFO("[MASTER] Elaborati %d blocchi add_users. Spawn completato.\n", processed);
     }
     shm->add_users_flag = 0;
 }
@@ -512,11 +462,9 @@ static void process_add_users_requests(MainSharedMemory *shm) {
  * Risolve il leak di posti causato da utenti interrotti prima di liberare il tavolo.
  */
 static void reset_dining_area_tables(MainSharedMemory *shm) {
-    reserve_sem(shm->semaphore_mutex_id, MUTEX_TABLES);
-    for (int i = 0; i < shm->seat_area.active_tables_count; i++) {
-        shm->seat_area.tables[i].occupied_seats = 0;
-    }
-    release_sem(shm->semaphore_mutex_id, MUTEX_TABLES);
+    lock_simulation_mutex(shm, MUTEX_TABLES);
+    dining_area_reset(&shm->seat_area);
+    unlock_simulation_mutex(shm, MUTEX_TABLES);
 }
 
 /**
@@ -524,34 +472,10 @@ static void reset_dining_area_tables(MainSharedMemory *shm) {
  * Risolve l'accumulo di messaggi orfani (ordini non processati del giorno precedente).
  */
 static void flush_message_queues(MainSharedMemory *shm) {
-    SimulationMessage msg;
-    int flushed_count = 0;
-
-    /* Svuota coda Primi Piatti */
-    while (receive_message_from_queue(shm->first_course_station.message_queue_id,
-           &msg, sizeof(StationPayload), 0, IPC_NOWAIT) != -1) {
-        flushed_count++;
-    }
-
-    /* Svuota coda Secondi Piatti */
-    while (receive_message_from_queue(shm->second_course_station.message_queue_id,
-           &msg, sizeof(StationPayload), 0, IPC_NOWAIT) != -1) {
-        flushed_count++;
-    }
-
-    /* Svuota coda Caffè/Dolci */
-    while (receive_message_from_queue(shm->coffee_dessert_station.message_queue_id,
-           &msg, sizeof(StationPayload), 0, IPC_NOWAIT) != -1) {
-        flushed_count++;
-    }
-
-    /* Svuota coda Cassa */
-    while (receive_message_from_queue(shm->register_station.message_queue_id,
-           &msg, sizeof(CashierPayload), 0, IPC_NOWAIT) != -1) {
-        flushed_count++;
-    }
+    /* Svuota ordini e risposte orfane di Primi, Secondi, Caffè/Dolci e Cassa */
+    int flushed_count = station_channel_flush_all(shm);
 
     if (flushed_count > 0) {
-        printf("[MASTER] Svuotate code messaggi: %d messaggi orfani rimossi.\n", flushed_count);
+        LOG_INFO("[MASTER] Svuotate code messaggi: %d messaggi orfani rimossi.\n", flushed_count);
     }
 }
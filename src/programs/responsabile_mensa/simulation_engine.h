@@ -3,7 +3,7 @@
  * @brief Header per il motore di simulazione del Responsabile Mensa.
  * 
  * Questo modulo gestisce il core loop temporale della simulazione, il controllo
- * dei timer POSIX, il rifornimento delle stazioni e la gestione dei segnali 
+ * degli allarmi sull'orologio simulato, il rifornimento delle stazioni e la gestione dei segnali 
  * di broadcast verso gli utenti e gli operatori.
  * 
  * @see simulation_engine.c per l'implementazione della logica.
@@ -34,10 +34,10 @@
 void run_simulation_loop(MainSharedMemory *shm);
 
 /**
- * @brief Configura e arma il timer POSIX per la fine della giornata lavorativa.
+ * @brief Arma l'allarme di fine giornata sull'orologio simulato (clock_ticker.h).
  * 
- * Al completamento del timer, il Master riceve un segnale (solitamente SIGALRM)
- * che innesca la fase di chiusura serale.
+ * La scadenza arriva al loop eventi del Master (master_events.h) e
+ * innesca la fase di chiusura serale.
  * 
  * @param shm Puntatore alla memoria condivisa per i parametri di timing.
  */
@@ -58,7 +58,7 @@ void arm_daily_timer(MainSharedMemory *shm);
 void handle_refill_cycle(MainSharedMemory *shm);
 
 /**
- * @brief Configura il timer/segnale per il rifornimento periodico.
+ * @brief Arma (o riarma) l'allarme per il rifornimento periodico.
  */
 void setup_refill_signal(void);
 
@@ -67,20 +67,27 @@ void setup_refill_signal(void);
  * ========================================================================== */
 
 /**
- * @brief Configura l'handler per gestire la terminazione asincrona dei figli (waitpid).
+ * @brief Instrada SIGINT/SIGTERM, SIGUSR1 e SIGCHLD sul loop eventi del Master.
  * 
- * Previene la creazione di processi zombie durante la simulazione.
+ * I segnali restano bloccati e vengono gestiti in modo sincrono: terminazione
+ * di emergenza, richieste add_users e raccolta dei figli con compensazione
+ * delle barriere. Va chiamata prima di lanciare i figli.
  * 
  * @param shm Puntatore alla memoria condivisa.
  */
-void setup_sigchld_handler(MainSharedMemory *shm);
+void setup_master_signals(MainSharedMemory *shm);
 
 /**
- * @brief Configura i segnali per la gestione della chiusura giornata (SIGINT, SIGALRM).
+ * @brief Attende che una barriera di BARRIER_* si azzeri servendo gli eventi del Master.
+ * 
+ * Tra un tentativo e l'altro raccoglie i figli terminati, così la
+ * compensazione può sbloccare la barriera che li stava aspettando.
  * 
  * @param shm Puntatore alla memoria condivisa.
+ * @param semaphore_index Indice del semaforo READY nel set di sincronizzazione.
+ * @return int 0 se raggiunta, -1 se la simulazione è stata fermata o in caso di errore.
  */
-void setup_signal_close_day(MainSharedMemory *shm);
+int wait_barrier_serving_events(MainSharedMemory *shm, int semaphore_index);
 
 /**
  * @brief Invia un segnale a tutti i processi registrati nella mappatura SHM.
@@ -100,6 +107,8 @@ void broadcast_signal_to_all_groups(MainSharedMemory *shm, int signal);
  * @brief Inizializza o resetta le barriere di sincronizzazione per i gruppi.
  * 
  * Pulisce i semafori di gruppo (meeting point, tavoli, uscita) per una nuova giornata.
+ * L'intero pool viene riscritto con una sola semctl(SETALL); se l'allocazione
+ * dei valori fallisce si ripiega su tre SETVAL per gruppo.
  * 
  * @param shm_ptr Puntatore alla memoria condivisa.
  */
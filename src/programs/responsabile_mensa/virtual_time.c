@@ -0,0 +1,302 @@
+/**
+ * @file virtual_time.c
+ * @brief Thread del Master che avanza l'orologio virtuale a sistema fermo.
+ *
+ * Rilevamento della quiete: una scansione di /proc raccoglie per ogni thread
+ * della simulazione lo stato (campo 3 di stat) e il numero di volte che è
+ * andato in esecuzione (campo 3 di schedstat). Il sistema è fermo se due
+ * scansioni consecutive trovano solo thread bloccati con contatori invariati:
+ * un thread svegliato tra le due letture risulta eseguibile o già rischedulato.
+ * L'appartenenza dei processi alla simulazione viene ricalcolata solo quando
+ * l'elenco dei PID in /proc cambia.
+ *
+ * @see virtual_time.h
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/prctl.h>
+
+/* Includes del progetto */
+#include "virtual_time.h"
+#include "virtual_clock.h"
+#include "clock_ticker.h"
+#include "utils.h"
+#include "log.h"
+
+/** Pausa reale del thread tra due controlli mentre la simulazione è attiva */
+#define VIRTUAL_TIME_IDLE_NS 20000L
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Campione di un thread della simulazione. */
+typedef struct {
+    pid_t tid;
+    unsigned long long timeslices;      /**< Esecuzioni sulla CPU (schedstat) */
+} TaskSample;
+
+/** Scansione di tutti i thread della simulazione. */
+typedef struct {
+    TaskSample *tasks;
+    int count;
+    int capacity;
+    bool all_blocked;                   /**< Nessun thread in stato R o D */
+} TaskSnapshot;
+
+/** Elenco di PID ridimensionabile. */
+typedef struct {
+    pid_t *pids;
+    int count;
+    int capacity;
+} PidList;
+
+/** Processi della simulazione e firma dell'elenco di /proc da cui sono stati ricavati. */
+static PidList simulation_pids = {0};
+static unsigned long long simulation_pids_signature = 0;
+
+/** Stato del thread di avanzamento. */
+static pthread_t driver_thread;
+static atomic_bool driver_running = false;
+static pid_t driver_tid = 0;
+static MainSharedMemory *driver_shm = NULL;
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+/** Legge un piccolo file di /proc. Ritorna i byte letti o -1. */
+static ssize_t read_proc_file(const char *path, char *buffer, size_t size) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return -1;
+    ssize_t len = read(fd, buffer, size - 1);
+    close(fd);
+    if (len >= 0) buffer[len] = '\0';
+    return len;
+}
+
+/** Estrae stato e process group da una riga di stat (il nome può contenere spazi). */
+static bool parse_proc_stat(const char *line, char *state, pid_t *pgid) {
+    const char *name_end = strrchr(line, ')');
+    return name_end != NULL && sscanf(name_end + 2, "%c %*d %d", state, pgid) == 2;
+}
+
+/** Vero se il processo appartiene alla simulazione (Master o uno dei suoi gruppi). */
+static bool is_simulation_process(const MainSharedMemory *shm, pid_t pid) {
+    if (pid == shm->master_pid) return true;
+
+    char path[64];
+    char line[512];
+    char state;
+    pid_t pgid;
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    if (read_proc_file(path, line, sizeof(line)) <= 0 || !parse_proc_stat(line, &state, &pgid)) {
+        return false;
+    }
+
+    for (int i = 0; i < MAX_PROCESS_GROUPS; i++) {
+        if (shm->process_group_pids[i] > 0 && shm->process_group_pids[i] == pgid) return true;
+    }
+    return false;
+}
+
+/** Aggiunge i thread del processo `pid` alla scansione. */
+static void sample_process_tasks(TaskSnapshot *snapshot, pid_t pid) {
+    char path[96];
+    snprintf(path, sizeof(path), "/proc/%d/task", pid);
+    DIR *task_dir = opendir(path);
+    if (task_dir == NULL) return;
+
+    struct dirent *entry;
+    while ((entry = readdir(task_dir)) != NULL) {
+        pid_t tid = (pid_t)atoi(entry->d_name);
+        if (tid <= 0 || tid == driver_tid) continue;
+
+        char line[512];
+        char state;
+        pid_t pgid;
+        snprintf(path, sizeof(path), "/proc/%d/task/%d/stat", pid, tid);
+        if (read_proc_file(path, line, sizeof(line)) <= 0 || !parse_proc_stat(line, &state, &pgid)) {
+            continue; /* Thread terminato durante la scansione */
+        }
+        if (state == 'R' || state == 'D') snapshot->all_blocked = false;
+
+        unsigned long long timeslices = 0;
+        snprintf(path, sizeof(path), "/proc/%d/task/%d/schedstat", pid, tid);
+        if (read_proc_file(path, line, sizeof(line)) > 0) {
+            sscanf(line, "%*u %*u %llu", &timeslices);
+        }
+
+        if (snapshot->count == snapshot->capacity) {
+            int capacity = snapshot->capacity > 0 ? snapshot->capacity * 2 : 256;
+            TaskSample *tasks = realloc(snapshot->tasks, (size_t)capacity * sizeof(TaskSample));
+            if (tasks == NULL) {
+                snapshot->all_blocked = false;
+                break;
+            }
+            snapshot->tasks = tasks;
+            snapshot->capacity = capacity;
+        }
+        snapshot->tasks[snapshot->count].tid = tid;
+        snapshot->tasks[snapshot->count].timeslices = timeslices;
+        snapshot->count++;
+    }
+    closedir(task_dir);
+}
+
+/** Accoda un PID alla lista. Ritorna false se l'allocazione fallisce. */
+static bool pid_list_append(PidList *list, pid_t pid) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity > 0 ? list->capacity * 2 : 256;
+        pid_t *pids = realloc(list->pids, (size_t)capacity * sizeof(pid_t));
+        if (pids == NULL) return false;
+        list->pids = pids;
+        list->capacity = capacity;
+    }
+    list->pids[list->count++] = pid;
+    return true;
+}
+
+/** Aggiorna simulation_pids se l'elenco dei processi in /proc è cambiato. */
+static bool refresh_simulation_pids(const MainSharedMemory *shm, PidList *proc_pids) {
+    proc_pids->count = 0;
+    unsigned long long signature = 0;
+
+    DIR *proc_dir = opendir("/proc");
+    if (proc_dir == NULL) return false;
+
+    struct dirent *entry;
+    while ((entry = readdir(proc_dir)) != NULL) {
+        pid_t pid = (pid_t)atoi(entry->d_name);
+        if (pid <= 0) continue;
+        if (!pid_list_append(proc_pids, pid)) {
+            closedir(proc_dir);
+            return false;
+        }
+        signature = signature * 1000003ULL + (unsigned long long)pid;
+    }
+    closedir(proc_dir);
+
+    if (signature == simulation_pids_signature && simulation_pids.count > 0) return true;
+
+    simulation_pids.count = 0;
+    for (int i = 0; i < proc_pids->count; i++) {
+        if (is_simulation_process(shm, proc_pids->pids[i]) &&
+            !pid_list_append(&simulation_pids, proc_pids->pids[i])) {
+            return false;
+        }
+    }
+    simulation_pids_signature = signature;
+    return true;
+}
+
+/** Scansiona tutti i thread della simulazione. Ritorna false se qualcuno è eseguibile. */
+static bool take_task_snapshot(const MainSharedMemory *shm, PidList *proc_pids, TaskSnapshot *snapshot) {
+    snapshot->count = 0;
+    snapshot->all_blocked = refresh_simulation_pids(shm, proc_pids);
+
+    for (int i = 0; i < simulation_pids.count && snapshot->all_blocked; i++) {
+        sample_process_tasks(snapshot, simulation_pids.pids[i]);
+    }
+    return snapshot->all_blocked;
+}
+
+/** Vero se tutti i thread della simulazione sono bloccati e nessuno è ripartito. */
+static bool simulation_is_quiescent(const MainSharedMemory *shm, PidList *proc_pids,
+                                    TaskSnapshot *first, TaskSnapshot *second) {
+    if (!take_task_snapshot(shm, proc_pids, first) || !take_task_snapshot(shm, proc_pids, second)) {
+        return false;
+    }
+    if (first->count != second->count) return false;
+
+    for (int i = 0; i < first->count; i++) {
+        if (first->tasks[i].tid != second->tasks[i].tid ||
+            first->tasks[i].timeslices != second->tasks[i].timeslices) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Scadenza più vicina tra risvegli registrati e allarmi armati (-1: nessuna). */
+static long long next_virtual_deadline(const MainSharedMemory *shm, VirtualClock *clock) {
+    long long next = virtual_clock_next_wakeup(clock);
+    unsigned long long alarm_tick = next_clock_alarm_tick();
+    if (alarm_tick > 0) {
+        long long deadline = (long long)alarm_tick * shm->simulation_clock.tick_ns;
+        if (next == -1 || deadline < next) next = deadline;
+    }
+    return next;
+}
+
+/** Corpo del thread di avanzamento. */
+static void *virtual_time_driver_main(void *arg) {
+    VirtualClock *clock = (VirtualClock *)arg;
+    TaskSnapshot first = {0};
+    TaskSnapshot second = {0};
+    PidList proc_pids = {0};
+    struct timespec idle = {0, VIRTUAL_TIME_IDLE_NS};
+
+    driver_tid = gettid();
+    /* Pause brevi e precise: lo slack predefinito (50 µs) dominerebbe il ciclo */
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+
+    while (atomic_load(&driver_running)) {
+        if (next_virtual_deadline(driver_shm, clock) == -1 ||
+            !simulation_is_quiescent(driver_shm, &proc_pids, &first, &second)) {
+            nanosleep(&idle, NULL);
+            continue;
+        }
+
+        /* Ricalcolo a sistema fermo: include i risvegli registrati durante la scansione */
+        long long next = next_virtual_deadline(driver_shm, clock);
+        if (next == -1) continue;
+
+        /* Tick e allarmi prima del risveglio: chi riparte legge già il nuovo tick */
+        publish_simulation_tick(driver_shm, (unsigned long long)(next / driver_shm->simulation_clock.tick_ns));
+        virtual_clock_advance(clock, next);
+    }
+
+    free(first.tasks);
+    free(second.tasks);
+    free(proc_pids.pids);
+    free(simulation_pids.pids);
+    return NULL;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+void start_virtual_time_driver(MainSharedMemory *shm) {
+    driver_shm = shm;
+    virtual_clock_bind(&shm->virtual_clock);
+
+    atomic_store(&driver_running, true);
+    int err = spawn_master_thread(&driver_thread, virtual_time_driver_main, &shm->virtual_clock);
+
+    if (err != 0) {
+        atomic_store(&driver_running, false);
+        fprintf(stderr, "[ERROR] MASTER: avvio tempo virtuale fallito (errno %d)\n", err);
+        exit(EXIT_FAILURE);
+    }
+    LOG_INFO("[MASTER] Tempo virtuale attivo: il clock avanza a sistema fermo.\n");
+}
+
+void stop_virtual_time_driver(void) {
+    if (!atomic_exchange(&driver_running, false)) return;
+    pthread_join(driver_thread, NULL);
+
+    /* Processi non figli del Master (es. generati dallo zygote) possono essere ancora in attesa */
+    virtual_clock_advance(&driver_shm->virtual_clock, LLONG_MAX / 2);
+}
@@ -0,0 +1,36 @@
+/**
+ * @file virtual_time.h
+ * @brief Avanzamento del tempo virtuale da parte del Master (CLOCK_MODE=virtual).
+ *
+ * Un thread del Master osserva lo stato dei thread di tutti i processi della
+ * simulazione (gruppi in process_group_pids più il Master stesso). Quando
+ * nessuno è eseguibile per due scansioni consecutive e nessuno è stato
+ * schedulato nel frattempo, porta l'orologio virtuale alla scadenza più
+ * vicina tra i risvegli registrati e gli allarmi del Master (clock_ticker.h),
+ * pubblicando prima il tick corrispondente dell'orologio simulato.
+ *
+ * @see virtual_clock.h per il lato dei processi in attesa.
+ */
+
+#ifndef VIRTUAL_TIME_H
+#define VIRTUAL_TIME_H
+
+/* Includes del progetto */
+#include "common.h"
+
+/**
+ * @brief Collega il Master all'orologio virtuale e avvia il thread di avanzamento.
+ *
+ * Il thread blocca tutti i segnali: restano al thread principale del Master.
+ */
+void start_virtual_time_driver(MainSharedMemory *shm);
+
+/**
+ * @brief Arresta e attende il thread di avanzamento.
+ *
+ * Da chiamare dopo l'attesa dei figli: fino ad allora il tempo deve avanzare
+ * per chi termina un'attesa simulata.
+ */
+void stop_virtual_time_driver(void);
+
+#endif /* VIRTUAL_TIME_H */
@@ -0,0 +1,1000 @@
+/**
+ * @file user_engine.c
+ * @brief Event loop utenti: ogni utente è una macchina a stati (USER_HOST_EVENT_LOOP=1).
+ *
+ * Un solo processo esegue tutti gli utenti dei gruppi ricevuti. Gli stati
+ * ricalcano le fasi di esegui_percorso_mensa_giornaliero(): ticket, primi,
+ * secondi, riunione, cassa, tavolo, pasto, caffè, uscita. Nessuno stato blocca
+ * il processo:
+ * - le attese di servizio ticket e di consumazione sono timer su una timer wheel;
+ * - chi trova occupato il ticket o pieno un canale di stazione si accoda sulla
+ *   risorsa: a ogni tick dell'orologio simulato in SHM ritenta solo la testa
+ *   della coda, gli altri non fanno chiamate di sistema;
+ * - le risposte di operatori e cassieri si controllano su timer con attesa
+ *   raddoppiata a ogni controllo a vuoto (il canale timbra reply_tick, quindi
+ *   l'attesa registrata resta esatta);
+ * - i leader senza tavolo si registrano sul canale di attesa della propria
+ *   dimensione (dining_area_register_waiter) e ripartono solo quando un rilascio
+ *   lo segnala, come i leader dei processi utente;
+ * - riunione, gate tavolo e uscita collettiva sono eventi locali: i membri di
+ *   un gruppo stanno sempre nello stesso processo e vengono risvegliati
+ *   dall'ultimo arrivato senza passare dai semafori di gruppo.
+ *
+ * Le barriere giornaliere del Master vengono attraversate una volta per tutti
+ * gli utenti del processo (sync_children_start).
+ *
+ * @see user_host.h per gli argomenti e le identità virtuali degli utenti.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+
+/* Includes del progetto */
+#include "utente.h"
+#include "user_host.h"
+#include "sem.h"
+#include "mutex.h"
+#include "statistics.h"
+#include "shm.h"
+#include "station_channel.h"
+#include "utils.h"
+#include "trace.h"
+#include "log.h"
+
+/* ==========================================================================
+ *                             SEZIONE: COSTANTI
+ * ========================================================================== */
+
+/** Slot della timer wheel (potenza di 2) */
+#define ENGINE_WHEEL_SLOTS 4096
+
+/** Attesa massima tra due controlli della stessa risposta: ticks_per_minute / N tick */
+#define ENGINE_REPLY_BACKOFF_DIVISOR 4
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Stati del percorso giornaliero di un utente. */
+typedef enum {
+    ENGINE_STATE_TICKET = 0,            /**< Coda e validazione ticket */
+    ENGINE_STATE_FIRST_COURSE,          /**< Ordine alla stazione Primi */
+    ENGINE_STATE_SECOND_COURSE,         /**< Ordine alla stazione Secondi */
+    ENGINE_STATE_REGROUP,               /**< Meeting point pre-cassa */
+    ENGINE_STATE_CASHIER,               /**< Pagamento */
+    ENGINE_STATE_TABLE,                 /**< Ricerca tavolo (leader) o attesa del leader */
+    ENGINE_STATE_EAT,                   /**< Consumazione al tavolo */
+    ENGINE_STATE_COFFEE,                /**< Ordine alla stazione Caffè/Dolci */
+    ENGINE_STATE_EXIT,                  /**< Uscita collettiva */
+    ENGINE_STATE_DONE                   /**< Giornata conclusa */
+} EngineUserState;
+
+_Static_assert((int)ENGINE_STATE_EXIT == (int)TRACE_PHASE_EXIT && (int)ENGINE_STATE_DONE == (int)TRACE_PHASE_COUNT,
+               "Gli stati dell'event loop coincidono con le fasi di trace.h");
+_Static_assert((int)ENGINE_STATE_EXIT == (int)JOURNEY_EXIT,
+               "Gli stati dell'event loop coincidono con le fasi di JourneyMetric");
+
+/** Motivo per cui un utente ha ceduto il controllo all'event loop. */
+typedef enum {
+    ENGINE_BLOCK_NONE = 0,              /**< Non sospeso */
+    ENGINE_BLOCK_QUEUE,                 /**< In coda su una risorsa esterna (EngineWaitQueue) */
+    ENGINE_BLOCK_TIMER,                 /**< Timer armato sulla wheel */
+    ENGINE_BLOCK_LOCAL                  /**< Attende un evento del proprio gruppo */
+} EngineBlockReason;
+
+/** Code locali sulle risorse esterne: a ogni tick si ritenta solo la testa. */
+typedef enum {
+    ENGINE_QUEUE_TICKET = 0,            /**< Semaforo dei ticket */
+    ENGINE_QUEUE_SEND_BASE,             /**< Canale di stazione pieno (+ StationChannelIndex) */
+    ENGINE_QUEUE_TABLE_BASE = ENGINE_QUEUE_SEND_BASE + STATION_CHANNEL_COUNT, /**< Attesa tavolo (+ canale dining_area) */
+    ENGINE_QUEUE_COUNT = ENGINE_QUEUE_TABLE_BASE + DINING_WAIT_CHANNELS
+} EngineWaitQueue;
+
+/** Esito non bloccante di una fase ordine/risposta. */
+typedef enum {
+    ENGINE_PHASE_DONE = 0,              /**< Fase conclusa */
+    ENGINE_PHASE_WAIT_SEND,             /**< Canale pieno: ordine da ritentare */
+    ENGINE_PHASE_WAIT_REPLY             /**< Ordine inviato: risposta da controllare */
+} EnginePhaseResult;
+
+/** Stato di un utente dell'event loop. */
+typedef struct {
+    StatoUtente profile;                /**< Profilo (ticket, scelte menu, gruppo, tavolo) */
+    EngineUserState state;              /**< Fase corrente */
+    EngineBlockReason blocked;          /**< Motivo dell'ultima sospensione */
+    bool pending;                       /**< Azione asincrona della fase già avviata */
+    bool got_first;                     /**< Primo ottenuto */
+    bool got_second;                    /**< Secondo ottenuto */
+    bool counted;                       /**< Statistica servito/non servito già registrata */
+    int order_choice;                   /**< Piatto ordinato alla stazione corrente */
+    unsigned long long order_start;     /**< Tick di invio dell'ordine (tempi di attesa) */
+    int reply_backoff;                  /**< Tick prima del prossimo controllo della risposta */
+    long long timer_tick;               /**< Tick di scadenza del timer */
+    int timer_next;                     /**< Successivo nello slot della wheel (-1: fine) */
+    int wait_next;                      /**< Successivo nella coda della risorsa (-1: fine) */
+} EngineUser;
+
+/** Stato locale di un gruppo (tutti i membri nello stesso processo). */
+typedef struct {
+    int first_user;                     /**< Indice del primo membro in users[] */
+    int size;                           /**< Numero di membri */
+    int group_index;                    /**< Indice del gruppo nel pool di sincronizzazione */
+    int leader;                         /**< Indice del leader in users[], -1 se assente */
+    int regroup_pending;                /**< Come GROUP_SEM_PRE_CASHIER */
+    int exit_pending;                   /**< Come GROUP_SEM_EXIT */
+    bool table_ready;                   /**< Come GROUP_SEM_TABLE_GATE aperto */
+    int table_id;                       /**< Tavolo prenotato dal leader */
+} EngineGroup;
+
+/** Event loop con i suoi utenti. */
+typedef struct {
+    MainSharedMemory *shm_ptr;          /**< SHM della simulazione */
+    EngineUser *users;                  /**< Utenti del processo */
+    int users_count;                    /**< Numero di utenti */
+    EngineGroup *groups;                /**< Gruppi del processo */
+    int groups_count;                   /**< Numero di gruppi */
+    int *user_group;                    /**< Gruppo (indice in groups[]) di ogni utente */
+
+    int queue_head[ENGINE_QUEUE_COUNT]; /**< Teste delle code sulle risorse (-1: vuota) */
+    int queue_tail[ENGINE_QUEUE_COUNT]; /**< Ultimi delle code sulle risorse (-1: vuota) */
+    int retry_user;                     /**< Testa in fase di nuovo tentativo (-1: nessuna) */
+    int retry_queue;                    /**< Coda da cui è stata estratta retry_user */
+    bool retry_failed;                  /**< retry_user è tornata in testa alla sua coda */
+
+    int wheel[ENGINE_WHEEL_SLOTS];      /**< Teste delle liste per slot (-1: vuoto) */
+    int timers_armed;                   /**< Utenti con un timer sulla wheel */
+    SimulationClock *clock;             /**< Orologio simulato in SHM (tick della wheel) */
+    long long current_tick;             /**< Ultimo tick elaborato */
+    int reply_backoff_max;              /**< Limite di reply_backoff in tick */
+
+    int users_in_progress;              /**< Utenti non ancora in ENGINE_STATE_DONE */
+} UserEngine;
+
+/** Flag del ciclo giornaliero, azzerato da SIGUSR2/SIGTERM/SIGINT. */
+static volatile sig_atomic_t engine_day_is_active = 0;
+
+/* ==========================================================================
+ *                       SEZIONE: PROTOTIPI PRIVATI
+ * ========================================================================== */
+
+static void engine_user_step(UserEngine *engine, int idx);
+
+/* ==========================================================================
+ *                       SEZIONE: TEMPO E TIMER WHEEL
+ * ========================================================================== */
+
+static void handle_engine_signals(int sig) {
+    (void)sig;
+    engine_day_is_active = 0;
+}
+
+/** Tick corrente dell'orologio simulato condiviso. */
+static long long engine_now_tick(UserEngine *engine) {
+    return (long long)simulation_clock_now(engine->clock);
+}
+
+/** Arma il timer dell'utente dopo `ticks` tick (almeno uno). */
+static void engine_timer_arm_ticks(UserEngine *engine, int idx, long long ticks) {
+    if (ticks < 1) ticks = 1;
+
+    EngineUser *user = &engine->users[idx];
+    user->timer_tick = engine_now_tick(engine) + ticks;
+    if (user->timer_tick <= engine->current_tick) user->timer_tick = engine->current_tick + 1;
+
+    int slot = (int)(user->timer_tick & (ENGINE_WHEEL_SLOTS - 1));
+    user->timer_next = engine->wheel[slot];
+    engine->wheel[slot] = idx;
+    user->blocked = ENGINE_BLOCK_TIMER;
+    engine->timers_armed++;
+}
+
+/** Arma il timer dell'utente dopo `delay_ns` nanosecondi reali (almeno un tick). */
+static void engine_timer_arm(UserEngine *engine, int idx, long long delay_ns) {
+    long tick_ns = engine->clock->tick_ns;
+    engine_timer_arm_ticks(engine, idx, (delay_ns + tick_ns - 1) / tick_ns);
+}
+
+/** Avanza la wheel fino al tick corrente e riprende gli utenti scaduti. */
+static void engine_timer_advance(UserEngine *engine) {
+    long long now_tick = engine_now_tick(engine);
+    long long steps = now_tick - engine->current_tick;
+    if (steps <= 0) return;
+    if (steps > ENGINE_WHEEL_SLOTS) steps = ENGINE_WHEEL_SLOTS;
+
+    /* Raccolta prima della ripresa: i nuovi timer vanno negli slot dopo now_tick */
+    int expired = -1;
+    for (long long t = 1; t <= steps; t++) {
+        int slot = (int)((engine->current_tick + t) & (ENGINE_WHEEL_SLOTS - 1));
+        int idx = engine->wheel[slot];
+        engine->wheel[slot] = -1;
+        while (idx != -1) {
+            int next = engine->users[idx].timer_next;
+            if (engine->users[idx].timer_tick <= now_tick) {
+                engine->users[idx].timer_next = expired;
+                expired = idx;
+                engine->timers_armed--;
+            } else {
+                engine->users[idx].timer_next = engine->wheel[slot];
+                engine->wheel[slot] = idx;
+            }
+            idx = next;
+        }
+    }
+    engine->current_tick = now_tick;
+
+    while (expired != -1) {
+        int next = engine->users[expired].timer_next;
+        engine->users[expired].blocked = ENGINE_BLOCK_NONE;
+        engine_user_step(engine, expired);
+        expired = next;
+    }
+}
+
+/**
+ * Primo tick con un timer armato (-1 se nessun utente attende un timer).
+ * Scorre la wheel in avanti da current_tick: si ferma al primo slot con un
+ * timer del giro corrente; i timer dei giri successivi danno il minimo di ripiego.
+ */
+static long long engine_next_timer_tick(UserEngine *engine) {
+    if (engine->timers_armed == 0) return -1;
+
+    long long next = -1;
+    for (long long t = 1; t <= ENGINE_WHEEL_SLOTS; t++) {
+        long long tick = engine->current_tick + t;
+        for (int idx = engine->wheel[tick & (ENGINE_WHEEL_SLOTS - 1)]; idx != -1; idx = engine->users[idx].timer_next) {
+            long long timer_tick = engine->users[idx].timer_tick;
+            if (timer_tick <= tick) return timer_tick;
+            if (next == -1 || timer_tick < next) next = timer_tick;
+        }
+    }
+    return next;
+}
+
+/* ==========================================================================
+ *                      SEZIONE: CODE SULLE RISORSE
+ * ========================================================================== */
+
+/** true se l'utente deve accodarsi senza tentare: la risorsa ha già utenti in coda davanti a lui. */
+static bool engine_queue_busy(UserEngine *engine, int idx, int queue) {
+    if (engine->retry_user == idx && engine->retry_queue == queue) return false;
+    return engine->queue_head[queue] != -1;
+}
+
+/** Accoda l'utente sulla risorsa: in testa se è la testa appena ritentata, altrimenti in fondo. */
+static void engine_block_queue(UserEngine *engine, int idx, int queue) {
+    EngineUser *user = &engine->users[idx];
+    user->blocked = ENGINE_BLOCK_QUEUE;
+
+    if (engine->retry_user == idx && engine->retry_queue == queue) {
+        user->wait_next = engine->queue_head[queue];
+        engine->queue_head[queue] = idx;
+        if (engine->queue_tail[queue] == -1) engine->queue_tail[queue] = idx;
+        engine->retry_failed = true;
+        return;
+    }
+
+    user->wait_next = -1;
+    if (engine->queue_tail[queue] == -1) {
+        engine->queue_head[queue] = idx;
+    } else {
+        engine->users[engine->queue_tail[queue]].wait_next = idx;
+    }
+    engine->queue_tail[queue] = idx;
+}
+
+/** Estrae la testa della coda (non vuota). */
+static int engine_queue_pop(UserEngine *engine, int queue) {
+    int idx = engine->queue_head[queue];
+    engine->queue_head[queue] = engine->users[idx].wait_next;
+    if (engine->queue_head[queue] == -1) engine->queue_tail[queue] = -1;
+    return idx;
+}
+
+/** true se qualche coda va ritentata al prossimo tick (il canale tavolo 0 non viene mai segnalato). */
+static bool engine_queues_pending(const UserEngine *engine) {
+    for (int q = 0; q < ENGINE_QUEUE_COUNT; q++) {
+        if (q != ENGINE_QUEUE_TABLE_BASE && engine->queue_head[q] != -1) return true;
+    }
+    return false;
+}
+
+/**
+ * Ritenta le code sulle risorse esterne: per ciascuna riprende la testa finché
+ * la risorsa la accetta, quindi al più un tentativo a vuoto per risorsa e tick.
+ * I leader in attesa di tavolo ripartono solo consumando il gettone del proprio
+ * canale, postato da dining_area_wake_fitting_waiters().
+ */
+static void engine_poll_queues(UserEngine *engine) {
+    int condition_semaphore_id = engine->shm_ptr->seat_area.condition_semaphore_id;
+
+    for (int q = 0; q < ENGINE_QUEUE_COUNT && engine_day_is_active; q++) {
+        if (q == ENGINE_QUEUE_TABLE_BASE) continue;
+
+        while (engine->queue_head[q] != -1 && engine_day_is_active) {
+            if (q > ENGINE_QUEUE_TABLE_BASE &&
+                reserve_sem_try_no_undo(condition_semaphore_id, q - ENGINE_QUEUE_TABLE_BASE) == -1) {
+                break;
+            }
+
+            int idx = engine_queue_pop(engine, q);
+            engine->retry_user = idx;
+            engine->retry_queue = q;
+            engine->retry_failed = false;
+            engine->users[idx].blocked = ENGINE_BLOCK_NONE;
+            engine_user_step(engine, idx);
+            engine->retry_user = -1;
+            if (engine->retry_failed) break;
+        }
+    }
+}
+
+/** Ricontrolla la risposta dopo reply_backoff tick, raddoppiati a ogni controllo fino a reply_backoff_max. */
+static void engine_block_reply(UserEngine *engine, int idx) {
+    EngineUser *user = &engine->users[idx];
+    engine_timer_arm_ticks(engine, idx, user->reply_backoff);
+    user->reply_backoff *= 2;
+    if (user->reply_backoff > engine->reply_backoff_max) user->reply_backoff = engine->reply_backoff_max;
+}
+
+/* ==========================================================================
+ *                      SEZIONE: AZIONI DELLE FASI
+ * ========================================================================== */
+
+/**
+ * Cambia fase, registrando uscita dalla precedente e ingresso nella nuova (trace.h).
+ * A giornata attiva registra anche la durata della fase conclusa e, all'uscita,
+ * del percorso completo; le fasi troncate dalla fine del giorno non contano.
+ */
+static void engine_set_state(UserEngine *engine, EngineUser *user, EngineUserState next) {
+    unsigned long long now = simulation_clock_now(engine->clock);
+
+    if (engine_day_is_active && user->state != ENGINE_STATE_DONE) {
+        record_journey_time(engine->shm_ptr, (JourneyMetric)user->state,
+                            get_simulated_minutes(engine->clock, user->profile.phase_start_tick));
+        if (user->state == ENGINE_STATE_EXIT) {
+            record_journey_time(engine->shm_ptr, JOURNEY_END_TO_END,
+                                get_simulated_minutes(engine->clock, user->profile.journey_start_tick));
+        }
+    }
+    if (trace_is_enabled(engine->shm_ptr)) {
+        if (user->state != ENGINE_STATE_DONE) {
+            trace_record(engine->shm_ptr, TRACE_EVENT_PHASE_EXIT, user->profile.user_pid, user->state, 0);
+        }
+        if (next != ENGINE_STATE_DONE) {
+            trace_record(engine->shm_ptr, TRACE_EVENT_PHASE_ENTER, user->profile.user_pid, next, 0);
+        }
+    }
+    user->state = next;
+    user->profile.phase_start_tick = now;
+}
+
+/** Riprende i membri del gruppo sospesi su un evento locale nella fase indicata. */
+static void engine_wake_group(UserEngine *engine, EngineGroup *group, EngineUserState state) {
+    for (int m = 0; m < group->size; m++) {
+        int idx = group->first_user + m;
+        EngineUser *member = &engine->users[idx];
+        if (member->blocked == ENGINE_BLOCK_LOCAL && member->state == state) {
+            member->blocked = ENGINE_BLOCK_NONE;
+            engine_user_step(engine, idx);
+        }
+    }
+}
+
+/** Equivalente di fase_ritiro_formale() per un utente dell'event loop. */
+static void engine_withdraw(UserEngine *engine, int idx) {
+    EngineUser *user = &engine->users[idx];
+    EngineGroup *group = &engine->groups[engine->user_group[idx]];
+    MainSharedMemory *shm = engine->shm_ptr;
+
+    LOG_DEBUG("[UTENTE] PID %d: Abbandono per mancanza cibo o pazienza.\n", user->profile.user_pid);
+
+    lock_simulation_mutex(shm, group_mutex_index(group->group_index));
+    if (shm->group_statuses[group->group_index].active_members > 0) {
+        shm->group_statuses[group->group_index].active_members--;
+        if (group->leader == idx) {
+            shm->group_statuses[group->group_index].group_leader_pid = 0;
+            group->leader = -1;
+        }
+    }
+    unlock_simulation_mutex(shm, group_mutex_index(group->group_index));
+
+    record_client_not_served(shm);
+    user->counted = true;
+    engine_set_state(engine, user, ENGINE_STATE_DONE);
+    engine->users_in_progress--;
+
+    /* Sblocco dei membri in attesa, come le P non bloccanti sui semafori di gruppo */
+    if (group->regroup_pending > 0 && --group->regroup_pending == 0) {
+        engine_wake_group(engine, group, ENGINE_STATE_REGROUP);
+    }
+    if (group->exit_pending > 0 && --group->exit_pending == 0) {
+        engine_wake_group(engine, group, ENGINE_STATE_EXIT);
+    }
+}
+
+/**
+ * Avvia l'ordine alla stazione Primi/Secondi/Caffè.
+ * @return int 1 ordine inviato, 0 da ritentare (canale pieno), -1 stazione saltata.
+ */
+static int engine_send_station_order(UserEngine *engine, EngineUser *user, StationChannelIndex channel) {
+    MainSharedMemory *shm = engine->shm_ptr;
+    StatoUtente *profile = &user->profile;
+
+    if (channel != STATION_CHANNEL_COFFEE_DESSERT) {
+        FoodDistributionStation *station = (channel == STATION_CHANNEL_FIRST_COURSE) ?
+                                           &shm->first_course_station : &shm->second_course_station;
+        int choice = (channel == STATION_CHANNEL_FIRST_COURSE) ?
+                     profile->selected_first_course_index : profile->selected_second_course_index;
+        if (choice == -1) return -1;
+
+        /* Ripiego su un piatto disponibile, come fase_servizio_stazione() */
+        if (get_station_portions(station, choice) <= 0) {
+            int num_dishes = (channel == STATION_CHANNEL_FIRST_COURSE) ?
+                             shm->food_menu.number_of_first_courses : shm->food_menu.number_of_second_courses;
+            choice = -1;
+            for (int i = 0; i < num_dishes && choice == -1; i++) {
+                if (get_station_portions(station, i) > 0) choice = i;
+            }
+            if (choice == -1) return -1;
+        }
+
+        int q_len = station_channel_pending_orders(shm, channel);
+        if (q_len > shm->configuration.thresholds.queue_patience_threshold) return -1;
+        user->order_choice = choice;
+    } else {
+        user->order_choice = profile->selected_dessert_coffee_index;
+    }
+
+    StationPayload payload;
+    payload.user_pid = profile->user_pid;
+    payload.reply_slot_index = profile->reply_slot_index;
+    payload.dish_index = user->order_choice;
+    payload.status = 0;
+
+    user->order_start = simulation_clock_now(engine->clock);
+    if (station_channel_try_send_order(shm, channel, &payload, sizeof(StationPayload)) == -1) {
+        return (errno == EAGAIN) ? 0 : -1;
+    }
+    return 1;
+}
+
+/**
+ * Controlla la risposta della stazione.
+ * @return int 1 piatto servito, 0 risposta non ancora arrivata, -1 non servito.
+ */
+static int engine_poll_station_reply(UserEngine *engine, EngineUser *user, StationChannelIndex channel) {
+    StationPayload payload;
+    payload.user_pid = user->profile.user_pid;
+    payload.reply_slot_index = user->profile.reply_slot_index;
+
+    if (station_channel_try_receive_reply(engine->shm_ptr, channel, &payload, sizeof(StationPayload)) == -1) {
+        return (errno == EAGAIN) ? 0 : -1;
+    }
+
+    double wait_min = simulation_clock_minutes_between(engine->clock, user->order_start, payload.reply_tick);
+    record_wait_time(engine->shm_ptr, wait_min, channel);
+
+    if (payload.status == ORDER_STATUS_SERVED) {
+        LOG_DEBUG("[UTENTE] PID %d: Piatto %d ricevuto.\n", user->profile.user_pid, user->order_choice);
+        return 1;
+    }
+    return -1;
+}
+
+/**
+ * Ciclo ordine/risposta di una fase di stazione. Appena inviato l'ordine la
+ * risposta non può essere già pronta: il primo controllo avviene sul timer.
+ */
+static EnginePhaseResult engine_station_phase(UserEngine *engine, int idx, StationChannelIndex channel, bool *served) {
+    EngineUser *user = &engine->users[idx];
+
+    if (!user->pending) {
+        if (engine_queue_busy(engine, idx, ENGINE_QUEUE_SEND_BASE + channel)) return ENGINE_PHASE_WAIT_SEND;
+        int sent = engine_send_station_order(engine, user, channel);
+        if (sent == 0) return ENGINE_PHASE_WAIT_SEND;
+        if (sent == -1) {
+            *served = false;
+            return ENGINE_PHASE_DONE;
+        }
+        user->pending = true;
+        user->reply_backoff = 1;
+        return ENGINE_PHASE_WAIT_REPLY;
+    }
+
+    int reply = engine_poll_station_reply(engine, user, channel);
+    if (reply == 0) return ENGINE_PHASE_WAIT_REPLY;
+    *served = (reply == 1);
+    user->pending = false;
+    return ENGINE_PHASE_DONE;
+}
+
+/** Fase cassa, con lo stesso ciclo ordine/risposta di engine_station_phase(). */
+static EnginePhaseResult engine_cashier_phase(UserEngine *engine, int idx) {
+    MainSharedMemory *shm = engine->shm_ptr;
+    EngineUser *user = &engine->users[idx];
+    CashierPayload payload;
+    payload.user_pid = user->profile.user_pid;
+    payload.reply_slot_index = user->profile.reply_slot_index;
+
+    if (!user->pending) {
+        if (engine_queue_busy(engine, idx, ENGINE_QUEUE_SEND_BASE + STATION_CHANNEL_CASHIER)) return ENGINE_PHASE_WAIT_SEND;
+        payload.had_first = user->got_first;
+        payload.had_second = user->got_second;
+        payload.want_coffee = true;
+        payload.has_discount = user->profile.ticket_is_validated;
+
+        user->order_start = simulation_clock_now(engine->clock);
+        if (station_channel_try_send_order(shm, STATION_CHANNEL_CASHIER, &payload, sizeof(CashierPayload)) == -1) {
+            return (errno == EAGAIN) ? ENGINE_PHASE_WAIT_SEND : ENGINE_PHASE_DONE;
+        }
+        LOG_DEBUG("[UTENTE] PID %d: In coda alla Cassa...\n", user->profile.user_pid);
+        user->pending = true;
+        user->reply_backoff = 1;
+        return ENGINE_PHASE_WAIT_REPLY;
+    }
+
+    if (station_channel_try_receive_reply(shm, STATION_CHANNEL_CASHIER, &payload, sizeof(CashierPayload)) == -1) {
+        if (errno == EAGAIN) return ENGINE_PHASE_WAIT_REPLY;
+    } else {
+        double wait_min = simulation_clock_minutes_between(engine->clock, user->order_start, payload.reply_tick);
+        record_wait_time(shm, wait_min, STATION_CHANNEL_CASHIER);
+        LOG_DEBUG("[UTENTE] PID %d: Pagamento completato.\n", user->profile.user_pid);
+    }
+    user->pending = false;
+    return ENGINE_PHASE_DONE;
+}
+
+/**
+ * Fase tavolo del leader. Senza tavolo libero il leader si registra, sotto lo
+ * stesso MUTEX_TABLES, sul canale di attesa della dimensione del gruppo.
+ * @return int -1 se il tavolo è stato prenotato, altrimenti il canale di attesa.
+ */
+static int engine_leader_reserve_table(UserEngine *engine, int idx, EngineGroup *group) {
+    MainSharedMemory *shm = engine->shm_ptr;
+    EngineUser *user = &engine->users[idx];
+
+    lock_simulation_mutex(shm, group_mutex_index(group->group_index));
+    int members = shm->group_statuses[group->group_index].active_members;
+    unlock_simulation_mutex(shm, group_mutex_index(group->group_index));
+
+    int wait_channel = -1;
+    lock_simulation_mutex(shm, MUTEX_TABLES);
+    int table_id = dining_area_reserve(&shm->seat_area, members);
+    if (table_id == -1) {
+        wait_channel = dining_area_register_waiter(&shm->seat_area, members);
+    }
+    unlock_simulation_mutex(shm, MUTEX_TABLES);
+    if (table_id == -1) return wait_channel;
+
+    user->profile.assigned_table_id = table_id;
+    lock_simulation_mutex(shm, group_mutex_index(group->group_index));
+    shm->group_statuses[group->group_index].assigned_table_id = table_id;
+    unlock_simulation_mutex(shm, group_mutex_index(group->group_index));
+
+    LOG_DEBUG("[UTENTE] PID %d: Tavolo %d trovato e occupato per il gruppo.\n", user->profile.user_pid, table_id);
+    group->table_id = table_id;
+    group->table_ready = true;
+    return -1;
+}
+
+/** Rilascia il posto al tavolo e sveglia i leader in attesa di altri processi. */
+static void engine_release_seat(UserEngine *engine, EngineUser *user) {
+    MainSharedMemory *shm = engine->shm_ptr;
+    lock_simulation_mutex(shm, MUTEX_TABLES);
+    dining_area_release(&shm->seat_area, user->profile.assigned_table_id, 1);
+    dining_area_wake_fitting_waiters(&shm->seat_area);
+    unlock_simulation_mutex(shm, MUTEX_TABLES);
+
+    LOG_DEBUG("[UTENTE] PID %d: Pasto terminato al tavolo %d. Posto liberato.\n",
+              user->profile.user_pid, user->profile.assigned_table_id);
+}
+
+/* ==========================================================================
+ *                      SEZIONE: MACCHINA A STATI
+ * ========================================================================== */
+
+/** Sospende l'utente secondo l'esito della fase: in coda sul canale o sul timer della risposta. */
+static void engine_block_phase(UserEngine *engine, int idx, EnginePhaseResult result, StationChannelIndex channel) {
+    if (result == ENGINE_PHASE_WAIT_SEND) {
+        engine_block_queue(engine, idx, ENGINE_QUEUE_SEND_BASE + channel);
+    } else {
+        engine_block_reply(engine, idx);
+    }
+}
+
+/** Esegue l'utente finché non deve attendere un evento. */
+static void engine_user_step(UserEngine *engine, int idx) {
+    EngineUser *user = &engine->users[idx];
+    StatoUtente *profile = &user->profile;
+    EngineGroup *group = &engine->groups[engine->user_group[idx]];
+    MainSharedMemory *shm = engine->shm_ptr;
+    long nanos_per_minute = shm->configuration.timings.nanoseconds_per_tick;
+
+    while (engine_day_is_active) {
+        switch (user->state) {
+            case ENGINE_STATE_TICKET:
+                if (!profile->has_ticket) {
+                    engine_set_state(engine, user, ENGINE_STATE_FIRST_COURSE);
+                } else if (!user->pending) {
+                    if (engine_queue_busy(engine, idx, ENGINE_QUEUE_TICKET) ||
+                        reserve_sem_try(shm->semaphore_ticket_id, 0) == -1) {
+                        engine_block_queue(engine, idx, ENGINE_QUEUE_TICKET);
+                        return;
+                    }
+                    user->pending = true;
+                    int varied_time = calculate_varied_time(shm->configuration.timings.average_service_time_ticket, 20);
+                    engine_timer_arm(engine, idx, ((long long)varied_time * nanos_per_minute) / 60);
+                    return;
+                } else {
+                    profile->ticket_is_validated = true;
+                    release_sem(shm->semaphore_ticket_id, 0);
+                    record_latency(shm, LATENCY_METRIC_TICKET, get_simulated_minutes(engine->clock, profile->phase_start_tick));
+                    LOG_DEBUG("[UTENTE] PID %d: Ticket validato.\n", profile->user_pid);
+                    user->pending = false;
+                    engine_set_state(engine, user, ENGINE_STATE_FIRST_COURSE);
+                }
+                break;
+
+            case ENGINE_STATE_FIRST_COURSE: {
+                EnginePhaseResult result = engine_station_phase(engine, idx, STATION_CHANNEL_FIRST_COURSE, &user->got_first);
+                if (result != ENGINE_PHASE_DONE) {
+                    engine_block_phase(engine, idx, result, STATION_CHANNEL_FIRST_COURSE);
+                    return;
+                }
+                engine_set_state(engine, user, ENGINE_STATE_SECOND_COURSE);
+                break;
+            }
+
+            case ENGINE_STATE_SECOND_COURSE: {
+                EnginePhaseResult result = engine_station_phase(engine, idx, STATION_CHANNEL_SECOND_COURSE, &user->got_second);
+                if (result != ENGINE_PHASE_DONE) {
+                    engine_block_phase(engine, idx, result, STATION_CHANNEL_SECOND_COURSE);
+                    return;
+                }
+                if (!user->got_first && !user->got_second) {
+                    engine_withdraw(engine, idx);
+                    return;
+                }
+                engine_set_state(engine, user, ENGINE_STATE_REGROUP);
+                break;
+            }
+
+            case ENGINE_STATE_REGROUP:
+                if (profile->group_size <= 1) {
+                    engine_set_state(engine, user, ENGINE_STATE_CASHIER);
+                    break;
+                }
+                if (!user->pending) {
+                    user->pending = true;
+                    if (group->leader == -1) {
+                        group->leader = idx;
+                        lock_simulation_mutex(shm, group_mutex_index(group->group_index));
+                        shm->group_statuses[group->group_index].group_leader_pid = profile->user_pid;
+                        unlock_simulation_mutex(shm, group_mutex_index(group->group_index));
+                    }
+                    /* Semantica del semaforo: a contatore esaurito l'arrivo resta in attesa */
+                    if (group->regroup_pending == 0) {
+                        user->blocked = ENGINE_BLOCK_LOCAL;
+                        return;
+                    }
+                    if (--group->regroup_pending == 0) {
+                        engine_wake_group(engine, group, ENGINE_STATE_REGROUP);
+                    }
+                }
+                if (group->regroup_pending > 0) {
+                    user->blocked = ENGINE_BLOCK_LOCAL;
+                    return;
+                }
+                user->pending = false;
+                engine_set_state(engine, user, ENGINE_STATE_CASHIER);
+                break;
+
+            case ENGINE_STATE_CASHIER: {
+                EnginePhaseResult result = engine_cashier_phase(engine, idx);
+                if (result != ENGINE_PHASE_DONE) {
+                    engine_block_phase(engine, idx, result, STATION_CHANNEL_CASHIER);
+                    return;
+                }
+                engine_set_state(engine, user, ENGINE_STATE_TABLE);
+                break;
+            }
+
+            case ENGINE_STATE_TABLE:
+                if (group->leader == idx) {
+                    int wait_channel = engine_leader_reserve_table(engine, idx, group);
+                    if (wait_channel != -1) {
+                        engine_block_queue(engine, idx, ENGINE_QUEUE_TABLE_BASE + wait_channel);
+                        return;
+                    }
+                    engine_wake_group(engine, group, ENGINE_STATE_TABLE);
+                } else {
+                    if (!group->table_ready) {
+                        user->blocked = ENGINE_BLOCK_LOCAL;
+                        return;
+                    }
+                    profile->assigned_table_id = group->table_id;
+                }
+                record_latency(shm, LATENCY_METRIC_TABLE, get_simulated_minutes(engine->clock, profile->phase_start_tick));
+                engine_set_state(engine, user, ENGINE_STATE_EAT);
+                break;
+
+            case ENGINE_STATE_EAT:
+                if (profile->assigned_table_id == -1) {
+                    engine_set_state(engine, user, ENGINE_STATE_COFFEE);
+                } else if (!user->pending) {
+                    int count = (user->got_first ? 1 : 0) + (user->got_second ? 1 : 0);
+                    user->pending = true;
+                    if (count > 0) {
+                        int minutes_to_eat = generate_random_integer(3 * count, 6 * count);
+                        engine_timer_arm(engine, idx, (long long)minutes_to_eat * nanos_per_minute);
+                        return;
+                    }
+                } else {
+                    engine_release_seat(engine, user);
+                    user->pending = false;
+                    engine_set_state(engine, user, ENGINE_STATE_COFFEE);
+                }
+                break;
+
+            case ENGINE_STATE_COFFEE: {
+                bool served = false;
+                EnginePhaseResult result = engine_station_phase(engine, idx, STATION_CHANNEL_COFFEE_DESSERT, &served);
+                if (result != ENGINE_PHASE_DONE) {
+                    engine_block_phase(engine, idx, result, STATION_CHANNEL_COFFEE_DESSERT);
+                    return;
+                }
+                record_client_served(shm, profile->has_ticket);
+                user->counted = true;
+                engine_set_state(engine, user, ENGINE_STATE_EXIT);
+                break;
+            }
+
+            case ENGINE_STATE_EXIT:
+                if (profile->group_size > 1) {
+                    if (!user->pending) {
+                        user->pending = true;
+                        if (group->exit_pending == 0) {
+                            user->blocked = ENGINE_BLOCK_LOCAL;
+                            return;
+                        }
+                        if (--group->exit_pending == 0) {
+                            engine_wake_group(engine, group, ENGINE_STATE_EXIT);
+                        }
+                    }
+                    if (group->exit_pending > 0) {
+                        user->blocked = ENGINE_BLOCK_LOCAL;
+                        return;
+                    }
+                    LOG_DEBUG("[UTENTE] PID %d: Uscita gruppo completata.\n", profile->user_pid);
+                }
+                user->pending = false;
+                engine_set_state(engine, user, ENGINE_STATE_DONE);
+                engine->users_in_progress--;
+                return;
+
+            case ENGINE_STATE_DONE:
+                return;
+        }
+    }
+}
+
+/* ==========================================================================
+ *                        SEZIONE: CICLO GIORNALIERO
+ * ========================================================================== */
+
+/** Prepara utenti e gruppi per una nuova giornata. */
+static void engine_start_day(UserEngine *engine) {
+    MainSharedMemory *shm = engine->shm_ptr;
+
+    for (int g = 0; g < engine->groups_count; g++) {
+        EngineGroup *group = &engine->groups[g];
+        int active = shm->group_statuses[group->group_index].active_members;
+        group->regroup_pending = active;
+        group->exit_pending = active;
+        group->table_ready = false;
+        group->table_id = -1;
+    }
+
+    for (int i = 0; i < engine->users_count; i++) {
+        EngineUser *user = &engine->users[i];
+        genera_identita_casuale(&user->profile);
+        user->profile.ticket_is_validated = false;
+        user->profile.assigned_table_id = -1;
+        user->state = ENGINE_STATE_TICKET;
+        user->profile.journey_start_tick = simulation_clock_now(engine->clock);
+        user->profile.phase_start_tick = user->profile.journey_start_tick;
+        TRACE_EVENT(shm, TRACE_EVENT_PHASE_ENTER, user->profile.user_pid, TRACE_PHASE_TICKET, 0);
+        user->blocked = ENGINE_BLOCK_NONE;
+        user->pending = false;
+        user->got_first = false;
+        user->got_second = false;
+        user->counted = false;
+        user->timer_next = -1;
+        user->wait_next = -1;
+    }
+
+    for (int s = 0; s < ENGINE_WHEEL_SLOTS; s++) engine->wheel[s] = -1;
+    engine->timers_armed = 0;
+    for (int q = 0; q < ENGINE_QUEUE_COUNT; q++) {
+        engine->queue_head[q] = -1;
+        engine->queue_tail[q] = -1;
+    }
+    engine->retry_user = -1;
+    engine->current_tick = engine_now_tick(engine);
+    engine->users_in_progress = engine->users_count;
+}
+
+/** Chiude la giornata: rilascia i ticket trattenuti e registra gli esiti mancanti. */
+static void engine_end_day(UserEngine *engine) {
+    MainSharedMemory *shm = engine->shm_ptr;
+
+    for (int i = 0; i < engine->users_count; i++) {
+        EngineUser *user = &engine->users[i];
+        if (user->state == ENGINE_STATE_TICKET && user->pending) {
+            release_sem(shm->semaphore_ticket_id, 0);
+        }
+        /* Come esegui_percorso_mensa_giornaliero(): servito solo oltre le stazioni */
+        if (!user->counted) {
+            if (user->state >= ENGINE_STATE_REGROUP) {
+                record_client_served(shm, user->profile.has_ticket);
+            } else {
+                record_client_not_served(shm);
+            }
+        }
+        engine_set_state(engine, user, ENGINE_STATE_DONE);
+    }
+    engine->users_in_progress = 0;
+}
+
+/** Esegue la giornata fino al segnale di fine giorno o alla conclusione di tutti gli utenti. */
+static void engine_run_day(UserEngine *engine) {
+    engine_start_day(engine);
+
+    for (int i = 0; i < engine->users_count && engine_day_is_active; i++) {
+        engine_user_step(engine, i);
+    }
+
+    while (engine_day_is_active && engine->users_in_progress > 0) {
+        engine_timer_advance(engine);
+        engine_poll_queues(engine);
+
+        /* Attesa del prossimo tick, o del primo timer se nessuna coda va ritentata
+         * (i segnali interrompono l'attesa) */
+        long long next_tick = engine->current_tick + 1;
+        if (!engine_queues_pending(engine)) {
+            long long timer_tick = engine_next_timer_tick(engine);
+            if (timer_tick > next_tick) next_tick = timer_tick;
+        }
+        simulation_clock_wait_until(engine->clock, (unsigned long long)next_tick);
+    }
+
+    engine_end_day(engine);
+}
+
+/** Libera la memoria dell'event loop (anche allocato in parte: gli array mancanti sono NULL). */
+static void engine_free(UserEngine *engine) {
+    free(engine->user_group);
+    free(engine->groups);
+    free(engine->users);
+    free(engine);
+}
+
+/** Rilascia le caselle dei primi `attached_users` utenti, sgancia la SHM e libera l'event loop. */
+static void engine_release(UserEngine *engine, int attached_users) {
+    for (int i = 0; i < attached_users; i++) {
+        station_channel_detach_user(engine->shm_ptr, engine->users[i].profile.reply_slot_index, getpid());
+    }
+    detach_shared_memory_segment(engine->shm_ptr);
+    engine_free(engine);
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+int run_user_engine(int shared_memory_id, int argc, char *argv[]) {
+    int first_group = atoi(argv[3]);
+    int group_count = argc - 4;
+
+    UserEngine *engine = (UserEngine *)calloc(1, sizeof(UserEngine));
+    if (engine == NULL) {
+        perror("[ERROR] Allocazione event loop utenti fallita");
+        return EXIT_FAILURE;
+    }
+
+    for (int g = 0; g < group_count; g++) {
+        engine->users_count += atoi(argv[4 + g]);
+    }
+    engine->groups_count = group_count;
+    engine->users = (EngineUser *)calloc(engine->users_count, sizeof(EngineUser));
+    engine->groups = (EngineGroup *)calloc(group_count, sizeof(EngineGroup));
+    engine->user_group = (int *)calloc(engine->users_count, sizeof(int));
+    if (engine->users == NULL || engine->groups == NULL || engine->user_group == NULL) {
+        perror("[ERROR] Allocazione event loop utenti fallita");
+        engine_free(engine);
+        return EXIT_FAILURE;
+    }
+
+    MainSharedMemory *shm = attach_to_simulation_shared_memory(shared_memory_id);
+    engine->shm_ptr = shm;
+    register_user_host(shm, first_group, group_count, engine->users_count);
+
+    /* Un solo flusso casuale per l'event loop: tutti gli utenti ospitati estraggono in sequenza */
+    seed_random_stream(shm->configuration.random_seed, RANDOM_STREAM_USER_ENGINE, (uint64_t)first_group);
+
+    /* Tick della wheel = tick dell'orologio pubblicato dal Master: nessun timer locale */
+    engine->clock = &shm->simulation_clock;
+    engine->reply_backoff_max = engine->clock->ticks_per_minute / ENGINE_REPLY_BACKOFF_DIVISOR;
+    if (engine->reply_backoff_max < 1) engine->reply_backoff_max = 1;
+
+    struct sigaction sa;
+    sa.sa_handler = handle_engine_signals;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGUSR2, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+
+    int u = 0;
+    for (int g = 0; g < group_count; g++) {
+        EngineGroup *group = &engine->groups[g];
+        group->first_user = u;
+        group->size = atoi(argv[4 + g]);
+        group->group_index = first_group + g;
+        group->leader = u;
+
+        for (int m = 0; m < group->size; m++, u++) {
+            StatoUtente *profile = &engine->users[u].profile;
+            profile->shared_memory_id = shared_memory_id;
+            profile->shm_ptr = shm;
+            profile->user_pid = USER_ENGINE_IDENTITY_BASE + group->group_index * MAX_USERS_PER_GROUP + m;
+            profile->group_id = group->group_index;
+            profile->group_size = group->size;
+            profile->is_group_leader = (m == 0);
+            profile->is_late_joiner = false;
+            engine->user_group[u] = g;
+
+            /* Caselle di risposta intestate al processo: la verifica di vita usa il PID reale.
+             * Senza casella l'event loop non parte: il Master compensa i suoi utenti alla terminazione */
+            profile->reply_slot_index = station_channel_attach_user(shm, getpid());
+            if (profile->reply_slot_index == -1) {
+                fprintf(stderr, "[ERROR] ENGINE PID %d: caselle di risposta esaurite\n", getpid());
+                engine_release(engine, u);
+                return EXIT_FAILURE;
+            }
+        }
+
+        lock_simulation_mutex(shm, group_mutex_index(group->group_index));
+        shm->group_statuses[group->group_index].group_leader_pid = engine->users[group->first_user].profile.user_pid;
+        unlock_simulation_mutex(shm, group_mutex_index(group->group_index));
+    }
+
+    LOG_INFO("[ENGINE] PID %d: %d utenti in event loop (gruppi %d-%d, tick %ld ns).\n",
+             getpid(), engine->users_count, first_group, first_group + group_count - 1, engine->clock->tick_ns);
+
+    if (shm->current_simulation_day == 0) {
+        sync_children_start_undo(shm->semaphore_sync_id, BARRIER_STARTUP_READY, BARRIER_STARTUP_GATE, engine->users_count);
+    }
+
+    while (shm->is_simulation_running) {
+        engine_day_is_active = 1;
+        sync_children_start_undo(shm->semaphore_sync_id, BARRIER_MORNING_READY, BARRIER_MORNING_GATE, engine->users_count);
+
+        if (engine_day_is_active) {
+            engine_run_day(engine);
+        }
+
+        if (shm->is_simulation_running) {
+            sync_children_start_undo(shm->semaphore_sync_id, BARRIER_EVENING_READY, BARRIER_EVENING_GATE, engine->users_count);
+        }
+    }
+
+    LOG_INFO("[ENGINE] PID %d: Terminazione.\n", getpid());
+    engine_release(engine, engine->users_count);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file user_host.c
+ * @brief Host utenti: esecuzione di più utenti come thread dello stesso processo.
+ *
+ * Il thread principale aggancia la SHM, crea un thread per ogni membro dei
+ * gruppi ricevuti e resta in sigtimedwait sui segnali del Master (SIGUSR2,
+ * SIGTERM, SIGINT), bloccati in tutti i thread. Ogni segnale ricevuto viene
+ * inoltrato ai thread ancora attivi con USER_HOST_WAKE_SIGNAL, che azzera il
+ * flag giornaliero del solo thread destinatario e interrompe le sue attese.
+ *
+ * @see user_host.h per il formato degli argomenti e la registrazione.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/* Includes del progetto */
+#include "utente.h"
+#include "user_host.h"
+#include "shm.h"
+#include "mutex.h"
+#include "log.h"
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Parametri e stato di un utente eseguito come thread. */
+typedef struct {
+    pthread_t thread;                   /**< Thread che esegue l'utente */
+    MainSharedMemory *shm_ptr;          /**< SHM condivisa da tutti i thread dell'host */
+    int shared_memory_id;               /**< ID della SHM */
+    int group_size;                     /**< Dimensione del gruppo di appartenenza */
+    int group_index;                    /**< Indice del gruppo nel pool di sincronizzazione */
+    int member_index;                   /**< Posizione nel gruppo (0: leader) */
+    bool started;                       /**< Thread creato con successo */
+    atomic_bool finished;               /**< Ciclo di vita dell'utente concluso */
+} HostedUser;
+
+/** Thread utente ancora in esecuzione. */
+static atomic_int running_users = 0;
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+/**
+ * Toglie dalla simulazione un utente che non ha potuto avviarsi (thread non
+ * creato o configurazione fallita): gruppo, barriere e popolazione non lo
+ * attendono più, e il Master non lo compensa di nuovo alla morte dell'host.
+ */
+static void withdraw_unstarted_user(HostedUser *hosted) {
+    MainSharedMemory *shm = hosted->shm_ptr;
+
+    lock_simulation_mutex(shm, MUTEX_USER_REGISTRY);
+    user_registry_release_user(&shm->user_registry, getpid());
+    unlock_simulation_mutex(shm, MUTEX_USER_REGISTRY);
+
+    withdraw_lost_group_members(shm, hosted->group_index, 1, 0);
+    withdraw_lost_users(shm, 1);
+}
+
+/** Corpo di un thread utente. */
+static void *hosted_user_main(void *arg) {
+    HostedUser *hosted = (HostedUser *)arg;
+    StatoUtente utente;
+    int result = 0;
+
+    if (configura_utente(&utente, hosted->shm_ptr, hosted->shared_memory_id, hosted->group_size,
+                         hosted->group_index, hosted->member_index, false) == 0) {
+        run_utente_simulation(&utente);
+        termina_utente(&utente);
+    } else {
+        /* Solo questo utente non parte: il resto dell'host prosegue */
+        withdraw_unstarted_user(hosted);
+        result = -1;
+    }
+
+    atomic_store(&hosted->finished, true);
+    atomic_fetch_sub(&running_users, 1);
+    return (void *)(intptr_t)result;
+}
+
+/** Inoltra il risveglio a tutti i thread utente non ancora terminati. */
+static void forward_wake_signal(HostedUser *users, int count) {
+    for (int i = 0; i < count; i++) {
+        if (users[i].started && !atomic_load(&users[i].finished)) {
+            pthread_kill(users[i].thread, USER_HOST_WAKE_SIGNAL);
+        }
+    }
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+void register_user_host(MainSharedMemory *shm, int first_group, int group_count, int user_count) {
+    lock_simulation_mutex(shm, MUTEX_USER_REGISTRY);
+    int slot = user_registry_insert_host(&shm->user_registry, getpid(), first_group, group_count, user_count);
+    unlock_simulation_mutex(shm, MUTEX_USER_REGISTRY);
+    if (slot == -1) {
+        fprintf(stderr, "[WARNING] Registro pieno. Host PID %d non tracciato.\n", getpid());
+    }
+}
+
+int run_user_host(int shared_memory_id, int argc, char *argv[]) {
+    int first_group = atoi(argv[3]);
+    int group_count = argc - 4;
+
+    int total_users = 0;
+    for (int g = 0; g < group_count; g++) {
+        total_users += atoi(argv[4 + g]);
+    }
+
+    HostedUser *users = (HostedUser *)calloc(total_users, sizeof(HostedUser));
+    if (users == NULL) {
+        perror("[ERROR] Allocazione utenti host fallita");
+        return EXIT_FAILURE;
+    }
+
+    MainSharedMemory *shm = attach_to_simulation_shared_memory(shared_memory_id);
+    register_user_host(shm, first_group, group_count, total_users);
+
+    /* Segnali del Master riservati al thread principale; maschera ereditata dai thread */
+    sigset_t master_signals;
+    sigemptyset(&master_signals);
+    sigaddset(&master_signals, SIGUSR2);
+    sigaddset(&master_signals, SIGTERM);
+    sigaddset(&master_signals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &master_signals, NULL);
+    setup_utente_signals();
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, USER_HOST_THREAD_STACK_SIZE);
+
+    int u = 0;
+    int failed_users = 0;
+    for (int g = 0; g < group_count; g++) {
+        int group_size = atoi(argv[4 + g]);
+        for (int m = 0; m < group_size; m++, u++) {
+            users[u].shm_ptr = shm;
+            users[u].shared_memory_id = shared_memory_id;
+            users[u].group_size = group_size;
+            users[u].group_index = first_group + g;
+            users[u].member_index = m;
+
+            atomic_fetch_add(&running_users, 1);
+            int err = pthread_create(&users[u].thread, &attr, hosted_user_main, &users[u]);
+            if (err != 0) {
+                atomic_fetch_sub(&running_users, 1);
+                fprintf(stderr, "[ERROR] HOST PID %d: creazione thread utente fallita (errno %d)\n",
+                        getpid(), err);
+                withdraw_unstarted_user(&users[u]);
+                failed_users++;
+                continue;
+            }
+            users[u].started = true;
+        }
+    }
+    pthread_attr_destroy(&attr);
+
+    LOG_INFO("[HOST] PID %d: %d utenti avviati (gruppi %d-%d).\n",
+             getpid(), total_users, first_group, first_group + group_count - 1);
+
+    /* Attesa segnali con timeout per accorgersi della fine di tutti i thread */
+    struct timespec poll_interval = {0, 100 * 1000 * 1000};
+    while (atomic_load(&running_users) > 0) {
+        if (sigtimedwait(&master_signals, NULL, &poll_interval) > 0) {
+            forward_wake_signal(users, total_users);
+        }
+    }
+
+    for (int i = 0; i < total_users; i++) {
+        void *result;
+        if (users[i].started && pthread_join(users[i].thread, &result) == 0 && result != NULL) {
+            failed_users++;
+        }
+    }
+
+    detach_shared_memory_segment(shm);
+    LOG_INFO("[HOST] PID %d: Terminazione (%d utenti non avviati).\n", getpid(), failed_users);
+    free(users);
+    return (failed_users > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -18,23 +18,51 @@
 #include <errno.h>
 #include <time.h>
 #include <stdbool.h>
+#include <string.h>
 
 /* Includes del progetto */
 #include "utente.h"
 #include "sem.h"
+#include "mutex.h"
+#include "statistics.h"
 #include "shm.h"
 #include "queue.h"
+#include "station_channel.h"
 #include "utils.h"
+#include "user_zygote.h"
+#include "user_host.h"
+#include "trace.h"
+#include "log.h"
 
 /* ==========================================================================
  *                        VARIABILI GLOBALI (SEGNALI)
  * ========================================================================== */
 
-/** Flag atomica per la gestione del ciclo giornaliero tramite segnali dal Master. */
-static volatile sig_atomic_t local_daily_cycle_is_active = 0;
+/**
+ * Flag per la gestione del ciclo giornaliero tramite segnali dal Master.
+ * Per-thread: in un host ogni utente viene fermato dal proprio segnale di risveglio.
+ */
+static __thread volatile sig_atomic_t local_daily_cycle_is_active = 0;
 
 /* Prototypes locali per helper non esposti in header */
-ssize_t receive_message_robust(int queue_id, void *msg_ptr, size_t size, long type);
+ssize_t receive_message_robust(MainSharedMemory *shm_ptr, StationChannelIndex channel, void *payload, size_t size);
+
+_Static_assert((int)JOURNEY_EXIT == (int)TRACE_PHASE_EXIT, "Le fasi di JourneyMetric seguono TracePhase");
+
+/** Ingresso in una fase del percorso: avvia il cronometro e lo traccia (trace.h). */
+static void inizia_fase(StatoUtente *utente, TracePhase fase) {
+    utente->phase_start_tick = simulation_clock_now(&utente->shm_ptr->simulation_clock);
+    TRACE_EVENT(utente->shm_ptr, TRACE_EVENT_PHASE_ENTER, utente->user_pid, fase, 0);
+}
+
+/** Uscita da una fase: ne registra la durata, se non interrotta dalla fine del giorno. */
+static void concludi_fase(StatoUtente *utente, TracePhase fase) {
+    TRACE_EVENT(utente->shm_ptr, TRACE_EVENT_PHASE_EXIT, utente->user_pid, fase, 0);
+    if (local_daily_cycle_is_active) {
+        record_journey_time(utente->shm_ptr, (JourneyMetric)fase,
+                            get_simulated_minutes(&utente->shm_ptr->simulation_clock, utente->phase_start_tick));
+    }
+}
 
 /* ==========================================================================
  *                             SEZIONE: MAIN
@@ -43,23 +71,40 @@ ssize_t receive_message_robust(int queue_id, void *msg_ptr, size_t size, long ty
 int main(int argc, char *argv[]) {
     StatoUtente utente;
 
+    log_set_role(LOG_ROLE_USER);
+
+    /* Modalità zygote: `utente <shm_id> zygote` (USER_LAUNCHER=zygote) */
+    if (argc == 3 && strcmp(argv[2], ZYGOTE_MODE_ARG) == 0) {
+        return run_user_zygote(atoi(argv[1]));
+    }
+
+    /* Modalità host: `utente <shm_id> host <primo_gruppo> <dim>...` (USERS_PER_HOST > 0) */
+    if (argc >= 5 && strcmp(argv[2], USER_HOST_MODE_ARG) == 0) {
+        return run_user_host(atoi(argv[1]), argc, argv);
+    }
+
+    /* Event loop: `utente <shm_id> engine <primo_gruppo> <dim>...` (USER_HOST_EVENT_LOOP=1) */
+    if (argc >= 5 && strcmp(argv[2], USER_ENGINE_MODE_ARG) == 0) {
+        return run_user_engine(atoi(argv[1]), argc, argv);
+    }
+
     if (argc < 5) {
         fprintf(stderr, "[ERROR] %s: Parametri insufficienti\n", argv[0]);
         exit(EXIT_FAILURE);
     }
 
-    /* 1. Inizializzazione Stato e Risorse */
-    init_utente(&utente, argc, argv);
-    
-    /* Diversificazione seed per ogni processo utente */
-    srand(time(NULL) ^ getpid());
+    /* 1. Inizializzazione Stato e Risorse (il Master compensa la terminazione) */
+    if (init_utente(&utente, argc, argv) == -1) {
+        detach_shared_memory_segment(utente.shm_ptr);
+        return EXIT_FAILURE;
+    }
 
     /* 2. Avvio Cicli di Simulazione */
     run_utente_simulation(&utente);
 
     /* 3. Cleanup */
+    termina_utente(&utente);
     detach_shared_memory_segment(utente.shm_ptr);
-    printf("[UTENTE] PID %d: Terminazione pulita.\n", getpid());
     
     return EXIT_SUCCESS;
 }
@@ -68,22 +113,57 @@ int main(int argc, char *argv[]) {
  *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
  * ========================================================================== */
 
-void init_utente(StatoUtente *utente, int argc, char *argv[]) {
+int init_utente(StatoUtente *utente, int argc, char *argv[]) {
     /* Parsing parametri da linea di comando */
-    utente->shared_memory_id = atoi(argv[1]);
-    utente->group_size = atoi(argv[2]);
+    int shared_memory_id = atoi(argv[1]);
+    int group_size = atoi(argv[2]);
     int sync_index = atoi(argv[3]);
-    utente->is_group_leader = (atoi(argv[4]) == 1);
-    utente->is_late_joiner = (argc > 5 && atoi(argv[5]) == 1);
+    int member_index = atoi(argv[4]);
+    bool is_late_joiner = (argc > 5 && atoi(argv[5]) == 1);
+
+    /* Connessione alla memoria condivisa */
+    MainSharedMemory *shm_ptr = attach_to_simulation_shared_memory(shared_memory_id);
+
+    return configura_utente(utente, shm_ptr, shared_memory_id, group_size, sync_index,
+                            member_index, is_late_joiner);
+}
+
+int configura_utente(StatoUtente *utente, MainSharedMemory *shm_ptr, int shared_memory_id,
+                      int group_size, int group_index, int member_index, bool is_late_joiner) {
+    bool is_group_leader = (member_index == 0);
+    utente->shared_memory_id = shared_memory_id;
+    utente->user_pid = gettid();
+    utente->shm_ptr = shm_ptr;
+    utente->group_size = group_size;
+    utente->is_group_leader = is_group_leader;
+    utente->is_late_joiner = is_late_joiner;
 
     /* Group ID basato sull'indice nel pool di sincronizzazione */
-    utente->group_id = sync_index; 
+    utente->group_id = group_index;
 
-    /* Connessione alla memoria condivisa */
-    utente->shm_ptr = attach_to_simulation_shared_memory(utente->shared_memory_id);
+    /* Casella di risposta per gli ordini alle stazioni */
+    utente->reply_slot_index = station_channel_attach_user(utente->shm_ptr, utente->user_pid);
+    if (utente->reply_slot_index == -1) {
+        fprintf(stderr, "[ERROR] Utente PID %d: caselle di risposta esaurite\n", utente->user_pid);
+        return -1;
+    }
+
+    /* Flusso casuale: gli slot gruppo vengono riusati, i late joiner distinguono anche il giorno */
+    uint64_t stream_index = (uint64_t)group_index * MAX_USERS_PER_GROUP + (uint64_t)member_index;
+    if (is_late_joiner) {
+        stream_index |= (uint64_t)shm_ptr->current_simulation_day << 32;
+    }
+    seed_random_stream(shm_ptr->configuration.random_seed,
+                       is_late_joiner ? RANDOM_STREAM_LATE_USER : RANDOM_STREAM_USER, stream_index);
 
     /* Definizione profilo utente (ticket, gusti, pazienza) */
     genera_identita_casuale(utente);
+    return 0;
+}
+
+void termina_utente(StatoUtente *utente) {
+    station_channel_detach_user(utente->shm_ptr, utente->reply_slot_index, utente->user_pid);
+    LOG_DEBUG("[UTENTE] PID %d: Terminazione pulita.\n", utente->user_pid);
 }
 
 void run_utente_simulation(StatoUtente *utente) {
@@ -95,7 +175,7 @@ void run_utente_simulation(StatoUtente *utente) {
         /* Preparazione giornata */
         reset_stato_giornaliero_utente(utente);
         
-        sync_child_start(utente->shm_ptr->semaphore_sync_id, BARRIER_MORNING_READY, BARRIER_MORNING_GATE);
+        sync_child_start_undo(utente->shm_ptr->semaphore_sync_id, BARRIER_MORNING_READY, BARRIER_MORNING_GATE);
         
         if (utente->is_late_joiner) {
             utente->is_late_joiner = false; /* Non più late joiner dopo il primo giorno */
@@ -108,7 +188,7 @@ void run_utente_simulation(StatoUtente *utente) {
 
         /* Fine giornata (skip se simulazione terminata) */
         if (utente->shm_ptr->is_simulation_running) {
-            sync_child_start(utente->shm_ptr->semaphore_sync_id, BARRIER_EVENING_READY, BARRIER_EVENING_GATE);
+            sync_child_start_undo(utente->shm_ptr->semaphore_sync_id, BARRIER_EVENING_READY, BARRIER_EVENING_GATE);
         }
     }
 }
@@ -117,7 +197,7 @@ void sincronizza_startup_utente(StatoUtente *utente) {
     /* IMPORTANTE: controllare is_late_joiner PRIMA di current_simulation_day */
     if (utente->is_late_joiner) {
         /* Late joiner: aspetta che il Master configuri la barriera mattutina (Interrompibile) */
-        printf("[DEBUG-UTENTE] PID %d: Late joiner, attendo BARRIER_ADD_USERS_GATE...\n", getpid());
+        LOG_DEBUG("[DEBUG-UTENTE] PID %d: Late joiner, attendo BARRIER_ADD_USERS_GATE...\n", utente->user_pid);
         
         /* Uso versione interrompibile per non bloccare su SIGINT/SIGTERM */
         while (local_daily_cycle_is_active || utente->shm_ptr->is_simulation_running) {
@@ -129,19 +209,19 @@ void sincronizza_startup_utente(StatoUtente *utente) {
                  break; 
              }
         }
-        printf("[DEBUG-UTENTE] PID %d: Late joiner, gate aperto, procedo\n", getpid());
+        LOG_DEBUG("[DEBUG-UTENTE] PID %d: Late joiner, gate aperto, procedo\n", utente->user_pid);
 
     } else if (utente->shm_ptr->current_simulation_day == 0) {
-        printf("[DEBUG] Utente PID %d: In attesa barriera di Startup.\n", getpid());
-        sync_child_start(utente->shm_ptr->semaphore_sync_id, BARRIER_STARTUP_READY, BARRIER_STARTUP_GATE);
+        LOG_DEBUG("[DEBUG] Utente PID %d: In attesa barriera di Startup.\n", utente->user_pid);
+        sync_child_start_undo(utente->shm_ptr->semaphore_sync_id, BARRIER_STARTUP_READY, BARRIER_STARTUP_GATE);
     }
 
     if (utente->is_group_leader) {
-        reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
-        utente->shm_ptr->group_statuses[utente->group_id].group_leader_pid = getpid();
-        release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+        lock_simulation_mutex(utente->shm_ptr, group_mutex_index(utente->group_id));
+        utente->shm_ptr->group_statuses[utente->group_id].group_leader_pid = utente->user_pid;
+        unlock_simulation_mutex(utente->shm_ptr, group_mutex_index(utente->group_id));
     }
-    printf("[DEBUG] Utente PID %d: Pronto (late_joiner=%d).\n", getpid(), utente->is_late_joiner);
+    LOG_DEBUG("[DEBUG] Utente PID %d: Pronto (late_joiner=%d).\n", utente->user_pid, utente->is_late_joiner);
 }
 
 void reset_stato_giornaliero_utente(StatoUtente *utente) {
@@ -152,12 +232,20 @@ void reset_stato_giornaliero_utente(StatoUtente *utente) {
 }
 
 void esegui_percorso_mensa_giornaliero(StatoUtente *utente) {
-    printf("[UTENTE] PID %d: Inizio giornata %d.\n", getpid(), utente->shm_ptr->current_simulation_day + 1);
+    LOG_DEBUG("[UTENTE] PID %d: Inizio giornata %d.\n", utente->user_pid, utente->shm_ptr->current_simulation_day + 1);
 
+    utente->journey_start_tick = simulation_clock_now(&utente->shm_ptr->simulation_clock);
+    inizia_fase(utente, TRACE_PHASE_TICKET);
     fase_validazione_ticket(utente);
+    concludi_fase(utente, TRACE_PHASE_TICKET);
 
+    inizia_fase(utente, TRACE_PHASE_FIRST_COURSE);
     bool got_first = fase_servizio_stazione(utente, 0);  /* Primi */
+    concludi_fase(utente, TRACE_PHASE_FIRST_COURSE);
+
+    inizia_fase(utente, TRACE_PHASE_SECOND_COURSE);
     bool got_second = fase_servizio_stazione(utente, 1); /* Secondi */
+    concludi_fase(utente, TRACE_PHASE_SECOND_COURSE);
 
     /* Gestione Abbandono */
     if (local_daily_cycle_is_active && !got_first && !got_second) {
@@ -166,14 +254,34 @@ void esegui_percorso_mensa_giornaliero(StatoUtente *utente) {
 
     /* Flusso Post-Servizio */
     if (local_daily_cycle_is_active) {
+        inizia_fase(utente, TRACE_PHASE_REGROUP);
         fase_riunione_gruppo(utente);
+        concludi_fase(utente, TRACE_PHASE_REGROUP);
+
+        inizia_fase(utente, TRACE_PHASE_CASHIER);
         fase_pagamento_cassa(utente, got_first, got_second);
+        concludi_fase(utente, TRACE_PHASE_CASHIER);
+
+        inizia_fase(utente, TRACE_PHASE_TABLE);
         fase_prenotazione_tavolo(utente);
+        concludi_fase(utente, TRACE_PHASE_TABLE);
+
+        inizia_fase(utente, TRACE_PHASE_EAT);
         fase_consumazione_pasto(utente, got_first, got_second);
+        concludi_fase(utente, TRACE_PHASE_EAT);
+
+        inizia_fase(utente, TRACE_PHASE_COFFEE);
         fase_servizio_caffe(utente);
+        concludi_fase(utente, TRACE_PHASE_COFFEE);
         
         aggiorna_statistiche_servito(utente);
+        inizia_fase(utente, TRACE_PHASE_EXIT);
         fase_uscita_collettiva(utente);
+        concludi_fase(utente, TRACE_PHASE_EXIT);
+        if (local_daily_cycle_is_active) {
+            record_journey_time(utente->shm_ptr, JOURNEY_END_TO_END,
+                                get_simulated_minutes(&utente->shm_ptr->simulation_clock, utente->journey_start_tick));
+        }
     } else {
         aggiorna_statistiche_non_servito(utente);
     }
@@ -185,7 +293,8 @@ void esegui_percorso_mensa_giornaliero(StatoUtente *utente) {
 
 void fase_validazione_ticket(StatoUtente *utente) {
     if (utente->has_ticket && local_daily_cycle_is_active) {
-        printf("[UTENTE] PID %d: In coda per validazione ticket...\n", getpid());
+        LOG_DEBUG("[UTENTE] PID %d: In coda per validazione ticket...\n", utente->user_pid);
+        unsigned long long start_tick = simulation_clock_now(&utente->shm_ptr->simulation_clock);
         if (reserve_sem_interruptible(utente->shm_ptr->semaphore_ticket_id, 0) != -1) {
             if (local_daily_cycle_is_active) {
                 int avg_ticket_time = utente->shm_ptr->configuration.timings.average_service_time_ticket;
@@ -193,7 +302,9 @@ void fase_validazione_ticket(StatoUtente *utente) {
                 
                 simulate_seconds_passage(varied_time, utente->shm_ptr->configuration.timings.nanoseconds_per_tick);
                 utente->ticket_is_validated = true;
-                printf("[UTENTE] PID %d: Ticket validato.\n", getpid());
+                record_latency(utente->shm_ptr, LATENCY_METRIC_TICKET,
+                               get_simulated_minutes(&utente->shm_ptr->simulation_clock, start_tick));
+                LOG_DEBUG("[UTENTE] PID %d: Ticket validato.\n", utente->user_pid);
             }
             release_sem(utente->shm_ptr->semaphore_ticket_id, 0);
         }
@@ -213,17 +324,17 @@ bool fase_servizio_stazione(StatoUtente *utente, int stazione_tipo) {
 
     if (choice == -1) return false;
 
-    /* Check disponibilità e ripiego atomico */
-    reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
-    
-    if (stazione->portions[choice] <= 0) {
+    /* Check disponibilità e ripiego (lettura lock-free: il prelievo effettivo
+       avviene con CAS lato operatore, che risponde OUT_OF_STOCK se nel frattempo
+       il piatto si esaurisce) */
+    if (get_station_portions(stazione, choice) <= 0) {
         int num_dishes = (stazione_tipo == 0) ? 
                         utente->shm_ptr->food_menu.number_of_first_courses : 
                         utente->shm_ptr->food_menu.number_of_second_courses;
         
         bool found_alt = false;
         for (int i = 0; i < num_dishes; i++) {
-            if (stazione->portions[i] > 0) {
+            if (get_station_portions(stazione, i) > 0) {
                 choice = i;
                 found_alt = true;
                 break;
@@ -231,32 +342,30 @@ bool fase_servizio_stazione(StatoUtente *utente, int stazione_tipo) {
         }
 
         if (!found_alt) {
-            release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
-            printf("[UTENTE] PID %d: Piatti ESAURITI alla stazione %s.\n", 
-                   getpid(), (stazione_tipo == 0 ? "Primi" : "Secondi"));
+            LOG_DEBUG("[UTENTE] PID %d: Piatti ESAURITI alla stazione %s.\n", 
+                      utente->user_pid, (stazione_tipo == 0 ? "Primi" : "Secondi"));
             return false;
         }
-        printf("[UTENTE] PID %d: Piatto preferito terminato. Scelgo alternativa %d.\n", getpid(), choice);
+        LOG_DEBUG("[UTENTE] PID %d: Piatto preferito terminato. Scelgo alternativa %d.\n", utente->user_pid, choice);
     }
-    release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
 
-    /* Check soglia pazienza (coda IPC) */
-    int q_len = get_message_queue_length(stazione->message_queue_id);
+    /* Check soglia pazienza (coda della stazione) */
+    int q_len = station_channel_pending_orders(utente->shm_ptr, (StationChannelIndex)stazione_tipo);
     if (q_len > utente->shm_ptr->configuration.thresholds.queue_patience_threshold) {
-        printf("[UTENTE] PID %d: Troppa coda alla stazione %s (%d utenti). Salto.\n", 
-               getpid(), (stazione_tipo == 0 ? "Primi" : "Secondi"), q_len);
+        LOG_DEBUG("[UTENTE] PID %d: Troppa coda alla stazione %s (%d utenti). Salto.\n", 
+                  utente->user_pid, (stazione_tipo == 0 ? "Primi" : "Secondi"), q_len);
         return false;
     }
 
-    return fase_checkout_piatto(utente, stazione, &choice, stazione_tipo);
+    return fase_checkout_piatto(utente, &choice, stazione_tipo);
 }
 
 void fase_ritiro_formale(StatoUtente *utente) {
-    printf("[UTENTE] PID %d: Abbandono per mancanza cibo o pazienza.\n", getpid());
+    LOG_DEBUG("[UTENTE] PID %d: Abbandono per mancanza cibo o pazienza.\n", utente->user_pid);
     local_daily_cycle_is_active = 0;
     
     int s_idx = utente->group_id;
-    reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    lock_simulation_mutex(utente->shm_ptr, group_mutex_index(s_idx));
     if (utente->shm_ptr->group_statuses[s_idx].active_members > 0) {
         utente->shm_ptr->group_statuses[s_idx].active_members--;
         if (utente->is_group_leader) {
@@ -264,7 +373,7 @@ void fase_ritiro_formale(StatoUtente *utente) {
             utente->is_group_leader = false;
         }
     }
-    release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    unlock_simulation_mutex(utente->shm_ptr, group_mutex_index(s_idx));
 
     /* Sblocco semafori di gruppo per evitare deadlock degli altri membri */
     int base_sem = s_idx * GROUP_SEMS_PER_ENTRY;
@@ -282,15 +391,15 @@ void fase_riunione_gruppo(StatoUtente *utente) {
     if (utente->group_size <= 1 || !local_daily_cycle_is_active) return;
 
     int s_idx = utente->group_id;
-    reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    lock_simulation_mutex(utente->shm_ptr, group_mutex_index(s_idx));
     if (utente->shm_ptr->group_statuses[s_idx].group_leader_pid == 0) {
-        utente->shm_ptr->group_statuses[s_idx].group_leader_pid = getpid();
+        utente->shm_ptr->group_statuses[s_idx].group_leader_pid = utente->user_pid;
         utente->is_group_leader = true;
     }
-    release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+    unlock_simulation_mutex(utente->shm_ptr, group_mutex_index(s_idx));
 
     int base_sem = s_idx * GROUP_SEMS_PER_ENTRY;
-    printf("[UTENTE] PID %d: Riunione amici al meeting point...\n", getpid());
+    LOG_DEBUG("[UTENTE] PID %d: Riunione amici al meeting point...\n", utente->user_pid);
     
     if (reserve_sem_interruptible(utente->shm_ptr->group_sync_semaphore_id, base_sem + GROUP_SEM_PRE_CASHIER) != -1) {
         if (local_daily_cycle_is_active) {
@@ -302,35 +411,31 @@ void fase_riunione_gruppo(StatoUtente *utente) {
 void fase_pagamento_cassa(StatoUtente *utente, bool p1, bool p2) {
     if (!local_daily_cycle_is_active) return;
 
-    struct timespec start_t, end_t;
-    clock_gettime(CLOCK_MONOTONIC, &start_t);
+    unsigned long long start_tick = simulation_clock_now(&utente->shm_ptr->simulation_clock);
 
-    SimulationMessage msg;
-    msg.message_type = MSG_TYPE_ORDER; 
-    
-    CashierPayload *payload = (CashierPayload *)msg.message_text;
-    payload->user_pid = getpid();
-    payload->had_first = p1;
-    payload->had_second = p2;
-    payload->want_coffee = true; 
-    payload->has_discount = utente->ticket_is_validated;
+    CashierPayload payload;
+    payload.user_pid = utente->user_pid;
+    payload.reply_slot_index = utente->reply_slot_index;
+    payload.had_first = p1;
+    payload.had_second = p2;
+    payload.want_coffee = true; 
+    payload.has_discount = utente->ticket_is_validated;
 
-    printf("[UTENTE] PID %d: In coda alla Cassa...\n", getpid());
+    LOG_DEBUG("[UTENTE] PID %d: In coda alla Cassa...\n", utente->user_pid);
 
-    /* Invio Messaggio (Interrompibile) */
-    if (send_message_to_queue_interruptible(utente->shm_ptr->register_station.message_queue_id, &msg, sizeof(CashierPayload), 0) == -1) {
+    /* Invio Pagamento (Interrompibile) */
+    if (station_channel_send_order(utente->shm_ptr, STATION_CHANNEL_CASHIER, &payload, sizeof(CashierPayload)) == -1) {
         return;
     }
 
     if (!local_daily_cycle_is_active) return;
 
     /* Ricezione Risposta (Robusta e Bloccante) */
-    if (receive_message_robust(utente->shm_ptr->register_station.message_queue_id, &msg, sizeof(CashierPayload), getpid()) != -1) {
+    if (receive_message_robust(utente->shm_ptr, STATION_CHANNEL_CASHIER, &payload, sizeof(CashierPayload)) != -1) {
         if (local_daily_cycle_is_active) {
-            clock_gettime(CLOCK_MONOTONIC, &end_t);
-            double w_min = get_simulated_minutes(start_t, end_t, utente->shm_ptr->configuration.timings.nanoseconds_per_tick);
+            double w_min = get_simulated_minutes(&utente->shm_ptr->simulation_clock, start_tick);
             update_wait_time_stat(utente, w_min, 3); /* 3: Cassa */
-            printf("[UTENTE] PID %d: Pagamento completato.\n", getpid());
+            LOG_DEBUG("[UTENTE] PID %d: Pagamento completato.\n", utente->user_pid);
         }
     }
 }
@@ -340,53 +445,60 @@ void fase_prenotazione_tavolo(StatoUtente *utente) {
 
     int s_idx = utente->group_id;
     int base_sem = s_idx * GROUP_SEMS_PER_ENTRY;
+    unsigned long long start_tick = simulation_clock_now(&utente->shm_ptr->simulation_clock);
 
     if (utente->is_group_leader) {
-        reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+        lock_simulation_mutex(utente->shm_ptr, group_mutex_index(s_idx));
         int members = utente->shm_ptr->group_statuses[s_idx].active_members;
-        release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+        unlock_simulation_mutex(utente->shm_ptr, group_mutex_index(s_idx));
 
-        printf("[UTENTE] PID %d: Leader cerca tavolo per %d persone...\n", getpid(), members);
+        LOG_DEBUG("[UTENTE] PID %d: Leader cerca tavolo per %d persone...\n", utente->user_pid, members);
         
         bool found = false;
         while (local_daily_cycle_is_active && !found) {
-            reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_TABLES);
-            
-            for (int i = 0; i < utente->shm_ptr->seat_area.active_tables_count; i++) {
-                Table *t = &utente->shm_ptr->seat_area.tables[i];
-                if ((t->capacity - t->occupied_seats) >= members) {
-                    t->occupied_seats += members;
-                    utente->assigned_table_id = i;
-                    
-                    reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
-                    utente->shm_ptr->group_statuses[s_idx].assigned_table_id = i;
-                    release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
-                    
-                    found = true;
-                    break;
-                }
+            int wait_channel = -1;
+            lock_simulation_mutex(utente->shm_ptr, MUTEX_TABLES);
+            int table_id = dining_area_reserve(&utente->shm_ptr->seat_area, members);
+            if (table_id == -1) {
+                wait_channel = dining_area_register_waiter(&utente->shm_ptr->seat_area, members);
+            }
+            unlock_simulation_mutex(utente->shm_ptr, MUTEX_TABLES);
+
+            if (table_id != -1) {
+                utente->assigned_table_id = table_id;
+                found = true;
             }
-            
-            release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_TABLES);
             
             if (!found && local_daily_cycle_is_active) {
-                /* Attesa passiva su semaforo di condizione - RITORNA SU SEGNALE FINE GIORNO */
-                reserve_sem_interruptible(utente->shm_ptr->seat_area.condition_semaphore_id, 0);
+                /* Attesa passiva sul canale della propria dimensione - RITORNA SU SEGNALE FINE GIORNO */
+                reserve_sem_interruptible_no_undo(utente->shm_ptr->seat_area.condition_semaphore_id, wait_channel);
             }
         }
 
         if (found) {
-            printf("[UTENTE] PID %d: Tavolo %d trovato e occupato per il gruppo.\n", getpid(), utente->assigned_table_id);
+            /* Pubblicazione del tavolo ai membri, fuori da MUTEX_TABLES (nessun lock annidato) */
+            lock_simulation_mutex(utente->shm_ptr, group_mutex_index(s_idx));
+            utente->shm_ptr->group_statuses[s_idx].assigned_table_id = utente->assigned_table_id;
+            unlock_simulation_mutex(utente->shm_ptr, group_mutex_index(s_idx));
+
+            record_latency(utente->shm_ptr, LATENCY_METRIC_TABLE,
+                           get_simulated_minutes(&utente->shm_ptr->simulation_clock, start_tick));
+            LOG_DEBUG("[UTENTE] PID %d: Tavolo %d trovato e occupato per il gruppo.\n", utente->user_pid, utente->assigned_table_id);
             open_barrier_gate(utente->shm_ptr->group_sync_semaphore_id, base_sem + GROUP_SEM_TABLE_GATE);
         }
     } else {
-        printf("[UTENTE] PID %d: In attesa del leader per il tavolo...\n", getpid());
+        LOG_DEBUG("[UTENTE] PID %d: In attesa del leader per il tavolo...\n", utente->user_pid);
         wait_for_zero_interruptible(utente->shm_ptr->group_sync_semaphore_id, base_sem + GROUP_SEM_TABLE_GATE);
         
         if (local_daily_cycle_is_active) {
-            reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+            lock_simulation_mutex(utente->shm_ptr, group_mutex_index(s_idx));
             utente->assigned_table_id = utente->shm_ptr->group_statuses[s_idx].assigned_table_id;
-            release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SHARED_DATA);
+            unlock_simulation_mutex(utente->shm_ptr, group_mutex_index(s_idx));
+
+            if (utente->assigned_table_id != -1) {
+                record_latency(utente->shm_ptr, LATENCY_METRIC_TABLE,
+                               get_simulated_minutes(&utente->shm_ptr->simulation_clock, start_tick));
+            }
         }
     }
 }
@@ -401,23 +513,21 @@ void fase_consumazione_pasto(StatoUtente *utente, bool p1, bool p2) {
     }
     
     /* Fase Rilascio Posto (Step 4) */
-    reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_TABLES);
-    utente->shm_ptr->seat_area.tables[utente->assigned_table_id].occupied_seats--;
-    release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_TABLES);
-    
-    /* Notifica a chi è in attesa */
-    release_sem(utente->shm_ptr->seat_area.condition_semaphore_id, 0);
-
-    printf("[UTENTE] PID %d: Pasto terminato al tavolo %d. Posto liberato.\n", 
-           getpid(), utente->assigned_table_id);
+    lock_simulation_mutex(utente->shm_ptr, MUTEX_TABLES);
+    dining_area_release(&utente->shm_ptr->seat_area, utente->assigned_table_id, 1);
+    /* Notifica solo i leader il cui gruppo ora trova posto */
+    dining_area_wake_fitting_waiters(&utente->shm_ptr->seat_area);
+    unlock_simulation_mutex(utente->shm_ptr, MUTEX_TABLES);
+
+    LOG_DEBUG("[UTENTE] PID %d: Pasto terminato al tavolo %d. Posto liberato.\n", 
+              utente->user_pid, utente->assigned_table_id);
 }
 
 void fase_servizio_caffe(StatoUtente *utente) {
-    FoodDistributionStation *stazione = &utente->shm_ptr->coffee_dessert_station;
     int choice = utente->selected_dessert_coffee_index;
 
-    printf("[UTENTE] PID %d: Coda Caffè/Dolce...\n", getpid());
-    fase_checkout_piatto(utente, stazione, &choice, 2); /* 2: Caffè */
+    LOG_DEBUG("[UTENTE] PID %d: Coda Caffè/Dolce...\n", utente->user_pid);
+    fase_checkout_piatto(utente, &choice, STATION_CHANNEL_COFFEE_DESSERT);
 }
 
 void fase_uscita_collettiva(StatoUtente *utente) {
@@ -430,32 +540,15 @@ void fase_uscita_collettiva(StatoUtente *utente) {
             wait_for_zero_interruptible(utente->shm_ptr->group_sync_semaphore_id, base_sem + GROUP_SEM_EXIT);
         }
     }
-    printf("[UTENTE] PID %d: Uscita gruppo completata.\n", getpid());
+    LOG_DEBUG("[UTENTE] PID %d: Uscita gruppo completata.\n", utente->user_pid);
 }
 
 void aggiorna_statistiche_servito(StatoUtente *utente) {
-    reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
-    
-    /* Incremento Giornaliero */
-    utente->shm_ptr->statistics.clients_statistics.daily_clients_served++;
-    /* Incremento Totale */
-    utente->shm_ptr->statistics.clients_statistics.total_clients_served++;
-    
-    if (utente->has_ticket) {
-        utente->shm_ptr->statistics.clients_statistics.daily_clients_with_ticket++;
-        utente->shm_ptr->statistics.clients_statistics.total_clients_with_ticket++;
-    } else {
-        utente->shm_ptr->statistics.clients_statistics.daily_clients_without_ticket++;
-        utente->shm_ptr->statistics.clients_statistics.total_clients_without_ticket++;
-    }
-    release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+    record_client_served(utente->shm_ptr, utente->has_ticket);
 }
 
 void aggiorna_statistiche_non_servito(StatoUtente *utente) {
-    reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
-    utente->shm_ptr->statistics.clients_statistics.daily_clients_not_served++;
-    utente->shm_ptr->statistics.clients_statistics.total_clients_not_served++;
-    release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+    record_client_not_served(utente->shm_ptr);
 }
 
 /* ==========================================================================
@@ -463,7 +556,7 @@ void aggiorna_statistiche_non_servito(StatoUtente *utente) {
  * ========================================================================== */
 
 void handle_utente_signals(int sig) {
-    if (sig == SIGUSR2 || sig == SIGTERM || sig == SIGINT) {
+    if (sig == SIGUSR2 || sig == SIGTERM || sig == SIGINT || sig == USER_HOST_WAKE_SIGNAL) {
         local_daily_cycle_is_active = 0;
     }
 }
@@ -476,11 +569,12 @@ void setup_utente_signals(void) {
     sigaction(SIGUSR2, &sa, NULL); /* Fine Giorno */
     sigaction(SIGTERM, &sa, NULL); /* Terminazione Master */
     sigaction(SIGINT,  &sa, NULL); /* Interruzione manuale */
+    sigaction(USER_HOST_WAKE_SIGNAL, &sa, NULL); /* Risveglio del singolo thread (host) */
 }
 
 void genera_identita_casuale(StatoUtente *utente) {
     /* PID % 5 != 0 garantisce circa l'80% di utenti con ticket sconto */
-    utente->has_ticket = ((getpid() % 5) != 0);
+    utente->has_ticket = ((utente->user_pid % 5) != 0);
     
     int n_primi = utente->shm_ptr->food_menu.number_of_first_courses;
     int n_secondi = utente->shm_ptr->food_menu.number_of_second_courses;
@@ -494,74 +588,61 @@ void genera_identita_casuale(StatoUtente *utente) {
 }
 
 /* Funzione helper per ricezione robusta senza polling */
-ssize_t receive_message_robust(int queue_id, void *msg_ptr, size_t size, long type) {
+ssize_t receive_message_robust(MainSharedMemory *shm_ptr, StationChannelIndex channel, void *payload, size_t size) {
     ssize_t res;
     while (local_daily_cycle_is_active) {
-        /* Chiamata bloccante (0), ma interrompibile da segnali */
-        res = receive_message_from_queue(queue_id, msg_ptr, size, type, 0); 
+        /* Chiamata bloccante, ma interrompibile da segnali */
+        res = station_channel_receive_reply(shm_ptr, channel, payload, size); 
         
         if (res != -1) return res;
         
         /* Se interrotto da segnale (EINTR), il loop controlla local_daily_cycle_is_active e riprova se attivo */
         if (errno != EINTR) {
-            perror("[UTENTE] Errore msgrcv");
+            perror("[UTENTE] Errore ricezione risposta stazione");
             return -1;
         }
     }
     return -1; /* Ciclo finito */
 }
 
-bool fase_checkout_piatto(StatoUtente *utente, FoodDistributionStation *stazione, int *choice, int stazione_tipo) {
-    struct timespec s_t, e_t;
-    clock_gettime(CLOCK_MONOTONIC, &s_t);
+bool fase_checkout_piatto(StatoUtente *utente, int *choice, int stazione_tipo) {
+    unsigned long long start_tick = simulation_clock_now(&utente->shm_ptr->simulation_clock);
 
-    SimulationMessage msg;
-    msg.message_type = MSG_TYPE_ORDER;
-    StationPayload *pay = (StationPayload *)msg.message_text;
-    pay->user_pid = getpid();
+    StationPayload payload;
+    StationPayload *pay = &payload;
+    pay->user_pid = utente->user_pid;
+    pay->reply_slot_index = utente->reply_slot_index;
     pay->dish_index = *choice;
     pay->status = 0;
 
     if (!local_daily_cycle_is_active) return false;
     
     /* Invio ordine */
-    if (send_message_to_queue_interruptible(stazione->message_queue_id, &msg, sizeof(StationPayload), 0) == -1) { 
+    if (station_channel_send_order(utente->shm_ptr, (StationChannelIndex)stazione_tipo, pay, sizeof(StationPayload)) == -1) { 
         return false; 
     }
     
     if (!local_daily_cycle_is_active) return false;
     
     /* Ricezione risposta (Robusta e Bloccante) */
-    if (receive_message_robust(stazione->message_queue_id, &msg, sizeof(StationPayload), getpid()) == -1) { 
+    if (receive_message_robust(utente->shm_ptr, (StationChannelIndex)stazione_tipo, pay, sizeof(StationPayload)) == -1) { 
         return false; 
     }
 
-    clock_gettime(CLOCK_MONOTONIC, &e_t);
-    double w_min = get_simulated_minutes(s_t, e_t, utente->shm_ptr->configuration.timings.nanoseconds_per_tick);
+    double w_min = get_simulated_minutes(&utente->shm_ptr->simulation_clock, start_tick);
     update_wait_time_stat(utente, w_min, stazione_tipo);
 
     if (pay->status == ORDER_STATUS_SERVED) {
-        printf("[UTENTE] PID %d: Piatto %d ricevuto.\n", getpid(), *choice);
+        LOG_DEBUG("[UTENTE] PID %d: Piatto %d ricevuto.\n", utente->user_pid, *choice);
         return true;
     }
     return false;
 }
 
-double get_simulated_minutes(struct timespec start, struct timespec end, long nanosecs_per_tick) {
-    long long delta_ns = (end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec);
-    return (nanosecs_per_tick > 0) ? (double)delta_ns / nanosecs_per_tick : 0;
+double get_simulated_minutes(const SimulationClock *clock, unsigned long long start_tick) {
+    return simulation_clock_minutes_since(clock, start_tick);
 }
 
 void update_wait_time_stat(StatoUtente *utente, double wait_min, int type) {
-    reserve_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
-    
-    WaitTimeAccumulator *daily = &utente->shm_ptr->statistics.daily_wait_accumulators;
-    WaitTimeAccumulator *total = &utente->shm_ptr->statistics.total_wait_accumulators;
-    
-    if (type == 0)      { daily->sum_wait_first += wait_min; daily->count_first++; total->sum_wait_first += wait_min; total->count_first++; }
-    else if (type == 1) { daily->sum_wait_second += wait_min; daily->count_second++; total->sum_wait_second += wait_min; total->count_second++; }
-    else if (type == 2) { daily->sum_wait_coffee += wait_min; daily->count_coffee++; total->sum_wait_coffee += wait_min; total->count_coffee++; }
-    else if (type == 3) { daily->sum_wait_cashier += wait_min; daily->count_cashier++; total->sum_wait_cashier += wait_min; total->count_cashier++; }
-    
-    release_sem(utente->shm_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+    record_wait_time(utente->shm_ptr, wait_min, type);
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 
 /* Includes di sistema */
 #include <stdbool.h>
+#include <signal.h>
 #include <sys/types.h>
 
 /* Includes del progetto */
@@ -20,6 +21,12 @@
 #include "queue.h"    /* Per SimulationMessage */
 #include "config.h"   /* Per FoodDistributionStation */
 
+/**
+ * Segnale di risveglio inoltrato dall'host ai singoli thread utente
+ * (USERS_PER_HOST > 0): equivale a SIGUSR2/SIGTERM per il solo thread destinatario.
+ */
+#define USER_HOST_WAKE_SIGNAL (SIGRTMIN + 2)
+
 /* ==========================================================================
  *                          STRUTTURE DATI (USER STATE)
  * ========================================================================== */
@@ -33,6 +40,7 @@
  */
 typedef struct {
     int shared_memory_id;               /**< ID della risorsa SHM passata via linea di comando */
+    pid_t user_pid;                     /**< Identità dell'utente: TID del thread (coincide col PID se processo dedicato) */
     bool has_ticket;                    /**< Possesso iniziale del ticket sconto (80% dei casi) */
     bool ticket_is_validated;           /**< Stato di convalida del ticket dopo la fase ticket */
     
@@ -42,6 +50,7 @@ typedef struct {
     bool is_late_joiner;                /**< Utente aggiunto a simulazione in corso (da add_users) */
 
     MainSharedMemory *shm_ptr;          /**< Puntatore alla memoria condivisa agganciata */
+    int reply_slot_index;               /**< Casella di risposta assegnata dal canale di stazione */
     
     /* Scelte Menu del giorno (Indici negli array del Menu in SHM) */
     int selected_first_course_index;     /**< Scelta random per il primo piatto */
@@ -52,6 +61,10 @@ typedef struct {
 
     /* Social Seating (Step 3) */
     int assigned_table_id;              /**< ID del tavolo occupato dal gruppo (-1 se nessuno) */
+
+    /* Tempi del percorso (statistics.h, JourneyMetric) */
+    unsigned long long journey_start_tick; /**< Tick di ingresso in mensa */
+    unsigned long long phase_start_tick;   /**< Tick di ingresso nella fase corrente */
 } StatoUtente;
 
 /* ==========================================================================
@@ -64,8 +77,27 @@ typedef struct {
  * @param utente Puntatore alla struttura da inizializzare.
  * @param argc Conteggio argomenti da main.
  * @param argv Vettore argomenti da main.
+ * @return int 0 successo, -1 se configura_utente() fallisce.
+ */
+int init_utente(StatoUtente *utente, int argc, char *argv[]);
+
+/**
+ * @brief Inizializza lo stato di un utente già agganciato alla SHM.
+ *
+ * Usata da init_utente() e dallo zygote, che passa i parametri del gruppo
+ * senza linea di comando. Inizializza il flusso casuale del thread (ruolo
+ * utente, indice da gruppo e posizione), assegna la casella di risposta e
+ * genera il profilo.
+ *
+ * @param member_index Posizione nel gruppo (0: leader).
+ * @return int 0 successo, -1 se le caselle di risposta sono esaurite (il
+ *         chiamante termina l'utente senza avviarne il ciclo di vita).
  */
-void init_utente(StatoUtente *utente, int argc, char *argv[]);
+int configura_utente(StatoUtente *utente, MainSharedMemory *shm_ptr, int shared_memory_id,
+                      int group_size, int group_index, int member_index, bool is_late_joiner);
+
+/** @brief Rilascia la casella di risposta a fine simulazione (la SHM resta agganciata). */
+void termina_utente(StatoUtente *utente);
 
 /**
  * @brief Esegue il ciclo di vita principale (Start -> Giorno -> Fine).
@@ -86,11 +118,48 @@ void esegui_percorso_mensa_giornaliero(StatoUtente *utente);
 /** @brief Resetta le flag e rigenera l'id casuale all'inizio della giornata. */
 void reset_stato_giornaliero_utente(StatoUtente *utente);
 
+/* ==========================================================================
+ *                        ZYGOTE (USER_LAUNCHER=zygote)
+ * ========================================================================== */
+
+/**
+ * @brief Ciclo dello zygote utenti: riceve richieste di spawn e genera utenti senza exec.
+ *
+ * @param shared_memory_id ID della SHM della simulazione.
+ * @return int Codice di uscita del processo zygote.
+ * @see user_zygote.h
+ */
+int run_user_zygote(int shared_memory_id);
+
+/* ==========================================================================
+ *                      HOST UTENTI (USERS_PER_HOST > 0)
+ * ========================================================================== */
+
+/**
+ * @brief Esegue più utenti come thread dello stesso processo.
+ *
+ * @param shared_memory_id ID della SHM della simulazione.
+ * @param argc Conteggio argomenti da main.
+ * @param argv Vettore argomenti da main (formato in user_host.h).
+ * @return int Codice di uscita del processo host.
+ */
+int run_user_host(int shared_memory_id, int argc, char *argv[]);
+
+/**
+ * @brief Esegue più utenti come macchine a stati in un unico event loop.
+ *
+ * Stessi argomenti di run_user_host(); le attese di servizio e di pasto sono
+ * timer e le interazioni con stazioni e cassa sono non bloccanti.
+ *
+ * @see user_engine.c
+ */
+int run_user_engine(int shared_memory_id, int argc, char *argv[]);
+
 /* ==========================================================================
  *                       UTILITY INTERNE (PROTOTIPI)
  * ========================================================================== */
 
-/** @brief Gestisce i segnali asincroni (SIGUSR2, SIGTERM, SIGINT). */
+/** @brief Gestisce i segnali asincroni (SIGUSR2, SIGTERM, SIGINT, USER_HOST_WAKE_SIGNAL). */
 void handle_utente_signals(int sig);
 
 /** @brief Configura gli handler per i segnali asincroni. */
@@ -99,14 +168,14 @@ void setup_utente_signals(void);
 /** @brief Definisce il profilo casuale (ticket, gusti, pazienza). */
 void genera_identita_casuale(StatoUtente *utente);
 
-/** @brief Gestisce l'invio dell'ordine via MQ e l'attesa della risposta. */
-bool fase_checkout_piatto(StatoUtente *utente, FoodDistributionStation *stazione, int *choice, int stazione_tipo);
+/** @brief Gestisce l'invio dell'ordine sul canale di stazione e l'attesa della risposta. */
+bool fase_checkout_piatto(StatoUtente *utente, int *choice, int stazione_tipo);
 
 /** @brief Ricezione da MQ con timeout soft per evitare blocchi infiniti. */
 ssize_t receive_message_with_soft_timeout(int queue_id, SimulationMessage *msg, size_t size, long type);
 
-/** @brief Converte delta temporali in minuti simulati. */
-double get_simulated_minutes(struct timespec start, struct timespec end, long nanosecs_per_tick);
+/** @brief Minuti simulati trascorsi da `start_tick` sull'orologio condiviso. */
+double get_simulated_minutes(const SimulationClock *clock, unsigned long long start_tick);
 
 /** @brief Aggiorna gli accumulatori delle statistiche in SHM. */
 void update_wait_time_stat(StatoUtente *utente, double wait_min, int type);
@@ -0,0 +1,110 @@
+/**
+ * @file zygote.c
+ * @brief Zygote utenti: spawn di processi utente senza fork+exec.
+ *
+ * Lo zygote aggancia la SHM e installa i gestori di segnale una sola volta.
+ * Per ogni utente richiesto esegue una doppia fork: il figlio intermedio
+ * termina subito e il nipote, adottato dal Master (child subreaper), entra
+ * direttamente nel ciclo di vita dell'utente.
+ *
+ * @see user_zygote.h per il protocollo e il lato client.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/wait.h>
+
+/* Includes del progetto */
+#include "utente.h"
+#include "user_zygote.h"
+#include "mutex.h"
+#include "shm.h"
+#include "log.h"
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+/** Corpo del processo utente generato dallo zygote (non ritorna). */
+static void run_zygote_child(MainSharedMemory *shm, int shared_memory_id,
+                             const ZygoteGroupRequest *group, int member_index) {
+    StatoUtente utente;
+
+    /* Registrazione per la compensazione SIGCHLD del Master (ora suo genitore),
+     * prima della configurazione perché ne copra anche il fallimento */
+    lock_simulation_mutex(shm, MUTEX_USER_REGISTRY);
+    int slot = user_registry_insert(&shm->user_registry, getpid(), group->group_index);
+    unlock_simulation_mutex(shm, MUTEX_USER_REGISTRY);
+    if (slot == -1) {
+        fprintf(stderr, "[WARNING] Registro pieno. PID %d non tracciato.\n", getpid());
+    }
+
+    if (configura_utente(&utente, shm, shared_memory_id, group->group_size, group->group_index,
+                         member_index, group->is_late_joiner == 1) == -1) {
+        detach_shared_memory_segment(shm);
+        exit(EXIT_FAILURE);
+    }
+
+    run_utente_simulation(&utente);
+    termina_utente(&utente);
+    detach_shared_memory_segment(shm);
+    exit(EXIT_SUCCESS);
+}
+
+/** Genera un membro del gruppo tramite doppia fork. */
+static void spawn_zygote_member(MainSharedMemory *shm, int shared_memory_id,
+                                const ZygoteGroupRequest *group, int member_index) {
+    /* Evita che il buffer di stdout dello zygote venga duplicato nei figli */
+    fflush(stdout);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        pid_t user_pid = fork();
+        if (user_pid == 0) {
+            run_zygote_child(shm, shared_memory_id, group, member_index);
+        }
+        _exit(user_pid == -1 ? EXIT_FAILURE : EXIT_SUCCESS);
+    } else if (pid > 0) {
+        while (waitpid(pid, NULL, 0) == -1 && errno == EINTR);
+    } else {
+        perror("[ERROR] fork zygote fallita");
+    }
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+int run_user_zygote(int shared_memory_id) {
+    MainSharedMemory *shm = attach_to_simulation_shared_memory(shared_memory_id);
+
+    /* Gestori ereditati dai figli: run_utente_simulation li reinstalla comunque */
+    setup_utente_signals();
+    LOG_INFO("[ZYGOTE] PID %d: Pronto a generare utenti.\n", getpid());
+
+    int spawned = 0;
+    while (shm->is_simulation_running) {
+        SimulationMessage msg;
+        if (receive_message_from_queue(shm->zygote_queue_id, &msg, sizeof(ZygoteSpawnPayload),
+                                       MSG_TYPE_ZYGOTE_SPAWN, 0) == -1) {
+            /* EINTR: fine giornata o terminazione, ricontrolla is_simulation_running */
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        ZygoteSpawnPayload *payload = (ZygoteSpawnPayload *)msg.message_text;
+        for (int g = 0; g < payload->group_count; g++) {
+            for (int m = 0; m < payload->groups[g].group_size; m++) {
+                spawn_zygote_member(shm, shared_memory_id, &payload->groups[g], m);
+                spawned++;
+            }
+        }
+    }
+
+    detach_shared_memory_segment(shm);
+    LOG_INFO("[ZYGOTE] PID %d: Terminazione (%d utenti generati).\n", getpid(), spawned);
+    return EXIT_SUCCESS;
+}
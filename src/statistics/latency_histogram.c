@@ -0,0 +1,125 @@
+/**
+ * @file latency_histogram.c
+ * @brief Implementazione degli istogrammi log-lineari dei tempi di attesa.
+ *
+ * @see latency_histogram.h per lo schema dei bucket.
+ */
+
+/* Includes del progetto */
+#include "latency_histogram.h"
+
+/** Bucket per potenza di 2 oltre la parte lineare */
+#define HALF_SUB_BUCKETS (1u << (LATENCY_HISTOGRAM_SUB_BITS - 1))
+
+/** Massimo valore con bucket proprio */
+#define MAX_TRACKED_VALUE ((1ull << LATENCY_HISTOGRAM_MAX_BITS) - 1)
+
+_Static_assert(LATENCY_HISTOGRAM_BUCKETS == 512, "Schema dei bucket inatteso");
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+/**
+ * Indice del bucket: lineare sotto 2^SUB_BITS, poi `shift` bit scartati
+ * in modo che restino SUB_BITS bit significativi (il primo sempre a 1).
+ */
+static int bucket_of(uint64_t value) {
+    if (value > MAX_TRACKED_VALUE) value = MAX_TRACKED_VALUE;
+    if (value < (1u << LATENCY_HISTOGRAM_SUB_BITS)) return (int)value;
+
+    int shift = (63 - __builtin_clzll(value)) - (LATENCY_HISTOGRAM_SUB_BITS - 1);
+    return (int)(shift * HALF_SUB_BUCKETS + (value >> shift));
+}
+
+/** Estremi [low, low + width) dei valori del bucket. */
+static void bucket_range(int index, uint64_t *low, uint64_t *width) {
+    if (index < (1 << LATENCY_HISTOGRAM_SUB_BITS)) {
+        *low = (uint64_t)index;
+        *width = 1;
+        return;
+    }
+    int shift = index / (int)HALF_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(index - shift * (int)HALF_SUB_BUCKETS);
+    *low = sub << shift;
+    *width = 1ull << shift;
+}
+
+/** Valore rappresentativo del bucket (punto medio), in minuti. */
+static double bucket_minutes(int index) {
+    uint64_t low, width;
+    bucket_range(index, &low, &width);
+    return ((double)low + (double)(width - 1) / 2.0) / LATENCY_UNITS_PER_MINUTE;
+}
+
+static uint64_t total_count(const LatencyHistogram *histogram) {
+    uint64_t total = 0;
+    for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+        total += atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+    }
+    return total;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+void latency_histogram_record(LatencyHistogram *histogram, double minutes) {
+    if (!(minutes > 0.0)) minutes = 0.0;
+    uint64_t value = (uint64_t)(minutes * LATENCY_UNITS_PER_MINUTE + 0.5);
+    atomic_fetch_add_explicit(&histogram->counts[bucket_of(value)], 1, memory_order_relaxed);
+}
+
+void latency_histogram_merge(LatencyHistogram *dst, const LatencyHistogram *src) {
+    for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+        uint32_t count = atomic_load_explicit(&src->counts[i], memory_order_relaxed);
+        if (count != 0) {
+            atomic_fetch_add_explicit(&dst->counts[i], count, memory_order_relaxed);
+        }
+    }
+}
+
+double latency_histogram_percentile(const LatencyHistogram *histogram, double percentile) {
+    uint64_t total = total_count(histogram);
+    if (total == 0) return 0.0;
+
+    /* Rango del campione: ceil(percentile% di total), almeno 1 */
+    double exact_rank = percentile / 100.0 * (double)total;
+    uint64_t rank = (uint64_t)exact_rank;
+    if ((double)rank < exact_rank || rank == 0) rank++;
+
+    uint64_t cumulative = 0;
+    for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+        cumulative += atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+        if (cumulative >= rank) return bucket_minutes(i);
+    }
+    return bucket_minutes(LATENCY_HISTOGRAM_BUCKETS - 1);
+}
+
+LatencyPercentiles latency_histogram_summary(const LatencyHistogram *histogram) {
+    LatencyPercentiles summary = {0};
+
+    summary.samples = (int)total_count(histogram);
+    if (summary.samples == 0) return summary;
+
+    summary.p50 = latency_histogram_percentile(histogram, 50.0);
+    summary.p95 = latency_histogram_percentile(histogram, 95.0);
+    summary.p99 = latency_histogram_percentile(histogram, 99.0);
+
+    double weighted_sum = 0.0;
+    for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+        uint32_t count = atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+        if (count != 0) weighted_sum += (double)count * bucket_minutes(i);
+    }
+    summary.mean = weighted_sum / summary.samples;
+
+    for (int i = LATENCY_HISTOGRAM_BUCKETS - 1; i >= 0; i--) {
+        if (atomic_load_explicit(&histogram->counts[i], memory_order_relaxed) != 0) {
+            uint64_t low, width;
+            bucket_range(i, &low, &width);
+            summary.max = (double)(low + width - 1) / LATENCY_UNITS_PER_MINUTE;
+            break;
+        }
+    }
+    return summary;
+}
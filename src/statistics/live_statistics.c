@@ -0,0 +1,191 @@
+/**
+ * @file live_statistics.c
+ * @brief Pubblicazione (Master) e lettura (mensa_top) dell'istantanea live.
+ *
+ * Lo scrittore legge contatori e campi di stato senza prendere alcun lock:
+ * valori letti a metà aggiornamento sono accettabili per un monitor e
+ * vengono corretti alla pubblicazione successiva. Il seqlock garantisce
+ * solo che il lettore non veda un'istantanea mescolata tra due minuti.
+ *
+ * @see live_statistics.h
+ */
+
+/* Includes di sistema */
+#include <string.h>
+
+/* Includes del progetto */
+#include "live_statistics.h"
+#include "common.h"
+#include "sem.h"
+#include "station_channel.h"
+
+_Static_assert(LIVE_STATION_COUNT == STATION_CHANNEL_COUNT, "Una vista per canale di stazione");
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Campione (minuto, serviti) della finestra del throughput mobile. */
+typedef struct {
+    int minute;
+    int served;
+} ThroughputSample;
+
+/** Campioni conservati: la finestra più il suo estremo iniziale */
+#define THROUGHPUT_RING_SIZE (LIVE_THROUGHPUT_WINDOW_MINUTES + 1)
+
+/** Storico dello scrittore (solo Master): ring degli ultimi minuti pubblicati. */
+static ThroughputSample throughput_samples[THROUGHPUT_RING_SIZE];
+static int throughput_sample_count = 0;
+static int throughput_next_sample = 0;
+static int throughput_day = -1;
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+/** Riempie la vista di una stazione: coda, postazioni occupate e porzioni. */
+static void collect_station_view(MainSharedMemory *shm, StationChannelIndex channel, LiveStationView *view) {
+    FoodDistributionStation *stations[] = {
+        &shm->first_course_station, &shm->second_course_station, &shm->coffee_dessert_station
+    };
+    int semaphore_set_id;
+
+    view->pending_orders = station_channel_pending_orders(shm, channel);
+    view->dish_count = 0;
+
+    if (channel == STATION_CHANNEL_CASHIER) {
+        semaphore_set_id = shm->register_station.semaphore_set_id;
+        view->total_posts = shm->configuration.seats.seats_cash_desk;
+    } else {
+        FoodDistributionStation *station = stations[channel];
+        semaphore_set_id = station->semaphore_set_id;
+        view->total_posts = station->num_operators_assigned;
+
+        /* Porzioni contate solo per Primi e Secondi (Caffè/Dolci illimitati) */
+        if (channel == STATION_CHANNEL_FIRST_COURSE) {
+            view->dish_count = shm->food_menu.number_of_first_courses;
+        } else if (channel == STATION_CHANNEL_SECOND_COURSE) {
+            view->dish_count = shm->food_menu.number_of_second_courses;
+        }
+        for (int i = 0; i < view->dish_count; i++) {
+            view->portions[i] = get_station_portions(station, i);
+        }
+    }
+
+    /* GETVAL non modifica il semaforo: posti occupati = assegnati - liberi */
+    int free_posts = get_sem_val(semaphore_set_id, STATION_SEM_AVAILABLE_POSTS);
+    view->busy_posts = (free_posts >= 0) ? view->total_posts - free_posts : 0;
+}
+
+/** Occupazione dei tavoli (letta senza MUTEX_TABLES). */
+static void collect_table_occupancy(const DiningArea *area, LiveStatisticsData *data) {
+    data->tables_count = area->active_tables_count;
+    for (int i = 0; i < area->active_tables_count; i++) {
+        int occupied = area->tables[i].occupied_seats;
+        data->total_seats += area->tables[i].capacity;
+        data->occupied_seats += occupied;
+        if (occupied > 0) data->tables_in_use++;
+    }
+    for (int i = 0; i < DINING_WAIT_CHANNELS; i++) {
+        data->waiting_groups += area->waiting_leaders[i];
+    }
+}
+
+/** Clienti serviti e rinunce (oggi e totali): base condivisa più shard (senza MUTEX_SIMULATION_STATS). */
+static void collect_clients(const MainSharedMemory *shm, LiveStatisticsData *data) {
+    const StatisticsClientData *base = &shm->statistics.clients_statistics;
+    data->clients_served_today = base->daily_clients_served;
+    data->clients_not_served_today = base->daily_clients_not_served;
+    data->clients_served_total = base->total_clients_served;
+    data->clients_not_served_total = base->total_clients_not_served;
+
+    const StatisticsShard *shards = shm_statistics_shards((MainSharedMemory *)shm);
+    for (int i = 0; i < shm->statistics_shards_count; i++) {
+        const StatisticsShard *shard = &shards[i];
+        data->clients_served_today += shard->daily.clients_served;
+        data->clients_not_served_today += shard->daily.clients_not_served;
+        data->clients_served_total += shard->total.clients_served;
+        data->clients_not_served_total += shard->total.clients_not_served;
+    }
+}
+
+/** Campione pubblicato `age` minuti-pubblicazione fa (0: il più recente). */
+static const ThroughputSample *throughput_sample(int age) {
+    return &throughput_samples[(throughput_next_sample - 1 - age + 2 * THROUGHPUT_RING_SIZE) % THROUGHPUT_RING_SIZE];
+}
+
+/** Aggiunge il campione del minuto e calcola il throughput sulla finestra mobile. */
+static void update_throughput(LiveStatisticsData *data) {
+    /* Nuovo giorno (minuti o contatori azzerati): lo storico non è più confrontabile */
+    if (data->day != throughput_day ||
+        (throughput_sample_count > 0 && (data->minute < throughput_sample(0)->minute ||
+                                         data->clients_served_today < throughput_sample(0)->served))) {
+        throughput_day = data->day;
+        throughput_sample_count = 0;
+        throughput_next_sample = 0;
+    }
+
+    throughput_samples[throughput_next_sample] = (ThroughputSample){ data->minute, data->clients_served_today };
+    throughput_next_sample = (throughput_next_sample + 1) % THROUGHPUT_RING_SIZE;
+    if (throughput_sample_count < THROUGHPUT_RING_SIZE) throughput_sample_count++;
+
+    /* Campione più vecchio ancora entro la finestra */
+    const ThroughputSample *oldest = throughput_sample(0);
+    for (int age = throughput_sample_count - 1; age > 0; age--) {
+        if (data->minute - throughput_sample(age)->minute <= LIVE_THROUGHPUT_WINDOW_MINUTES) {
+            oldest = throughput_sample(age);
+            break;
+        }
+    }
+
+    int window = data->minute - oldest->minute;
+    data->throughput_window_minutes = window;
+    data->throughput_per_minute = (window > 0) ? (double)(data->clients_served_today - oldest->served) / window : 0.0;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+void live_statistics_publish(struct MainSharedMemory *shared_memory_ptr) {
+    LiveStatistics *live = &shared_memory_ptr->live_statistics;
+    LiveStatisticsData data;
+    memset(&data, 0, sizeof(data));
+
+    /* Raccolta fuori dalla sezione di scrittura: il seqlock resta dispari per una sola copia */
+    data.tick = simulation_clock_now(&shared_memory_ptr->simulation_clock);
+    data.day = shared_memory_ptr->current_simulation_day;
+    data.minute = shared_memory_ptr->simulation_minutes_passed;
+    data.total_users = shared_memory_ptr->current_total_users;
+
+    for (int i = 0; i < LIVE_STATION_COUNT; i++) {
+        collect_station_view(shared_memory_ptr, (StationChannelIndex)i, &data.stations[i]);
+    }
+    collect_table_occupancy(&shared_memory_ptr->seat_area, &data);
+    collect_clients(shared_memory_ptr, &data);
+    update_throughput(&data);
+
+    /* Scrittore unico: sequenza dispari, dati, sequenza pari */
+    uint32_t sequence = atomic_load_explicit(&live->sequence, memory_order_relaxed);
+    atomic_store_explicit(&live->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&live->data, &data, sizeof(data));
+    atomic_store_explicit(&live->sequence, sequence + 2, memory_order_release);
+}
+
+int live_statistics_read(const LiveStatistics *live, LiveStatisticsData *out) {
+    for (int attempt = 0; attempt < LIVE_STATISTICS_READ_RETRIES; attempt++) {
+        uint32_t before = atomic_load_explicit(&live->sequence, memory_order_acquire);
+        if (before == 0) return -1;
+        if (before & 1u) continue;
+
+        memcpy(out, &live->data, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+
+        if (atomic_load_explicit(&live->sequence, memory_order_relaxed) == before) {
+            return 0;
+        }
+    }
+    return -1;
+}
@@ -4,8 +4,10 @@
  * 
  * Fornisce funzioni per:
  * - Raccolta thread-safe delle statistiche dalla SHM
- * - Calcolo medie tempi di attesa
- * - Report a terminale e salvataggio su file
+ * - Contatori per processo (shard) aggiornati senza lock
+ * - Calcolo medie e percentili dei tempi di attesa
+ * - Tempi di coda/servizio e utilizzo per stazione e operatore
+ * - Report a terminale (il file è scritto da statistics_writer.c)
  * 
  * @see statistics.h per la documentazione delle strutture.
  */
@@ -13,11 +15,203 @@
 /* Includes di sistema */
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
 
 /* Includes del progetto */
 #include "statistics.h"
 #include "common.h"
 #include "sem.h"
+#include "mutex.h"
+#include "log.h"
+
+/** Shard condiviso di ripiego (pool esaurito), aggiornato sotto MUTEX_SIMULATION_STATS */
+#define STATISTICS_OVERFLOW_SHARD 0
+
+/** Shard assegnato al processo/thread chiamante */
+static __thread StatisticsShard *local_statistics_shard = NULL;
+
+/** Stripe di istogrammi del thread chiamante (scelta per TID) */
+static __thread LatencyStripe *local_latency_stripe = NULL;
+
+/** Etichette delle attese nei report, allineate alla colonna (LatencyMetric) */
+static const char *const latency_metric_labels[LATENCY_METRIC_COUNT] = {
+    "Primi:     ", "Secondi:   ", "Caffè/D:   ", "Cassa:     ", "Ticket:    ", "Tavolo:    "
+};
+
+/** Etichette delle fasi del percorso nei report (JourneyMetric) */
+static const char *const journey_metric_labels[JOURNEY_METRIC_COUNT] = {
+    "Ticket:    ", "Primi:     ", "Secondi:   ", "Riunione:  ", "Cassa:     ",
+    "Tavolo:    ", "Pasto:     ", "Caffè/D:   ", "Uscita:    ", "TOTALE:    "
+};
+
+/* ==========================================================================
+ *                          SEZIONE: FUNZIONI PRIVATE
+ * ========================================================================== */
+
+static void accumulate_plate_counts(StatisticsPlateCounts *dst, const StatisticsPlateCounts *src) {
+    dst->first_course_count += src->first_course_count;
+    dst->second_course_count += src->second_course_count;
+    dst->coffee_dessert_count += src->coffee_dessert_count;
+    dst->total_plates_count += src->total_plates_count;
+}
+
+static void accumulate_wait_times(WaitTimeAccumulator *dst, const WaitTimeAccumulator *src) {
+    dst->sum_wait_first += src->sum_wait_first;
+    dst->count_first += src->count_first;
+    dst->sum_wait_second += src->sum_wait_second;
+    dst->count_second += src->count_second;
+    dst->sum_wait_coffee += src->sum_wait_coffee;
+    dst->count_coffee += src->count_coffee;
+    dst->sum_wait_cashier += src->sum_wait_cashier;
+    dst->count_cashier += src->count_cashier;
+}
+
+/** Somma i contatori di uno shard nei campi giornalieri e totali della struttura aggregata. */
+static void merge_shard_counters(SimulationStatistics *stats, const StatisticsShard *shard) {
+    const StatisticsCounters *d = &shard->daily;
+    const StatisticsCounters *t = &shard->total;
+
+    accumulate_plate_counts(&stats->daily_served_plates, &d->served_plates);
+    accumulate_wait_times(&stats->daily_wait_accumulators, &d->wait_accumulators);
+    stats->clients_statistics.daily_clients_served += d->clients_served;
+    stats->clients_statistics.daily_clients_not_served += d->clients_not_served;
+    stats->clients_statistics.daily_clients_with_ticket += d->clients_with_ticket;
+    stats->clients_statistics.daily_clients_without_ticket += d->clients_without_ticket;
+    stats->operators_statistics.daily_active_operators += d->active_operators;
+    stats->operators_statistics.daily_breaks_taken += d->breaks_taken;
+    stats->income_statistics.current_daily_income += d->income;
+
+    accumulate_plate_counts(&stats->total_served_plates, &t->served_plates);
+    accumulate_wait_times(&stats->total_wait_accumulators, &t->wait_accumulators);
+    stats->clients_statistics.total_clients_served += t->clients_served;
+    stats->clients_statistics.total_clients_not_served += t->clients_not_served;
+    stats->clients_statistics.total_clients_with_ticket += t->clients_with_ticket;
+    stats->clients_statistics.total_clients_without_ticket += t->clients_without_ticket;
+    stats->operators_statistics.total_active_operators_all_time += t->active_operators;
+    stats->operators_statistics.total_breaks_taken += t->breaks_taken;
+    stats->income_statistics.accumulated_total_income += t->income;
+}
+
+/**
+ * Shard su cui registrare un aggiornamento. Se il processo non ha uno shard
+ * proprio si usa quello di ripiego, e *locked segnala il mutex acquisito.
+ */
+static StatisticsShard *begin_shard_update(struct MainSharedMemory *shm_ptr, int *locked) {
+    StatisticsShard *shard = get_local_statistics_shard(shm_ptr);
+    if (shard != NULL) {
+        *locked = 0;
+        return shard;
+    }
+    lock_simulation_mutex(shm_ptr, MUTEX_SIMULATION_STATS);
+    *locked = 1;
+    return &shm_statistics_shards(shm_ptr)[STATISTICS_OVERFLOW_SHARD];
+}
+
+static void end_shard_update(struct MainSharedMemory *shm_ptr, int locked) {
+    if (locked) unlock_simulation_mutex(shm_ptr, MUTEX_SIMULATION_STATS);
+}
+
+/** Fonde gli istogrammi di tutte le stripe e ne calcola i percentili. */
+static void collect_latency_histograms(SimulationStatistics *stats, struct MainSharedMemory *shm_ptr) {
+    for (int i = 0; i < MAX_LATENCY_STRIPES; i++) {
+        const LatencyStripe *stripe = &shm_ptr->latency_stripes[i];
+        for (int m = 0; m < LATENCY_METRIC_COUNT; m++) {
+            latency_histogram_merge(&stats->daily_latency_histograms[m], &stripe->daily[m]);
+            latency_histogram_merge(&stats->total_latency_histograms[m], &stripe->total[m]);
+        }
+        for (int m = 0; m < JOURNEY_METRIC_COUNT; m++) {
+            latency_histogram_merge(&stats->daily_journey_histograms[m], &stripe->daily_journey[m]);
+            latency_histogram_merge(&stats->total_journey_histograms[m], &stripe->total_journey[m]);
+        }
+    }
+    for (int m = 0; m < LATENCY_METRIC_COUNT; m++) {
+        stats->daily_latency_percentiles[m] = latency_histogram_summary(&stats->daily_latency_histograms[m]);
+        stats->total_latency_percentiles[m] = latency_histogram_summary(&stats->total_latency_histograms[m]);
+    }
+    for (int m = 0; m < JOURNEY_METRIC_COUNT; m++) {
+        stats->daily_journey_percentiles[m] = latency_histogram_summary(&stats->daily_journey_histograms[m]);
+        stats->total_journey_percentiles[m] = latency_histogram_summary(&stats->total_journey_histograms[m]);
+    }
+}
+
+static void accumulate_service_timing(ServiceTimingCounters *dst, const ServiceTimingCounters *src) {
+    dst->orders += src->orders;
+    dst->queue_minutes += src->queue_minutes;
+    dst->service_minutes += src->service_minutes;
+    dst->idle_minutes += src->idle_minutes;
+}
+
+static ServiceTimingSummary summarize_service_timing(const ServiceTimingCounters *counters) {
+    ServiceTimingSummary summary = {0};
+    double on_post = counters->service_minutes + counters->idle_minutes;
+
+    summary.orders = counters->orders;
+    summary.busy_minutes = counters->service_minutes;
+    summary.idle_minutes = counters->idle_minutes;
+    if (counters->orders > 0) {
+        summary.average_queue_delay = counters->queue_minutes / counters->orders;
+        summary.average_service_time = counters->service_minutes / counters->orders;
+    }
+    if (on_post > 0.0) summary.utilisation = counters->service_minutes / on_post;
+    return summary;
+}
+
+/** Somma gli slot degli operatori per stazione e ne copia il riepilogo per operatore. */
+static void collect_service_timings(SimulationStatistics *stats, struct MainSharedMemory *shm_ptr) {
+    ServiceTimingCounters daily[SERVICE_POINT_COUNT];
+    ServiceTimingCounters total[SERVICE_POINT_COUNT];
+
+    /* Base: tempi degli slot già riassegnati ad altri operatori */
+    memcpy(daily, stats->daily_retired_service, sizeof(daily));
+    memcpy(total, stats->total_retired_service, sizeof(total));
+
+    stats->operator_timings_count = 0;
+    for (int i = 0; i < MAX_OPERATOR_ACTIVITY; i++) {
+        const OperatorActivity *activity = &shm_ptr->operator_activity[i];
+        pid_t owner = activity->operator_pid;
+        if (owner == 0 || activity->service_point < 0 || activity->service_point >= SERVICE_POINT_COUNT) continue;
+
+        accumulate_service_timing(&daily[activity->service_point], &activity->daily);
+        accumulate_service_timing(&total[activity->service_point], &activity->total);
+
+        OperatorTimingSummary *entry = &stats->operator_timings[stats->operator_timings_count++];
+        entry->operator_pid = owner;
+        entry->service_point = activity->service_point;
+        entry->timing = summarize_service_timing(&activity->total);
+    }
+    for (int p = 0; p < SERVICE_POINT_COUNT; p++) {
+        stats->daily_service_points[p] = summarize_service_timing(&daily[p]);
+        stats->total_service_points[p] = summarize_service_timing(&total[p]);
+    }
+    stats->daily_open_minutes = shm_ptr->simulation_minutes_passed;
+}
+
+/** Stripe di istogrammi del thread chiamante, scelta per TID al primo utilizzo. */
+static LatencyStripe *get_local_latency_stripe(struct MainSharedMemory *shm_ptr) {
+    if (local_latency_stripe == NULL) {
+        local_latency_stripe = &shm_ptr->latency_stripes[gettid() % MAX_LATENCY_STRIPES];
+    }
+    return local_latency_stripe;
+}
+
+/** Tabella media/percentili delle fasi, con la quota della media sul percorso completo. */
+static void print_journey_breakdown(const LatencyPercentiles *phases) {
+    double journey_mean = phases[JOURNEY_END_TO_END].mean;
+
+    printf("  Fase:      | Campioni |   Media     p50     p95     p99 | %% Percorso\n");
+    printf("  -----------|----------|---------------------------------|-----------\n");
+    for (int m = 0; m < JOURNEY_METRIC_COUNT; m++) {
+        const LatencyPercentiles *p = &phases[m];
+        if (m == JOURNEY_END_TO_END) {
+            printf("  -----------|----------|---------------------------------|-----------\n");
+        }
+        printf("  %s| %8d | %7.2f %7.2f %7.2f %7.2f | %9.1f%%\n",
+               journey_metric_labels[m], p->samples, p->mean, p->p50, p->p95, p->p99,
+               (journey_mean > 0.0) ? 100.0 * p->mean / journey_mean : 0.0);
+    }
+}
 
 /* ==========================================================================
  *                         SEZIONE: RACCOLTA DATI
@@ -25,16 +219,24 @@
 
 /**
  * Raccoglie le statistiche dalla SHM con accesso protetto da mutex.
- * Calcola le medie dai dati accumulatori prima di restituire.
+ * Somma la base condivisa e gli shard per processo, poi calcola le medie.
  */
 SimulationStatistics collect_simulation_statistics(struct MainSharedMemory *shared_memory_ptr) {
     SimulationStatistics stats;
     int num_days = shared_memory_ptr->current_simulation_day + 1;
 
     /* 1. Protocollo di Accesso Sicuro (Sez 5.1 Consegna) */
-    reserve_sem(shared_memory_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+    lock_simulation_mutex(shared_memory_ptr, MUTEX_SIMULATION_STATS);
     memcpy(&stats, &shared_memory_ptr->statistics, sizeof(SimulationStatistics));
-    release_sem(shared_memory_ptr->semaphore_mutex_id, MUTEX_SIMULATION_STATS);
+    StatisticsShard *shards = shm_statistics_shards(shared_memory_ptr);
+    for (int i = 0; i < shared_memory_ptr->statistics_shards_count; i++) {
+        merge_shard_counters(&stats, &shards[i]);
+    }
+    unlock_simulation_mutex(shared_memory_ptr, MUTEX_SIMULATION_STATS);
+
+    /* Istogrammi e slot operatori: scrittori senza lock, letti senza lock */
+    collect_latency_histograms(&stats, shared_memory_ptr);
+    collect_service_timings(&stats, shared_memory_ptr);
 
     /* 2. Calcolo Medie Giornaliere (Utenti) */
     stats.clients_statistics.average_daily_clients_served = (double)stats.clients_statistics.total_clients_served / num_days;
@@ -78,6 +280,222 @@ SimulationStatistics collect_simulation_statistics(struct MainSharedMemory *shar
     return stats;
 }
 
+/* ==========================================================================
+ *                      SEZIONE: SHARD PER PROCESSO
+ * ========================================================================== */
+
+void reset_daily_statistics_counters(struct MainSharedMemory *shared_memory_ptr) {
+    StatisticsShard *shards = shm_statistics_shards(shared_memory_ptr);
+    for (int i = 0; i < shared_memory_ptr->statistics_shards_count; i++) {
+        memset(&shards[i].daily, 0, sizeof(StatisticsCounters));
+    }
+    for (int i = 0; i < MAX_LATENCY_STRIPES; i++) {
+        LatencyStripe *stripe = &shared_memory_ptr->latency_stripes[i];
+        memset(stripe->daily, 0, sizeof(stripe->daily));
+        memset(stripe->daily_journey, 0, sizeof(stripe->daily_journey));
+    }
+    for (int i = 0; i < MAX_OPERATOR_ACTIVITY; i++) {
+        memset(&shared_memory_ptr->operator_activity[i].daily, 0, sizeof(ServiceTimingCounters));
+    }
+}
+
+StatisticsShard *get_local_statistics_shard(struct MainSharedMemory *shared_memory_ptr) {
+    if (local_statistics_shard != NULL) return local_statistics_shard;
+
+    pid_t self = gettid(); /* TID: shard distinto per ogni thread di un host utenti */
+    StatisticsShard *shards = shm_statistics_shards(shared_memory_ptr);
+    int usable = shared_memory_ptr->statistics_shards_count - 1;
+    int start = (int)(self % usable);
+
+    for (int i = 0; i < usable; i++) {
+        StatisticsShard *shard = &shards[1 + (start + i) % usable];
+        pid_t current = atomic_load(&shard->owner_pid);
+
+        if (current == 0) {
+            if (atomic_compare_exchange_strong(&shard->owner_pid, &current, self)) {
+                local_statistics_shard = shard;
+                return shard;
+            }
+        } else if (kill(current, 0) == -1 && errno == ESRCH) {
+            /* Proprietario terminato: i suoi contatori confluiscono nella base */
+            int claimed = 0;
+            lock_simulation_mutex(shared_memory_ptr, MUTEX_SIMULATION_STATS);
+            if (atomic_compare_exchange_strong(&shard->owner_pid, &current, self)) {
+                merge_shard_counters(&shared_memory_ptr->statistics, shard);
+                memset(&shard->daily, 0, sizeof(StatisticsCounters));
+                memset(&shard->total, 0, sizeof(StatisticsCounters));
+                claimed = 1;
+            }
+            unlock_simulation_mutex(shared_memory_ptr, MUTEX_SIMULATION_STATS);
+
+            if (claimed) {
+                local_statistics_shard = shard;
+                return shard;
+            }
+        }
+    }
+    return NULL;
+}
+
+void record_served_plate(struct MainSharedMemory *shared_memory_ptr, int station_type) {
+    int locked;
+    StatisticsShard *shard = begin_shard_update(shared_memory_ptr, &locked);
+
+    if (station_type == 0) {
+        shard->daily.served_plates.first_course_count++;
+        shard->total.served_plates.first_course_count++;
+    } else if (station_type == 1) {
+        shard->daily.served_plates.second_course_count++;
+        shard->total.served_plates.second_course_count++;
+    } else {
+        shard->daily.served_plates.coffee_dessert_count++;
+        shard->total.served_plates.coffee_dessert_count++;
+    }
+    shard->daily.served_plates.total_plates_count++;
+    shard->total.served_plates.total_plates_count++;
+
+    end_shard_update(shared_memory_ptr, locked);
+}
+
+void record_wait_time(struct MainSharedMemory *shared_memory_ptr, double wait_minutes, int type) {
+    int locked;
+    StatisticsShard *shard = begin_shard_update(shared_memory_ptr, &locked);
+    WaitTimeAccumulator *daily = &shard->daily.wait_accumulators;
+    WaitTimeAccumulator *total = &shard->total.wait_accumulators;
+
+    if (type == 0)      { daily->sum_wait_first += wait_minutes; daily->count_first++; total->sum_wait_first += wait_minutes; total->count_first++; }
+    else if (type == 1) { daily->sum_wait_second += wait_minutes; daily->count_second++; total->sum_wait_second += wait_minutes; total->count_second++; }
+    else if (type == 2) { daily->sum_wait_coffee += wait_minutes; daily->count_coffee++; total->sum_wait_coffee += wait_minutes; total->count_coffee++; }
+    else if (type == 3) { daily->sum_wait_cashier += wait_minutes; daily->count_cashier++; total->sum_wait_cashier += wait_minutes; total->count_cashier++; }
+
+    end_shard_update(shared_memory_ptr, locked);
+
+    if (type >= LATENCY_METRIC_FIRST_COURSE && type <= LATENCY_METRIC_CASHIER) {
+        record_latency(shared_memory_ptr, (LatencyMetric)type, wait_minutes);
+    }
+}
+
+void record_latency(struct MainSharedMemory *shared_memory_ptr, LatencyMetric metric, double wait_minutes) {
+    LatencyStripe *stripe = get_local_latency_stripe(shared_memory_ptr);
+    latency_histogram_record(&stripe->daily[metric], wait_minutes);
+    latency_histogram_record(&stripe->total[metric], wait_minutes);
+}
+
+void record_journey_time(struct MainSharedMemory *shared_memory_ptr, JourneyMetric metric, double minutes) {
+    LatencyStripe *stripe = get_local_latency_stripe(shared_memory_ptr);
+    latency_histogram_record(&stripe->daily_journey[metric], minutes);
+    latency_histogram_record(&stripe->total_journey[metric], minutes);
+}
+
+/** Riporta i tempi di uno slot riassegnato nella base della sua stazione (con MUTEX_SIMULATION_STATS). */
+static void retire_operator_activity(struct MainSharedMemory *shm_ptr, OperatorActivity *activity) {
+    int point = activity->service_point;
+    if (activity->operator_pid != 0 && point >= 0 && point < SERVICE_POINT_COUNT) {
+        accumulate_service_timing(&shm_ptr->statistics.daily_retired_service[point], &activity->daily);
+        accumulate_service_timing(&shm_ptr->statistics.total_retired_service[point], &activity->total);
+    }
+    memset(&activity->daily, 0, sizeof(ServiceTimingCounters));
+    memset(&activity->total, 0, sizeof(ServiceTimingCounters));
+}
+
+OperatorActivity *claim_operator_activity(struct MainSharedMemory *shared_memory_ptr, int service_point) {
+    pid_t self = getpid();
+
+    /* Primo passaggio: slot mai usati; secondo: rilasciati o con proprietario terminato */
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < MAX_OPERATOR_ACTIVITY; i++) {
+            OperatorActivity *activity = &shared_memory_ptr->operator_activity[i];
+            pid_t current = atomic_load(&activity->owner_pid);
+
+            if (pass == 0 && (current != 0 || activity->operator_pid != 0)) continue;
+            if (pass == 1 && current != 0 && !(kill(current, 0) == -1 && errno == ESRCH)) continue;
+
+            int claimed = 0;
+            lock_simulation_mutex(shared_memory_ptr, MUTEX_SIMULATION_STATS);
+            if (atomic_compare_exchange_strong(&activity->owner_pid, &current, self)) {
+                retire_operator_activity(shared_memory_ptr, activity);
+                activity->operator_pid = self;
+                activity->service_point = service_point;
+                claimed = 1;
+            }
+            unlock_simulation_mutex(shared_memory_ptr, MUTEX_SIMULATION_STATS);
+
+            if (claimed) return activity;
+        }
+    }
+    return NULL;
+}
+
+void release_operator_activity(OperatorActivity *activity) {
+    if (activity == NULL) return;
+    atomic_store(&activity->owner_pid, 0);
+}
+
+void record_operator_service(OperatorActivity *activity, double queue_minutes, double service_minutes) {
+    if (activity == NULL) return;
+    activity->daily.orders++;
+    activity->daily.queue_minutes += queue_minutes;
+    activity->daily.service_minutes += service_minutes;
+    activity->total.orders++;
+    activity->total.queue_minutes += queue_minutes;
+    activity->total.service_minutes += service_minutes;
+}
+
+void record_operator_idle(OperatorActivity *activity, double idle_minutes) {
+    if (activity == NULL) return;
+    activity->daily.idle_minutes += idle_minutes;
+    activity->total.idle_minutes += idle_minutes;
+}
+
+void record_client_served(struct MainSharedMemory *shared_memory_ptr, int has_ticket) {
+    int locked;
+    StatisticsShard *shard = begin_shard_update(shared_memory_ptr, &locked);
+
+    shard->daily.clients_served++;
+    shard->total.clients_served++;
+    if (has_ticket) {
+        shard->daily.clients_with_ticket++;
+        shard->total.clients_with_ticket++;
+    } else {
+        shard->daily.clients_without_ticket++;
+        shard->total.clients_without_ticket++;
+    }
+
+    end_shard_update(shared_memory_ptr, locked);
+}
+
+void record_client_not_served(struct MainSharedMemory *shared_memory_ptr) {
+    int locked;
+    StatisticsShard *shard = begin_shard_update(shared_memory_ptr, &locked);
+    shard->daily.clients_not_served++;
+    shard->total.clients_not_served++;
+    end_shard_update(shared_memory_ptr, locked);
+}
+
+void record_operator_active(struct MainSharedMemory *shared_memory_ptr) {
+    int locked;
+    StatisticsShard *shard = begin_shard_update(shared_memory_ptr, &locked);
+    shard->daily.active_operators++;
+    shard->total.active_operators++;
+    end_shard_update(shared_memory_ptr, locked);
+}
+
+void record_operator_break(struct MainSharedMemory *shared_memory_ptr) {
+    int locked;
+    StatisticsShard *shard = begin_shard_update(shared_memory_ptr, &locked);
+    shard->daily.breaks_taken++;
+    shard->total.breaks_taken++;
+    end_shard_update(shared_memory_ptr, locked);
+}
+
+void record_income(struct MainSharedMemory *shared_memory_ptr, double amount) {
+    int locked;
+    StatisticsShard *shard = begin_shard_update(shared_memory_ptr, &locked);
+    shard->daily.income += amount;
+    shard->total.income += amount;
+    end_shard_update(shared_memory_ptr, locked);
+}
+
 /* ==========================================================================
  *                       SEZIONE: OUTPUT E REPORT
  * ========================================================================== */
@@ -121,6 +539,31 @@ void display_daily_statistics_report(SimulationStatistics s, int simulation_day)
     printf("  Cassa:     | %7.2f | %7.2f\n", s.daily_average_wait_times.average_wait_cash_desk, s.total_average_wait_times.average_wait_cash_desk);
     printf("  Caffè/D:   | %7.2f | %7.2f\n", s.daily_average_wait_times.average_wait_coffee_dessert, s.total_average_wait_times.average_wait_coffee_dessert);
 
+    printf("\n[DISTRIBUZIONE ATTESE (Minuti)]\n");
+    printf("  Attesa:    |   Oggi p50     p95     p99 |  Totale p50     p95     p99\n");
+    printf("  -----------|----------------------------|----------------------------\n");
+    for (int m = 0; m < LATENCY_METRIC_COUNT; m++) {
+        const LatencyPercentiles *d = &s.daily_latency_percentiles[m];
+        const LatencyPercentiles *t = &s.total_latency_percentiles[m];
+        printf("  %s| %10.2f %7.2f %7.2f | %10.2f %7.2f %7.2f\n",
+               latency_metric_labels[m], d->p50, d->p95, d->p99, t->p50, t->p95, t->p99);
+    }
+
+    printf("\n[PERCORSO UTENTE - OGGI (Minuti)]\n");
+    print_journey_breakdown(s.daily_journey_percentiles);
+
+    printf("\n[CODA E SERVIZIO - OGGI (Minuti, Little: L = lambda * W)]\n");
+    printf("  Stazione:  | Ordini |  Coda Wq  Serv. S | Utilizzo | lambda/min      Lq       L\n");
+    printf("  -----------|--------|------------------|----------|---------------------------\n");
+    for (int p = 0; p < SERVICE_POINT_COUNT; p++) {
+        const ServiceTimingSummary *t = &s.daily_service_points[p];
+        double arrival_rate = (s.daily_open_minutes > 0.0) ? t->orders / s.daily_open_minutes : 0.0;
+        printf("  %s| %6d | %8.2f %8.2f | %7.1f%% | %10.3f %7.2f %7.2f\n",
+               latency_metric_labels[p], t->orders, t->average_queue_delay, t->average_service_time,
+               100.0 * t->utilisation, arrival_rate, arrival_rate * t->average_queue_delay,
+               arrival_rate * (t->average_queue_delay + t->average_service_time));
+    }
+
     printf("\n[OPERATORI E INCASSI]\n");
     printf("  Operatori: Attivi oggi: %d | Attivi Tot: %d | Pause: %d (Media/gg: %.2f)\n", 
            s.operators_statistics.daily_active_operators, s.operators_statistics.total_active_operators_all_time, 
@@ -176,6 +619,40 @@ void display_final_simulation_report(SimulationStatistics s, int total_days) {
     printf("  Attesa Cassa:    %.2f min\n", s.total_average_wait_times.average_wait_cash_desk);
     printf("  Attesa Caffè:    %.2f min\n", s.total_average_wait_times.average_wait_coffee_dessert);
 
+    printf("\n[DISTRIBUZIONE ATTESE GLOBALI (Minuti)]\n");
+    printf("  Attesa:    | Campioni |     p50     p95     p99     max\n");
+    printf("  -----------|----------|--------------------------------\n");
+    for (int m = 0; m < LATENCY_METRIC_COUNT; m++) {
+        const LatencyPercentiles *t = &s.total_latency_percentiles[m];
+        printf("  %s| %8d | %7.2f %7.2f %7.2f %7.2f\n",
+               latency_metric_labels[m], t->samples, t->p50, t->p95, t->p99, t->max);
+    }
+
+    printf("\n[PERCORSO UTENTE - COMPLESSIVO (Minuti)]\n");
+    print_journey_breakdown(s.total_journey_percentiles);
+
+    printf("\n[CODA E SERVIZIO PER STAZIONE (Minuti)]\n");
+    printf("  Stazione:  | Ordini |  Coda Wq  Serv. S | Occupato  Inattivo | Utilizzo\n");
+    printf("  -----------|--------|------------------|--------------------|---------\n");
+    for (int p = 0; p < SERVICE_POINT_COUNT; p++) {
+        const ServiceTimingSummary *t = &s.total_service_points[p];
+        printf("  %s| %6d | %8.2f %8.2f | %8.1f %9.1f | %7.1f%%\n",
+               latency_metric_labels[p], t->orders, t->average_queue_delay, t->average_service_time,
+               t->busy_minutes, t->idle_minutes, 100.0 * t->utilisation);
+    }
+
+    printf("\n[CODA E SERVIZIO PER OPERATORE (Minuti)]\n");
+    printf("  Stazione:  |     PID | Ordini |  Coda Wq  Serv. S | Occupato  Inattivo | Utilizzo\n");
+    printf("  -----------|---------|--------|------------------|--------------------|---------\n");
+    for (int i = 0; i < s.operator_timings_count; i++) {
+        const OperatorTimingSummary *op = &s.operator_timings[i];
+        const ServiceTimingSummary *t = &op->timing;
+        printf("  %s| %7d | %6d | %8.2f %8.2f | %8.1f %9.1f | %7.1f%%\n",
+               latency_metric_labels[op->service_point], (int)op->operator_pid, t->orders,
+               t->average_queue_delay, t->average_service_time, t->busy_minutes, t->idle_minutes,
+               100.0 * t->utilisation);
+    }
+
     printf("\n[ECONOMIA E PERSONALE]\n");
     printf("  Incasso Totale:  %.2f EUR (Media: %.2f EUR/gg)\n", 
            s.income_statistics.accumulated_total_income, s.income_statistics.average_daily_income);
@@ -187,57 +664,3 @@ void display_final_simulation_report(SimulationStatistics s, int total_days) {
     printf("                  FINE REPORT - PROGETTO SO 2026\n");
     printf("######################################################################\n\n");
 }
-
-/**
- * Salva le statistiche giornaliere su file.
- */
-int save_statistics_to_csv(SimulationStatistics s, int simulation_day, const char *filepath) {
-    FILE *check_file = fopen(filepath, "r");
-    int file_exists = (check_file != NULL);
-    if (check_file) fclose(check_file);
-
-    FILE *file = fopen(filepath, "a");
-    if (file == NULL) {
-        perror("[STATISTICS] Errore apertura file statistiche");
-        return -1;
-    }
-
-    if (!file_exists) {
-        fprintf(file, "day,daily_srv,daily_not_srv,daily_tk,daily_notk,total_srv,total_not_srv,"
-                      "daily_plate_1,daily_plate_2,daily_plate_c,total_plate_1,total_plate_2,total_plate_c,"
-                      "waste_1,waste_2,avg_wait_1_day,avg_wait_1_tot,avg_wait_c_day,avg_wait_c_tot,"
-                      "ops_active,ops_breaks_tot,income_day,income_tot\n");
-    }
-
-    fprintf(file, "%d,%d,%d,%d,%d,%d,%d,"
-                  "%d,%d,%d,%d,%d,%d,"
-                  "%d,%d,%.2f,%.2f,%.2f,%.2f,"
-                  "%d,%d,%.2f,%.2f\n",
-            simulation_day + 1,
-            s.clients_statistics.daily_clients_served,
-            s.clients_statistics.daily_clients_not_served,
-            s.clients_statistics.daily_clients_with_ticket,
-            s.clients_statistics.daily_clients_without_ticket,
-            s.clients_statistics.total_clients_served,
-            s.clients_statistics.total_clients_not_served,
-            s.daily_served_plates.first_course_count,
-            s.daily_served_plates.second_course_count,
-            s.daily_served_plates.coffee_dessert_count,
-            s.total_served_plates.first_course_count,
-            s.total_served_plates.second_course_count,
-            s.total_served_plates.coffee_dessert_count,
-            s.daily_leftover_plates.first_course_count,
-            s.daily_leftover_plates.second_course_count,
-            s.daily_average_wait_times.average_wait_first_course,
-            s.total_average_wait_times.average_wait_first_course,
-            s.daily_average_wait_times.average_wait_cash_desk,
-            s.total_average_wait_times.average_wait_cash_desk,
-            s.operators_statistics.daily_active_operators,
-            s.operators_statistics.total_breaks_taken,
-            s.income_statistics.current_daily_income,
-            s.income_statistics.accumulated_total_income);
-
-    fclose(file);
-    printf("[STATISTICS] Log CSV aggiornato per giorno %d.\n", simulation_day + 1);
-    return 0;
-}
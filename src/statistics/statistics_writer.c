@@ -0,0 +1,521 @@
+/**
+ * @file statistics_writer.c
+ * @brief Esportazione delle statistiche con scrittura asincrona (lato Master).
+ *
+ * La tabella dei campi è costruita una volta all'apertura a partire dalle
+ * strutture di statistics.h (nome, tipo, offset): intestazione CSV, righe
+ * CSV e oggetti JSON ne seguono lo stesso ordine. Il thread principale
+ * formatta ogni record in un buffer e lo accoda; il thread di scrittura
+ * svuota la coda con write() e fdatasync().
+ *
+ * @see statistics_writer.h per lo schema.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <ctype.h>
+#include <unistd.h>
+
+/* Includes del progetto */
+#include "statistics_writer.h"
+#include "utils.h"
+#include "log.h"
+
+_Static_assert(sizeof(TerminationReason) == sizeof(int), "La causa di terminazione è esportata come intero");
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Campi esportati al massimo (la tabella attuale ne usa circa 310) */
+#define STATISTICS_MAX_FIELDS 512
+
+/** Lunghezza massima del nome di un campo (terminatore incluso) */
+#define STATISTICS_FIELD_KEY_LENGTH 64
+
+/** Capacità iniziale del buffer di un record */
+#define STATISTICS_RECORD_INITIAL_CAPACITY 8192
+
+typedef enum {
+    FIELD_INT = 0,
+    FIELD_DOUBLE
+} FieldType;
+
+/** Membro di una sottostruttura: suffisso del nome, tipo e offset nella sottostruttura. */
+typedef struct {
+    const char *name;
+    FieldType type;
+    size_t offset;
+} MemberField;
+
+/** Campo esportato: nome completo e offset in SimulationStatistics. */
+typedef struct {
+    char key[STATISTICS_FIELD_KEY_LENGTH];
+    FieldType type;
+    size_t offset;
+} ExportedField;
+
+/** Record formattato in attesa del thread di scrittura. */
+typedef struct StatisticsChunk {
+    struct StatisticsChunk *next;
+    char *data;
+    size_t length;
+} StatisticsChunk;
+
+/** Buffer di testo a crescita geometrica. */
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+    bool failed;                        /**< Allocazione fallita: record scartato */
+} TextBuffer;
+
+#define INT_MEMBER(name, type, member) { name, FIELD_INT, offsetof(type, member) }
+#define DOUBLE_MEMBER(name, type, member) { name, FIELD_DOUBLE, offsetof(type, member) }
+#define MEMBER_COUNT(members) ((int)(sizeof(members) / sizeof((members)[0])))
+
+static const MemberField plate_count_members[] = {
+    INT_MEMBER("first_course", StatisticsPlateCounts, first_course_count),
+    INT_MEMBER("second_course", StatisticsPlateCounts, second_course_count),
+    INT_MEMBER("coffee_dessert", StatisticsPlateCounts, coffee_dessert_count),
+    INT_MEMBER("total", StatisticsPlateCounts, total_plates_count),
+};
+
+static const MemberField plate_average_members[] = {
+    DOUBLE_MEMBER("first_course", StatisticsPlateAverages, average_daily_first_courses),
+    DOUBLE_MEMBER("second_course", StatisticsPlateAverages, average_daily_second_courses),
+    DOUBLE_MEMBER("coffee_dessert", StatisticsPlateAverages, average_daily_coffee_dessert),
+    DOUBLE_MEMBER("total", StatisticsPlateAverages, average_daily_total),
+};
+
+static const MemberField wait_time_members[] = {
+    DOUBLE_MEMBER("first_course", StatisticsWaitTimes, average_wait_first_course),
+    DOUBLE_MEMBER("second_course", StatisticsWaitTimes, average_wait_second_course),
+    DOUBLE_MEMBER("coffee_dessert", StatisticsWaitTimes, average_wait_coffee_dessert),
+    DOUBLE_MEMBER("cash_desk", StatisticsWaitTimes, average_wait_cash_desk),
+    DOUBLE_MEMBER("global", StatisticsWaitTimes, average_wait_global),
+};
+
+static const MemberField wait_accumulator_members[] = {
+    DOUBLE_MEMBER("sum_first_course", WaitTimeAccumulator, sum_wait_first),
+    INT_MEMBER("count_first_course", WaitTimeAccumulator, count_first),
+    DOUBLE_MEMBER("sum_second_course", WaitTimeAccumulator, sum_wait_second),
+    INT_MEMBER("count_second_course", WaitTimeAccumulator, count_second),
+    DOUBLE_MEMBER("sum_coffee_dessert", WaitTimeAccumulator, sum_wait_coffee),
+    INT_MEMBER("count_coffee_dessert", WaitTimeAccumulator, count_coffee),
+    DOUBLE_MEMBER("sum_cash_desk", WaitTimeAccumulator, sum_wait_cashier),
+    INT_MEMBER("count_cash_desk", WaitTimeAccumulator, count_cashier),
+};
+
+static const MemberField percentile_members[] = {
+    INT_MEMBER("samples", LatencyPercentiles, samples),
+    DOUBLE_MEMBER("mean", LatencyPercentiles, mean),
+    DOUBLE_MEMBER("p50", LatencyPercentiles, p50),
+    DOUBLE_MEMBER("p95", LatencyPercentiles, p95),
+    DOUBLE_MEMBER("p99", LatencyPercentiles, p99),
+    DOUBLE_MEMBER("max", LatencyPercentiles, max),
+};
+
+static const MemberField service_members[] = {
+    INT_MEMBER("orders", ServiceTimingSummary, orders),
+    DOUBLE_MEMBER("avg_queue", ServiceTimingSummary, average_queue_delay),
+    DOUBLE_MEMBER("avg_service", ServiceTimingSummary, average_service_time),
+    DOUBLE_MEMBER("busy", ServiceTimingSummary, busy_minutes),
+    DOUBLE_MEMBER("idle", ServiceTimingSummary, idle_minutes),
+    DOUBLE_MEMBER("utilisation", ServiceTimingSummary, utilisation),
+};
+
+static const MemberField client_members[] = {
+    INT_MEMBER("daily_served", StatisticsClientData, daily_clients_served),
+    INT_MEMBER("daily_not_served", StatisticsClientData, daily_clients_not_served),
+    INT_MEMBER("daily_with_ticket", StatisticsClientData, daily_clients_with_ticket),
+    INT_MEMBER("daily_without_ticket", StatisticsClientData, daily_clients_without_ticket),
+    INT_MEMBER("total_served", StatisticsClientData, total_clients_served),
+    INT_MEMBER("total_not_served", StatisticsClientData, total_clients_not_served),
+    DOUBLE_MEMBER("avg_daily_served", StatisticsClientData, average_daily_clients_served),
+    DOUBLE_MEMBER("avg_daily_not_served", StatisticsClientData, average_daily_clients_not_served),
+    INT_MEMBER("total_with_ticket", StatisticsClientData, total_clients_with_ticket),
+    INT_MEMBER("total_without_ticket", StatisticsClientData, total_clients_without_ticket),
+};
+
+static const MemberField operator_members[] = {
+    INT_MEMBER("total_active", StatisticsOperatorData, total_active_operators_all_time),
+    INT_MEMBER("daily_active", StatisticsOperatorData, daily_active_operators),
+    INT_MEMBER("daily_breaks", StatisticsOperatorData, daily_breaks_taken),
+    INT_MEMBER("total_breaks", StatisticsOperatorData, total_breaks_taken),
+    DOUBLE_MEMBER("avg_daily_breaks", StatisticsOperatorData, average_daily_breaks),
+};
+
+static const MemberField income_members[] = {
+    DOUBLE_MEMBER("total", StatisticsIncomeData, accumulated_total_income),
+    DOUBLE_MEMBER("daily", StatisticsIncomeData, current_daily_income),
+    DOUBLE_MEMBER("avg_daily", StatisticsIncomeData, average_daily_income),
+};
+
+/** Nomi delle attese (LatencyMetric); i primi SERVICE_POINT_COUNT nominano anche i punti di servizio */
+static const char *const latency_metric_keys[LATENCY_METRIC_COUNT] = {
+    "first_course", "second_course", "coffee_dessert", "cashier", "ticket", "table"
+};
+
+/** Nomi delle fasi del percorso (JourneyMetric) */
+static const char *const journey_metric_keys[JOURNEY_METRIC_COUNT] = {
+    "ticket", "first_course", "second_course", "regroup", "cashier",
+    "table", "eat", "coffee_dessert", "exit", "end_to_end"
+};
+
+/** Nomi dei tipi di record (StatisticsRecordKind) */
+static const char *const record_kind_names[] = { "day", "final" };
+
+/** Tabella dei campi (costruita all'apertura). */
+static ExportedField exported_fields[STATISTICS_MAX_FIELDS];
+static int exported_field_count = 0;
+
+/** Stato del file e del thread di scrittura. */
+static int writer_fd = -1;
+static StatisticsFormat writer_format = STATISTICS_FORMAT_CSV;
+static pthread_t writer_thread;
+static pthread_mutex_t writer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writer_wakeup = PTHREAD_COND_INITIALIZER;
+static StatisticsChunk *pending_head = NULL;
+static StatisticsChunk *pending_tail = NULL;
+static bool writer_stopping = false;
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PRIVATA
+ * ========================================================================== */
+
+/** Aggiunge i membri di una sottostruttura che inizia a `base` con nomi `prefix_membro`. */
+static void add_member_fields(const char *prefix, size_t base, const MemberField *members, int count) {
+    for (int i = 0; i < count && exported_field_count < STATISTICS_MAX_FIELDS; i++) {
+        ExportedField *field = &exported_fields[exported_field_count++];
+        snprintf(field->key, sizeof(field->key), "%s_%s", prefix, members[i].name);
+        field->type = members[i].type;
+        field->offset = base + members[i].offset;
+    }
+}
+
+/** Come add_member_fields() per ogni elemento di un array di sottostrutture. */
+static void add_array_fields(const char *prefix, size_t base, size_t stride, const char *const *keys, int count,
+                             const MemberField *members, int member_count) {
+    char element_prefix[STATISTICS_FIELD_KEY_LENGTH];
+    for (int i = 0; i < count; i++) {
+        snprintf(element_prefix, sizeof(element_prefix), "%s_%s", prefix, keys[i]);
+        add_member_fields(element_prefix, base + (size_t)i * stride, members, member_count);
+    }
+}
+
+/** Costruisce la tabella dei campi nell'ordine dello schema. */
+static void build_field_table(void) {
+    static const MemberField open_minutes[] = { DOUBLE_MEMBER("open_minutes", SimulationStatistics, daily_open_minutes) };
+    static const MemberField termination[] = { INT_MEMBER("reason", SimulationStatistics, reason_for_termination) };
+
+    exported_field_count = 0;
+
+    add_member_fields("clients", offsetof(SimulationStatistics, clients_statistics),
+                      client_members, MEMBER_COUNT(client_members));
+    add_member_fields("daily_served", offsetof(SimulationStatistics, daily_served_plates),
+                      plate_count_members, MEMBER_COUNT(plate_count_members));
+    add_member_fields("total_served", offsetof(SimulationStatistics, total_served_plates),
+                      plate_count_members, MEMBER_COUNT(plate_count_members));
+    add_member_fields("daily_leftover", offsetof(SimulationStatistics, daily_leftover_plates),
+                      plate_count_members, MEMBER_COUNT(plate_count_members));
+    add_member_fields("total_leftover", offsetof(SimulationStatistics, total_leftover_plates),
+                      plate_count_members, MEMBER_COUNT(plate_count_members));
+    add_member_fields("avg_daily_served", offsetof(SimulationStatistics, average_daily_served_plates),
+                      plate_average_members, MEMBER_COUNT(plate_average_members));
+    add_member_fields("avg_daily_leftover", offsetof(SimulationStatistics, average_daily_leftover_plates),
+                      plate_average_members, MEMBER_COUNT(plate_average_members));
+
+    add_member_fields("daily_avg_wait", offsetof(SimulationStatistics, daily_average_wait_times),
+                      wait_time_members, MEMBER_COUNT(wait_time_members));
+    add_member_fields("total_avg_wait", offsetof(SimulationStatistics, total_average_wait_times),
+                      wait_time_members, MEMBER_COUNT(wait_time_members));
+    add_member_fields("daily_wait", offsetof(SimulationStatistics, daily_wait_accumulators),
+                      wait_accumulator_members, MEMBER_COUNT(wait_accumulator_members));
+    add_member_fields("total_wait", offsetof(SimulationStatistics, total_wait_accumulators),
+                      wait_accumulator_members, MEMBER_COUNT(wait_accumulator_members));
+
+    add_array_fields("daily_latency", offsetof(SimulationStatistics, daily_latency_percentiles), sizeof(LatencyPercentiles),
+                     latency_metric_keys, LATENCY_METRIC_COUNT, percentile_members, MEMBER_COUNT(percentile_members));
+    add_array_fields("total_latency", offsetof(SimulationStatistics, total_latency_percentiles), sizeof(LatencyPercentiles),
+                     latency_metric_keys, LATENCY_METRIC_COUNT, percentile_members, MEMBER_COUNT(percentile_members));
+    add_array_fields("daily_journey", offsetof(SimulationStatistics, daily_journey_percentiles), sizeof(LatencyPercentiles),
+                     journey_metric_keys, JOURNEY_METRIC_COUNT, percentile_members, MEMBER_COUNT(percentile_members));
+    add_array_fields("total_journey", offsetof(SimulationStatistics, total_journey_percentiles), sizeof(LatencyPercentiles),
+                     journey_metric_keys, JOURNEY_METRIC_COUNT, percentile_members, MEMBER_COUNT(percentile_members));
+
+    add_array_fields("daily_service", offsetof(SimulationStatistics, daily_service_points), sizeof(ServiceTimingSummary),
+                     latency_metric_keys, SERVICE_POINT_COUNT, service_members, MEMBER_COUNT(service_members));
+    add_array_fields("total_service", offsetof(SimulationStatistics, total_service_points), sizeof(ServiceTimingSummary),
+                     latency_metric_keys, SERVICE_POINT_COUNT, service_members, MEMBER_COUNT(service_members));
+    add_member_fields("daily", 0, open_minutes, MEMBER_COUNT(open_minutes));
+
+    add_member_fields("operators", offsetof(SimulationStatistics, operators_statistics),
+                      operator_members, MEMBER_COUNT(operator_members));
+    add_member_fields("income", offsetof(SimulationStatistics, income_statistics),
+                      income_members, MEMBER_COUNT(income_members));
+    add_member_fields("termination", 0, termination, MEMBER_COUNT(termination));
+}
+
+static void text_buffer_appendf(TextBuffer *buffer, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/** Accoda testo formattato, raddoppiando la capacità quando serve. */
+static void text_buffer_appendf(TextBuffer *buffer, const char *format, ...) {
+    if (buffer->failed) return;
+
+    for (;;) {
+        size_t available = buffer->capacity - buffer->length;
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(buffer->data + buffer->length, available, format, args);
+        va_end(args);
+
+        if (written < 0) {
+            buffer->failed = true;
+            return;
+        }
+        if ((size_t)written < available) {
+            buffer->length += (size_t)written;
+            return;
+        }
+
+        size_t capacity = buffer->capacity * 2;
+        while (capacity - buffer->length <= (size_t)written) capacity *= 2;
+        char *data = realloc(buffer->data, capacity);
+        if (data == NULL) {
+            buffer->failed = true;
+            return;
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+}
+
+/** Valore a `offset` da `base`: intero, decimale o vuoto/null se non finito. */
+static void append_value(TextBuffer *buffer, const void *base, FieldType type, size_t offset) {
+    const char *address = (const char *)base + offset;
+
+    if (type == FIELD_INT) {
+        text_buffer_appendf(buffer, "%d", *(const int *)address);
+        return;
+    }
+
+    double value = *(const double *)address;
+    if (isfinite(value)) {
+        text_buffer_appendf(buffer, "%.4f", value);
+    } else if (writer_format == STATISTICS_FORMAT_JSONL) {
+        text_buffer_appendf(buffer, "null");
+    }
+}
+
+/** Intestazione CSV: colonne fisse seguite dai nomi della tabella. */
+static void format_csv_header(TextBuffer *buffer) {
+    text_buffer_appendf(buffer, "schema_version,record,day");
+    for (int i = 0; i < exported_field_count; i++) {
+        text_buffer_appendf(buffer, ",%s", exported_fields[i].key);
+    }
+    text_buffer_appendf(buffer, "\n");
+}
+
+static void format_csv_record(TextBuffer *buffer, const SimulationStatistics *statistics, int day, StatisticsRecordKind kind) {
+    text_buffer_appendf(buffer, "%d,%s,%d", STATISTICS_SCHEMA_VERSION, record_kind_names[kind], day);
+    for (int i = 0; i < exported_field_count; i++) {
+        text_buffer_appendf(buffer, ",");
+        append_value(buffer, statistics, exported_fields[i].type, exported_fields[i].offset);
+    }
+    text_buffer_appendf(buffer, "\n");
+}
+
+static void format_jsonl_record(TextBuffer *buffer, const SimulationStatistics *statistics, int day, StatisticsRecordKind kind) {
+    text_buffer_appendf(buffer, "{\"schema_version\":%d,\"record\":\"%s\",\"day\":%d",
+                        STATISTICS_SCHEMA_VERSION, record_kind_names[kind], day);
+    for (int i = 0; i < exported_field_count; i++) {
+        text_buffer_appendf(buffer, ",\"%s\":", exported_fields[i].key);
+        append_value(buffer, statistics, exported_fields[i].type, exported_fields[i].offset);
+    }
+
+    /* Tempi per operatore (complessivi): numero variabile, solo in JSON */
+    text_buffer_appendf(buffer, ",\"operators\":[");
+    for (int i = 0; i < statistics->operator_timings_count; i++) {
+        const OperatorTimingSummary *op = &statistics->operator_timings[i];
+        const char *point = (op->service_point >= 0 && op->service_point < SERVICE_POINT_COUNT)
+                            ? latency_metric_keys[op->service_point] : "unknown";
+        text_buffer_appendf(buffer, "%s{\"pid\":%d,\"service_point\":\"%s\"", (i > 0) ? "," : "",
+                            (int)op->operator_pid, point);
+        for (int m = 0; m < MEMBER_COUNT(service_members); m++) {
+            text_buffer_appendf(buffer, ",\"%s\":", service_members[m].name);
+            append_value(buffer, &op->timing, service_members[m].type, service_members[m].offset);
+        }
+        text_buffer_appendf(buffer, "}");
+    }
+    text_buffer_appendf(buffer, "]}\n");
+}
+
+/** Passa il buffer al thread di scrittura (che ne diventa proprietario). */
+static void enqueue_buffer(TextBuffer *buffer) {
+    StatisticsChunk *chunk = buffer->failed ? NULL : malloc(sizeof(*chunk));
+    if (chunk == NULL) {
+        LOG_WARN("[STATISTICS] Memoria esaurita: record statistiche scartato.\n");
+        free(buffer->data);
+        return;
+    }
+    chunk->next = NULL;
+    chunk->data = buffer->data;
+    chunk->length = buffer->length;
+
+    pthread_mutex_lock(&writer_lock);
+    if (pending_tail != NULL) pending_tail->next = chunk;
+    else pending_head = chunk;
+    pending_tail = chunk;
+    pthread_cond_signal(&writer_wakeup);
+    pthread_mutex_unlock(&writer_lock);
+}
+
+static bool text_buffer_init(TextBuffer *buffer) {
+    buffer->data = malloc(STATISTICS_RECORD_INITIAL_CAPACITY);
+    buffer->length = 0;
+    buffer->capacity = STATISTICS_RECORD_INITIAL_CAPACITY;
+    buffer->failed = (buffer->data == NULL);
+    return !buffer->failed;
+}
+
+/** Scrive tutto il blocco (scritture parziali e EINTR ripresi). */
+static int write_all(int fd, const char *data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written == -1) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+/** Corpo del thread di scrittura: svuota la coda a lotti finché non viene fermato. */
+static void *statistics_writer_main(void *arg) {
+    (void)arg;
+    bool error_reported = false;
+
+    pthread_mutex_lock(&writer_lock);
+    for (;;) {
+        while (pending_head == NULL && !writer_stopping) {
+            pthread_cond_wait(&writer_wakeup, &writer_lock);
+        }
+        if (pending_head == NULL) break;
+
+        StatisticsChunk *batch = pending_head;
+        pending_head = pending_tail = NULL;
+        pthread_mutex_unlock(&writer_lock);
+
+        bool failed = false;
+        while (batch != NULL) {
+            StatisticsChunk *next = batch->next;
+            if (!failed && write_all(writer_fd, batch->data, batch->length) == -1) failed = true;
+            free(batch->data);
+            free(batch);
+            batch = next;
+        }
+        if (!failed && fdatasync(writer_fd) == -1) failed = true;
+        if (failed && !error_reported) {
+            perror("[ERROR] MASTER: scrittura statistiche fallita");
+            error_reported = true;
+        }
+
+        pthread_mutex_lock(&writer_lock);
+    }
+    pthread_mutex_unlock(&writer_lock);
+    return NULL;
+}
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+int statistics_format_from_name(const char *name) {
+    static const char *const names[] = { "csv", "jsonl" };
+
+    while (isspace((unsigned char)*name)) name++;
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++) {
+        size_t len = strlen(names[i]);
+        if (strncasecmp(name, names[i], len) == 0 && !isalnum((unsigned char)name[len])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int statistics_writer_open(const SimulationConfiguration *config) {
+    if (writer_fd != -1) return 0;
+
+    writer_format = (config->statistics_format == STATISTICS_FORMAT_JSONL) ? STATISTICS_FORMAT_JSONL
+                                                                           : STATISTICS_FORMAT_CSV;
+    const char *path = (writer_format == STATISTICS_FORMAT_JSONL) ? STATISTICS_JSONL_FILE_PATH
+                                                                  : STATISTICS_CSV_FILE_PATH;
+    build_field_table();
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        perror("[ERROR] MASTER: apertura file statistiche fallita");
+        return -1;
+    }
+    writer_fd = fd;
+    writer_stopping = false;
+
+    int err = spawn_master_thread(&writer_thread, statistics_writer_main, NULL);
+
+    if (err != 0) {
+        fprintf(stderr, "[ERROR] MASTER: avvio thread statistiche fallito (errno %d)\n", err);
+        close(fd);
+        writer_fd = -1;
+        return -1;
+    }
+
+    if (writer_format == STATISTICS_FORMAT_CSV) {
+        TextBuffer buffer;
+        if (text_buffer_init(&buffer)) format_csv_header(&buffer);
+        enqueue_buffer(&buffer);
+    }
+
+    LOG_INFO("[MASTER] Statistiche su %s (schema %d, %d campi).\n",
+             path, STATISTICS_SCHEMA_VERSION, exported_field_count);
+    return 0;
+}
+
+void statistics_writer_append(const SimulationStatistics *statistics, int simulation_day, StatisticsRecordKind kind) {
+    if (writer_fd == -1) return;
+
+    TextBuffer buffer;
+    if (text_buffer_init(&buffer)) {
+        if (writer_format == STATISTICS_FORMAT_JSONL) {
+            format_jsonl_record(&buffer, statistics, simulation_day + 1, kind);
+        } else {
+            format_csv_record(&buffer, statistics, simulation_day + 1, kind);
+        }
+    }
+    enqueue_buffer(&buffer);
+}
+
+void statistics_writer_close(void) {
+    if (writer_fd == -1) return;
+
+    pthread_mutex_lock(&writer_lock);
+    writer_stopping = true;
+    pthread_cond_signal(&writer_wakeup);
+    pthread_mutex_unlock(&writer_lock);
+
+    pthread_join(writer_thread, NULL);
+    close(writer_fd);
+    writer_fd = -1;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file timeseries.c
+ * @brief Registrazione della serie temporale su file mappato (lato Master).
+ *
+ * Lo stato (file, mappatura, prossimo campione) è privato del Master: il file
+ * è aperto dal thread principale prima di avviare l'orologio, scritto dal solo
+ * thread dell'orologio e chiuso dopo averlo fermato.
+ *
+ * @see timeseries.h per il formato.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/* Includes del progetto */
+#include "timeseries.h"
+#include "log.h"
+
+_Static_assert(sizeof(TimeSeriesHeader) % 8 == 0, "I record devono restare allineati a 8 byte");
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+static int series_fd = -1;
+static void *series_map = NULL;
+static size_t series_map_size = 0;
+static TimeSeriesHeader *series_header = NULL;
+static TimeSeriesRecord *series_records = NULL;
+
+/** Ultimo minuto campionato: oltre la durata del pasto la mensa è chiusa. */
+static int last_sample_minute = 0;
+
+/** Prossimo campione: giorno e minuto (il primo campione di ogni giorno è al minuto 0). */
+static int next_sample_day = 0;
+static int next_sample_minute = 0;
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+int timeseries_open(const char *path, const SimulationConfiguration *config, const SimulationMenu *menu) {
+    int interval = config->timings.timeseries_interval_minutes;
+    if (interval <= 0) return 0;
+
+    long per_day = config->timings.meal_duration_minutes / interval + 1 + TIMESERIES_SLACK_RECORDS_PER_DAY;
+    long capacity = per_day * (config->timings.simulation_duration_days > 0 ? config->timings.simulation_duration_days : 1);
+    size_t size = sizeof(TimeSeriesHeader) + (size_t)capacity * sizeof(TimeSeriesRecord);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        perror("[ERROR] MASTER: apertura serie temporale fallita");
+        return -1;
+    }
+
+    /* Blocchi riservati subito: i campioni non allocano spazio su disco */
+    int err = posix_fallocate(fd, 0, (off_t)size);
+    if (err != 0) {
+        fprintf(stderr, "[ERROR] MASTER: preallocazione serie temporale fallita (errno %d)\n", err);
+        close(fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        perror("[ERROR] MASTER: mmap serie temporale fallita");
+        close(fd);
+        return -1;
+    }
+
+    TimeSeriesHeader *header = (TimeSeriesHeader *)map;
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, TIMESERIES_FILE_MAGIC, sizeof(header->magic));
+    header->version = TIMESERIES_FILE_VERSION;
+    header->record_size = sizeof(TimeSeriesRecord);
+    header->capacity = (uint32_t)capacity;
+    header->interval_minutes = (uint32_t)interval;
+    header->dish_counts[0] = (uint32_t)menu->number_of_first_courses;
+    header->dish_counts[1] = (uint32_t)menu->number_of_second_courses;
+    for (int d = 0; d < menu->number_of_first_courses; d++) {
+        memcpy(header->dish_names[0][d], menu->first_courses[d].name, MAX_DISH_NAME_LENGTH);
+    }
+    for (int d = 0; d < menu->number_of_second_courses; d++) {
+        memcpy(header->dish_names[1][d], menu->second_courses[d].name, MAX_DISH_NAME_LENGTH);
+    }
+
+    series_fd = fd;
+    series_map = map;
+    series_map_size = size;
+    series_header = header;
+    series_records = (TimeSeriesRecord *)((char *)map + sizeof(TimeSeriesHeader));
+    last_sample_minute = config->timings.meal_duration_minutes;
+    next_sample_day = 0;
+    next_sample_minute = 0;
+
+    LOG_INFO("[MASTER] Serie temporale su %s: un campione ogni %d minuti, %ld record preallocati.\n",
+             path, interval, capacity);
+    return 0;
+}
+
+void timeseries_sample(const LiveStatisticsData *data) {
+    if (series_header == NULL) return;
+
+    /*
+     * Nuovo giorno: si riparte dal minuto 0. Il giorno viene incrementato
+     * prima dell'azzeramento dei minuti, quindi anche un minuto che torna
+     * indietro segna l'inizio della giornata.
+     */
+    if (data->day != next_sample_day || data->minute < next_sample_minute - (int)series_header->interval_minutes) {
+        next_sample_day = data->day;
+        next_sample_minute = 0;
+    }
+    if (data->minute < next_sample_minute || data->minute > last_sample_minute) return;
+
+    /* Minuti saltati (risveglio in ritardo): il passo resta allineato all'intervallo */
+    int interval = (int)series_header->interval_minutes;
+    next_sample_minute = (data->minute / interval + 1) * interval;
+
+    if (series_header->record_count >= series_header->capacity) {
+        if (series_header->dropped++ == 0) {
+            LOG_WARN("[MASTER] Serie temporale piena (%u record): campioni successivi scartati.\n",
+                     series_header->capacity);
+        }
+        return;
+    }
+
+    TimeSeriesRecord *record = &series_records[series_header->record_count];
+    memset(record, 0, sizeof(*record));
+    record->tick = data->tick;
+    record->day = data->day;
+    record->minute = data->minute;
+    for (int i = 0; i < LIVE_STATION_COUNT; i++) {
+        record->pending_orders[i] = data->stations[i].pending_orders;
+        record->busy_posts[i] = data->stations[i].busy_posts;
+    }
+    for (int c = 0; c < 2; c++) {
+        const LiveStationView *view = &data->stations[c];
+        for (int d = 0; d < view->dish_count; d++) {
+            record->portions[c][d] = view->portions[d];
+        }
+    }
+    record->occupied_seats = data->occupied_seats;
+    record->tables_in_use = data->tables_in_use;
+    record->waiting_groups = data->waiting_groups;
+    record->total_users = data->total_users;
+    record->clients_served_total = data->clients_served_total;
+    record->clients_not_served_total = data->clients_not_served_total;
+
+    /* Conteggio aggiornato dopo il record: un lettore concorrente vede solo record completi */
+    atomic_thread_fence(memory_order_release);
+    series_header->record_count++;
+}
+
+void timeseries_close(void) {
+    if (series_header == NULL) return;
+
+    uint32_t count = series_header->record_count;
+    uint32_t dropped = series_header->dropped;
+    off_t used = (off_t)(sizeof(TimeSeriesHeader) + (size_t)count * sizeof(TimeSeriesRecord));
+
+    munmap(series_map, series_map_size);
+    if (ftruncate(series_fd, used) == -1) {
+        perror("[ERROR] MASTER: troncamento serie temporale fallito");
+    }
+    close(series_fd);
+
+    series_fd = -1;
+    series_map = NULL;
+    series_header = NULL;
+    series_records = NULL;
+
+    LOG_INFO("[MASTER] Serie temporale chiusa: %u campioni, %u scartati.\n", count, dropped);
+}
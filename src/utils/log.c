@@ -0,0 +1,68 @@
+/**
+ * @file log.c
+ * @brief Implementazione del filtro per ruolo e della scrittura dei log.
+ *
+ * @see log.h per i livelli e i macro LOG_*.
+ */
+
+/* Includes di sistema */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+/* Includes del progetto */
+#include "log.h"
+
+/* ==========================================================================
+ *                        STRUTTURE DATI (PRIVATE)
+ * ========================================================================== */
+
+/** Livelli usati prima di log_bind_levels(): tutto abilitato */
+static const int default_levels[LOG_ROLE_COUNT] = {
+    LOG_LEVEL_DEBUG, LOG_LEVEL_DEBUG, LOG_LEVEL_DEBUG, LOG_LEVEL_DEBUG, LOG_LEVEL_DEBUG
+};
+
+static LogRole process_role = LOG_ROLE_TOOL;
+static const int *role_levels = default_levels;
+
+const int *log_current_level = &default_levels[LOG_ROLE_TOOL];
+
+/* ==========================================================================
+ *                    SEZIONE: IMPLEMENTAZIONE PUBBLICA
+ * ========================================================================== */
+
+void log_set_role(LogRole role) {
+    process_role = role;
+    log_current_level = &role_levels[process_role];
+}
+
+void log_bind_levels(const int *levels) {
+    role_levels = (levels != NULL) ? levels : default_levels;
+    log_current_level = &role_levels[process_role];
+}
+
+int log_level_from_name(const char *name) {
+    static const char *const names[] = {"error", "warn", "info", "debug"};
+
+    while (isspace((unsigned char)*name)) name++;
+    if (*name >= '0' && *name <= '9') {
+        int level = *name - '0';
+        return (level <= LOG_LEVEL_DEBUG) ? level : -1;
+    }
+    for (int i = 0; i <= LOG_LEVEL_DEBUG; i++) {
+        size_t len = strlen(names[i]);
+        if (strncasecmp(name, names[i], len) == 0 && !isalnum((unsigned char)name[len])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void log_write(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
@@ -4,8 +4,9 @@
  * 
  * Fornisce:
  * - Gestione errori critici
- * - Generazione numeri casuali e probabilità
+ * - Generazione numeri casuali e probabilità (xoshiro256** per thread)
  * - Simulazione del passaggio del tempo
+ * - Avvio dei thread di servizio
  * 
  * @see utils.h per la documentazione delle funzioni pubbliche.
  */
@@ -15,9 +16,13 @@
 #include <stdio.h>
 #include <time.h>
 #include <errno.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <signal.h>
 
 /* Includes del progetto */
 #include "utils.h"
+#include "virtual_clock.h"
 
 /* ==========================================================================
  *                         SEZIONE: GESTIONE ERRORI
@@ -33,13 +38,109 @@ void display_critical_error(const char *error_message) {
  *                       SEZIONE: GENERAZIONE CASUALE
  * ========================================================================== */
 
+/** Stato xoshiro256** del thread (tutto zero: non ancora inizializzato). */
+typedef struct {
+    uint64_t s[4];
+} RandomStreamState;
+
+static __thread RandomStreamState random_stream;
+
+/** Passo di splitmix64: espande un seme a 64 bit in parole ben distribuite. */
+static uint64_t splitmix64_next(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotate_left(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/** Passo di xoshiro256** sullo stato indicato. */
+static inline uint64_t xoshiro256_next(RandomStreamState *state) {
+    uint64_t *s = state->s;
+    uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate_left(s[3], 45);
+    return result;
+}
+
+/** Stato del thread, inizializzato al volo se nessuno ha chiamato seed_random_stream(). */
+static RandomStreamState *current_random_stream(void) {
+    RandomStreamState *state = &random_stream;
+    if ((state->s[0] | state->s[1] | state->s[2] | state->s[3]) == 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        uint64_t fallback = ((uint64_t)now.tv_sec << 32) ^ (uint64_t)now.tv_nsec;
+        seed_random_stream(fallback, RANDOM_STREAM_MASTER, (uint64_t)gettid());
+    }
+    return state;
+}
+
+/** Intero uniforme in [0, range) con il metodo di Lemire (range > 0, al più 2^32). */
+static inline uint64_t bounded_random(RandomStreamState *state, uint64_t range) {
+    uint64_t product = (xoshiro256_next(state) >> 32) * range;
+    uint32_t low = (uint32_t)product;
+
+    if (low < range) {
+        uint32_t threshold = (uint32_t)((0x100000000ULL - range) % range);
+        while (low < threshold) {
+            product = (xoshiro256_next(state) >> 32) * range;
+            low = (uint32_t)product;
+        }
+    }
+    return product >> 32;
+}
+
+void seed_random_stream(uint64_t master_seed, RandomStreamRole role, uint64_t index) {
+    /* Ruolo e indice mescolati nel seme: flussi distinti per ogni coppia */
+    uint64_t mix = master_seed;
+    uint64_t key = ((uint64_t)role << 56) ^ index;
+    mix ^= splitmix64_next(&key);
+
+    for (int i = 0; i < 4; i++) {
+        random_stream.s[i] = splitmix64_next(&mix);
+    }
+    if ((random_stream.s[0] | random_stream.s[1] | random_stream.s[2] | random_stream.s[3]) == 0) {
+        random_stream.s[0] = 1; /* Lo stato nullo è l'unico punto fisso del generatore */
+    }
+}
+
+uint64_t generate_random_bits(void) {
+    return xoshiro256_next(current_random_stream());
+}
+
+void generate_random_integers(int *values, int count, int minimum_value, int maximum_value) {
+    if (minimum_value >= maximum_value) {
+        for (int i = 0; i < count; i++) values[i] = minimum_value;
+        return;
+    }
+
+    /* Copia locale: lo stato resta nei registri per tutto il blocco */
+    RandomStreamState *stream = current_random_stream();
+    RandomStreamState state = *stream;
+    uint64_t range = (uint64_t)((int64_t)maximum_value - minimum_value) + 1;
+    for (int i = 0; i < count; i++) {
+        values[i] = (int)((int64_t)minimum_value + (int64_t)bounded_random(&state, range));
+    }
+    *stream = state;
+}
+
 /** Genera un intero casuale nell'intervallo [min, max]. */
 int generate_random_integer(int minimum_value, int maximum_value) {
     int random_result = minimum_value;
     
     /* Protezione contro parametri invertiti o uguali */
     if (minimum_value < maximum_value) {
-        random_result = minimum_value + rand() % (maximum_value - minimum_value + 1);
+        uint64_t range = (uint64_t)((int64_t)maximum_value - minimum_value) + 1;
+        random_result = (int)((int64_t)minimum_value + (int64_t)bounded_random(current_random_stream(), range));
     }
     
     return random_result;
@@ -70,7 +171,7 @@ bool evaluate_probability_event(int success_percentage_rate) {
     if (success_percentage_rate >= 100) {
         event_occurred = true;
     } else if (success_percentage_rate > 0) {
-        event_occurred = (rand() % 100) < success_percentage_rate;
+        event_occurred = bounded_random(current_random_stream(), 100) < (uint64_t)success_percentage_rate;
     }
     
     return event_occurred;
@@ -81,17 +182,27 @@ bool evaluate_probability_event(int success_percentage_rate) {
  * ========================================================================== */
 
 /**
- * Simula il passaggio del tempo convertendo unità simulate in nanosleep.
+ * Attesa di `total_nanoseconds` reali, o virtuali con CLOCK_MODE=virtual.
  * Gestisce automaticamente le interruzioni da segnale (EINTR).
  */
-void simulate_time_passage(int simulated_minutes, long nanoseconds_per_minute) {
-    if (simulated_minutes <= 0) return;
-
+static void sleep_simulated_nanoseconds(long long total_nanoseconds) {
+#ifdef USE_VIRTUAL_CLOCK
+    VirtualClock *clock = virtual_clock_bound();
+    if (clock != NULL) {
+        if (virtual_clock_sleep(clock, total_nanoseconds, false) == 0) return;
+
+        /* Slot esauriti: l'attesa reale non segue l'orologio virtuale, l'ordine delle scadenze non è garantito */
+        static atomic_bool exhaustion_reported = false;
+        if (!atomic_exchange(&exhaustion_reported, true)) {
+            fprintf(stderr, "[ERROR] PID %d: slot dell'orologio virtuale esauriti (%d), attesa reale.\n",
+                    getpid(), clock->sleepers_count);
+        }
+    }
+    /* Processo fuori SHM o slot esauriti: ripiego sull'attesa reale */
+#endif
     struct timespec requested_time;
-    long total_nanoseconds = (long)simulated_minutes * nanoseconds_per_minute;
-
-    requested_time.tv_sec = total_nanoseconds / 1000000000L;
-    requested_time.tv_nsec = total_nanoseconds % 1000000000L;
+    requested_time.tv_sec = (time_t)(total_nanoseconds / 1000000000LL);
+    requested_time.tv_nsec = (long)(total_nanoseconds % 1000000000LL);
 
     /* Loop robusto per nanosleep: riprende se interrotto da EINTR */
     while (nanosleep(&requested_time, &requested_time) == -1) {
@@ -101,19 +212,30 @@ void simulate_time_passage(int simulated_minutes, long nanoseconds_per_minute) {
     }
 }
 
+/** Simula il passaggio del tempo convertendo unità simulate in attese. */
+void simulate_time_passage(int simulated_minutes, long nanoseconds_per_minute) {
+    if (simulated_minutes <= 0) return;
+
+    sleep_simulated_nanoseconds((long long)simulated_minutes * nanoseconds_per_minute);
+}
+
 void simulate_seconds_passage(int simulated_seconds, long nanoseconds_per_minute) {
     if (simulated_seconds <= 0) return;
 
-    struct timespec requested_time;
     /* Conversione: secondi simulati → nanosecondi reali via scala NNANOSECS (per minuto) */
-    long long total_nanoseconds = ((long long)simulated_seconds * nanoseconds_per_minute) / 60;
+    sleep_simulated_nanoseconds(((long long)simulated_seconds * nanoseconds_per_minute) / 60);
+}
 
-    requested_time.tv_sec = (time_t)(total_nanoseconds / 1000000000LL);
-    requested_time.tv_nsec = (long)(total_nanoseconds % 1000000000LL);
+/* ==========================================================================
+ *                      SEZIONE: THREAD DI SERVIZIO
+ * ========================================================================== */
 
-    while (nanosleep(&requested_time, &requested_time) == -1) {
-        if (errno != EINTR) {
-            break;
-        }
-    }
+int spawn_master_thread(pthread_t *thread, void *(*start_routine)(void *), void *arg) {
+    /* Maschera ereditata dal thread: i segnali restano al thread principale */
+    sigset_t all_signals, previous;
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_BLOCK, &all_signals, &previous);
+    int err = pthread_create(thread, NULL, start_routine, arg);
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    return err;
 }